@@ -0,0 +1,137 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file block_cache.hpp
+#pragma once
+#ifndef PCH
+    #include <array>
+    #include <atomic>
+    #include <cstdint>
+    #include <memory>
+    #include <mutex>
+    #include <span>
+    #include <string>
+    #include <unordered_map>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief A page-aligned block of a cached source.
+    struct cached_block
+    {
+        /// @brief Allocates `capacity` bytes aligned to `alignment`.
+        cached_block(std::size_t capacity, std::size_t alignment) noexcept(false);
+
+        /// @brief The valid bytes of the block.
+        std::span<const std::uint8_t> bytes() const noexcept { return {data.get(), size}; }
+
+        std::unique_ptr<std::uint8_t, void (*)(void*)> data; /// Aligned storage of `block_cache::block_size()` bytes.
+        std::size_t size {};                                 /// Number of valid bytes (less for the last block of a source).
+    };
+
+    /// @brief Counters of a `block_cache`, for sizing it.
+    struct block_cache_statistics
+    {
+        std::uint64_t hits {};           /// Lookups served from the cache.
+        std::uint64_t misses {};         /// Blocks that had to be loaded.
+        std::uint64_t evictions {};      /// Blocks dropped to make room.
+        std::uint64_t resident_bytes {}; /// Bytes currently held.
+        std::uint64_t pinned_bytes {};   /// Bytes held by pinned blocks.
+    };
+
+    /// @brief A concurrent cache of fixed-size source blocks under a byte budget, shared by all readers of a process.
+    /// Blocks are keyed by (source id, block number) and spread over independently locked shards; each shard evicts
+    /// with the CLOCK algorithm (a second chance for recently used blocks) and skips pinned blocks, such as the top
+    /// levels of a spatial index. Blocks are handed out as shared pointers, so an evicted block stays valid for the
+    /// readers still using it. The cache never loads anything itself: `cached_reader` loads missing blocks in runs.
+    class block_cache
+    {
+    public:
+        /// @brief Constructs the cache.
+        /// @param capacity_bytes Byte budget; at least one block per shard is kept.
+        /// @param block_size Size of a block; a multiple of the page size.
+        explicit block_cache(std::size_t capacity_bytes, std::size_t block_size = default_block_size) noexcept(false);
+
+        /// @brief A stable id for a named source (e.g. a path with its size and modification time).
+        std::uint64_t source_id(const std::string& name) noexcept(false);
+        /// @brief Size of a block in bytes.
+        std::size_t block_size() const noexcept { return block_size_; }
+
+        /// @brief Looks up a block, counting a hit when found.
+        /// @param pin True to pin the block if it is found.
+        /// @return The block, or null if it is not resident.
+        std::shared_ptr<const cached_block> find(std::uint64_t source, std::uint64_t block, bool pin = false) noexcept(false);
+        /// @brief True if the block is resident; not counted as a hit.
+        bool contains(std::uint64_t source, std::uint64_t block) noexcept(false);
+        /// @brief Allocates an empty block for `insert`.
+        std::shared_ptr<cached_block> allocate() const noexcept(false);
+        /// @brief Inserts a loaded block, counting a miss, and evicts as needed.
+        /// @param pin True to keep the block resident for the lifetime of the cache (while pinned blocks fill at most
+        ///            half of the budget; beyond that the block is cached normally).
+        /// @return The resident block: `data`, or the copy another reader inserted first.
+        std::shared_ptr<const cached_block> insert(std::uint64_t source, std::uint64_t block, std::shared_ptr<cached_block> data,
+                                                   bool pin = false) noexcept(false);
+
+        /// @brief A snapshot of the counters.
+        block_cache_statistics statistics() const noexcept;
+        /// @brief Prints the counters to standard output.
+        void print_statistics() const noexcept(false);
+
+        static constexpr std::size_t default_block_size {64u * 1024u}; /// Default block size.
+
+    private:
+        /// @brief Key of a block.
+        struct block_key
+        {
+            std::uint64_t source {}; /// Source id.
+            std::uint64_t block {};  /// Block number.
+
+            bool operator==(const block_key&) const noexcept = default;
+        };
+
+        /// @brief Hash of a block key.
+        struct block_key_hash
+        {
+            std::size_t operator()(const block_key& key) const noexcept;
+        };
+
+        /// @brief A cache entry.
+        struct slot
+        {
+            block_key key {};                            /// Key of the held block.
+            std::shared_ptr<const cached_block> data {}; /// The block (null for a free slot).
+            bool referenced {};                          /// CLOCK reference bit.
+            bool pinned {};                              /// Never evicted.
+        };
+
+        /// @brief An independently locked part of the cache.
+        struct shard
+        {
+            std::mutex mutex {};                                                 /// Guards the shard.
+            std::unordered_map<block_key, std::size_t, block_key_hash> index {}; /// Slot of each resident block.
+            std::vector<slot> slots {};                                          /// Entries, swept by the clock hand.
+            std::size_t hand {};                                                 /// CLOCK hand.
+        };
+
+        /// @brief The shard of a key.
+        shard& shard_of(const block_key& key) noexcept;
+        /// @brief Finds a slot for a new block in a locked shard, evicting an unreferenced one if the shard is full.
+        /// @return The slot index, or `slots.size()` if every slot is pinned.
+        std::size_t free_slot(shard& target) noexcept;
+
+        static constexpr std::size_t shard_count_ {16u}; /// Number of shards.
+        static constexpr std::size_t alignment_ {4096u}; /// Block alignment (the page size).
+
+        const std::size_t block_size_;                              /// Size of a block.
+        const std::size_t slots_per_shard_;                         /// Capacity of a shard in blocks.
+        const std::uint64_t max_pinned_bytes_;                      /// Bytes that may be pinned.
+        std::array<shard, shard_count_> shards_ {};                 /// The shards.
+        std::mutex sources_mutex_ {};                               /// Guards `sources_`.
+        std::unordered_map<std::string, std::uint64_t> sources_ {}; /// Source ids by name.
+        std::atomic<std::uint64_t> hits_ {};                        /// Lookups served from the cache.
+        std::atomic<std::uint64_t> misses_ {};                      /// Loaded blocks.
+        std::atomic<std::uint64_t> evictions_ {};                   /// Evicted blocks.
+        std::atomic<std::uint64_t> resident_bytes_ {};              /// Bytes held.
+        std::atomic<std::uint64_t> pinned_bytes_ {};                /// Bytes held by pinned blocks.
+    };
+
+} // namespace kmx::gis
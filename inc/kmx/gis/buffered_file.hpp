@@ -0,0 +1,106 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file buffered_file.hpp
+#pragma once
+#ifndef PCH
+    #include <cstddef>
+    #include <cstdint>
+    #include <span>
+    #include <string>
+    #include <string_view>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Sequential reader of a file with one large buffer, for streaming passes over big files.
+    /// The kernel is told the access is sequential, so it reads ahead; lines and peeked bytes are views into the buffer
+    /// and stay valid until the next call that reads.
+    class buffered_file_reader
+    {
+    public:
+        /// @brief Opens the file.
+        /// @param path Path of the file.
+        /// @param buffer_size Size of the read buffer (grows if a line does not fit).
+        /// @throws std::runtime_error If the file cannot be opened.
+        buffered_file_reader(const std::string& path, std::size_t buffer_size) noexcept(false);
+        /// @brief Closes the file. `noexcept` is ensured.
+        ~buffered_file_reader() noexcept;
+
+        buffered_file_reader(const buffered_file_reader&) = delete;
+        buffered_file_reader& operator=(const buffered_file_reader&) = delete;
+        buffered_file_reader(buffered_file_reader&&) = delete;
+        buffered_file_reader& operator=(buffered_file_reader&&) = delete;
+
+        /// @brief Path of the file.
+        const std::string& path() const noexcept { return path_; }
+
+        /// @brief Reads the next line, without its "\n" or "\r\n".
+        /// @return False at the end of the file.
+        /// @throws std::runtime_error On read errors.
+        bool next_line(std::string_view& line) noexcept(false);
+        /// @brief Copies the next `out.size()` bytes.
+        /// @return False if the file ends first (then nothing is consumed).
+        /// @throws std::runtime_error On read errors.
+        bool read_exact(std::span<std::uint8_t> out) noexcept(false);
+        /// @brief The next (at most) `count` bytes, without consuming them.
+        std::string_view peek(std::size_t count) noexcept(false);
+        /// @brief Consumes and returns all buffered bytes, reading more first if none are buffered.
+        /// @return An empty view at the end of the file.
+        std::string_view take_buffered() noexcept(false);
+
+    private:
+        /// @brief Moves the unread bytes to the front of the buffer and reads more behind them.
+        /// @return False if nothing more could be read.
+        bool fill() noexcept(false);
+
+        std::string path_;           /// Path of the file.
+        int fd_ {-1};                /// File descriptor.
+        std::vector<char> buffer_;   /// Read buffer.
+        std::size_t begin_ {};       /// First unread byte in `buffer_`.
+        std::size_t end_ {};         /// End of the read bytes in `buffer_`.
+        bool eof_ {};                /// True once the end of the file was reached.
+    };
+
+    /// @brief Sequential writer of a file with one large buffer.
+    class buffered_file_writer
+    {
+    public:
+        /// @brief Creates or truncates the file.
+        /// @throws std::runtime_error If the file cannot be created.
+        buffered_file_writer(const std::string& path, std::size_t buffer_size) noexcept(false);
+        /// @brief Closes the file without reporting errors; call `close` to check them. `noexcept` is ensured.
+        ~buffered_file_writer() noexcept;
+
+        buffered_file_writer(const buffered_file_writer&) = delete;
+        buffered_file_writer& operator=(const buffered_file_writer&) = delete;
+        buffered_file_writer(buffered_file_writer&&) = delete;
+        buffered_file_writer& operator=(buffered_file_writer&&) = delete;
+
+        /// @brief Appends bytes.
+        /// @throws std::runtime_error On write errors.
+        void write(std::string_view bytes) noexcept(false);
+        /// @brief Appends raw bytes.
+        void write(std::span<const std::uint8_t> bytes) noexcept(false)
+        {
+            write(std::string_view {reinterpret_cast<const char*>(bytes.data()), bytes.size()});
+        }
+        /// @brief Number of bytes written so far (including buffered ones).
+        std::uint64_t size() const noexcept { return written_ + buffer_.size(); }
+        /// @brief Writes the buffered bytes and closes the file.
+        /// @throws std::runtime_error On write errors.
+        void close() noexcept(false);
+
+    private:
+        /// @brief Writes the buffered bytes.
+        void flush() noexcept(false);
+        /// @brief Writes bytes to the file, past the buffer.
+        void write_through(std::string_view bytes) noexcept(false);
+
+        std::string path_;          /// Path of the file.
+        int fd_ {-1};               /// File descriptor.
+        std::vector<char> buffer_;  /// Pending bytes.
+        std::size_t capacity_ {};   /// Flush threshold.
+        std::uint64_t written_ {};  /// Bytes handed to the kernel.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,89 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file cached_reader.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/block_cache.hpp"
+    #include "kmx/gis/http_range_reader.hpp"
+    #include "kmx/thread_pool.hpp"
+    #include <atomic>
+    #include <cstdint>
+    #include <functional>
+    #include <memory>
+    #include <span>
+    #include <string>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Partial reads of a file through a shared `block_cache`.
+    /// The bytes come from a loader: `pread` for local files, range requests for `http://` URLs. Reads are split into
+    /// cache blocks; consecutive missing blocks are loaded with one loader call, so a read costs at most one `pread` or
+    /// request per run of missing blocks. Thread-safe.
+    class cached_reader
+    {
+    public:
+        /// @brief Loads `out.size()` bytes starting at `offset`; must be callable from several threads at once.
+        using loader = std::function<void(std::uint64_t offset, std::span<std::uint8_t> out)>;
+
+        /// @brief Constructs a reader over a custom loader.
+        /// @param cache The shared cache; must outlive the reader.
+        /// @param name Identifies the bytes in the cache; must change when the content does.
+        /// @param size Size of the source in bytes.
+        /// @param load Loads bytes of the source.
+        cached_reader(block_cache& cache, const std::string& name, std::uint64_t size, loader load) noexcept(false);
+
+        /// @brief Opens a local file (read with `pread`) or an `http://` URL (read with range requests).
+        /// @throws std::runtime_error If the file cannot be opened.
+        static std::unique_ptr<cached_reader> open(block_cache& cache, const std::string& path) noexcept(false);
+
+        /// @brief The path or URL the reader was opened with.
+        const std::string& name() const noexcept { return name_; }
+        /// @brief Size of the source in bytes.
+        std::uint64_t size() const noexcept { return size_; }
+
+        /// @brief Reads `out.size()` bytes starting at `offset` through the cache.
+        /// @param pin True to pin the touched blocks (e.g. the top levels of an index).
+        /// @throws std::runtime_error If the range lies outside the source or loading fails.
+        void read(std::uint64_t offset, std::span<std::uint8_t> out, bool pin = false) noexcept(false);
+        /// @brief Reads one range through the cache.
+        std::vector<std::uint8_t> read(byte_range range) noexcept(false);
+        /// @brief Reads bypassing the cache, for large one-off scans that would only evict the working set.
+        void read_uncached(std::uint64_t offset, std::span<std::uint8_t> out) noexcept(false);
+        /// @brief Loads the missing blocks of several ranges into the cache, runs in parallel on `pool`.
+        /// Subsequent `read`s of the ranges are then served from the cache (while it holds them).
+        void prefetch(std::span<const byte_range> ranges, thread_pool& pool) noexcept(false);
+
+        /// @brief Number of loader calls (system calls or requests) so far.
+        std::uint64_t load_count() const noexcept { return load_count_; }
+        /// @brief Number of bytes loaded so far.
+        std::uint64_t bytes_loaded() const noexcept { return bytes_loaded_; }
+
+    private:
+        /// @brief A run of consecutive blocks.
+        struct block_run
+        {
+            std::uint64_t first {}; /// First block.
+            std::uint64_t count {}; /// Number of blocks.
+        };
+
+        /// @brief Calls the loader and counts the call.
+        void load(std::uint64_t offset, std::span<std::uint8_t> out) noexcept(false);
+        /// @brief Loads a run of blocks with one loader call and inserts them into the cache.
+        /// @param out Receives the resident blocks of the run (may be empty).
+        void load_run(const block_run& run, bool pin, std::span<std::shared_ptr<const cached_block>> out) noexcept(false);
+        /// @brief Number of valid bytes of a block.
+        std::size_t block_length(std::uint64_t block) const noexcept;
+
+        static constexpr std::uint64_t max_run_blocks_ {128u}; /// Blocks loaded with one call at most.
+
+        block_cache& cache_;                         /// The shared cache.
+        std::string name_;                           /// Path or URL.
+        std::uint64_t source_ {};                    /// Source id in the cache.
+        std::uint64_t size_ {};                      /// Size of the source.
+        loader load_;                                /// Loads source bytes.
+        std::atomic<std::uint64_t> load_count_ {};   /// Loader calls.
+        std::atomic<std::uint64_t> bytes_loaded_ {}; /// Bytes loaded.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,56 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file container_limits.hpp
+#pragma once
+#ifndef PCH
+    #include <cstdint>
+    #include <filesystem>
+    #include <optional>
+    #include <string>
+    #include <string_view>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief The CPUs a process may use, and where the restriction comes from.
+    struct cpu_allowance
+    {
+        std::uint32_t online {};        /// CPUs of the host (`std::thread::hardware_concurrency`).
+        std::uint32_t affinity {};      /// CPUs in the scheduler affinity mask (`sched_getaffinity`).
+        std::optional<double> quota {}; /// CPU bandwidth quota of the cgroup in CPUs, if one is set.
+        std::uint32_t effective {};     /// Usable CPUs: the affinity count, capped by the whole quota (at least 1).
+    };
+
+    /// @brief Reads the resource limits that the control groups of the process impose (container and batch job limits).
+    /// Both cgroup v2 (the unified hierarchy) and v1 (one hierarchy per controller) are understood. A limit can be set at
+    /// any level above the cgroup of the process, so the directories from its own cgroup up to the hierarchy root are
+    /// all read and the tightest limit wins. Missing or unreadable files mean "no limit".
+    class container_limits
+    {
+    public:
+        /// @brief The memory limit of the process: `memory.max` (v2) or `memory.limit_in_bytes` (v1).
+        /// @return The limit in bytes, or `std::nullopt` if none is set.
+        static std::optional<std::uint64_t> memory_limit() noexcept(false);
+        /// @brief The CPU bandwidth quota of the process: `cpu.max` (v2) or `cpu.cfs_quota_us / cpu.cfs_period_us` (v1).
+        /// @return The quota in CPUs (e.g. 2.5), or `std::nullopt` if none is set.
+        static std::optional<double> cpu_quota() noexcept(false);
+        /// @brief The CPUs the process may use, from the affinity mask and the quota.
+        static cpu_allowance cpus() noexcept(false);
+
+    private:
+        /// @brief The cgroup directories of the process for a controller, from its own cgroup up to the root.
+        /// @param v1_controller The controller name in the v1 hierarchy (e.g. "memory"); v2 has a single hierarchy.
+        /// @param[out] is_v2 Set to true if the directories belong to the unified hierarchy.
+        static std::vector<std::filesystem::path> cgroup_directories(std::string_view v1_controller, bool& is_v2) noexcept(false);
+        /// @brief The first whitespace-delimited word of a file (empty if it cannot be read).
+        static std::string first_word(const std::filesystem::path& path) noexcept(false);
+        /// @brief Parses `text` as a whole unsigned number.
+        static std::optional<std::uint64_t> parse_number(std::string_view text) noexcept;
+        /// @brief Number of CPUs in the affinity mask of the process (0 if it cannot be read).
+        static std::uint32_t affinity_cpus() noexcept;
+
+        static constexpr std::string_view cgroup_root_ {"/sys/fs/cgroup"};        /// Mount point of the hierarchies.
+        static constexpr std::uint64_t v1_unlimited_ {std::uint64_t {1u} << 62u}; /// v1 reports "no limit" as a huge value.
+    };
+
+} // namespace kmx::gis
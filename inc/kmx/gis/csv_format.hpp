@@ -0,0 +1,45 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file csv_format.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/bounding_box.hpp"
+    #include "kmx/gis/types.hpp"
+    #include <cstdint>
+    #include <ostream>
+    #include <string_view>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Stateless helpers shared by the CSV writers of all modes.
+    class csv_format
+    {
+    public:
+        /// @brief CSV delimiter character.
+        static constexpr char delimiter {','};
+
+        /// @brief Writes a string field, enclosing it in double quotes (with embedded quotes doubled) if it contains a
+        /// comma, a double quote or a newline.
+        /// @param out The output stream.
+        /// @param value The field value.
+        static void write_escaped(std::ostream& out, std::string_view value) noexcept(false);
+
+        /// @brief Writes the header row of the bounding box CSV output (bbox mode).
+        /// @param out_file The output stream.
+        static void write_bbox_header(std::ostream& out_file) noexcept(false);
+
+        /// @brief Writes a single bounding box CSV row for a feature; shared by all bbox mode readers.
+        /// @param out_file The output stream.
+        /// @param uat_name The UAT name for the feature.
+        /// @param uat_code The UAT code for the feature (0 if not available).
+        /// @param county_mn The 2-character county code for the feature.
+        /// @param bbox The calculated bounding box for the feature.
+        static void write_bbox_row(std::ostream& out_file, std::string_view uat_name, std::uint32_t uat_code, const county_code& county_mn,
+                                   const bounding_box& bbox) noexcept(false);
+
+    private:
+        static constexpr std::string_view newline_ {"\n"};                     /// CSV newline string.
+        static constexpr double square_meters_in_square_kilometer_ {1000000.0}; /// Conversion factor
+    };
+
+} // namespace kmx::gis
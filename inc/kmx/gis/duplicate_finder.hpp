@@ -0,0 +1,83 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file duplicate_finder.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/fgb_dataset.hpp"
+    #include "kmx/gis/geometry_hash.hpp"
+    #include "kmx/gis/types.hpp"
+    #include "kmx/thread_pool.hpp"
+    #include <array>
+    #include <cstdint>
+    #include <limits>
+    #include <mutex>
+    #include <string>
+    #include <string_view>
+    #include <unordered_map>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Finds the features of a polygon FlatGeobuf layer whose geometries are identical, whatever their
+    /// attributes, and writes either a duplicates report or a deduplicated copy of the layer.
+    /// Every ring is canonicalized (closing vertex dropped, started at its smallest vertex and walked in the direction
+    /// that gives the smaller sequence), so the same polygon digitized from another vertex or with the opposite winding
+    /// still matches; ring and part order are kept. The canonical coordinates of each feature are hashed to 128 bits in
+    /// parallel and the hashes are grouped in a sharded concurrent map that chains the features of every hash. Within
+    /// a chain, each feature is compared coordinate by coordinate with every distinct geometry of the chain at a lower
+    /// index and becomes a duplicate of the first one it equals, so a hash collision neither merges distinct geometries
+    /// nor hides a duplicate of a geometry that is not the first of its hash. Only the XY coordinates take part.
+    class duplicate_finder
+    {
+    public:
+        /// @brief Constructs the finder.
+        /// @param input_fgb_path Path to the input FlatGeobuf file (Polygon or MultiPolygon).
+        /// @param output_path Path of the output: a deduplicated FlatGeobuf file if it ends in ".fgb", otherwise a CSV
+        /// report with `feature_index,uat_code,duplicate_of,duplicate_of_uat_code` rows.
+        /// @param num_threads Number of worker threads.
+        duplicate_finder(const std::string& input_fgb_path, const std::string& output_path, std::uint32_t num_threads) noexcept(false);
+
+        /// @brief Finds the duplicates and writes the output.
+        /// @return True on success, false on controlled failure.
+        bool find() noexcept(false);
+
+    private:
+        /// @brief An independently locked part of the hash map.
+        struct shard
+        {
+            std::mutex mutex {};                                                               /// Guards the shard during the hashing pass.
+            std::unordered_map<geometry_hash, std::uint64_t, geometry_hash::hasher> chains {}; /// Last feature chained per hash.
+        };
+
+        /// @brief Per-task scratch buffers.
+        struct scratch
+        {
+            std::vector<ring_view> rings {};                  /// Rings of the current feature.
+            std::vector<std::uint64_t> words {};              /// Canonical form of the current feature.
+            std::vector<std::uint64_t> members {};            /// Features of the current chain, in index order.
+            std::vector<std::uint64_t> leaders {};            /// Lowest feature of every distinct geometry of the chain.
+            std::vector<std::vector<std::uint64_t>> forms {}; /// Canonical forms of the leaders, then of the current feature.
+        };
+
+        /// @brief Writes the canonical form of feature `index` to `words` (see `geometry_hash::canonicalize`).
+        /// @return False if the feature has no polygon rings.
+        bool canonicalize(std::uint64_t index, std::vector<ring_view>& rings, std::vector<std::uint64_t>& words) const noexcept(false);
+        /// @brief The shard of a hash.
+        shard& shard_of(const geometry_hash& hash) noexcept { return shards_[hash.high % shard_count_]; }
+
+        /// @brief Writes the features without a duplicate of a lower index as a new indexed FlatGeobuf file.
+        bool write_deduplicated(const std::vector<std::uint64_t>& duplicate_of) const noexcept(false);
+        /// @brief Writes one row per duplicate feature, in feature order.
+        bool write_report(const std::vector<std::uint64_t>& duplicate_of) const noexcept(false);
+
+        static constexpr std::string_view expected_uat_code_column_ {"natcode"};
+        static constexpr std::size_t shard_count_ {64u};                                        /// Number of map shards.
+        static constexpr std::uint64_t no_feature_ {std::numeric_limits<std::uint64_t>::max()}; /// End of a hash chain.
+
+        const std::string output_path_;             /// Path of the output file.
+        thread_pool thread_pool_;                   /// Thread pool for parallel processing.
+        fgb_dataset dataset_;                       /// Mapped input file.
+        std::array<shard, shard_count_> shards_ {}; /// The hash map.
+    };
+
+} // namespace kmx::gis
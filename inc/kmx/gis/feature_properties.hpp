@@ -0,0 +1,67 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file feature_properties.hpp
+#pragma once
+#ifndef PCH
+    #include "flatgeobuf/feature_generated.h"
+    #include <cstdint>
+    #include <optional>
+    #include <string>
+    #include <string_view>
+#endif
+
+namespace kmx::gis
+{
+    // Type aliases for FlatGeobuf enums
+    using FgbColumnType = FlatGeobuf::ColumnType;
+    using FgbGeometryType = FlatGeobuf::GeometryType;
+
+    /// @brief A stateless utility class for decoding FlatGeobuf feature property blobs.
+    /// Properties are stored per feature as a sequence of (uint16_t column_index, value) pairs whose
+    /// value encoding is defined by the column type in the header schema.
+    class feature_properties
+    {
+    public:
+        /// @brief Finds the index of a property (column) by its name.
+        /// @param fbs_header Pointer to the FlatBuffer Header object.
+        /// @param property_name_to_find The name of the property to search for.
+        /// @return An optional containing the index if found, otherwise `std::nullopt`.
+        static std::optional<std::size_t> find_column_index(const FlatGeobuf::Header* fbs_header,
+                                                            std::string_view property_name_to_find) noexcept;
+
+        /// @brief Retrieves the string value of a specific property for a feature by its column index.
+        /// @param fbs_feature Pointer to the FlatBuffer Feature object.
+        /// @param fbs_header Pointer to the FlatBuffer Header object (for column schema).
+        /// @param target_column_index The index of the desired column/property.
+        /// @return The property value as a string. Returns an empty string if not found or on error.
+        static std::string get_string_value(const FlatGeobuf::Feature* fbs_feature, const FlatGeobuf::Header* fbs_header,
+                                            std::size_t target_column_index) noexcept(false);
+
+        /// @brief Trims surrounding whitespace from `text` and parses the remainder as an unsigned 32-bit integer.
+        /// @param text The raw property text (e.g., a SIRUTA code stored as a string column).
+        /// @return The parsed value, or `std::nullopt` if the trimmed text is empty or not fully numeric.
+        static std::optional<std::uint32_t> parse_uint32(std::string_view text) noexcept;
+
+        /// @brief Reads a property value from the properties blob at a given offset and converts it to a string.
+        /// @param col_type The FlatGeobuf column type of the property.
+        /// @param properties_data_start Pointer to the start of the properties data blob for the feature.
+        /// @param value_offset_in_blob Offset within the properties blob where the value starts.
+        /// @param properties_blob_size Total size of the properties blob.
+        /// @param[out] bytes_read_for_value Number of bytes read from the blob for this specific value.
+        /// @return The property value as a string. Returns an empty string on error or if conversion is not possible.
+        static std::string read_and_convert_value_at_offset(FgbColumnType col_type, const std::uint8_t* properties_data_start,
+                                                            flatbuffers::uoffset_t value_offset_in_blob,
+                                                            flatbuffers::uoffset_t properties_blob_size,
+                                                            flatbuffers::uoffset_t& bytes_read_for_value) noexcept(false);
+
+        /// @brief Calculates the number of bytes a property value occupies in the properties blob, to skip it.
+        /// @param col_type The FlatGeobuf column type of the property.
+        /// @param properties_data_start Pointer to the start of the properties data blob for the feature.
+        /// @param value_offset_in_blob Offset within the properties blob where the value starts.
+        /// @param properties_blob_size Total size of the properties blob.
+        /// @return The number of bytes this property value occupies.
+        static flatbuffers::uoffset_t skip_value_at_offset(FgbColumnType col_type, const std::uint8_t* properties_data_start,
+                                                           flatbuffers::uoffset_t value_offset_in_blob,
+                                                           flatbuffers::uoffset_t properties_blob_size) noexcept;
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,184 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file feature_source.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/block_cache.hpp"
+    #include "kmx/gis/bounding_box.hpp"
+    #include "kmx/gis/shard_plan.hpp"
+    #include "kmx/gis/types.hpp"
+    #include "kmx/thread_pool.hpp"
+    #include <cstdint>
+    #include <memory>
+    #include <optional>
+    #include <span>
+    #include <string>
+    #include <string_view>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief A batch of consecutive features in columnar form, as delivered by a `feature_source`.
+    /// Geometries are zero-copy ring views (valid while the source is alive); properties are the projected columns
+    /// only, converted to text.
+    struct feature_batch
+    {
+        /// @brief Source index of the first feature of the batch.
+        std::uint64_t first_index {};
+        /// @brief Source indices of the features when they are not consecutive (restricted sources; empty otherwise).
+        std::vector<std::uint64_t> indices {};
+        /// @brief Number of features in the batch.
+        std::size_t size {};
+        /// @brief Rings of all features of the batch, concatenated.
+        std::vector<ring_view> rings {};
+        /// @brief Rings of feature `i` are `rings[ring_offsets[i] .. ring_offsets[i + 1])` (`size + 1` entries).
+        std::vector<std::uint32_t> ring_offsets {};
+        /// @brief Exact per-feature boxes, when the source stores them (empty otherwise; then boxes come from the rings).
+        std::vector<bounding_box> bboxes {};
+        /// @brief Projected property columns: `properties[column][i]` (empty text for missing values or columns).
+        std::vector<std::vector<std::string>> properties {};
+        /// @brief Input offset just past the batch, for sources that resume from a byte offset (0 for the others).
+        std::uint64_t end_offset {};
+
+        /// @brief Resets the batch for `column_count` projected columns, keeping the allocated buffers.
+        void reset(const std::uint64_t first, const std::size_t column_count) noexcept(false)
+        {
+            first_index = first;
+            indices.clear();
+            size = 0u;
+            rings.clear();
+            ring_offsets.assign(1u, 0u);
+            bboxes.clear();
+            end_offset = 0u;
+            properties.resize(column_count);
+            for (std::vector<std::string>& column: properties)
+                column.clear();
+        }
+
+        /// @brief Source index of feature `i` of the batch.
+        std::uint64_t index_of(const std::size_t i) const noexcept { return indices.empty() ? first_index + i : indices[i]; }
+
+        /// @brief Approximate heap bytes held by the batch (its buffers and property texts, not the ring coordinates).
+        std::uint64_t memory_bytes() const noexcept
+        {
+            std::uint64_t bytes {indices.capacity() * sizeof(std::uint64_t) + rings.capacity() * sizeof(ring_view) +
+                                 ring_offsets.capacity() * sizeof(std::uint32_t) + bboxes.capacity() * sizeof(bounding_box)};
+            for (const std::vector<std::string>& column: properties)
+            {
+                bytes += column.capacity() * sizeof(std::string);
+                for (const std::string& value: column)
+                    bytes += (value.capacity() > std::string {}.capacity()) ? value.capacity() : 0u;
+            }
+            return bytes;
+        }
+
+        /// @brief Input volume of the batch: 16 bytes per vertex (two doubles) plus the projected property texts.
+        /// Unlike `memory_bytes`, it grows with the vertex density, the main cost of computing a batch.
+        std::uint64_t input_bytes() const noexcept
+        {
+            std::uint64_t bytes {};
+            for (const ring_view& ring: rings)
+                bytes += static_cast<std::uint64_t>(ring.point_count) * 2u * sizeof(double);
+            for (const std::vector<std::string>& column: properties)
+                for (const std::string& value: column)
+                    bytes += value.size();
+            return bytes;
+        }
+
+        /// @brief The rings of feature `i` of the batch.
+        std::span<const ring_view> rings_of(const std::size_t i) const noexcept
+        {
+            return std::span<const ring_view> {rings}.subspan(ring_offsets[i], ring_offsets[i + 1u] - ring_offsets[i]);
+        }
+    };
+
+    /// @brief A sequential reader of polygon features, independent of the file format.
+    /// The processing pipelines pull batches with `next_batch` and only depend on this interface, so new formats and
+    /// in-memory sources plug in without touching them. Sources are not thread-safe; the batches they return are
+    /// read-only and may be processed concurrently.
+    class feature_source
+    {
+    public:
+        virtual ~feature_source() noexcept = default;
+
+        /// @brief Opens the source matching the file type of `path`: ESRI Shapefile for `.shp`, WKB/WKT streams for `.wkb`,
+        /// `.hexwkb`, `.copy`, `.tsv` and `.csv` (see `stream_feature_source`), FlatGeobuf otherwise; `http://` URLs are
+        /// read as remote FlatGeobuf files with range requests.
+        /// @param path Path to the input file.
+        /// @param pool Thread pool the source may use for parallel parsing; must outlive the source.
+        /// @param cache If set, FlatGeobuf files are read with partial reads through it instead of being mapped;
+        ///              required for `http://` URLs. Must outlive the source.
+        /// @throws std::runtime_error If the file cannot be opened or is not valid.
+        static std::unique_ptr<feature_source> open(const std::string& path, thread_pool& pool,
+                                                    block_cache* cache = nullptr) noexcept(false);
+
+        /// @brief True if `path` ends with `extension` (given in lower case), ignoring case.
+        static bool has_extension(std::string_view path, std::string_view extension) noexcept;
+
+        /// @brief Prints basic information about the source to standard output.
+        virtual void print_info() const noexcept(false) = 0;
+        /// @brief Name of the geometry type, for diagnostics.
+        virtual std::string_view geometry_type_name() const noexcept = 0;
+        /// @brief True if the source holds Polygon or MultiPolygon features.
+        virtual bool is_polygonal() const noexcept = 0;
+        /// @brief Number of features of the source (within the window and shard after `restrict_to` and `restrict_to_shard`).
+        virtual std::uint64_t feature_count() const noexcept = 0;
+
+        /// @brief Selects the properties delivered by `next_batch`, in this order.
+        /// @param names The property names.
+        /// @return For each name, the source column index, or `std::nullopt` if the source has no such property.
+        virtual std::vector<std::optional<std::size_t>> project(std::span<const std::string_view> names) noexcept(false) = 0;
+
+        /// @brief Restricts the following batches to the features whose bounding boxes intersect `window`.
+        /// Indexed sources answer this from their spatial index, remote ones without fetching the other features.
+        /// @return False if the source cannot filter by window.
+        virtual bool restrict_to(const bounding_box& window) noexcept(false)
+        {
+            static_cast<void>(window);
+            return false;
+        }
+
+        /// @brief Restricts the following batches to one byte-balanced contiguous shard of the features (see `shard_plan`).
+        /// Sources that know their feature offsets without reading the features (index leaves, record tables) only
+        /// touch the bytes of their own shard afterwards. Combines with `restrict_to` in either order.
+        /// @return The range of the shard, or `std::nullopt` if the source cannot be split.
+        virtual std::optional<shard_range> restrict_to_shard(const shard_spec& shard) noexcept(false)
+        {
+            static_cast<void>(shard);
+            return std::nullopt;
+        }
+
+        /// @brief Continues an interrupted run: the next batch starts with the feature at `position`.
+        /// Called after the restrictions and before the first `next_batch`. Sources addressing features by index jump
+        /// there directly; sequential ones start reading at `offset`, the `feature_batch::end_offset` of the last batch
+        /// the run completed. The default reads and drops `position` features.
+        /// @param position Number of features of the (restricted) sequence the run completed.
+        /// @param offset The input offset reported with the last completed batch.
+        /// @return False if the source has fewer features.
+        virtual bool seek(std::uint64_t position, std::uint64_t offset) noexcept(false);
+
+        /// @brief Bounds the input bytes the source holds at once, for runs under a memory budget: the input is then read
+        /// in windows of about `bytes` or released behind the run (see `release`). Called before the first `next_batch`.
+        /// The default keeps the whole input, as sources that parse it up front do.
+        virtual void limit_buffering(std::uint64_t bytes) noexcept(false) { static_cast<void>(bytes); }
+
+        /// @brief True if the whole input stays in memory whatever `limit_buffering` asks, so a budgeted run cannot stream
+        /// it. The default is false; sources parsing the input up front are recognized by their format instead.
+        virtual bool holds_whole_input() const noexcept { return false; }
+
+        /// @brief Tells the source that the run is done with the features before `position` of the sequence (as in
+        /// `seek`), so the memory of their input may be given back. Their ring views must not be used afterwards.
+        virtual void release(std::uint64_t position) noexcept(false) { static_cast<void>(position); }
+
+        /// @brief Input bytes the source holds in memory: mapped and not released, or read into its buffers (0 if it
+        /// does not track them).
+        virtual std::uint64_t resident_bytes() const noexcept { return 0u; }
+
+        /// @brief Reads the next features.
+        /// @param batch Filled with up to `max_features` features.
+        /// @param max_features The batch size limit.
+        /// @return False if no feature was left.
+        virtual bool next_batch(feature_batch& batch, std::size_t max_features) noexcept(false) = 0;
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,78 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file fgb_augmenter.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/bounding_box.hpp"
+    #include "kmx/gis/fgb_dataset.hpp"
+    #include "kmx/gis/types.hpp"
+    #include "kmx/thread_pool.hpp"
+    #include <array>
+    #include <cstdint>
+    #include <span>
+    #include <string>
+    #include <string_view>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Rewrites a polygon FlatGeobuf file with `min_x`, `min_y`, `max_x`, `max_y` and `area` Double columns
+    /// appended to the schema and to every feature's property blob, so downstream tools need not recompute them.
+    /// Features are not re-encoded where the FlatBuffer layout allows it: the size-prefixed bytes are copied and the
+    /// new (column index, value) pairs are written after the blob when it is the last object of the buffer, or the
+    /// extended blob is appended to the buffer and the properties offset re-pointed to it. Only features without a
+    /// properties slot in their vtable are rebuilt with a `FlatBufferBuilder`. Workers rewrite batches in parallel and
+    /// the batches are written in input order; the index, whose size depends only on the feature count, is written
+    /// into the space reserved for it once all feature sizes are known.
+    class fgb_augmenter
+    {
+    public:
+        /// @brief Constructs the augmenter.
+        /// @param input_fgb_path Path to the input FlatGeobuf file (Polygon or MultiPolygon).
+        /// @param output_fgb_path Path for the output FlatGeobuf file.
+        /// @param num_threads Number of worker threads.
+        fgb_augmenter(const std::string& input_fgb_path, const std::string& output_fgb_path, std::uint32_t num_threads) noexcept(false);
+
+        /// @brief Rewrites the file.
+        /// @return True on success, false on controlled failure.
+        bool augment() noexcept(false);
+
+        /// @brief Names of the appended columns, in order.
+        static constexpr std::array<std::string_view, 5u> appended_columns {"min_x", "min_y", "max_x", "max_y", "area"};
+
+    private:
+        /// @brief How a feature was rewritten.
+        enum class rewrite_kind : std::uint8_t
+        {
+            extended,   /// The blob was the last object and grew in place.
+            repointed,  /// The extended blob was appended and the properties offset re-pointed.
+            re_encoded, /// The feature was rebuilt.
+            copied,     /// Copied unchanged (a feature with its own schema).
+        };
+
+        /// @brief The rewritten features of one batch.
+        struct rewritten_batch
+        {
+            std::vector<std::uint8_t> bytes {};     /// Concatenated size-prefixed features.
+            std::vector<std::uint64_t> sizes {};    /// Size of each feature.
+            std::array<std::uint64_t, 4u> kinds {}; /// Features per `rewrite_kind`.
+        };
+
+        /// @brief Rewrites the features `[begin, end)`.
+        /// @param boxes The box of every feature of the file.
+        rewritten_batch rewrite_batch(std::uint64_t begin, std::uint64_t end, std::span<const bounding_box> boxes) const noexcept(false);
+        /// @brief Appends the rewritten feature `index`, whose box is `bbox`, to `out`.
+        rewrite_kind rewrite_feature(std::uint64_t index, const bounding_box& bbox, std::vector<ring_view>& rings,
+                                     std::vector<std::uint8_t>& out) const noexcept(false);
+
+        static constexpr std::size_t batch_size_ {4096u};      /// Features per task.
+        static constexpr std::size_t batches_per_thread_ {2u};  /// Pending batches per worker.
+        static constexpr std::uint16_t index_node_size_ {16u}; /// Node size of the written R-tree.
+
+        const std::string output_fgb_path_; /// Path to the output FlatGeobuf file.
+        thread_pool thread_pool_;           /// Thread pool for parallel processing.
+        fgb_dataset dataset_;               /// Mapped input file.
+        std::uint16_t first_column_ {};     /// Index of the first appended column.
+    };
+
+} // namespace kmx::gis
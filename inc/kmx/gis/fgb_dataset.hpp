@@ -0,0 +1,139 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file fgb_dataset.hpp
+#pragma once
+#ifndef PCH
+    #include "flatgeobuf/feature_generated.h"
+    #include "flatgeobuf/packedrtree.h"
+    #include "kmx/gis/bounding_box.hpp"
+    #include "kmx/gis/huge_pages.hpp"
+    #include "kmx/gis/mapped_file.hpp"
+    #include <algorithm>
+    #include <cstdint>
+    #include <optional>
+    #include <span>
+    #include <string>
+    #include <string_view>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief A memory-mapped, validated FlatGeobuf file with random access to its features.
+    /// On construction the header is parsed and the offset of every feature is recorded, so that any feature can
+    /// subsequently be addressed by index without touching the others. The offsets come from the R-tree leaves when
+    /// the file has an index (no feature page is read), otherwise from one scan of the feature size prefixes.
+    /// All accessors are `const` and may be used concurrently from worker threads.
+    class fgb_dataset
+    {
+    public:
+        /// @brief Maps and validates the FlatGeobuf file.
+        /// @param fgb_path Path to the FlatGeobuf file.
+        /// @throws std::runtime_error If the file cannot be mapped, is not a FlatGeobuf file or its header is truncated.
+        explicit fgb_dataset(const std::string& fgb_path) noexcept(false);
+
+        /// @brief The parsed FlatBuffer header table.
+        const FlatGeobuf::Header* header() const noexcept { return header_; }
+        /// @brief Number of `double` values per coordinate (2 for XY, 3 for XYZ/XYM, 4 for XYZM).
+        std::uint32_t coordinate_stride() const noexcept { return coordinate_stride_; }
+        /// @brief Number of features actually present in the file (may be lower than the header count for truncated files).
+        std::uint64_t feature_count() const noexcept { return feature_offsets_.size(); }
+        /// @brief The geometry type declared in the header.
+        FlatGeobuf::GeometryType geometry_type() const noexcept { return header_->geometry_type(); }
+        /// @brief The effective type of a feature geometry: its own type, or the header type when the geometry leaves it unset.
+        FlatGeobuf::GeometryType geometry_type_of(const FlatGeobuf::Geometry* geometry) const noexcept;
+        /// @brief True if the file carries a packed Hilbert R-tree index.
+        bool has_index() const noexcept { return !index_bytes_.empty(); }
+        /// @brief Node size of the packed R-tree (0 if the file has no index).
+        std::uint16_t index_node_size() const noexcept { return has_index() ? header_->index_node_size() : std::uint16_t {}; }
+
+        /// @brief Path of the mapped file.
+        const std::string& path() const noexcept { return file_.path(); }
+        /// @brief The whole mapped file.
+        std::span<const std::uint8_t> file_bytes() const noexcept { return file_.bytes(); }
+        /// @brief Magic bytes, header size prefix and header table, exactly as stored in the file.
+        std::span<const std::uint8_t> header_bytes() const noexcept { return file_.bytes().first(header_end_); }
+        /// @brief The serialized packed R-tree (empty if the file has no index).
+        std::span<const std::uint8_t> index_bytes() const noexcept { return index_bytes_; }
+        /// @brief Offset of the first feature from the start of the file.
+        std::size_t features_offset() const noexcept { return features_offset_; }
+
+        /// @brief Offset of feature `index` relative to `features_offset()` (as stored in the R-tree leaves).
+        std::uint64_t feature_offset(const std::uint64_t index) const noexcept { return feature_offsets_[index]; }
+        /// @brief Size of the feature section, from `features_offset()` to the end of the file.
+        std::uint64_t features_size() const noexcept { return file_.size() - features_offset_; }
+        /// @brief Size-prefixed bytes of feature `index`, exactly as stored in the file.
+        std::span<const std::uint8_t> feature_bytes(std::uint64_t index) const noexcept;
+        /// @brief The feature table of feature `index`.
+        const FlatGeobuf::Feature* feature(std::uint64_t index) const noexcept;
+        /// @brief Starts loading the first cache lines of feature `index` (size prefix, table, vtable and the start of
+        /// the geometry) without touching it. Workers walking a run of features call it for the feature
+        /// `prefetch_distance()` ahead, so its misses overlap the work on the current one.
+        void prefetch_feature(const std::uint64_t index) const noexcept
+        {
+            if (index >= feature_offsets_.size())
+                return;
+            const std::uint64_t offset {feature_offsets_[index]};
+            const std::uint64_t end {((index + 1u) < feature_offsets_.size()) ? feature_offsets_[index + 1u] : features_size()};
+            const std::uint8_t* const bytes {file_.data() + features_offset_ + offset};
+            const std::size_t size {static_cast<std::size_t>(std::min<std::uint64_t>(end - offset, max_prefetch_bytes_))};
+            for (std::size_t line {}; line < size; line += cache_line_size_)
+                __builtin_prefetch(bytes + line, 0, 3);
+        }
+        /// @brief How many features ahead to prefetch: enough small features to cover a memory latency, one for
+        /// large ones, derived from the mean feature size.
+        std::size_t prefetch_distance() const noexcept { return prefetch_distance_; }
+
+        /// @brief True if the file was read into a private huge page copy (see `mapped_file::is_anonymous`).
+        bool is_anonymous() const noexcept { return file_.is_anonymous(); }
+        /// @brief Advises that the features are read in file order (see `mapped_file::advise_sequential`).
+        void advise_sequential() const noexcept { file_.advise_sequential(); }
+        /// @brief Gives back the mapped pages of the features in `[begin, end)`, offsets relative to `features_offset()`.
+        void release_features(const std::uint64_t begin, const std::uint64_t end) const noexcept
+        {
+            file_.release(static_cast<std::size_t>(features_offset_ + begin), static_cast<std::size_t>(end - begin));
+        }
+
+        /// @brief Maps an offset relative to `features_offset()` back to a feature index.
+        /// @return The index of the feature starting at `offset`, or `std::nullopt` if no feature starts there.
+        std::optional<std::uint64_t> feature_index_at(std::uint64_t offset) const noexcept;
+
+        /// @brief Finds a property column by name (see `feature_properties::find_column_index`).
+        std::optional<std::size_t> find_column(std::string_view name) const noexcept;
+
+        /// @brief Finds the features whose bounding boxes intersect `query`.
+        /// Uses the packed R-tree directly on the mapped index when present, otherwise falls back to a linear scan
+        /// that computes each feature's bounding box.
+        /// @param query The query window.
+        /// @return Indices of the candidate features in ascending order.
+        std::vector<std::uint64_t> search(const bounding_box& query) const noexcept(false);
+
+        /// @brief Bounding box of feature `index`, read from the R-tree leaf when available or computed from its geometry.
+        bounding_box feature_bbox(std::uint64_t index) const noexcept;
+
+    private:
+        /// @brief Validates the magic bytes and locates the header table.
+        void parse_header() noexcept(false);
+        /// @brief Takes the feature offsets from the R-tree leaves, which lists them in file order for files written
+        /// by the reference writers.
+        /// @return False if the leaves are not ascending or do not fit the file; the offsets are then left empty.
+        bool load_leaf_offsets() noexcept(false);
+        /// @brief Walks the feature size prefixes to record the offset of every feature.
+        void scan_feature_offsets() noexcept;
+
+        static constexpr std::size_t magic_size_ {8u};               /// Size of the FlatGeobuf magic bytes.
+        static constexpr std::size_t cache_line_size_ {64u};         /// Prefetch granularity.
+        static constexpr std::size_t max_prefetch_bytes_ {512u};     /// Bytes prefetched per feature (the whole of a small one).
+        static constexpr std::size_t prefetch_window_bytes_ {2048u}; /// Feature bytes to keep in flight ahead of a worker.
+        static constexpr std::size_t max_prefetch_distance_ {16u};   /// Upper bound of `prefetch_distance()`.
+
+        mapped_file file_;                                   /// Read-only mapping of the whole file.
+        const FlatGeobuf::Header* header_ {};                /// Parsed header table (points into `file_`).
+        std::size_t header_end_ {};                          /// Offset just after the header table.
+        std::span<const std::uint8_t> index_bytes_ {};       /// Serialized packed R-tree (points into `file_`).
+        std::size_t features_offset_ {};                     /// Offset of the first feature.
+        std::uint32_t coordinate_stride_ {2u};               /// Doubles per coordinate.
+        huge_page_vector<std::uint64_t> feature_offsets_ {}; /// Per-feature offsets relative to `features_offset_`.
+        std::size_t prefetch_distance_ {1u};                 /// Features to prefetch ahead.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,56 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file fgb_feature_source.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/feature_source.hpp"
+    #include "kmx/gis/fgb_dataset.hpp"
+#endif
+
+namespace kmx::gis
+{
+    /// @brief `feature_source` over a memory-mapped FlatGeobuf file.
+    /// Rings point straight into the mapping; only the projected properties are decoded.
+    class fgb_feature_source final: public feature_source
+    {
+    public:
+        /// @brief Maps and validates the FlatGeobuf file.
+        /// @throws std::runtime_error If the file cannot be mapped or is not a FlatGeobuf file.
+        explicit fgb_feature_source(const std::string& fgb_path) noexcept(false);
+
+        void print_info() const noexcept(false) override;
+        std::string_view geometry_type_name() const noexcept override;
+        bool is_polygonal() const noexcept override;
+        std::uint64_t feature_count() const noexcept override;
+        std::vector<std::optional<std::size_t>> project(std::span<const std::string_view> names) noexcept(false) override;
+        /// @brief Selects the window candidates through the packed R-tree (or a scan of the boxes without index).
+        bool restrict_to(const bounding_box& window) noexcept(false) override;
+        /// @brief Splits the features by their offsets, which the dataset takes from the index leaves when present.
+        std::optional<shard_range> restrict_to_shard(const shard_spec& shard) noexcept(false) override;
+        /// @brief Jumps to the feature at `position`; the offset is not needed.
+        bool seek(std::uint64_t position, std::uint64_t offset) noexcept(false) override;
+        /// @brief Reads the mapping sequentially and releases its pages behind the run (not for window selections, whose
+        /// features are few and scattered).
+        void limit_buffering(std::uint64_t bytes) noexcept(false) override;
+        /// @brief True for a private huge page copy of the file, which cannot give pages back.
+        bool holds_whole_input() const noexcept override { return dataset_.is_anonymous(); }
+        void release(std::uint64_t position) noexcept(false) override;
+        /// @brief The mapped bytes up to the next feature, less the released ones (the whole file unless streaming).
+        std::uint64_t resident_bytes() const noexcept override;
+        bool next_batch(feature_batch& batch, std::size_t max_features) noexcept(false) override;
+
+    private:
+        /// @brief Offset of the feature at `position` of the shard, relative to the feature section.
+        std::uint64_t offset_at(std::uint64_t position) const noexcept;
+
+        fgb_dataset dataset_;                                    /// The mapped file.
+        std::vector<std::optional<std::size_t>> columns_ {};     /// Projected column indices.
+        std::vector<ring_view> scratch_rings_ {};                /// Rings of the current feature.
+        std::optional<std::vector<std::uint64_t>> selection_ {}; /// Window candidates, after `restrict_to`.
+        std::uint64_t range_begin_ {};                           /// First feature of the shard.
+        std::uint64_t range_end_ {};                             /// One past the last feature of the shard.
+        std::uint64_t next_index_ {};                            /// Position of the next feature (in `selection_` if set).
+        bool streaming_ {};                                      /// True once `limit_buffering` applies.
+        std::uint64_t released_offset_ {};                       /// Feature section bytes released so far.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,63 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file fgb_subset.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/bounding_box.hpp"
+    #include "kmx/gis/fgb_dataset.hpp"
+    #include "kmx/thread_pool.hpp"
+    #include <cstdint>
+    #include <optional>
+    #include <span>
+    #include <string>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Selection criteria of a subset; a feature is selected if it satisfies all given criteria.
+    struct fgb_subset_filter
+    {
+        /// @brief Property compared against `values` (no attribute filter if empty).
+        std::string column {};
+        /// @brief Accepted property values, compared as text (e.g. a list of natcodes).
+        std::vector<std::string> values {};
+        /// @brief Window the feature boxes must intersect (no spatial filter if invalid).
+        bounding_box window {};
+    };
+
+    /// @brief Writes the features of a FlatGeobuf file that match a filter to a new indexed FlatGeobuf file without
+    /// decoding or re-encoding them: the size-prefixed feature bytes are copied verbatim from the input, long runs of
+    /// consecutive selected features with `copy_file_range` (in-kernel, reflinked on file systems that support it) and
+    /// short ones from the mapping. The header is re-emitted with the new feature count and the index is rebuilt from
+    /// the per-feature boxes, which come from the input index when it has one.
+    class fgb_subset_writer
+    {
+    public:
+        /// @brief Constructs the subset writer.
+        /// @param input_fgb_path Path to the input FlatGeobuf file.
+        /// @param output_fgb_path Path for the output FlatGeobuf file.
+        /// @param num_threads Number of worker threads (used to evaluate the filter).
+        /// @param filter The selection criteria.
+        fgb_subset_writer(const std::string& input_fgb_path, const std::string& output_fgb_path, std::uint32_t num_threads,
+                          fgb_subset_filter filter) noexcept(false);
+
+        /// @brief Selects the features and writes the output file.
+        /// @return True on success, false on controlled failure.
+        bool write() noexcept(false);
+
+    private:
+        /// @brief Indices of the features matching the filter, in file order.
+        /// @return The selection, or `std::nullopt` if the filter property does not exist.
+        std::optional<std::vector<std::uint64_t>> select() noexcept(false);
+        /// @brief Copies the selected features to `output_fd`, run by run.
+        bool copy_features(int output_fd, std::span<const std::uint64_t> selected) const noexcept(false);
+
+        static constexpr std::size_t raw_copy_threshold_ {1u << 16}; /// Runs this long are copied by the kernel.
+
+        const std::string output_fgb_path_; /// Path to the output FlatGeobuf file.
+        const fgb_subset_filter filter_;    /// The selection criteria.
+        thread_pool thread_pool_;           /// Thread pool for parallel processing.
+        fgb_dataset dataset_;               /// Mapped input file.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,81 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file fgb_writer.hpp
+#pragma once
+#ifndef PCH
+    #include "flatgeobuf/feature_generated.h"
+    #include "flatgeobuf/packedrtree.h"
+    #include "kmx/gis/bounding_box.hpp"
+    #include <array>
+    #include <cstdint>
+    #include <optional>
+    #include <span>
+    #include <string>
+    #include <string_view>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief One feature of an output file: its size-prefixed FlatBuffer bytes and its bounding box.
+    struct fgb_feature_entry
+    {
+        std::span<const std::uint8_t> bytes; /// Size-prefixed Feature table (may point into a mapped input file).
+        bounding_box bbox;                   /// Extent of the feature geometry.
+    };
+
+    /// @brief Writes indexed FlatGeobuf files derived from an existing one: the header of the source file is re-emitted
+    /// with the new feature count, envelope and index node size, a packed R-tree is built over the feature boxes and the
+    /// feature bytes follow in the given order. Subsets of an indexed file keep its Hilbert order, so the rebuilt tree
+    /// is as tight as the original one.
+    class fgb_writer
+    {
+    public:
+        /// @brief A column schema vector (header or feature level).
+        using column_vector = flatbuffers::Vector<flatbuffers::Offset<FlatGeobuf::Column>>;
+
+        /// @brief Constructs a writer for files sharing the schema of `source_header`.
+        /// @param source_header The header of the source file (columns, CRS, geometry type, metadata).
+        /// @param index_node_size Node size of the packed R-tree written before the features.
+        /// @param geometry_type Geometry type of the output, if it differs from the source one (e.g. promoted to multi).
+        explicit fgb_writer(const FlatGeobuf::Header* source_header, std::uint16_t index_node_size = 16u,
+                            std::optional<FlatGeobuf::GeometryType> geometry_type = {}) noexcept;
+
+        /// @brief Writes a complete FlatGeobuf file.
+        /// @param path The output path.
+        /// @param features The features, in output order.
+        /// @return True on success, false on controlled failure (reported on `std::cerr`).
+        bool write(const std::string& path, std::span<const fgb_feature_entry> features) const noexcept(false);
+
+        /// @brief Magic bytes, size prefix and header table of an output file.
+        /// @param features_count The number of features of the output file.
+        /// @param envelope The extent of the output features (omitted if invalid).
+        /// @param appended_columns Names of nullable Double columns appended to the source schema.
+        std::vector<std::uint8_t> build_header(std::uint64_t features_count, const bounding_box& envelope,
+                                               std::span<const std::string_view> appended_columns = {}) const noexcept(false);
+
+        /// @brief Serializes the packed R-tree over `features`, with leaf offsets following their sizes in order.
+        /// @return The index bytes (empty if there are no features).
+        std::vector<std::uint8_t> build_index(std::span<const fgb_feature_entry> features) const noexcept(false);
+        /// @brief Serializes the packed R-tree over features given by their boxes and sizes, in file order.
+        /// @return The index bytes (empty if there are no features).
+        std::vector<std::uint8_t> build_index(std::span<const bounding_box> boxes, std::span<const std::uint64_t> sizes) const
+            noexcept(false);
+
+        /// @brief Extent of the valid feature boxes (the header envelope).
+        static bounding_box envelope_of(std::span<const fgb_feature_entry> features) noexcept;
+
+        /// @brief Copies a column schema vector (header or feature level) into `fbb`.
+        /// @return The offset of the copy, or a null offset if `columns` is null.
+        static flatbuffers::Offset<column_vector> copy_columns(flatbuffers::FlatBufferBuilder& fbb, const column_vector* columns)
+            noexcept(false);
+
+        /// @brief FlatGeobuf magic bytes (format version 3.0).
+        static constexpr std::array<std::uint8_t, 8u> magic_bytes {0x66u, 0x67u, 0x62u, 0x03u, 0x66u, 0x67u, 0x62u, 0x00u};
+
+    private:
+        const FlatGeobuf::Header* source_header_;                     /// Header the output schema is copied from.
+        const std::uint16_t index_node_size_;                         /// Node size of the written R-tree.
+        const std::optional<FlatGeobuf::GeometryType> geometry_type_; /// Output geometry type overriding the source one.
+    };
+
+} // namespace kmx::gis
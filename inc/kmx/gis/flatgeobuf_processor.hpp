@@ -2,11 +2,19 @@
 /// @file flatgeobuf_processor.hpp
 #pragma once
 #ifndef PCH
-    #include "flatgeobuf/feature_generated.h"
+    #include "kmx/gis/block_cache.hpp"
+    #include "kmx/gis/feature_source.hpp"
+    #include "kmx/gis/memory_budget.hpp"
+    #include "kmx/gis/pipeline_tuner.hpp"
+    #include "kmx/gis/result_sorter.hpp"
+    #include "kmx/gis/run_checkpoint.hpp"
+    #include "kmx/gis/shard_plan.hpp"
     #include "kmx/gis/types.hpp"
     #include "kmx/thread_pool.hpp"
+    #include <array>
+    #include <chrono>
     #include <fstream>
-    #include <future>
+    #include <memory>
     #include <optional>
     #include <string>
     #include <string_view>
@@ -15,151 +23,117 @@
 
 namespace kmx::gis
 {
-    // Type aliases for FlatGeobuf enums
-    using FgbColumnType = FlatGeobuf::ColumnType;
-    using FgbGeometryType = FlatGeobuf::GeometryType;
-
-    /// @brief Orchestrates reading FlatGeobuf files, processing features for bounding boxes,
-    /// and writing results to a CSV file.
-    /// This class handles low-level interaction with FlatBuffer-generated structures.
+    /// @brief Orchestrates reading polygon features, computing their bounding boxes and writing the results to a CSV file.
+    /// The input is read through a `feature_source` (FlatGeobuf, ESRI Shapefile, WKB or WKT streams); batches of features
+    /// are computed on the thread pool while the next batches are read, and the results are written in input order.
+    /// With checkpoints, the progress is saved every few seconds after a written batch, so an interrupted run can resume
+    /// from the last checkpoint instead of starting over. With a sort order, the results pass through a `result_sorter`
+    /// and are written once all are known.
+    /// Under a `memory_budget` (`--max-memory` or the cgroup limit) the run picks its plan before reading: an input that
+    /// fits in part of the budget is held in memory, a larger FlatGeobuf input is streamed (read in windows or released
+    /// page by page behind the writer). The bytes of batches in flight, the sort buffer and the block cache get their
+    /// own shares, and the peak of every subsystem is reported at the end.
+    /// The active worker count and the batch volume are tuned at the start of the run by a `pipeline_tuner`, unless
+    /// they are fixed on the command line.
     class flatgeobuf_processor
     {
     public:
         /// @brief Constructs the processor.
-        /// @param input_fgb_path Path to the input FlatGeobuf file (must be Polygon or MultiPolygon).
+        /// @param input_fgb_path Path to the input file (any `feature_source` format; must be Polygon or MultiPolygon).
         /// @param output_csv_path Path for the output CSV file.
         /// @param num_threads Number of worker threads for parallel processing.
-        flatgeobuf_processor(const std::string& input_fgb_path, const std::string& output_csv_path,
-                             std::uint32_t num_threads) noexcept(false);
+        /// @param window If valid, only the features whose bounding boxes intersect it are processed.
+        /// @param cache_bytes Budget of the block cache used for partial reads (URLs, and FlatGeobuf files with a window).
+        /// @param shard If sharded, only this slice of the input is processed and a `shard_manifest` is written next to
+        ///              the output.
+        /// @param checkpoint When to write `run_checkpoint`s and whether to resume from one.
+        /// @param sort Order of the output rows (input order if not sorted).
+        /// @param sort_memory Bytes of results sorted in memory before runs are spilled next to the output.
+        /// @param max_memory Memory budget of the run in bytes (0: only the cgroup limit, if any); caps `cache_bytes`
+        ///                   and `sort_memory` to their shares.
+        /// @param tuning The pipeline parameters fixed on the command line; the others are tuned.
+        flatgeobuf_processor(const std::string& input_fgb_path, const std::string& output_csv_path, std::uint32_t num_threads,
+                             const bounding_box& window = {}, std::uint64_t cache_bytes = default_cache_bytes,
+                             const shard_spec& shard = {}, const checkpoint_settings& checkpoint = {}, const result_sort_spec& sort = {},
+                             std::uint64_t sort_memory = result_sorter::default_memory_budget,
+                             std::uint64_t max_memory = 0u, const tuning_settings& tuning = {}) noexcept(false);
+
+        static constexpr std::uint64_t default_cache_bytes {64u * 1024u * 1024u}; /// Default block cache budget.
 
         /// @brief Main processing function. Executes the workflow of reading, processing, and writing.
         /// @return True on success, false on controlled failure (e.g., file format error).
         bool process_features() noexcept(false);
 
     private:
-        // File and Header Processing
-        /// @brief Loads the entire FGB file into an internal buffer.
-        /// @return True if successful, false if file cannot be read or is empty.
-        bool initialize_file_buffer() noexcept(false);
-
-        /// @brief Parses the FGB header from the buffer and validates it.
-        /// @param[out] out_fbs_header Pointer to store the parsed FlatBuffer Header.
-        /// @param[out] out_header_actual_size Size of the header read from the file.
-        /// @return True if header is valid and parsed, false otherwise.
-        bool parse_and_validate_header(const FlatGeobuf::Header*& out_fbs_header, std::uint32_t& out_header_actual_size) noexcept;
-
-        // Feature Processing Orchestration
-        /// @brief Iterates through features in the FGB buffer, submitting them for processing.
-        /// @param fbs_header The parsed FGB header.
-        /// @param initial_offset Offset in the buffer after the header (and optional index).
-        /// @param coordinate_stride Calculated coordinate stride for geometries.
-        /// @return True if all features were submitted successfully, false on error.
-        bool submit_feature_tasks(const FlatGeobuf::Header* fbs_header, std::size_t initial_offset,
-                                  std::uint32_t coordinate_stride) noexcept(false);
-
-        /// @brief Collects results from completed feature processing tasks and writes them to CSV.
+        /// @brief How the run uses memory, chosen from the budget before reading.
+        struct memory_plan
+        {
+            bool streaming {};            /// The input is read in windows and released behind the writer.
+            std::uint64_t read_window {}; /// Input bytes read at once when streaming.
+            std::uint64_t batch_bytes {}; /// Bytes of batches and results in flight.
+        };
+
+        /// @brief Chooses the plan for the opened source and prints it when the run has a budget.
+        memory_plan choose_memory_plan() const noexcept(false);
+        /// @brief Records what the source, the batches, the sorter and the cache hold now.
+        void account_memory(std::uint64_t batch_bytes) noexcept(false);
+        /// @brief Projects the expected properties and reports which of them the source provides.
+        void project_expected_columns() noexcept(false);
+        /// @brief Writes the manifest of a sharded run next to the output.
+        void write_manifest(const shard_range& range) const noexcept(false);
+        /// @brief The checkpoint of the run so far, without the output offset.
+        run_checkpoint current_checkpoint() const noexcept(false);
+        /// @brief Loads the checkpoint of the output if it matches this run, truncates the output to it and seeks the source.
+        /// @return The number of features to skip, 0 to start over, or `std::nullopt` on failure (reported).
+        std::optional<std::uint64_t> resume_from_checkpoint() noexcept(false);
+        /// @brief Flushes the output and writes a checkpoint once the interval has elapsed since the last one.
         /// @param output_file The output CSV file stream.
-        /// @param total_features_submitted The total number of features that were submitted for processing.
-        /// @return True if all results collected and written, false otherwise.
-        bool collect_and_write_results(std::ofstream& output_file, std::uint64_t total_features_submitted) noexcept(false);
-
-        // Property Parsing Helpers
-        /// @brief Reads a property value from the properties blob at a given offset and converts it to a string.
-        /// @param col_type The FlatGeobuf column type of the property.
-        /// @param properties_data_start Pointer to the start of the properties data blob for the feature.
-        /// @param value_offset_in_blob Offset within the properties blob where the value starts.
-        /// @param properties_blob_size Total size of the properties blob.
-        /// @param[out] bytes_read_for_value Number of bytes read from the blob for this specific value.
-        /// @return The property value as a string. Returns an empty string on error or if conversion is not possible.
-        std::string read_and_convert_property_value_at_offset(FgbColumnType col_type, const uint8_t* properties_data_start,
-                                                              flatbuffers::uoffset_t value_offset_in_blob,
-                                                              flatbuffers::uoffset_t properties_blob_size,
-                                                              flatbuffers::uoffset_t& bytes_read_for_value) const noexcept(false);
-
-        /// @brief Calculates the number of bytes a property value occupies in the properties blob, to skip it.
-        /// @param col_type The FlatGeobuf column type of the property.
-        /// @param properties_data_start Pointer to the start of the properties data blob for the feature.
-        /// @param value_offset_in_blob Offset within the properties blob where the value starts.
-        /// @param properties_blob_size Total size of the properties blob.
-        /// @return The number of bytes this property value occupies.
-        flatbuffers::uoffset_t skip_property_value_at_offset(FgbColumnType col_type, const uint8_t* properties_data_start,
-                                                             flatbuffers::uoffset_t value_offset_in_blob,
-                                                             flatbuffers::uoffset_t properties_blob_size) const noexcept;
-
-        /// @brief Retrieves the string value of a specific property for a feature by its column index.
-        /// @param fbs_feature Pointer to the FlatBuffer Feature object.
-        /// @param fbs_header Pointer to the FlatBuffer Header object (for column schema).
-        /// @param target_column_index The index of the desired column/property.
-        /// @return The property value as a string. Returns an empty string if not found or on error.
-        std::string get_string_value_for_property(const FlatGeobuf::Feature* fbs_feature, const FlatGeobuf::Header* fbs_header,
-                                                  std::size_t target_column_index) const noexcept(false);
-
-        // Other Helpers
-        /// @brief Finds the index of a property (column) by its name.
-        /// @param fbs_header Pointer to the FlatBuffer Header object.
-        /// @param property_name_to_find The name of the property to search for.
-        /// @return An optional containing the index if found, otherwise `std::nullopt`.
-        std::optional<std::size_t> find_property_index_by_name(const FlatGeobuf::Header* fbs_header,
-                                                               std::string_view property_name_to_find) const noexcept;
+        /// @param input_offset `feature_batch::end_offset` of the last written batch.
+        void maybe_write_checkpoint(std::ofstream& output_file, std::uint64_t input_offset) noexcept(false);
 
-        /// @brief Prints basic information from the FGB header to standard output.
-        /// @param fbs_header Pointer to the FlatBuffer Header object.
-        void print_header_info(const FlatGeobuf::Header* fbs_header) const noexcept;
+        /// @brief Computes the results of one batch; designed to be run in a separate thread.
+        /// @param batch The batch read from the source.
+        /// @return One `task_result` per feature of the batch, in order.
+        static std::vector<task_result> process_batch(const feature_batch& batch) noexcept(false);
 
-        /// @brief Writes the CSV header row to the output file stream.
-        /// @param out_file The output file stream.
-        void write_csv_header(std::ofstream& out_file) const noexcept(false);
-
-        /// @brief Writes a single CSV data row for a feature to the output file stream.
-        /// @param out_file The output file stream.
-        /// @param uat_name The UAT name for the feature.
-        /// @param uat_code The UAT code for the feature (0 if not available).
-        /// @param county_mn The 2-character county code for the feature.
-        /// @param bbox The calculated bounding box for the feature.
-        void write_csv_row(std::ofstream& out_file, const std::string& uat_name, std::uint32_t uat_code, const county_code& county_mn,
-                           const bounding_box& bbox) const noexcept(false);
-
-        /// @brief Loads the content of a file into a byte buffer.
-        /// @param file_path The path to the file.
-        /// @return A vector of bytes containing the file's content.
-        std::vector<std::uint8_t> load_file_to_buffer(const std::string& file_path) const noexcept(false);
-
-        /// @brief Static method to process a single feature; designed to be run in a separate thread.
-        /// @param task_data Input data for the task, including geometry and identifiers.
-        /// @return A `task_result` containing the identifiers and the calculated bounding box.
-        static task_result process_single_feature_task(task_input_data task_data) noexcept;
+        /// @brief Writes the results of one batch to the CSV file, or hands them to the sorter.
+        /// @param output_file The output CSV file stream.
+        /// @param results The results of the batch.
+        void write_results(std::ofstream& output_file, std::vector<task_result>&& results) noexcept(false);
 
         // Constants
-        static constexpr int default_coordinate_stride_ {2};              /// Default stride (XY)
+        static constexpr std::size_t batches_per_thread_ {4u};            /// Batches in flight per active worker.
         static constexpr std::uint64_t progress_report_interval_ {1000u}; /// Interval for reporting progress
-        static constexpr int csv_coordinate_precision {3};                /// Precision for coordinates in CSV output
+        static constexpr double in_memory_share_ {0.5};                   /// Largest input held in memory, of the budget.
+        static constexpr double read_window_share_ {0.125};               /// Streaming read window, of the budget.
+        static constexpr double batch_share_ {0.125};                     /// Batches in flight, of the budget.
+        static constexpr double sort_share_ {0.25};                       /// Sort buffer, of the budget.
+        static constexpr double cache_share_ {0.125};                     /// Block cache, of the budget.
+
+        // Expected column names (assuming these are fixed for your specific FGB files), in projection order.
+        static constexpr std::size_t name_property_ {0u};
+        static constexpr std::size_t code_property_ {1u};
+        static constexpr std::size_t county_property_ {2u};
+        static constexpr std::array<std::string_view, 3u> expected_columns_ {"name", "natcode", "countyMn"};
 
-        // Expected column names (assuming these are fixed for your specific FGB files)
-        static constexpr std::string_view expected_uat_name_column_ {"name"};
-        static constexpr std::string_view expected_uat_code_column_ {"natcode"};
-        static constexpr std::string_view expected_county_mn_column_ {"countyMn"};
-
-        static constexpr double square_meters_in_square_kilometer_ {1000000.0}; /// Conversion factor
-
-        static constexpr char csv_delimiter_ {','};                                              /// CSV delimiter character.
-        static constexpr std::string_view csv_newline_ {"\n"};                                   /// CSV newline string.
         static constexpr std::string_view uat_name_fallback_prefix_ {"Name_Unavailable_Index_"}; /// Prefix for fallback UAT names.
-        static constexpr std::uint32_t min_fgb_file_size_ {12u}; /// Minimum valid FGB file size (8 magic + 4 header_size).
 
         // Member Variables
-        const std::string input_fgb_path_;                            /// Path to the input FlatGeobuf file.
-        const std::string output_csv_path_;                           /// Path to the output CSV file.
-        thread_pool thread_pool_;                                     /// Thread pool for parallel processing.
-        std::vector<std::uint8_t> fgb_buffer_ {};                     /// Buffer to hold the entire FGB file content.
-        std::vector<std::future<task_result>> processing_futures_ {}; /// Futures for asynchronous task results.
-        std::uint64_t feature_submission_count_ {};                   /// Counter for submitted features.
-
-        /// Pre-calculated column index for the UAT name property.
-        std::optional<std::size_t> uat_name_column_index_ {};
-        /// Pre-calculated column index for the UAT code property.
-        std::optional<std::size_t> uat_code_column_index_ {};
-        /// Pre-calculated column index for the County MN property.
-        std::optional<std::size_t> county_mn_column_index_ {};
+        const std::string input_fgb_path_;                         /// Path to the input file.
+        const std::string output_csv_path_;                        /// Path to the output CSV file.
+        const bounding_box window_;                                /// Feature filter (invalid for all features).
+        const shard_spec shard_;                                   /// Slice of the input to process.
+        const checkpoint_settings checkpoint_;                     /// Checkpoint interval and resume request.
+        const result_sort_spec sort_;                              /// Order of the output rows.
+        memory_budget memory_;                                     /// Budget and accounting of the run.
+        const std::uint64_t sort_memory_;                          /// Memory budget of the sorter.
+        pipeline_tuner tuner_;                                     /// Worker count and batch volume (outlives the tasks).
+        thread_pool thread_pool_;                                  /// Thread pool for parallel processing.
+        block_cache block_cache_;                                  /// Cache of the partial reads.
+        std::unique_ptr<feature_source> source_ {};                /// The opened input.
+        std::unique_ptr<result_sorter> sorter_ {};                 /// Sorts the results (null in input order).
+        std::uint64_t features_written_count_ {};                  /// Counter for written features.
+        std::chrono::steady_clock::time_point last_checkpoint_ {}; /// When the last checkpoint was written.
     };
 
 } // namespace kmx::gis
@@ -0,0 +1,39 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file geometry_hash.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/types.hpp"
+    #include <cstddef>
+    #include <cstdint>
+    #include <span>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief A 128-bit hash of the canonical form of a polygon geometry.
+    /// Every ring is canonicalized (closing vertex dropped, started at its smallest vertex and walked in the direction
+    /// that gives the smaller sequence), so the same polygon digitized from another vertex or with the opposite winding
+    /// gets the same hash; ring and part order are kept and only the XY coordinates take part.
+    struct geometry_hash
+    {
+        std::uint64_t low {};  /// Low half.
+        std::uint64_t high {}; /// High half.
+
+        bool operator==(const geometry_hash&) const noexcept = default;
+
+        /// @brief Hash of a `geometry_hash` for unordered containers (its low half, already well mixed).
+        struct hasher
+        {
+            std::size_t operator()(const geometry_hash& hash) const noexcept { return static_cast<std::size_t>(hash.low); }
+        };
+
+        /// @brief Writes the canonical form of a feature's rings to `words`: per ring a header word (part index and
+        /// point count), then the bit patterns of its canonical coordinates (-0.0 folded into 0.0).
+        /// @return False if there are no rings.
+        static bool canonicalize(std::span<const ring_view> rings, std::vector<std::uint64_t>& words) noexcept(false);
+        /// @brief Hashes a canonical form (MurmurHash3 x64 128).
+        static geometry_hash of_words(std::span<const std::uint64_t> words) noexcept;
+    };
+
+} // namespace kmx::gis
@@ -3,6 +3,8 @@
 #pragma once
 #ifndef PCH
     #include "kmx/gis/types.hpp"
+    #include <span>
+    #include <vector>
 #endif
 
 // Forward declarations for FlatGeobuf types
@@ -31,7 +33,41 @@ namespace kmx::gis
         static bounding_box calculate_for_geometry(const FlatGeobuf::Geometry* geometry_fbs, std::uint32_t coordinate_stride,
                                                    FlatGeobuf::GeometryType actual_geometry_type) noexcept;
 
+        /// @brief Collects zero-copy views of all rings of a Polygon or MultiPolygon geometry.
+        /// Polygon rings are delimited by the geometry's `ends` array; MultiPolygon parts are visited in order and
+        /// their rings are tagged with the part index.
+        /// @param geometry_fbs Pointer to the constant FlatBuffer Geometry table. Nothing is collected if null.
+        /// @param actual_geometry_type The effective geometry type of `geometry_fbs`.
+        /// @param[out] out_rings Receives the rings; it is cleared first so callers can reuse its capacity.
+        static void collect_rings(const FlatGeobuf::Geometry* geometry_fbs, FlatGeobuf::GeometryType actual_geometry_type,
+                                  std::vector<ring_view>& out_rings) noexcept(false);
+
+        /// @brief Tests whether a point lies inside a set of rings using the even-odd rule.
+        /// Holes and the parts of a MultiPolygon are handled naturally by the parity of the crossings.
+        /// @param rings The rings of one feature, as produced by `collect_rings`.
+        /// @param x The X coordinate of the point.
+        /// @param y The Y coordinate of the point.
+        /// @return True if the point is inside; points exactly on an edge may report either side.
+        static bool contains_point(std::span<const ring_view> rings, double x, double y) noexcept;
+
+        /// @brief Computes the bounding box of a set of rings.
+        /// @param rings The rings of one feature.
+        /// @return The extent of all ring points; invalid if there are no points.
+        static bounding_box bbox_of_rings(std::span<const ring_view> rings) noexcept;
+
+        /// @brief Computes the area of a set of rings: exterior rings add, holes subtract, whatever their winding.
+        /// @param rings The rings of one feature, as produced by `collect_rings`.
+        /// @return The area in squared CRS units.
+        static double area_of_rings(std::span<const ring_view> rings) noexcept;
+
     private:
+        /// @brief Appends the rings of a single polygon to `out_rings`.
+        /// @param polygon_fbs The polygon geometry (exterior ring first, then holes, delimited by `ends`).
+        /// @param polygon_index The part index to record on each ring.
+        /// @param out_rings The ring list to append to.
+        static void append_polygon_rings(const FlatGeobuf::Geometry& polygon_fbs, std::uint32_t polygon_index,
+                                         std::vector<ring_view>& out_rings) noexcept(false);
+
         /// @brief Updates a given bounding box with coordinates from a simple geometry's coordinate array.
         /// A "simple" geometry here typically refers to a part that directly contains an array of coordinates,
         /// such as a linestring, a polygon ring, or a set of points.
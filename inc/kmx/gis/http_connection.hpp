@@ -0,0 +1,67 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file http_connection.hpp
+#pragma once
+#ifndef PCH
+    #include <cstdint>
+    #include <optional>
+    #include <span>
+    #include <string>
+    #include <string_view>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief A TCP socket carrying HTTP/1.1 messages, shared by the range reader (client) and the file server.
+    /// Owns the socket; reads are buffered so that a message head and the start of its body may arrive together.
+    /// Not thread-safe: a connection serves one request at a time.
+    class http_connection
+    {
+    public:
+        /// @brief Takes ownership of a connected socket.
+        explicit http_connection(int socket_fd) noexcept;
+        /// @brief Closes the socket. `noexcept` is ensured.
+        ~http_connection() noexcept;
+
+        http_connection(const http_connection&) = delete;
+        http_connection& operator=(const http_connection&) = delete;
+        http_connection(http_connection&&) = delete;
+        http_connection& operator=(http_connection&&) = delete;
+
+        /// @brief Opens a TCP connection (with `TCP_NODELAY`).
+        /// @throws std::runtime_error If the host cannot be resolved or connected to.
+        static int connect_to(const std::string& host, std::uint16_t port) noexcept(false);
+
+        /// @brief Sends all of `data`.
+        /// @return False if the peer closed the connection or the send failed.
+        bool send_all(std::span<const std::uint8_t> data) noexcept;
+        /// @brief Sends all of `text`.
+        bool send_all(std::string_view text) noexcept;
+
+        /// @brief Reads a message head (start line and headers, up to the empty line).
+        /// @param head Receives the head, without the final empty line.
+        /// @return False on end of stream, error, timeout or an oversized head.
+        bool read_head(std::string& head) noexcept(false);
+        /// @brief Reads exactly `out.size()` body bytes.
+        /// @return False on premature end of stream or error.
+        bool read_body(std::span<std::uint8_t> out) noexcept;
+        /// @brief Reads and drops `size` body bytes.
+        bool discard_body(std::uint64_t size) noexcept;
+
+        /// @brief Sets the receive timeout of the socket.
+        void set_receive_timeout(std::uint32_t seconds) noexcept;
+
+        /// @brief The value of header `name` (case-insensitive) in a message head, without surrounding whitespace.
+        static std::optional<std::string_view> header_value(std::string_view head, std::string_view name) noexcept;
+
+    private:
+        /// @brief Receives more bytes into the buffer; returns false on end of stream or error.
+        bool fill() noexcept(false);
+
+        static constexpr std::size_t max_head_size_ {16u * 1024u}; /// Largest accepted message head.
+        static constexpr std::size_t receive_chunk_ {64u * 1024u}; /// Bytes requested per receive call.
+
+        int fd_ {-1};           /// The socket.
+        std::string buffer_ {};  /// Received bytes not consumed yet.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,55 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file http_file_server.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/block_cache.hpp"
+    #include "kmx/gis/http_connection.hpp"
+    #include "kmx/thread_pool.hpp"
+    #include <atomic>
+    #include <cstdint>
+    #include <string>
+    #include <string_view>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief A minimal HTTP/1.1 file server for tests and benchmarks of the range-read paths.
+    /// Serves the files below a root directory with GET and HEAD, single byte ranges (`Range: bytes=a-b`, `a-`, `-n`)
+    /// and keep-alive; each connection is handled by a worker of the thread pool, so the thread count bounds the
+    /// number of connections served at once. File bytes are read with `pread` through a shared `block_cache`, so hot
+    /// ranges such as index nodes and popular features are served from memory. Listens on the loopback interface only.
+    class http_file_server
+    {
+    public:
+        /// @brief Constructs the server.
+        /// @param root_path Directory whose files are served (a file path serves its directory).
+        /// @param port TCP port to listen on.
+        /// @param num_threads Number of worker threads (concurrent connections).
+        /// @param cache_bytes Budget of the block cache.
+        http_file_server(const std::string& root_path, std::uint16_t port, std::uint32_t num_threads,
+                         std::uint64_t cache_bytes) noexcept(false);
+
+        /// @brief Accepts and serves connections until the process is stopped.
+        /// @return False if the listening socket cannot be set up.
+        bool serve() noexcept(false);
+
+    private:
+        /// @brief Serves the requests of one connection until it is closed or idles out.
+        void handle_connection(int socket_fd) noexcept;
+        /// @brief Answers one request; returns false if the connection must be closed afterwards.
+        bool handle_request(http_connection& connection, const std::string& head) noexcept(false);
+        /// @brief Maps a request target to a file below the root, or an empty string if it escapes the root.
+        std::string resolve_target(std::string_view target) const noexcept(false);
+
+        static constexpr std::uint32_t idle_timeout_seconds_ {5u}; /// Keep-alive connections idle longer are closed.
+        static constexpr std::size_t send_chunk_ {256u * 1024u};    /// Bytes read from the cache per send.
+        static constexpr std::uint64_t statistics_interval_ {1024u}; /// Requests between two cache statistics lines.
+
+        std::string root_;                         /// Served directory.
+        std::uint16_t port_;                       /// Listening port.
+        block_cache block_cache_;                  /// Blocks of the served files.
+        std::atomic<std::uint64_t> requests_ {};   /// Requests answered.
+        thread_pool thread_pool_;                  /// Workers serving the connections.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,78 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file http_range_reader.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/http_connection.hpp"
+    #include <atomic>
+    #include <cstdint>
+    #include <memory>
+    #include <mutex>
+    #include <span>
+    #include <string>
+    #include <string_view>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief A byte range of a file.
+    struct byte_range
+    {
+        std::uint64_t offset {}; /// First byte.
+        std::uint64_t length {}; /// Number of bytes.
+    };
+
+    /// @brief Reads byte ranges of a file served over plain HTTP/1.1 (e.g. an object storage bucket behind a proxy,
+    /// or `http_file_server`).
+    /// Connections are kept alive and pooled, so concurrent reads from worker threads each use their own connection.
+    /// Usually wrapped by `cached_reader`, which merges neighbouring blocks into shared requests. Thread-safe.
+    class http_range_reader
+    {
+    public:
+        /// @brief Parses the URL and queries the size of the file.
+        /// @param url An `http://host[:port]/path` URL.
+        /// @throws std::runtime_error If the URL is not supported or the server does not report the file size.
+        explicit http_range_reader(const std::string& url) noexcept(false);
+        ~http_range_reader() noexcept;
+
+        /// @brief True if `path` is an `http://` URL.
+        static bool is_url(std::string_view path) noexcept;
+
+        /// @brief The URL of the file.
+        const std::string& url() const noexcept { return url_; }
+        /// @brief Size of the remote file in bytes.
+        std::uint64_t size() const noexcept { return size_; }
+
+        /// @brief Reads one range.
+        /// @throws std::runtime_error If the request fails or the range lies outside the file.
+        std::vector<std::uint8_t> read(byte_range range) noexcept(false);
+        /// @brief Reads one range into `out` (`out.size()` bytes starting at `offset`).
+        void read_into(std::uint64_t offset, std::span<std::uint8_t> out) noexcept(false);
+
+        /// @brief Number of HTTP requests issued so far.
+        std::uint64_t request_count() const noexcept { return request_count_; }
+        /// @brief Number of body bytes received so far.
+        std::uint64_t bytes_received() const noexcept { return bytes_received_; }
+
+    private:
+        /// @brief Takes an idle connection from the pool or opens a new one.
+        std::unique_ptr<http_connection> acquire() noexcept(false);
+        /// @brief Returns a connection to the pool for reuse.
+        void release(std::unique_ptr<http_connection> connection) noexcept(false);
+        /// @brief Sends one request and reads the response head; retries once on a stale keep-alive connection.
+        /// @return The connection (positioned at the body), the response head and the body length.
+        std::unique_ptr<http_connection> request(std::string_view method, const std::string& extra_headers, std::string& head,
+                                                 std::uint64_t& content_length) noexcept(false);
+
+        std::string url_;                                      /// The URL as given.
+        std::string host_ {};                                  /// Host name.
+        std::uint16_t port_ {80u};                             /// TCP port.
+        std::string target_ {};                                /// Request target (path and query).
+        std::uint64_t size_ {};                                /// Size of the remote file.
+        std::mutex idle_mutex_ {};                             /// Guards `idle_`.
+        std::vector<std::unique_ptr<http_connection>> idle_ {}; /// Keep-alive connections ready for reuse.
+        std::atomic<std::uint64_t> request_count_ {};          /// Requests issued.
+        std::atomic<std::uint64_t> bytes_received_ {};         /// Body bytes received.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,134 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file huge_pages.hpp
+#pragma once
+#ifndef PCH
+    #include <array>
+    #include <atomic>
+    #include <cstddef>
+    #include <cstdint>
+    #include <new>
+    #include <optional>
+    #include <string_view>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief How large buffers are backed by huge pages (`--huge-pages <mode>`).
+    enum class huge_page_mode : std::uint8_t
+    {
+        off,         /// Normal pages.
+        transparent, /// `madvise(MADV_HUGEPAGE)`: the kernel backs the range with 2 MiB pages where it can.
+        hugetlb,     /// Reserved hugetlbfs pages (`MAP_HUGETLB`), falling back to `transparent` if none are free.
+    };
+
+    /// @brief Process-wide huge page policy for file mappings and large anonymous buffers.
+    /// Multi-GB inputs and per-feature arrays need millions of 4 KiB TLB entries, so random accesses (index queries,
+    /// grid lookups) miss the TLB on almost every step; with 2 MiB pages one entry covers 512 times more memory.
+    /// The mode is set once at startup, before any buffer is allocated. Buffers below `min_size` keep normal pages.
+    class huge_pages
+    {
+    public:
+        static constexpr std::size_t page_size {2u * 1024u * 1024u}; /// Size of a huge page on x86-64 and arm64.
+        static constexpr std::size_t min_size {page_size};           /// Smallest buffer backed by huge pages.
+
+        /// @brief Parses "off", "thp" or "hugetlb".
+        static std::optional<huge_page_mode> parse(std::string_view text) noexcept;
+        /// @brief The `--huge-pages` value of a mode.
+        static std::string_view name(huge_page_mode mode) noexcept;
+        /// @brief Sets the process-wide mode.
+        static void set_mode(huge_page_mode mode) noexcept { mode_.store(mode, std::memory_order_relaxed); }
+        /// @brief The process-wide mode.
+        static huge_page_mode mode() noexcept { return mode_.load(std::memory_order_relaxed); }
+
+        /// @brief Asks for transparent huge pages on an existing mapping (a no-op in `off` mode).
+        static void advise(void* address, std::size_t size) noexcept;
+        /// @brief Maps `size` bytes of anonymous memory, backed by huge pages as the mode asks.
+        /// @return The zero-filled mapping, or null if even normal pages cannot be mapped.
+        static void* map_anonymous(std::size_t size) noexcept;
+        /// @brief Unmaps memory from `map_anonymous`.
+        static void unmap_anonymous(void* address, std::size_t size) noexcept;
+
+        /// @brief Prints how many buffers got huge pages and how many fell back.
+        static void print_statistics() noexcept(false);
+
+    private:
+        /// @brief Size of the mapping of a `size` byte buffer (whole huge pages).
+        static std::size_t mapping_size(std::size_t size) noexcept { return (size + page_size - 1u) / page_size * page_size; }
+
+        static inline std::atomic<huge_page_mode> mode_ {huge_page_mode::off}; /// The process-wide mode.
+        static inline std::atomic<std::uint64_t> hugetlb_buffers_ {};         /// Buffers on reserved huge pages.
+        static inline std::atomic<std::uint64_t> transparent_buffers_ {};     /// Buffers advised for transparent huge pages.
+        static inline std::atomic<std::uint64_t> fallbacks_ {};               /// `MAP_HUGETLB` requests that found no free pages.
+    };
+
+    /// @brief Allocator placing large arrays in `huge_pages::map_anonymous` memory and small ones on the heap.
+    /// The choice depends on the size alone, so `deallocate` finds the right path without extra state.
+    template <class T>
+    struct huge_page_allocator
+    {
+        using value_type = T;
+
+        huge_page_allocator() noexcept = default;
+        template <class U>
+        huge_page_allocator(const huge_page_allocator<U>&) noexcept
+        {
+        }
+
+        T* allocate(const std::size_t count)
+        {
+            const std::size_t size {count * sizeof(T)};
+            if (size < huge_pages::min_size)
+                return static_cast<T*>(::operator new(size, std::align_val_t {alignof(T)}));
+            void* const memory {huge_pages::map_anonymous(size)};
+            if (memory == nullptr)
+                throw std::bad_alloc {};
+            return static_cast<T*>(memory);
+        }
+
+        void deallocate(T* const memory, const std::size_t count) noexcept
+        {
+            const std::size_t size {count * sizeof(T)};
+            if (size < huge_pages::min_size)
+                ::operator delete(memory, std::align_val_t {alignof(T)});
+            else
+                huge_pages::unmap_anonymous(memory, size);
+        }
+
+        template <class U>
+        bool operator==(const huge_page_allocator<U>&) const noexcept
+        {
+            return true;
+        }
+    };
+
+    /// @brief A vector whose large buffers follow the huge page policy.
+    template <class T>
+    using huge_page_vector = std::vector<T, huge_page_allocator<T>>;
+
+    /// @brief Counts the dTLB loads and misses of the process with `perf_event_open` (`--tlb-stats`).
+    /// One run measures one huge page mode, which the report names; the comparison takes a control run with
+    /// `--huge-pages off` and the same input, mode and -t, since the mode is fixed before any buffer is allocated.
+    /// Threads started after construction are counted too; their counts are added when they exit, so the report is
+    /// printed on destruction, after the worker pools of the run are gone.
+    class tlb_counters
+    {
+    public:
+        /// @brief Starts counting; the counters stay closed if the kernel denies access (see `perf_event_paranoid`).
+        tlb_counters() noexcept;
+        /// @brief Prints the huge page mode, the loads, misses and miss rate, and closes the counters. `noexcept` is ensured.
+        ~tlb_counters() noexcept;
+
+        tlb_counters(const tlb_counters&) = delete;
+        tlb_counters& operator=(const tlb_counters&) = delete;
+        tlb_counters(tlb_counters&&) = delete;
+        tlb_counters& operator=(tlb_counters&&) = delete;
+
+    private:
+        /// @brief Prints the counts.
+        void print() const noexcept(false);
+
+        std::array<int, 2u> fds_ {-1, -1}; /// Loads and misses counters.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,92 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file layer_diff.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/bounding_box.hpp"
+    #include "kmx/gis/fgb_dataset.hpp"
+    #include "kmx/gis/geometry_hash.hpp"
+    #include "kmx/thread_pool.hpp"
+    #include <cstdint>
+    #include <limits>
+    #include <span>
+    #include <string>
+    #include <string_view>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Detects the changes between two versions of the same polygon FlatGeobuf layer.
+    /// Features are matched by a key column. Each side is digested in parallel into its key, geometry hash
+    /// (`geometry_hash`), bounding box and area. The digests are radix-partitioned by key hash and every partition is
+    /// joined by its own task: the previous features are loaded into a hash map and the new ones probe it. Repeated keys
+    /// are paired in file order. A matched pair is changed if its geometry hash, box or area differs. The CSV output
+    /// lists the added, removed and changed features sorted by key, with the box and area deltas of the changed ones.
+    class layer_diff
+    {
+    public:
+        /// @brief Constructs the diff.
+        /// @param input_fgb_path Path to the new version of the layer.
+        /// @param previous_fgb_path Path to the previous version of the layer.
+        /// @param output_csv_path Path for the output CSV file.
+        /// @param num_threads Number of worker threads.
+        /// @param key_column Column matching the features of both versions.
+        layer_diff(const std::string& input_fgb_path, const std::string& previous_fgb_path, const std::string& output_csv_path,
+                   std::uint32_t num_threads, const std::string& key_column) noexcept(false);
+
+        /// @brief Compares the two versions and writes the changes.
+        /// @return True on success, false on controlled failure.
+        bool diff() noexcept(false);
+
+        static constexpr std::string_view default_key_column {"natcode"}; /// Default `--key`.
+
+    private:
+        /// @brief What a feature is compared by.
+        struct feature_digest
+        {
+            std::string key {};        /// Key column value.
+            std::uint64_t key_hash {}; /// Hash of `key`.
+            geometry_hash hash {};     /// Hash of the canonical geometry (zero without rings).
+            bounding_box bbox {};      /// Box of the rings.
+            double area {};            /// Area of the rings.
+        };
+
+        /// @brief Kind of an output row.
+        enum class change_kind : std::uint8_t
+        {
+            added,   /// Only in the new version.
+            removed, /// Only in the previous version.
+            changed, /// In both, with another geometry.
+        };
+
+        /// @brief One output row.
+        struct change
+        {
+            change_kind kind {};       /// Kind of change.
+            std::uint64_t previous {}; /// Feature index in the previous version (`no_feature_` if added).
+            std::uint64_t current {};  /// Feature index in the new version (`no_feature_` if removed).
+        };
+
+        /// @brief Digests every feature of `dataset`.
+        std::vector<feature_digest> digest(const fgb_dataset& dataset, std::size_t key_column) noexcept(false);
+        /// @brief Groups the feature indices of `digests` by key partition.
+        /// @param[out] starts Receives `partition_count_ + 1` offsets into the returned indices.
+        static std::vector<std::uint64_t> partition(std::span<const feature_digest> digests, std::vector<std::uint64_t>& starts)
+            noexcept(false);
+        /// @brief Partition of a key hash.
+        static std::size_t partition_of(const std::uint64_t key_hash) noexcept { return (key_hash * 0x9E3779B97F4A7C15ull) >> 56u; }
+        /// @brief Writes the changes, sorted by key.
+        bool write_changes(std::vector<change>& changes, std::span<const feature_digest> previous,
+                           std::span<const feature_digest> current) const noexcept(false);
+
+        static constexpr std::size_t partition_count_ {256u};                                   /// Join partitions (top 8 bits).
+        static constexpr std::uint64_t no_feature_ {std::numeric_limits<std::uint64_t>::max()}; /// Absent side of a row.
+
+        const std::string output_csv_path_; /// Path to the output CSV file.
+        const std::string key_column_;      /// Column matching the features.
+        thread_pool thread_pool_;           /// Thread pool for parallel processing.
+        fgb_dataset dataset_;               /// Mapped new version.
+        fgb_dataset previous_;              /// Mapped previous version.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,183 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file lookup_grid.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/fgb_dataset.hpp"
+    #include "kmx/gis/huge_pages.hpp"
+    #include "kmx/gis/mapped_file.hpp"
+    #include "kmx/gis/polygon_rasterizer.hpp"
+    #include "kmx/gis/types.hpp"
+    #include "kmx/thread_pool.hpp"
+    #include <array>
+    #include <cstdint>
+    #include <optional>
+    #include <span>
+    #include <string>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief On-disk header of a lookup grid file. All sections follow it as little-endian arrays aligned to 8 bytes,
+    /// so the whole file can be memory-mapped and queried without any parsing.
+    ///
+    /// The grid has two resolutions. Each coarse cell holds either a feature index (the cell is entirely inside that
+    /// feature), `empty_cell`, or `reference_flag | block` pointing at a block of `refine_factor`² fine cells. A fine
+    /// cell holds a feature index, `empty_cell`, or `reference_flag | offset` pointing at a candidate list
+    /// `[count, feature...]` for cells crossed by a boundary, which require an exact point-in-polygon test.
+    struct lookup_grid_file_header
+    {
+        std::array<char, 8u> magic {};        /// File signature, `magic_value`.
+        std::uint32_t version {};             /// Format version, `current_version`.
+        std::uint32_t refine_factor {};       /// Fine cells per coarse cell along each axis.
+        std::uint32_t cols {};                /// Coarse columns.
+        std::uint32_t rows {};                /// Coarse rows.
+        double origin_x {};                   /// X of the south-west corner of the grid.
+        double origin_y {};                   /// Y of the south-west corner of the grid.
+        double cell_size {};                  /// Coarse cell size in CRS units.
+        std::uint64_t feature_count {};       /// Number of features in the source FGB.
+        std::uint64_t source_size {};         /// Size of the source FGB in bytes, used to detect stale grids.
+        std::uint64_t codes_offset {};        /// Offset of the `uint32_t[feature_count]` UAT code table.
+        std::uint64_t coarse_offset {};       /// Offset of the `uint32_t[cols * rows]` coarse cells.
+        std::uint64_t blocks_offset {};       /// Offset of the `uint32_t[block_count * refine_factor²]` fine blocks.
+        std::uint64_t block_count {};         /// Number of refined blocks.
+        std::uint64_t candidates_offset {};   /// Offset of the candidate list words.
+        std::uint64_t candidates_size {};     /// Number of `uint32_t` words in the candidate lists.
+
+        static constexpr std::array<char, 8u> magic_value {'U', 'A', 'T', 'G', 'R', 'I', 'D', '\0'};
+        static constexpr std::uint32_t current_version {1u};
+        static constexpr std::uint32_t empty_cell {0xFFFFFFFFu};     /// Cell not covered by any feature.
+        static constexpr std::uint32_t reference_flag {0x80000000u}; /// Marks a block or candidate list reference.
+    };
+
+    /// @brief Parameters of a lookup grid build.
+    struct lookup_grid_settings
+    {
+        /// @brief Coarse cell size in CRS units (metres for the Romanian Stereo 70 data).
+        double cell_size {2000.0};
+        /// @brief Fine cells per coarse cell along each axis; boundary cells at this resolution need an exact test.
+        std::uint32_t refine_factor {8u};
+    };
+
+    /// @brief Precomputes a two-level lookup grid for a polygon FlatGeobuf file.
+    /// Every feature is rasterized in parallel straight from the mapped rings (scanline fill for interiors, edge
+    /// tracing for boundaries) onto the fine grid, which is then compressed into uniform coarse cells and refined
+    /// blocks and written as a memory-mappable file.
+    class lookup_grid_builder
+    {
+    public:
+        /// @brief Constructs the builder.
+        /// @param input_fgb_path Path to the input FlatGeobuf file (must be Polygon or MultiPolygon).
+        /// @param output_grid_path Path of the grid file to write.
+        /// @param num_threads Number of worker threads for parallel rasterization.
+        /// @param settings Grid resolution parameters.
+        lookup_grid_builder(const std::string& input_fgb_path, const std::string& output_grid_path, std::uint32_t num_threads,
+                            const lookup_grid_settings& settings) noexcept(false);
+
+        /// @brief Builds the grid and writes it to disk.
+        /// @return True on success, false on controlled failure (e.g., unsupported geometry type or grid too large).
+        bool build() noexcept(false);
+
+        /// @brief Conventional location of the grid for a FlatGeobuf file: next to it, with a `.grid` suffix.
+        static std::string default_grid_path(const std::string& fgb_path) { return fgb_path + ".grid"; }
+
+    private:
+        /// @brief Rasterizes all features onto `fine_cells_`, collecting (fine cell, feature) candidate pairs.
+        void rasterize_features(const raster_grid& fine_grid) noexcept(false);
+
+        /// @brief Reads the UAT code of every feature for the code table.
+        std::vector<std::uint32_t> read_uat_codes() const noexcept(false);
+
+        /// @brief Compresses the fine grid into the two-level representation and writes the file.
+        bool write_grid_file(const raster_grid& fine_grid, const bounding_box& extent, std::uint32_t coarse_cols,
+                             std::uint32_t coarse_rows) noexcept(false);
+
+        static constexpr std::uint32_t boundary_marker_ {0xFFFFFFFEu};      /// Transient fine cell value for boundary cells.
+        static constexpr std::uint64_t max_fine_cells_ {1ull << 31u};        /// Upper bound on the transient fine grid.
+        static constexpr std::uint64_t max_feature_count_ {0x7FFFFFFEu};     /// Feature ids must not collide with the flags.
+        static constexpr std::string_view expected_uat_code_column_ {"natcode"};
+
+        const std::string input_fgb_path_;                                   /// Path to the input FlatGeobuf file.
+        const std::string output_grid_path_;                                 /// Path to the output grid file.
+        const lookup_grid_settings settings_;                                /// Grid resolution parameters.
+        thread_pool thread_pool_;                                            /// Thread pool for parallel processing.
+        fgb_dataset dataset_;                                                /// Mapped input file.
+        huge_page_vector<std::uint32_t> fine_cells_ {};                      /// Transient full-resolution grid.
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> candidates_ {}; /// (fine cell, feature) pairs on boundaries.
+    };
+
+    /// @brief Result of a raw grid lookup.
+    struct lookup_grid_cell
+    {
+        /// @brief The feature covering the whole cell, or `lookup_grid_file_header::empty_cell`.
+        std::uint32_t feature {lookup_grid_file_header::empty_cell};
+        /// @brief Features whose boundary crosses the cell; non-empty only when an exact test is required.
+        std::span<const std::uint32_t> candidates {};
+    };
+
+    /// @brief Read-only, memory-mapped lookup grid. Opening it costs one `mmap`; lookups are a couple of array reads.
+    /// All members are `const` and may be used concurrently.
+    class lookup_grid
+    {
+    public:
+        /// @brief Maps and validates a grid file.
+        /// @param grid_path Path to the grid file.
+        /// @throws std::runtime_error If the file cannot be mapped or is not a valid grid.
+        explicit lookup_grid(const std::string& grid_path) noexcept(false);
+
+        /// @brief The file header.
+        const lookup_grid_file_header& header() const noexcept { return header_; }
+
+        /// @brief Looks up the grid cell containing (x, y) without touching any geometry.
+        lookup_grid_cell lookup(double x, double y) const noexcept;
+
+        /// @brief Finds the feature containing (x, y), running the exact point-in-polygon test for boundary cells.
+        /// @param x The X coordinate.
+        /// @param y The Y coordinate.
+        /// @param dataset The FlatGeobuf file the grid was built from.
+        /// @param scratch_rings Reusable ring buffer (one per thread).
+        /// @return The feature index, or `std::nullopt` if no feature contains the point.
+        std::optional<std::uint32_t> locate(double x, double y, const fgb_dataset& dataset,
+                                            std::vector<ring_view>& scratch_rings) const noexcept(false);
+
+        /// @brief UAT code of a feature (0 if the source had none).
+        std::uint32_t uat_code(std::uint32_t feature) const noexcept { return codes_[feature]; }
+
+    private:
+        mapped_file file_;                          /// Read-only mapping of the grid file.
+        lookup_grid_file_header header_ {};         /// Copy of the validated header.
+        std::span<const std::uint32_t> codes_ {};      /// UAT code per feature.
+        std::span<const std::uint32_t> coarse_ {};     /// Coarse cells.
+        std::span<const std::uint32_t> blocks_ {};     /// Fine blocks.
+        std::span<const std::uint32_t> candidates_ {}; /// Candidate lists.
+    };
+
+    /// @brief Assigns points (e.g., GPS pings) to features using a lookup grid and writes one CSV row per point.
+    /// Input lines are `x,y[,...]`; lines whose first two fields are not numbers (such as a header row) are skipped.
+    class point_locator
+    {
+    public:
+        /// @brief Constructs the locator.
+        /// @param input_fgb_path Path to the FlatGeobuf file the grid was built from.
+        /// @param grid_path Path to the grid file.
+        /// @param points_csv_path Path to the input points.
+        /// @param output_csv_path Path for the output CSV file.
+        /// @param num_threads Number of worker threads.
+        point_locator(const std::string& input_fgb_path, const std::string& grid_path, const std::string& points_csv_path,
+                      const std::string& output_csv_path, std::uint32_t num_threads) noexcept(false);
+
+        /// @brief Locates all points and writes `x,y,feature_index,uat_code` rows in input order.
+        /// @return True on success, false on controlled failure.
+        bool process_points() noexcept(false);
+
+    private:
+        static constexpr std::size_t points_per_task_ {65536u}; /// Points located by one task.
+
+        const std::string points_csv_path_; /// Path to the input points.
+        const std::string output_csv_path_; /// Path to the output CSV file.
+        thread_pool thread_pool_;           /// Thread pool for parallel processing.
+        fgb_dataset dataset_;               /// Mapped FlatGeobuf file.
+        lookup_grid grid_;                  /// Mapped grid.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,62 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file mapped_file.hpp
+#pragma once
+#ifndef PCH
+    #include <cstddef>
+    #include <cstdint>
+    #include <span>
+    #include <string>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Read-only memory mapping of a whole file.
+    /// The mapping is shared between threads; all accessors are `const` and safe to call concurrently.
+    /// Large files follow the `huge_pages` policy: `thp` advises the mapping (effective where the file system supports
+    /// huge pages in the page cache), `hugetlb` reads the file into a private copy on huge pages instead, as files
+    /// cannot be mapped from hugetlbfs pages unless they live there.
+    class mapped_file
+    {
+    public:
+        /// @brief Maps the file at `file_path` into memory.
+        /// @param file_path Path to the file to map.
+        /// @throws std::runtime_error If the file cannot be opened, inspected or mapped.
+        explicit mapped_file(const std::string& file_path) noexcept(false);
+        /// @brief Unmaps the file. `noexcept` is ensured.
+        ~mapped_file() noexcept;
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+        mapped_file(mapped_file&&) = delete;
+        mapped_file& operator=(mapped_file&&) = delete;
+
+        /// @brief Pointer to the first byte of the mapping (null for an empty file).
+        const std::uint8_t* data() const noexcept { return data_; }
+        /// @brief Size of the mapping in bytes.
+        std::size_t size() const noexcept { return size_; }
+        /// @brief The whole mapping as a byte span.
+        std::span<const std::uint8_t> bytes() const noexcept { return {data_, size_}; }
+        /// @brief Advises the kernel that the mapping is read front to back (more readahead, pages reclaimed sooner).
+        void advise_sequential() const noexcept;
+        /// @brief Gives back the pages from the one holding `offset` up to the one holding `offset + length`, which usually
+        /// holds the data that follows and is kept. Released pages are read from the file again if touched later. Has no
+        /// effect on a private huge page copy, whose pages could not be read again.
+        void release(std::size_t offset, std::size_t length) const noexcept;
+        /// @brief True if the file was read into a private huge page copy, which stays resident as a whole: `release` and
+        /// `advise_sequential` have no effect on it.
+        bool is_anonymous() const noexcept { return anonymous_; }
+        /// @brief Path the mapping was created from.
+        const std::string& path() const noexcept { return path_; }
+
+    private:
+        const std::string path_;         /// Path of the mapped file.
+        /// @brief Reads the file into `huge_pages::map_anonymous` memory.
+        /// @return False if the memory cannot be mapped or the file read (the file is then mapped as usual).
+        bool load_into_huge_pages(int fd) noexcept;
+
+        const std::uint8_t* data_ {};    /// Start of the mapping.
+        std::size_t size_ {};            /// Size of the mapping in bytes.
+        bool anonymous_ {};              /// True for a copy in `huge_pages::map_anonymous` memory.
+    };
+
+} // namespace kmx::gis
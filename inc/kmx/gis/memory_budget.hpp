@@ -0,0 +1,72 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file memory_budget.hpp
+#pragma once
+#ifndef PCH
+    #include <array>
+    #include <cstddef>
+    #include <cstdint>
+    #include <optional>
+    #include <string_view>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief The major memory consumers of a pipeline, as accounted by `memory_budget`.
+    enum class memory_subsystem : std::uint8_t
+    {
+        input,       /// Input bytes mapped and not released, or read into buffers.
+        block_cache, /// Blocks resident in the `block_cache`.
+        batches,     /// Feature batches and their results between reading and writing.
+        sort_buffer, /// Results held by the `result_sorter` before a run is spilled.
+    };
+
+    /// @brief The memory budget of a run and the accounting of its major allocations against it.
+    /// The budget is the tightest of `--max-memory` and a share of the cgroup memory limit (the rest is left to code,
+    /// thread stacks, allocator slack and the page cache of the output). Pipelines split it between their subsystems
+    /// to choose their plan (in memory or streaming, window sizes, spill thresholds) and report the bytes each subsystem
+    /// holds as the run proceeds; the peaks are printed at the end. The accounting is updated by the pipeline thread.
+    class memory_budget
+    {
+    public:
+        /// @brief Determines the budget.
+        /// @param max_memory_bytes The `--max-memory` budget, 0 for none (then only the cgroup limit applies).
+        explicit memory_budget(std::uint64_t max_memory_bytes) noexcept(false);
+
+        /// @brief The budget in bytes, or `std::nullopt` if the run is not limited.
+        std::optional<std::uint64_t> limit() const noexcept { return limit_; }
+        /// @brief Where the budget comes from ("--max-memory" or "cgroup memory limit"), for the log.
+        std::string_view limit_source() const noexcept { return limit_source_; }
+        /// @brief `fraction` of the budget, or `unlimited` if there is none.
+        std::uint64_t share(double fraction, std::uint64_t unlimited) const noexcept;
+
+        /// @brief Records the bytes a subsystem holds now, updating its peak.
+        void set(memory_subsystem subsystem, std::uint64_t bytes) noexcept;
+        /// @brief Adds `bytes` to what a subsystem holds.
+        void add(memory_subsystem subsystem, std::uint64_t bytes) noexcept { set(subsystem, current(subsystem) + bytes); }
+        /// @brief Removes `bytes` from what a subsystem holds.
+        void remove(memory_subsystem subsystem, std::uint64_t bytes) noexcept;
+        /// @brief The bytes a subsystem holds now.
+        std::uint64_t current(const memory_subsystem subsystem) const noexcept { return current_[index_of(subsystem)]; }
+        /// @brief The most bytes a subsystem held at once.
+        std::uint64_t peak(const memory_subsystem subsystem) const noexcept { return peak_[index_of(subsystem)]; }
+
+        /// @brief Prints the budget and the peak of every subsystem to standard output.
+        void print_report() const noexcept(false);
+
+        static constexpr double cgroup_share {0.75};             /// Part of the cgroup limit given to the accounted subsystems.
+        static constexpr std::uint64_t mebibyte {1024u * 1024u}; /// Bytes per MiB.
+
+    private:
+        static constexpr std::size_t subsystem_count_ {4u}; /// Number of `memory_subsystem` values.
+        static constexpr std::array<std::string_view, subsystem_count_> subsystem_names_ {"input", "block cache", "batches",
+                                                                                          "sort buffer"};
+
+        static constexpr std::size_t index_of(const memory_subsystem subsystem) noexcept { return static_cast<std::size_t>(subsystem); }
+
+        std::optional<std::uint64_t> limit_ {};                  /// The budget (none if unlimited).
+        std::string_view limit_source_ {};                       /// Origin of `limit_`.
+        std::array<std::uint64_t, subsystem_count_> current_ {}; /// Bytes held now, per subsystem.
+        std::array<std::uint64_t, subsystem_count_> peak_ {};    /// Peak bytes, per subsystem.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,135 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file mvt_encoder.hpp
+#pragma once
+#ifndef PCH
+    #include <cstdint>
+    #include <span>
+    #include <string>
+    #include <string_view>
+    #include <unordered_map>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Minimal protocol buffers writer for the few wire types the vector tile format uses.
+    class protobuf_writer
+    {
+    public:
+        /// @brief Protocol buffers wire types.
+        enum class wire_type : std::uint32_t
+        {
+            varint = 0u,
+            fixed64 = 1u,
+            length_delimited = 2u,
+            fixed32 = 5u,
+        };
+
+        /// @brief Appends a base-128 varint.
+        void write_varint(std::uint64_t value) noexcept(false);
+        /// @brief Appends a field key.
+        void write_key(std::uint32_t field, wire_type type) noexcept(false);
+        /// @brief Appends a varint field.
+        void write_uint_field(std::uint32_t field, std::uint64_t value) noexcept(false);
+        /// @brief Appends a zigzag-encoded signed varint field.
+        void write_sint_field(std::uint32_t field, std::int64_t value) noexcept(false);
+        /// @brief Appends a 64-bit floating point field.
+        void write_double_field(std::uint32_t field, double value) noexcept(false);
+        /// @brief Appends a length-delimited field (string, bytes or embedded message).
+        void write_bytes_field(std::uint32_t field, std::string_view bytes) noexcept(false);
+        /// @brief Appends already serialized fields.
+        void write_raw(std::string_view bytes) noexcept(false);
+        /// @brief Appends a packed repeated uint32 field.
+        void write_packed_field(std::uint32_t field, std::span<const std::uint32_t> values) noexcept(false);
+
+        /// @brief The bytes written so far.
+        const std::string& data() const noexcept { return buffer_; }
+        /// @brief Discards the written bytes, keeping the capacity.
+        void clear() noexcept { buffer_.clear(); }
+
+        /// @brief ZigZag encoding of a signed value.
+        static constexpr std::uint64_t zigzag(const std::int64_t value) noexcept
+        {
+            return (static_cast<std::uint64_t>(value) << 1u) ^ static_cast<std::uint64_t>(value >> 63);
+        }
+
+    private:
+        std::string buffer_ {}; /// Serialized bytes.
+    };
+
+    /// @brief Integer point in tile coordinates.
+    struct tile_point
+    {
+        std::int32_t x {};
+        std::int32_t y {};
+
+        bool operator==(const tile_point&) const noexcept = default;
+    };
+
+    /// @brief Builds one layer of a Mapbox Vector Tile (specification 2.1) and serializes the tile.
+    /// Keys and values are deduplicated per layer. The builder can be cleared and reused for the next tile.
+    class mvt_layer_builder
+    {
+    public:
+        /// @brief MVT command ids.
+        static constexpr std::uint32_t command_move_to {1u};
+        static constexpr std::uint32_t command_line_to {2u};
+        static constexpr std::uint32_t command_close_path {7u};
+        /// @brief MVT geometry type of polygons.
+        static constexpr std::uint32_t geometry_type_polygon {3u};
+
+        /// @brief Constructs a layer builder.
+        /// @param name The layer name.
+        /// @param extent The tile extent in integer tile units (usually 4096).
+        mvt_layer_builder(std::string name, std::uint32_t extent) noexcept;
+
+        /// @brief Index of a property key in the layer's key table.
+        std::uint32_t key_index(std::string_view key) noexcept(false);
+        /// @brief Index of a string value in the layer's value table.
+        std::uint32_t string_value_index(std::string_view value) noexcept(false);
+        /// @brief Index of a floating point value in the layer's value table.
+        std::uint32_t double_value_index(double value) noexcept(false);
+        /// @brief Index of a signed integer value in the layer's value table.
+        std::uint32_t int_value_index(std::int64_t value) noexcept(false);
+        /// @brief Index of an unsigned integer value in the layer's value table.
+        std::uint32_t uint_value_index(std::uint64_t value) noexcept(false);
+        /// @brief Index of a boolean value in the layer's value table.
+        std::uint32_t bool_value_index(bool value) noexcept(false);
+
+        /// @brief Appends the commands of one closed ring to a polygon command stream.
+        /// @param ring The ring vertices without the closing point; must hold at least 3 points.
+        /// @param cursor The current pen position, updated to the last vertex.
+        /// @param out_geometry The command stream to append to.
+        static void encode_ring(std::span<const tile_point> ring, tile_point& cursor,
+                                std::vector<std::uint32_t>& out_geometry) noexcept(false);
+
+        /// @brief Adds a polygon feature.
+        /// @param id The feature id.
+        /// @param tags Alternating key and value indices.
+        /// @param geometry The command stream (see `encode_ring`).
+        void add_polygon(std::uint64_t id, std::span<const std::uint32_t> tags, std::span<const std::uint32_t> geometry) noexcept(false);
+
+        /// @brief True if no feature has been added since the last `clear`.
+        bool empty() const noexcept { return feature_count_ == 0u; }
+        /// @brief Serializes a tile containing this layer.
+        /// @param out_tile Receives the tile bytes.
+        void write_tile(std::string& out_tile) noexcept(false);
+        /// @brief Removes all features, keys and values.
+        void clear() noexcept;
+
+    private:
+        /// @brief Deduplicates an encoded Value message.
+        std::uint32_t value_index(const protobuf_writer& encoded_value) noexcept(false);
+
+        const std::string name_;                                   /// Layer name.
+        const std::uint32_t extent_;                               /// Tile extent.
+        protobuf_writer features_ {};                              /// Serialized feature fields of the layer.
+        protobuf_writer scratch_ {};                               /// Scratch message buffer.
+        std::uint32_t feature_count_ {};                           /// Number of features added.
+        std::vector<std::string> keys_ {};                         /// Key table.
+        std::unordered_map<std::string, std::uint32_t> key_map_ {};   /// Key deduplication.
+        std::vector<std::string> values_ {};                       /// Encoded Value messages.
+        std::unordered_map<std::string, std::uint32_t> value_map_ {}; /// Value deduplication.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,54 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file part_merger.hpp
+#pragma once
+#ifndef PCH
+    #include <cstddef>
+    #include <cstdint>
+    #include <string>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Merges the partial outputs of sharded or partitioned runs into one file with a streaming k-way merge.
+    /// - Without a key, the parts of a `--shard` run are concatenated in feature order, as recorded in their
+    ///   `shard_manifest`s, which restores the output of an unsharded run.
+    /// - With a key column, CSV parts that are each sorted by it are merged through a `tournament_tree` into one
+    ///   globally sorted CSV. Numeric values compare by value and before text, text compares bytewise, ties keep the
+    ///   order of the parts. Records must be single lines.
+    /// - Binary covering tables (`quadkey_covering_builder`) are merged by cell id and feature.
+    /// Every part is read sequentially through one large buffer and memory stays constant in the size of the parts.
+    class part_merger
+    {
+    public:
+        /// @brief Constructs the merger.
+        /// @param part_paths The partial outputs.
+        /// @param output_path Path of the merged output.
+        /// @param key_column CSV column to merge by; empty to restore the input order from the shard manifests.
+        part_merger(std::vector<std::string> part_paths, const std::string& output_path, const std::string& key_column) noexcept(false);
+
+        /// @brief Merges the parts.
+        /// @return True on success, false on controlled failure (inconsistent or unsorted parts).
+        bool merge() noexcept(false);
+
+    private:
+        /// @brief Orders the parts by their manifests and concatenates them, keeping the first CSV header.
+        bool concatenate_in_manifest_order() noexcept(false);
+        /// @brief Merges CSV parts sorted by `key_column_`.
+        bool merge_csv_by_key() noexcept(false);
+        /// @brief Merges binary covering tables.
+        bool merge_cover_tables() noexcept(false);
+        /// @brief Read buffer size per part, so that all buffers together stay within `memory_budget_`.
+        std::size_t buffer_size() const noexcept;
+
+        static constexpr std::size_t memory_budget_ {256u * 1024u * 1024u}; /// Total size of the read and write buffers.
+        static constexpr std::size_t min_buffer_size_ {64u * 1024u};        /// Smallest buffer per part.
+        static constexpr std::size_t max_buffer_size_ {8u * 1024u * 1024u}; /// Largest buffer per part.
+        static constexpr std::uint64_t progress_report_interval_ {1000000u}; /// Rows between progress reports.
+
+        std::vector<std::string> part_paths_; /// The partial outputs.
+        const std::string output_path_;       /// Path of the merged output.
+        const std::string key_column_;        /// CSV key column (empty: manifest order).
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,142 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file pipeline_tuner.hpp
+#pragma once
+#ifndef PCH
+    #include <array>
+    #include <chrono>
+    #include <condition_variable>
+    #include <cstddef>
+    #include <cstdint>
+    #include <mutex>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief The pipeline parameters fixed on the command line; the others are tuned.
+    struct tuning_settings
+    {
+        bool tune_workers {true};     /// Tune the active worker count (off with an explicit -t).
+        std::uint64_t batch_bytes {}; /// Fixed batch volume in bytes (0: tuned).
+    };
+
+    /// @brief Tunes the active worker count and the batch volume of a batch pipeline while it runs.
+    /// The best values depend on the data (vertex density, property sizes) and the machine, so they are measured: the
+    /// first `tuning_share` of the features is processed in short trials, each with one candidate setting, and the
+    /// throughput (input bytes per second: vertices and property texts, reading and writing included) of every trial
+    /// is compared. The batch volume is tuned first with all workers, then the worker count with the best volume; the
+    /// smallest worker count within `worker_tolerance` of the best throughput wins, leaving the rest of the CPUs idle.
+    /// Batches are sized by input volume (`feature_batch::input_bytes`): the features per batch follow from the average
+    /// feature volume read so far, so dense geometries get fewer features per batch.
+    /// The pipeline drains its batches in flight between trials, so a trial measures only its own batches. Workers are
+    /// limited by a gate that every batch task passes (`worker_slot`); the pool itself keeps its threads.
+    class pipeline_tuner
+    {
+    public:
+        /// @brief Holds one of the active worker slots while a batch task runs.
+        class worker_slot
+        {
+        public:
+            /// @brief Waits until fewer than the active worker count of `tuner` are running.
+            explicit worker_slot(pipeline_tuner& tuner) noexcept(false);
+            /// @brief Frees the slot.
+            ~worker_slot() noexcept;
+
+            worker_slot(const worker_slot&) = delete;
+            worker_slot& operator=(const worker_slot&) = delete;
+
+        private:
+            pipeline_tuner& tuner_; /// The tuner whose gate is held.
+        };
+
+        /// @brief Constructs the tuner.
+        /// @param max_workers Worker threads of the pool.
+        /// @param settings The parameters fixed on the command line.
+        pipeline_tuner(std::size_t max_workers, const tuning_settings& settings) noexcept(false);
+
+        /// @brief Starts tuning a run of `feature_count` features (unknown if 0; then no tuning is done).
+        void start(std::uint64_t feature_count) noexcept(false);
+        /// @brief Features to read into the next batch.
+        std::size_t batch_features() const noexcept;
+        /// @brief Batch tasks allowed to run at once.
+        std::size_t active_workers() const noexcept;
+        /// @brief Records a batch read by the pipeline.
+        /// @param features Features of the batch.
+        /// @param bytes Input volume of the batch (`feature_batch::input_bytes`).
+        void record_batch(std::size_t features, std::uint64_t bytes) noexcept;
+        /// @brief True if the current trial is over; the pipeline then drains its batches and calls `next_trial`.
+        bool trial_complete() const noexcept;
+        /// @brief Concludes the trial of the drained pipeline and switches to the next candidate, or to the choice.
+        void next_trial() noexcept(false);
+        /// @brief Prints the trials and the chosen parameters with the options reproducing them.
+        void print_choice() const noexcept(false);
+
+        static constexpr double tuning_share {0.05};                /// Part of the features processed in trials at most.
+        static constexpr double worker_tolerance {0.03};            /// Throughput given up for fewer workers.
+        static constexpr std::size_t default_batch_features {256u}; /// Features per batch before anything is measured.
+        static constexpr std::uint64_t kibibyte {1024u};            /// Bytes per KiB.
+
+    private:
+        /// @brief What is being tuned.
+        enum class stage : std::uint8_t
+        {
+            warm_up,      /// A first trial that is not compared (cold caches and page faults).
+            batch_volume, /// Batch volume candidates with all workers.
+            workers,      /// Worker count candidates with the best volume.
+            done,         /// The parameters are fixed.
+        };
+
+        /// @brief One measured trial.
+        struct trial
+        {
+            std::size_t workers {};       /// Active workers.
+            std::uint64_t batch_bytes {}; /// Target batch volume.
+            double bytes_per_second {};   /// Measured throughput.
+        };
+
+        /// @brief Features in a batch of `batch_bytes`, from the average feature size read so far.
+        std::size_t features_in(std::uint64_t batch_bytes) const noexcept;
+        /// @brief True if a trial of the batch volume candidate `candidate_` fits in the rest of the tuning budget.
+        bool volume_trial_fits() const noexcept;
+        /// @brief Keeps the best candidate of the current stage and enters the next one, skipping the ones with nothing to tune.
+        void advance_stage() noexcept(false);
+        /// @brief Applies the candidate `candidate_` of the current stage.
+        void apply_candidate() noexcept(false);
+        /// @brief Fixes the best measured parameters and ends the tuning.
+        void finish() noexcept(false);
+        /// @brief The measured trial of the current stage with the best throughput, or nullptr if there is none.
+        const trial* best_of_stage() const noexcept;
+        /// @brief Changes the active worker count, waking the waiting tasks.
+        void set_active_workers(std::size_t workers) noexcept(false);
+
+        /// @brief Batch volume candidates, from a few large features to thousands of small ones per batch.
+        static constexpr std::array<std::uint64_t, 4u> batch_volumes_ {128u * kibibyte, 512u * kibibyte, 2048u * kibibyte,
+                                                                       8192u * kibibyte};
+        static constexpr std::size_t max_batch_features_ {65536u};       /// Upper bound of the features per batch.
+        static constexpr std::size_t trial_batches_per_worker_ {2u};     /// Fewest batches per active worker in a trial.
+        static constexpr std::chrono::milliseconds trial_duration_ {25}; /// Shortest trial.
+
+        using clock = std::chrono::steady_clock;
+
+        const std::size_t max_workers_;                 /// Worker threads of the pool.
+        const tuning_settings settings_;                /// The fixed parameters.
+        stage stage_ {stage::done};                     /// Current stage.
+        std::vector<std::size_t> worker_candidates_ {}; /// Worker counts tried in `stage::workers`.
+        std::size_t candidate_ {};                      /// Index of the candidate in its stage.
+        std::vector<trial> trials_ {};                  /// Measured trials, in order.
+        std::size_t stage_begin_ {};                    /// First trial of the current stage in `trials_`.
+        std::uint64_t batch_bytes_ {};                  /// Target batch volume (0: `default_batch_features`).
+        std::uint64_t tuning_features_ {};              /// Features the trials may take.
+        std::uint64_t features_read_ {};                /// Features read since `start`.
+        std::uint64_t bytes_read_ {};                   /// Input volume of the features read since `start`.
+        std::uint64_t trial_bytes_ {};                  /// Input volume of the batches of the current trial.
+        std::size_t trial_batches_ {};                  /// Batches read in the current trial.
+        clock::time_point trial_start_ {};              /// When the current trial began.
+
+        mutable std::mutex gate_mutex_ {}; /// Guards `active_workers_` and `running_`.
+        std::condition_variable gate_ {};  /// Signalled when a slot frees or the count grows.
+        std::size_t active_workers_ {};    /// Batch tasks allowed to run at once.
+        std::size_t running_ {};           /// Batch tasks running.
+    };
+
+} // namespace kmx::gis
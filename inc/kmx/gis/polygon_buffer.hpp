@@ -0,0 +1,60 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file polygon_buffer.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/types.hpp"
+    #include <cstdint>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Owned storage for decoded polygon rings (WKB, WKT), appended feature after feature.
+    /// Rings are recorded as extents into `xy` rather than pointers, so the buffer may grow while it is filled;
+    /// `view` turns an extent into a `ring_view` once filling is done.
+    struct polygon_buffer
+    {
+        /// @brief A ring stored in `xy`.
+        struct ring_extent
+        {
+            std::size_t first_point {};     /// Index of the first point in `xy` (in points, not doubles).
+            std::uint32_t point_count {};   /// Number of points.
+            std::uint32_t polygon_index {}; /// Index of the polygon within its (Multi)Polygon.
+            bool is_exterior {};            /// True for the first ring of a polygon.
+        };
+
+        std::vector<double> xy {};         /// Interleaved X/Y coordinates of all rings.
+        std::vector<ring_extent> rings {};    /// Rings in input order.
+
+        /// @brief Starts a ring at the current end of `xy`.
+        void begin_ring(const std::uint32_t polygon_index, const bool is_exterior) noexcept(false)
+        {
+            rings.push_back({xy.size() / 2u, 0u, polygon_index, is_exterior});
+        }
+
+        /// @brief Appends a point to the ring started last.
+        void add_point(const double x, const double y) noexcept(false)
+        {
+            xy.push_back(x);
+            xy.push_back(y);
+            ++rings.back().point_count;
+        }
+
+        /// @brief Drops rings (and their points) recorded after the first `ring_count`, e.g. after a parse error.
+        void truncate(const std::size_t ring_count) noexcept
+        {
+            if (ring_count >= rings.size())
+                return;
+            xy.resize(rings[ring_count].first_point * 2u);
+            rings.resize(ring_count);
+        }
+
+        /// @brief A view of ring `i`; valid until `xy` is modified.
+        ring_view view(const std::size_t i) const noexcept
+        {
+            const ring_extent& ring {rings[i]};
+            return {xy.data() + ring.first_point * 2u, ring.point_count, ring.polygon_index, ring.is_exterior};
+        }
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,99 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file polygon_overlay.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/fgb_dataset.hpp"
+    #include "kmx/gis/segment_index.hpp"
+    #include "kmx/gis/types.hpp"
+    #include "kmx/thread_pool.hpp"
+    #include <cstdint>
+    #include <span>
+    #include <string>
+    #include <string_view>
+    #include <utility>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Computes exact intersection areas of polygons without building the intersection polygon.
+    /// The boundary of A ∩ B consists of the parts of A's boundary inside B, the parts of B's boundary inside A and the
+    /// boundary parts A and B share with the same orientation; integrating the shoelace term over those pieces yields the
+    /// area. Each edge is cut at its intersections with the other polygon and every piece is classified by its midpoint,
+    /// so shared (collinear) edges are handled explicitly instead of relying on inside/outside tests on the boundary.
+    /// Rings are reoriented (exteriors counter-clockwise, holes clockwise) and coordinates are shifted to a local origin.
+    /// Holds scratch buffers sized by the two polygons, so keep one per worker task.
+    class polygon_intersector
+    {
+    public:
+        /// @brief Sets the subject polygon; its bounding box minimum becomes the local origin.
+        /// @param rings The rings of the subject feature.
+        void set_subject(std::span<const ring_view> rings) noexcept(false);
+
+        /// @brief Area of the intersection of the subject with `rings`.
+        /// @param rings The rings of the clip feature.
+        /// @return The intersection area in squared CRS units.
+        double intersection_area(std::span<const ring_view> rings) noexcept(false);
+
+    private:
+        /// @brief A collinear overlap of the cut edge with an edge of the other polygon, in edge parameter units.
+        struct overlap
+        {
+            double t0, t1;
+            bool same_direction;
+        };
+
+        /// @brief Adds the oriented edges of `rings`, relative to the origin, to `out_edges` and builds the index.
+        void prepare(std::span<const ring_view> rings, segment_index& out_edges) const noexcept(false);
+        /// @brief Twice the shoelace integral over the pieces of `edges` inside `other` (plus shared pieces if requested).
+        double boundary_integral(const segment_index& edges, const segment_index& other, bool include_shared) noexcept(false);
+
+        static constexpr double relative_tolerance_ {1e-10}; /// Tolerance of the parallel/collinear tests.
+
+        double origin_x_ {};               /// Local origin (subject bbox minimum).
+        double origin_y_ {};               /// Local origin (subject bbox minimum).
+        double distance_tolerance_ {};     /// Collinearity tolerance, scaled by the subject extent.
+        segment_index subject_ {};         /// Oriented subject edges.
+        segment_index clip_ {};            /// Oriented clip edges.
+        std::vector<double> cuts_ {};      /// Cut parameters of the current edge.
+        std::vector<overlap> overlaps_ {}; /// Collinear overlaps of the current edge.
+    };
+
+    /// @brief Overlays a polygon FlatGeobuf layer (the UATs) with a second polygon layer (e.g. hazard zones) and writes the
+    /// intersection area of every intersecting (UAT, zone) pair as `uat_code,zone_id,area` rows.
+    /// Candidate pairs come from querying the zone layer's packed R-tree with each UAT's box (a linear scan if the zone
+    /// layer has no index); pairs are then processed in parallel, grouped by UAT so that each worker prepares a UAT once.
+    class polygon_overlay
+    {
+    public:
+        /// @brief Constructs the overlay.
+        /// @param input_fgb_path Path to the UAT FlatGeobuf file.
+        /// @param zones_fgb_path Path to the zone FlatGeobuf file (same CRS).
+        /// @param output_csv_path Path for the output CSV file.
+        /// @param num_threads Number of worker threads.
+        /// @param zone_id_column Zone property written as `zone_id`; the zone feature index is written if empty.
+        polygon_overlay(const std::string& input_fgb_path, const std::string& zones_fgb_path, const std::string& output_csv_path,
+                        std::uint32_t num_threads, const std::string& zone_id_column) noexcept(false);
+
+        /// @brief Runs the overlay and writes the result rows ordered by UAT, then zone.
+        /// @return True on success, false on controlled failure.
+        bool process() noexcept(false);
+
+    private:
+        /// @brief Finds the (UAT, zone) pairs whose bounding boxes intersect, sorted.
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> find_candidate_pairs() noexcept(false);
+        /// @brief Writes the pairs with a positive intersection area.
+        bool write_results(const std::vector<std::pair<std::uint32_t, std::uint32_t>>& pairs, const std::vector<double>& areas) const
+            noexcept(false);
+
+        static constexpr std::string_view expected_uat_code_column_ {"natcode"};
+        static constexpr std::size_t pairs_per_task_ {64u}; /// Candidate pairs per task (bounds the scratch of one worker).
+
+        const std::string output_csv_path_; /// Path to the output CSV file.
+        const std::string zone_id_column_;  /// Zone property written as `zone_id`.
+        thread_pool thread_pool_;           /// Thread pool for parallel processing.
+        fgb_dataset dataset_;               /// Mapped UAT layer.
+        fgb_dataset zones_;                 /// Mapped zone layer.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,84 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file polygon_rasterizer.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/types.hpp"
+    #include <cstdint>
+    #include <span>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Geometry of a regular, axis-aligned raster grid.
+    /// `origin_x`/`origin_y` is the outer corner of cell (row 0, column 0). A positive `cell_height` makes rows grow
+    /// northwards (south-up grids); a negative one makes them grow southwards (north-up images such as GeoTIFF/ENVI).
+    struct raster_grid
+    {
+        /// @brief X coordinate of the outer corner of cell (0, 0).
+        double origin_x {};
+        /// @brief Y coordinate of the outer corner of cell (0, 0).
+        double origin_y {};
+        /// @brief Cell width in CRS units (always positive).
+        double cell_width {1.0};
+        /// @brief Signed cell height in CRS units.
+        double cell_height {1.0};
+        /// @brief Number of columns.
+        std::uint32_t cols {};
+        /// @brief Number of rows.
+        std::uint32_t rows {};
+
+        /// @brief Total number of cells.
+        std::uint64_t cell_count() const noexcept { return static_cast<std::uint64_t>(cols) * rows; }
+        /// @brief Fractional column coordinate of `x` (cell `c` spans `[c, c + 1)`).
+        double column_of(const double x) const noexcept { return (x - origin_x) / cell_width; }
+        /// @brief Fractional row coordinate of `y` (cell `r` spans `[r, r + 1)`).
+        double row_of(const double y) const noexcept { return (y - origin_y) / cell_height; }
+    };
+
+    /// @brief A horizontal run of cells `[col_begin, col_end)` in one row.
+    struct cell_span
+    {
+        /// @brief Row of the run.
+        std::uint32_t row {};
+        /// @brief First column of the run.
+        std::uint32_t col_begin {};
+        /// @brief One past the last column of the run.
+        std::uint32_t col_end {};
+    };
+
+    /// @brief Rasterizes polygon rings onto a `raster_grid`.
+    /// An instance owns scratch buffers that are reused between calls, so each worker thread should keep its own.
+    class polygon_rasterizer
+    {
+    public:
+        /// @brief Scanline fill: finds the cells whose centres lie inside the rings (even-odd rule).
+        /// Edges are bucketed by the rows they cross, so the cost is proportional to the number of edge/row
+        /// crossings rather than rows times edges.
+        /// @param rings The rings of one feature.
+        /// @param grid The target grid; cells outside it are ignored.
+        /// @param[out] out_spans Receives the inside runs ordered by row, then column. It is cleared first.
+        void fill(std::span<const ring_view> rings, const raster_grid& grid, std::vector<cell_span>& out_spans) noexcept(false);
+
+        /// @brief Conservative boundary trace: finds every cell touched by at least one ring edge.
+        /// @param rings The rings of one feature.
+        /// @param grid The target grid; edges are clipped to it.
+        /// @param[out] out_cells Receives sorted, unique cell ids (`row * cols + col`). It is cleared first.
+        void trace(std::span<const ring_view> rings, const raster_grid& grid, std::vector<std::uint64_t>& out_cells) noexcept(false);
+
+    private:
+        /// @brief An edge crossing of a row centre line, in fractional column units.
+        struct crossing
+        {
+            std::uint32_t row {};
+            double column {};
+        };
+
+        /// @brief Walks the cells of one edge (fractional grid units) and appends their ids.
+        static void trace_segment(double u0, double v0, double u1, double v1, const raster_grid& grid,
+                                  std::vector<std::uint64_t>& out_cells) noexcept(false);
+
+        std::vector<crossing> crossings_ {}; /// Scratch buffer for the scanline fill.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,164 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file quadkey_covering.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/fgb_dataset.hpp"
+    #include "kmx/gis/segment_index.hpp"
+    #include "kmx/gis/types.hpp"
+    #include "kmx/thread_pool.hpp"
+    #include <array>
+    #include <cstdint>
+    #include <span>
+    #include <string>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Hierarchical quadtree cell ids over a square root domain.
+    /// Ids use the S2-style encoding: the Morton code of the cell at its level, left-aligned to `max_level`, followed by a
+    /// single marker bit. Sorting ids therefore lists every cell right before its descendants' range, and a cell contains
+    /// another if the other id lies in `[range_min(id), range_max(id)]`.
+    class quadkey
+    {
+    public:
+        /// @brief Deepest supported level (cells of `root_size / 2^30`).
+        static constexpr std::uint32_t max_level {30u};
+
+        /// @brief Builds the id of cell (x, y) at `level`, where x and y are in `[0, 2^level)`.
+        static std::uint64_t make_id(std::uint32_t level, std::uint32_t x, std::uint32_t y) noexcept;
+        /// @brief Level of a cell id.
+        static std::uint32_t level_of(std::uint64_t id) noexcept;
+        /// @brief Column and row of a cell id at its own level.
+        static std::pair<std::uint32_t, std::uint32_t> position_of(std::uint64_t id) noexcept;
+        /// @brief Smallest id of the cell's descendants (inclusive).
+        static std::uint64_t range_min(std::uint64_t id) noexcept;
+        /// @brief Largest id of the cell's descendants (inclusive).
+        static std::uint64_t range_max(std::uint64_t id) noexcept;
+        /// @brief Quadkey string with one digit per level, digit = x bit + 2 * y bit (y grows northwards).
+        static std::string to_string(std::uint64_t id) noexcept(false);
+    };
+
+    /// @brief Accuracy/cost knobs of a covering.
+    struct quadkey_covering_settings
+    {
+        /// @brief Deepest level boundary cells are refined to (accuracy).
+        std::uint32_t max_level {16u};
+        /// @brief Budget of cells per feature (cost). A level is only refined if the result then still fits; the smallest
+        /// cell enclosing the feature is always produced, even with a budget below four.
+        std::uint32_t max_cells {64u};
+    };
+
+    /// @brief One row of the covering table.
+    struct quadkey_cover_entry
+    {
+        /// @brief Cell id (see `quadkey`).
+        std::uint64_t cell_id {};
+        /// @brief Feature index in the source file.
+        std::uint32_t feature {};
+        /// @brief `interior_flag` if the cell lies entirely inside the feature, 0 for boundary cells.
+        std::uint32_t flags {};
+
+        static constexpr std::uint32_t interior_flag {1u};
+
+        bool operator<(const quadkey_cover_entry& other) const noexcept
+        {
+            return (cell_id != other.cell_id) ? (cell_id < other.cell_id) : (feature < other.feature);
+        }
+    };
+
+    /// @brief On-disk header of a binary covering table; `entry_count` `quadkey_cover_entry` rows follow it.
+    struct quadkey_cover_file_header
+    {
+        std::array<char, 8u> magic {};  /// File signature, `magic_value`.
+        std::uint32_t version {};       /// Format version, `current_version`.
+        std::uint32_t max_level {};     /// Max level used for the covering.
+        double root_origin_x {};        /// X of the south-west corner of the root cell.
+        double root_origin_y {};        /// Y of the south-west corner of the root cell.
+        double root_size {};            /// Side length of the root cell.
+        std::uint64_t entry_count {};   /// Number of rows.
+
+        static constexpr std::array<char, 8u> magic_value {'U', 'A', 'T', 'C', 'O', 'V', 'R', '\0'};
+        static constexpr std::uint32_t current_version {1u};
+    };
+
+    /// @brief Computes the quadtree covering of one polygon. Holds scratch buffers, so keep one per worker thread.
+    /// Candidate cells carry the subset of polygon edges crossing them; children only test their parent's edges, and
+    /// cells without edges are classified by a point-in-polygon test of their centre against a `segment_index`.
+    class quadkey_coverer
+    {
+    public:
+        /// @brief Constructs a coverer for a root domain.
+        /// @param root_origin_x X of the south-west corner of the root cell.
+        /// @param root_origin_y Y of the south-west corner of the root cell.
+        /// @param root_size Side length of the root cell.
+        /// @param settings Accuracy and cost limits.
+        quadkey_coverer(double root_origin_x, double root_origin_y, double root_size, const quadkey_covering_settings& settings) noexcept;
+
+        /// @brief Covers one feature and appends its cells to `out_entries`.
+        /// @param rings The rings of the feature.
+        /// @param feature The feature index recorded on each entry.
+        /// @param out_entries The table to append to.
+        void cover(std::span<const ring_view> rings, std::uint32_t feature, std::vector<quadkey_cover_entry>& out_entries) noexcept(false);
+
+    private:
+        /// @brief Extent of a cell.
+        struct cell_rect
+        {
+            double min_x, min_y, max_x, max_y;
+        };
+
+        /// @brief A cell awaiting classification, with its crossing edges in `[edges_begin, edges_end)` of the level pool.
+        struct candidate
+        {
+            std::uint32_t level, x, y;
+            std::size_t edges_begin, edges_end;
+        };
+
+        /// @brief Extent of a cell.
+        cell_rect cell_bounds(std::uint32_t level, std::uint32_t x, std::uint32_t y) const noexcept;
+        /// @brief Checks whether an edge touches a closed cell rectangle.
+        static bool edge_intersects(const line_segment& e, const cell_rect& cell) noexcept;
+
+        const double root_origin_x_;               /// X of the south-west corner of the root cell.
+        const double root_origin_y_;               /// Y of the south-west corner of the root cell.
+        const double root_size_;                   /// Side length of the root cell.
+        const quadkey_covering_settings settings_; /// Accuracy and cost limits.
+
+        segment_index edges_ {};                       /// Edges of the current feature.
+        std::vector<candidate> candidates_ {};         /// Candidates of the current level.
+        std::vector<candidate> next_candidates_ {};    /// Candidates of the next level.
+        std::vector<std::uint32_t> edge_pool_ {};      /// Edge lists of the current level.
+        std::vector<std::uint32_t> next_edge_pool_ {}; /// Edge lists of the next level.
+    };
+
+    /// @brief Computes coverings for all features of a polygon FlatGeobuf file in parallel and writes them as a table
+    /// sorted by cell id: binary (`quadkey_cover_file_header` + rows) by default, or CSV if the output ends in ".csv".
+    class quadkey_covering_builder
+    {
+    public:
+        /// @brief Constructs the builder.
+        /// @param input_fgb_path Path to the input FlatGeobuf file (must be Polygon or MultiPolygon).
+        /// @param output_path Path of the covering table to write.
+        /// @param num_threads Number of worker threads.
+        /// @param settings Accuracy and cost limits.
+        quadkey_covering_builder(const std::string& input_fgb_path, const std::string& output_path, std::uint32_t num_threads,
+                                 const quadkey_covering_settings& settings) noexcept(false);
+
+        /// @brief Covers all features and writes the table.
+        /// @return True on success, false on controlled failure.
+        bool build() noexcept(false);
+
+    private:
+        /// @brief Merges the per-task tables, each already sorted by its worker, into one sorted table.
+        std::vector<quadkey_cover_entry> sort_and_merge(std::vector<std::vector<quadkey_cover_entry>>& runs) noexcept(false);
+        /// @brief Writes the table in the format selected by the output path.
+        bool write_table(const std::vector<quadkey_cover_entry>& entries, const quadkey_cover_file_header& header) const noexcept(false);
+
+        const std::string output_path_;                 /// Path of the covering table.
+        const quadkey_covering_settings settings_;      /// Accuracy and cost limits.
+        thread_pool thread_pool_;                       /// Thread pool for parallel processing.
+        fgb_dataset dataset_;                           /// Mapped input file.
+    };
+
+} // namespace kmx::gis
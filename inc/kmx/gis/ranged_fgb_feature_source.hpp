@@ -0,0 +1,102 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file ranged_fgb_feature_source.hpp
+#pragma once
+#ifndef PCH
+    #include "flatgeobuf/feature_generated.h"
+    #include "kmx/gis/cached_reader.hpp"
+    #include "kmx/gis/feature_source.hpp"
+    #include <unordered_map>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief `feature_source` over a FlatGeobuf file read with partial reads through the shared block cache: `pread`
+    /// for local files, range requests for `http://` URLs.
+    /// Only the header is read up front. With `restrict_to`, the packed R-tree is walked with
+    /// `PackedRTree::streamSearch`, whose node reads go through the cache with the top levels pinned, and just the
+    /// matching features are read, neighbours sharing blocks and missing blocks loaded in parallel runs. Repeated
+    /// queries against the same file are then mostly served from memory. Without a window, the feature section is
+    /// read in large parallel ranges that bypass the cache.
+    class ranged_fgb_feature_source final: public feature_source
+    {
+    public:
+        /// @brief Reads and validates the header.
+        /// @param path A local path or an `http://` URL of a FlatGeobuf file.
+        /// @param pool Thread pool used for parallel reads; must outlive the source.
+        /// @param cache The shared block cache; must outlive the source.
+        /// @throws std::runtime_error If the file cannot be read or is not a FlatGeobuf file.
+        ranged_fgb_feature_source(const std::string& path, thread_pool& pool, block_cache& cache) noexcept(false);
+
+        void print_info() const noexcept(false) override;
+        std::string_view geometry_type_name() const noexcept override;
+        bool is_polygonal() const noexcept override;
+        std::uint64_t feature_count() const noexcept override;
+        std::vector<std::optional<std::size_t>> project(std::span<const std::string_view> names) noexcept(false) override;
+        /// @brief Walks the index and reads the matching features (all features if the file has no index).
+        bool restrict_to(const bounding_box& window) noexcept(false) override;
+        /// @brief Without a window, reads the feature section from `offset` on only.
+        bool seek(std::uint64_t position, std::uint64_t offset) noexcept(false) override;
+        /// @brief Makes a full read proceed in windows of `bytes` (at least one scan range) instead of reading the whole
+        /// feature section up front; each window is freed once `release` passes its features.
+        void limit_buffering(std::uint64_t bytes) noexcept(false) override;
+        void release(std::uint64_t position) noexcept(false) override;
+        /// @brief Bytes of the feature buffers not yet released.
+        std::uint64_t resident_bytes() const noexcept override { return buffered_bytes_; }
+        bool next_batch(feature_batch& batch, std::size_t max_features) noexcept(false) override;
+
+    private:
+        /// @brief A read feature.
+        struct read_feature
+        {
+            std::span<const std::uint8_t> bytes {}; /// Size-prefixed feature bytes (in `buffers_`).
+            std::uint64_t index {};                 /// Feature index in the file.
+            std::uint64_t offset {};                /// Offset of the feature, relative to the feature section.
+        };
+
+        /// @brief The effective type of a feature geometry (the header type when the geometry leaves it unset).
+        FlatGeobuf::GeometryType geometry_type_of(const FlatGeobuf::Geometry* geometry) const noexcept;
+        /// @brief Starts reading the feature section from `start` on (all of it, or the first window) and splits it into features.
+        /// @param start Offset of the first feature to read, relative to the feature section.
+        /// @param first_index Index of that feature.
+        void read_all_features(std::uint64_t start = 0u, std::uint64_t first_index = 0u) noexcept(false);
+        /// @brief Reads the next window of a full read.
+        /// @return False if no further feature was read.
+        bool read_window() noexcept(false);
+        /// @brief Marks a full read complete and reports it.
+        void finish_scan() noexcept(false);
+        /// @brief Reads the features at the given offsets (relative to the feature section), in index order.
+        void read_features(const std::vector<std::pair<std::uint64_t, std::uint64_t>>& hits) noexcept(false);
+        /// @brief `PackedRTree::streamSearch` callback: reads index bytes through the cache, pinning the top levels.
+        void read_index(std::uint8_t* buffer, std::size_t offset, std::size_t length) noexcept(false);
+        /// @brief Prints the read statistics of the pass that just finished.
+        void report_transfer(std::string_view what) const noexcept(false);
+
+        static constexpr std::size_t initial_read_size_ {64u * 1024u};     /// First read: magic bytes and header.
+        static constexpr std::size_t scan_read_size_ {8u * 1024u * 1024u};   /// Range size of a full feature scan.
+
+        std::unique_ptr<cached_reader> reader_;                            /// Partial reads of the file.
+        thread_pool& pool_;                                                /// Workers for parallel reads.
+        std::vector<std::uint8_t> header_bytes_ {};                        /// Magic bytes, header size and header table.
+        const FlatGeobuf::Header* header_ {};                              /// Parsed header (in `header_bytes_`).
+        std::uint64_t index_offset_ {};                                    /// Offset of the packed R-tree.
+        std::uint64_t index_size_ {};                                      /// Size of the packed R-tree (0 without index).
+        std::uint64_t pinned_index_size_ {};                               /// Bytes of the upper (non-leaf) index levels.
+        std::uint64_t features_offset_ {};                                 /// Offset of the first feature.
+        std::unordered_map<std::uint64_t, std::uint64_t> leaf_offsets_ {}; /// Leaf offsets seen while searching, by feature index.
+        std::vector<std::vector<std::uint8_t>> buffers_ {};                /// Read feature bytes.
+        std::vector<std::size_t> buffer_ends_ {};                          /// Features read up to each window of a full read.
+        std::size_t released_buffers_ {};                                  /// Windows freed by `release`.
+        std::uint64_t buffered_bytes_ {};                                  /// Bytes of the buffers not freed.
+        std::uint64_t scan_window_ {};                                     /// Window size of a full read (0: all at once).
+        std::uint64_t scan_offset_ {};                                     /// Next offset of a full read, in the feature section.
+        bool scan_done_ {};                                                /// True once a read has located all its features.
+        bool reported_ {};                                                 /// True once a full read was reported.
+        std::vector<read_feature> features_ {};                            /// Read features, in file order.
+        bool fetched_ {};                                                  /// True once features were read.
+        std::uint64_t skipped_ {};                                         /// Features before `start` of a resumed full read.
+        std::vector<std::optional<std::size_t>> columns_ {};               /// Projected column indices.
+        std::vector<ring_view> scratch_rings_ {};                          /// Rings of the current feature.
+        std::size_t next_feature_ {};                                      /// Next entry of `features_` to deliver.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,97 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file raster_dataset.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/mapped_file.hpp"
+    #include "kmx/gis/polygon_rasterizer.hpp"
+    #include <bit>
+    #include <cstdint>
+    #include <cstring>
+    #include <optional>
+    #include <string>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Pixel data types of ENVI rasters (values are the ENVI "data type" codes).
+    enum class raster_data_type : std::uint8_t
+    {
+        uint8 = 1u,
+        int16 = 2u,
+        int32 = 3u,
+        float32 = 4u,
+        float64 = 5u,
+        uint16 = 12u,
+        uint32 = 13u,
+        int64 = 14u,
+        uint64 = 15u,
+    };
+
+    /// @brief A memory-mapped single-band view of a raw (ENVI-style) raster.
+    /// The layout comes from the ENVI header next to the raster ("<raster>.hdr" or the raster path with its extension
+    /// replaced by ".hdr"): samples, lines, bands, data type, byte order, header offset, interleave and data ignore value.
+    /// The georeference is read from the header's "map info" or, if absent, from a world file ("<raster>.wld" or the
+    /// raster path with a ".wld"/".tfw" extension). Only the first band is exposed.
+    class raster_dataset
+    {
+    public:
+        /// @brief Maps the raster and parses its sidecar files.
+        /// @param raster_path Path to the raw raster file.
+        /// @throws std::runtime_error If the header or georeference is missing or invalid, or the file is too small.
+        explicit raster_dataset(const std::string& raster_path) noexcept(false);
+
+        /// @brief The pixel grid in the CRS of the georeference (north-up rasters have a negative cell height).
+        const raster_grid& grid() const noexcept { return grid_; }
+        /// @brief The pixel data type.
+        raster_data_type data_type() const noexcept { return data_type_; }
+        /// @brief The "data ignore value", if the header declares one.
+        std::optional<double> no_data() const noexcept { return no_data_; }
+        /// @brief True if the pixels are stored big-endian.
+        bool big_endian() const noexcept { return big_endian_; }
+        /// @brief Size in bytes of one pixel value.
+        static std::size_t size_of(raster_data_type type) noexcept;
+
+        /// @brief Address of pixel (row, col) of the first band.
+        const std::uint8_t* pixel_address(const std::uint32_t row, const std::uint32_t col) const noexcept
+        {
+            return pixels_ + static_cast<std::size_t>(row) * row_stride_ + static_cast<std::size_t>(col) * pixel_stride_;
+        }
+        /// @brief Byte distance between horizontally adjacent pixels.
+        std::size_t pixel_stride() const noexcept { return pixel_stride_; }
+
+        /// @brief Reads a pixel value of type `T` stored at `address` in the raster's byte order.
+        template <class T>
+        T read(const std::uint8_t* const address) const noexcept
+        {
+            if constexpr (sizeof(T) == 1u)
+                return static_cast<T>(*address);
+            else
+            {
+                using bits_type = std::conditional_t<sizeof(T) == 2u, std::uint16_t,
+                                                     std::conditional_t<sizeof(T) == 4u, std::uint32_t, std::uint64_t>>;
+                bits_type bits {};
+                std::memcpy(&bits, address, sizeof(bits));
+                if (big_endian_ != (std::endian::native == std::endian::big))
+                    bits = std::byteswap(bits);
+                return std::bit_cast<T>(bits);
+            }
+        }
+
+    private:
+        /// @brief Parses the ENVI header and sets layout, data type and (if present) the georeference.
+        /// @return True if the header carried a "map info" georeference.
+        bool parse_header(const std::string& raster_path) noexcept(false);
+        /// @brief Reads the georeference from a world file.
+        void parse_world_file(const std::string& raster_path) noexcept(false);
+
+        mapped_file file_;                      /// Mapped raster file.
+        raster_grid grid_ {};                   /// Pixel grid.
+        raster_data_type data_type_ {};         /// Pixel data type.
+        std::optional<double> no_data_ {};      /// Data ignore value.
+        bool big_endian_ {};                    /// Byte order of the pixels.
+        const std::uint8_t* pixels_ {};         /// First pixel of the first band.
+        std::size_t pixel_stride_ {};           /// Bytes between adjacent pixels of a row.
+        std::size_t row_stride_ {};             /// Bytes between adjacent rows.
+    };
+
+} // namespace kmx::gis
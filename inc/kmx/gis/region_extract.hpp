@@ -0,0 +1,63 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file region_extract.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/bounding_box.hpp"
+    #include "kmx/gis/fgb_dataset.hpp"
+    #include "kmx/gis/fgb_writer.hpp"
+    #include "kmx/gis/types.hpp"
+    #include "kmx/thread_pool.hpp"
+    #include <cstdint>
+    #include <span>
+    #include <string>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Writes the features of a polygon FlatGeobuf file that intersect a query window, clipped to it, as a new
+    /// indexed FlatGeobuf file with the schema of the input.
+    /// Candidates come from the packed R-tree; features whose box lies inside the window are copied as raw bytes without
+    /// being decoded, the others are clipped polygon by polygon (`ring_clipper`) in parallel and re-encoded with their
+    /// property blobs copied byte for byte. Features left without area are dropped. A polygon that the window cuts into
+    /// pieces becomes a MultiPolygon, so a Polygon file with such a feature is written as a MultiPolygon file.
+    class region_extract
+    {
+    public:
+        /// @brief Constructs the extractor.
+        /// @param input_fgb_path Path to the input FlatGeobuf file.
+        /// @param output_fgb_path Path for the output FlatGeobuf file.
+        /// @param num_threads Number of worker threads.
+        /// @param window The query window, in the CRS of the input.
+        region_extract(const std::string& input_fgb_path, const std::string& output_fgb_path, std::uint32_t num_threads,
+                       const bounding_box& window) noexcept(false);
+
+        /// @brief Runs the extraction and writes the output file.
+        /// @return True on success, false on controlled failure.
+        bool extract() noexcept(false);
+
+    private:
+        /// @brief Per-task scratch buffers.
+        struct clip_scratch;
+
+        /// @brief Clips the candidate features in parallel into `entries`, with the re-encoded ones kept in `clipped_bytes`.
+        /// @param multi_output True if the output is a MultiPolygon file.
+        /// @return True if a feature has to be a MultiPolygon although `multi_output` is false (it is then left empty).
+        bool clip_candidates(std::span<const std::uint64_t> candidates, bool multi_output, std::vector<fgb_feature_entry>& entries,
+                             std::vector<std::vector<std::uint8_t>>& clipped_bytes) noexcept(false);
+
+        /// @brief Clips feature `index` to the window and re-encodes it.
+        /// @param multi_output True if the output is a MultiPolygon file.
+        /// @param[out] out_bytes The size-prefixed feature, left empty if nothing of the feature remains.
+        /// @param[out] needs_multi Set if the clipped feature has several polygons but `multi_output` is false.
+        /// @return The extent of the clipped geometry.
+        bounding_box clip_feature(std::uint64_t index, bool multi_output, clip_scratch& scratch, std::vector<std::uint8_t>& out_bytes,
+                                  bool& needs_multi) const noexcept(false);
+
+        const std::string output_fgb_path_; /// Path to the output FlatGeobuf file.
+        const bounding_box window_;         /// The query window.
+        thread_pool thread_pool_;           /// Thread pool for parallel processing.
+        fgb_dataset dataset_;               /// Mapped input file.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,107 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file result_sorter.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/types.hpp"
+    #include "kmx/thread_pool.hpp"
+    #include <cstddef>
+    #include <cstdint>
+    #include <optional>
+    #include <ostream>
+    #include <string>
+    #include <string_view>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief A field of the bbox output to sort by.
+    enum class result_sort_field : std::uint8_t
+    {
+        name,     /// UAT name, collated (case and Romanian diacritics folded first, then bytewise).
+        uat_code, /// UAT code.
+        county,   /// County code.
+        area,     /// Bounding box area (invalid boxes last).
+    };
+
+    /// @brief The sort order of the bbox output (`--sort-by <field>[,<field>...]`); ties keep the input order.
+    struct result_sort_spec
+    {
+        std::vector<result_sort_field> fields {}; /// Fields by priority (empty: input order).
+
+        /// @brief True if the output is sorted at all.
+        bool is_sorted() const noexcept { return !fields.empty(); }
+
+        /// @brief Parses a comma separated list of "name", "uat_code", "county" and "area" (or the CSV column names).
+        /// @return The spec, or `std::nullopt` if a field is unknown.
+        static std::optional<result_sort_spec> parse(std::string_view text) noexcept(false);
+    };
+
+    /// @brief Sorts the bbox results on their way to the output, spilling sorted runs to disk beyond a memory budget.
+    /// Every result gets a binary key that compares with `memcmp` (fields in order, then the input position), so the
+    /// runs merge without knowing the fields. A buffer is sorted in parallel slices that are merged through a
+    /// `tournament_tree`: an LSD radix sort for a single integer or double field, a key comparison otherwise.
+    /// When the buffer exceeds the budget it is written as a run next to the output; at the end the runs are merged
+    /// with one sequential pass over each.
+    class result_sorter
+    {
+    public:
+        /// @brief Constructs the sorter.
+        /// @param spec The sort order (must be sorted).
+        /// @param pool Workers for sorting the slices; must outlive the sorter.
+        /// @param memory_budget Bytes of results held before a run is spilled.
+        /// @param run_path_prefix Runs are written to `<prefix>.<n>`.
+        result_sorter(result_sort_spec spec, thread_pool& pool, std::uint64_t memory_budget, std::string run_path_prefix) noexcept(false);
+        /// @brief Removes the remaining runs. `noexcept` is ensured.
+        ~result_sorter() noexcept;
+
+        result_sorter(const result_sorter&) = delete;
+        result_sorter& operator=(const result_sorter&) = delete;
+        result_sorter(result_sorter&&) = delete;
+        result_sorter& operator=(result_sorter&&) = delete;
+
+        static constexpr std::uint64_t default_memory_budget {512u * 1024u * 1024u}; /// Default `--sort-memory`.
+
+        /// @brief Adds the next result (in input order), spilling a run if the budget is exceeded.
+        void add(task_result&& result) noexcept(false);
+        /// @brief Approximate bytes of the results held in memory (not yet spilled).
+        std::uint64_t buffered_bytes() const noexcept { return buffered_bytes_; }
+        /// @brief Writes all results in sorted order as bbox CSV rows (without the header).
+        void write(std::ostream& out) noexcept(false);
+
+    private:
+        /// @brief A buffered result and its key.
+        struct entry
+        {
+            std::string key {};    /// `memcmp`-comparable key.
+            task_result result {}; /// The result.
+        };
+
+        /// @brief Appends the key of `result` at input position `position` to `key`.
+        void encode_key(const task_result& result, std::uint64_t position, std::string& key) const noexcept(false);
+        /// @brief Sorts the buffer in parallel slices.
+        /// @return The buffer indices in sorted order.
+        std::vector<std::uint32_t> sort_buffer() noexcept(false);
+        /// @brief Sorts the slice `[begin, end)` of `order` by the numeric key prefix with an LSD radix sort.
+        void radix_sort(std::uint32_t* begin, std::uint32_t* end) const noexcept(false);
+        /// @brief Sorts the buffer and writes it as a new run.
+        void spill() noexcept(false);
+        /// @brief Merges the runs into `out`.
+        void merge_runs(std::ostream& out) noexcept(false);
+
+        static constexpr std::size_t min_slice_size_ {4096u};          /// Smallest slice sorted by one task.
+        static constexpr std::size_t min_buffer_size_ {64u * 1024u};   /// Smallest read buffer per run.
+        static constexpr std::size_t max_buffer_size_ {8u * 1024u * 1024u}; /// Largest read buffer per run.
+
+        const result_sort_spec spec_;          /// The sort order.
+        thread_pool& pool_;                    /// Workers for the slices.
+        const std::uint64_t memory_budget_;    /// Bytes held before spilling.
+        const std::string run_path_prefix_;    /// Prefix of the run paths.
+        std::size_t numeric_key_size_ {};      /// Bytes of a single numeric field (0 if the radix sort does not apply).
+        std::vector<entry> buffer_ {};         /// Results not yet spilled.
+        std::uint64_t buffered_bytes_ {};      /// Approximate memory held by `buffer_`.
+        std::uint64_t next_position_ {};       /// Input position of the next result.
+        std::vector<std::string> run_paths_ {}; /// Spilled runs.
+    };
+
+} // namespace kmx::gis
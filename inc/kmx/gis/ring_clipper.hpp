@@ -0,0 +1,483 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file ring_clipper.hpp
+#pragma once
+#ifndef PCH
+    #include <algorithm>
+    #include <array>
+    #include <cmath>
+    #include <cstdint>
+    #include <span>
+    #include <utility>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Polygons produced by a `ring_clipper`: rings concatenated, grouped into polygons.
+    /// Rings are implicitly closed (the first vertex is not repeated). The first ring of every polygon is its exterior,
+    /// with a positive signed area (counter-clockwise when y points up); the holes that follow have a negative one.
+    template <class P>
+    struct clipped_polygons
+    {
+        std::vector<P> points {};                   /// Vertices of all rings.
+        std::vector<std::uint32_t> ring_ends {};    /// End of every ring in `points`.
+        std::vector<std::uint32_t> polygon_ends {}; /// End of every polygon in `ring_ends`.
+
+        /// @brief Removes all polygons, keeping the allocated buffers.
+        void clear() noexcept
+        {
+            points.clear();
+            ring_ends.clear();
+            polygon_ends.clear();
+        }
+
+        /// @brief Number of polygons.
+        std::size_t polygon_count() const noexcept { return polygon_ends.size(); }
+        /// @brief Index of the exterior ring of polygon `polygon`; its rings end at `polygon_ends[polygon]`.
+        std::size_t first_ring(const std::size_t polygon) const noexcept { return (polygon == 0u) ? 0u : polygon_ends[polygon - 1u]; }
+        /// @brief The vertices of ring `r`.
+        std::span<const P> ring(const std::size_t r) const noexcept
+        {
+            const std::size_t begin {(r == 0u) ? 0u : ring_ends[r - 1u]};
+            return std::span<const P> {points}.subspan(begin, ring_ends[r] - begin);
+        }
+    };
+
+    /// @brief Clips polygons against an axis-aligned rectangle into valid polygons.
+    /// The rings of a polygon (its exterior, then its holes) are oriented so that the interior lies to their left, then
+    /// cut into the pieces that run inside the rectangle, each from the point where its ring enters the rectangle to
+    /// the point where it leaves it. The output rings follow a piece to its exit, the rectangle border counter-clockwise
+    /// to the nearest entry (taking the corners passed on the way), and the piece starting there, until they close. A
+    /// ring that leaves and re-enters the rectangle therefore yields separate polygons, not one ring joined by
+    /// zero-width bridges along the border, and a hole crossing the border becomes a notch of its exterior. Rings
+    /// inside the rectangle are kept whole (holes go to the output polygon containing them); when no ring crosses the
+    /// border and the rectangle lies inside the polygon, the rectangle itself is the result. The point type only needs
+    /// aggregate `x` and `y` members.
+    template <class P>
+    class ring_clipper
+    {
+    public:
+        /// @brief Sets the rectangle [min_x, max_x] x [min_y, max_y].
+        void set_rectangle(const double min_x, const double min_y, const double max_x, const double max_y) noexcept
+        {
+            min_x_ = min_x;
+            min_y_ = min_y;
+            max_x_ = max_x;
+            max_y_ = max_y;
+            width_ = max_x - min_x;
+            height_ = max_y - min_y;
+            perimeter_ = 2.0 * (width_ + height_);
+        }
+
+        /// @brief Starts a polygon; its rings follow with `add_point` and `end_ring`, the exterior first.
+        void begin_polygon() noexcept
+        {
+            input_.clear();
+            input_ends_.clear();
+        }
+
+        /// @brief Adds a vertex to the current ring.
+        void add_point(const double x, const double y) noexcept(false) { input_.push_back(P {x, y}); }
+
+        /// @brief Ends the current ring; a repeated first vertex is dropped.
+        void end_ring() noexcept(false)
+        {
+            const std::size_t begin {input_ends_.empty() ? 0u : input_ends_.back()};
+            if (((input_.size() - begin) > 1u) && same(input_[begin], input_.back()))
+                input_.pop_back();
+            input_ends_.push_back(static_cast<std::uint32_t>(input_.size()));
+        }
+
+        /// @brief Clips the current polygon and appends the resulting polygons to `out` (none if nothing remains).
+        void clip_polygon(clipped_polygons<P>& out) noexcept(false)
+        {
+            piece_points_.clear();
+            piece_ends_.clear();
+            piece_entries_.clear();
+            piece_exits_.clear();
+            inside_rings_.clear();
+            outside_rings_.clear();
+            rings_.clear();
+            ring_ends_.clear();
+
+            for (std::size_t r {}; r < input_ends_.size(); ++r)
+            {
+                const std::size_t begin {(r == 0u) ? 0u : input_ends_[r - 1u]};
+                const std::size_t n {input_ends_[r] - begin};
+                const double area2 {(n < 3u) ? 0.0 : signed_area2(std::span<const P> {input_}.subspan(begin, n))};
+                if (area2 == 0.0)
+                {
+                    if (r == 0u) // Holes of a dropped exterior ring are dropped with it
+                        return;
+                    continue;
+                }
+                // Exteriors counter-clockwise and holes clockwise put the interior to the left of every edge
+                const ring_ref ring {begin, n, (r == 0u) == (area2 < 0.0)};
+                switch (trace_ring(ring))
+                {
+                    case ring_state::inside: inside_rings_.push_back({ring, r == 0u}); break;
+                    case ring_state::outside: outside_rings_.push_back(ring); break;
+                    case ring_state::crossing: break;
+                }
+            }
+
+            connect_pieces();
+            if (piece_ends_.empty())
+            {
+                // No ring crosses the border: the exterior lies inside the rectangle, or the rectangle inside the polygon,
+                // or they are disjoint. The center is off every outside ring, so the even-odd rule decides.
+                if (!inside_rings_.empty() && inside_rings_.front().is_exterior)
+                    append_ring(rings_, ring_ends_, inside_rings_.front().ring);
+                else if (contains_center())
+                {
+                    for (const P& corner: corners())
+                        rings_.push_back(corner);
+                    ring_ends_.push_back(static_cast<std::uint32_t>(rings_.size()));
+                }
+            }
+
+            // Every exterior takes the holes inside it
+            hole_used_.assign(inside_rings_.size(), 0u);
+            for (std::size_t e {}; e < ring_ends_.size(); ++e)
+            {
+                const std::size_t begin {(e == 0u) ? 0u : ring_ends_[e - 1u]};
+                const std::span<const P> exterior {std::span<const P> {rings_}.subspan(begin, ring_ends_[e] - begin)};
+                out.points.insert(out.points.end(), exterior.begin(), exterior.end());
+                out.ring_ends.push_back(static_cast<std::uint32_t>(out.points.size()));
+                for (std::size_t h {}; h < inside_rings_.size(); ++h)
+                {
+                    const inside_ring& hole {inside_rings_[h]};
+                    if (hole.is_exterior || hole_used_[h] || !contains(exterior, vertex(hole.ring, 0u)))
+                        continue;
+                    hole_used_[h] = 1u;
+                    append_ring(out.points, out.ring_ends, hole.ring);
+                }
+                out.polygon_ends.push_back(static_cast<std::uint32_t>(out.ring_ends.size()));
+            }
+        }
+
+        /// @brief Twice the signed area of a ring (positive if counter-clockwise when y points up).
+        static double signed_area2(const std::span<const P> ring) noexcept
+        {
+            double area2 {};
+            for (std::size_t i {}, j {ring.size() - 1u}; i < ring.size(); j = i++)
+                area2 += ring[j].x * ring[i].y - ring[i].x * ring[j].y;
+            return area2;
+        }
+
+    private:
+        /// @brief An input ring, in the orientation of the clipping.
+        struct ring_ref
+        {
+            std::size_t begin {};  /// First vertex in `input_`.
+            std::size_t size {};   /// Vertex count.
+            bool reversed {};      /// Traversed from the last vertex to the first.
+        };
+
+        /// @brief An input ring within the rectangle.
+        struct inside_ring
+        {
+            ring_ref ring {};     /// The ring.
+            bool is_exterior {};  /// True for the exterior of the polygon.
+        };
+
+        /// @brief Where an input ring lies relative to the rectangle.
+        enum class ring_state : std::uint8_t
+        {
+            inside,   /// Within the rectangle (its border included).
+            outside,  /// Off the interior of the rectangle.
+            crossing, /// Cut into pieces.
+        };
+
+        /// @brief The part of a segment within the rectangle (Liang-Barsky).
+        struct segment_clip
+        {
+            double t0 {};   /// Parameter of the entry point.
+            double t1 {};   /// Parameter of the exit point.
+            P entry {};     /// Entry point, on the border if `t0 > 0`.
+            P exit {};      /// Exit point, on the border if `t1 < 1`.
+        };
+
+        static bool same(const P& a, const P& b) noexcept { return (a.x == b.x) && (a.y == b.y); }
+
+        bool inside(const P& p) const noexcept { return (p.x >= min_x_) && (p.x <= max_x_) && (p.y >= min_y_) && (p.y <= max_y_); }
+
+        const P& vertex(const ring_ref& ring, const std::size_t i) const noexcept
+        {
+            const std::size_t k {i % ring.size};
+            return input_[ring.begin + (ring.reversed ? (ring.size - 1u - k) : k)];
+        }
+
+        std::array<P, 4u> corners() const noexcept
+        {
+            return {P {min_x_, min_y_}, P {max_x_, min_y_}, P {max_x_, max_y_}, P {min_x_, max_y_}};
+        }
+
+        /// @brief Position of a border point along the perimeter, counter-clockwise from (min_x, min_y).
+        double border_position(const P& p) const noexcept
+        {
+            const double left {p.x - min_x_}, right {max_x_ - p.x}, bottom {p.y - min_y_}, top {max_y_ - p.y};
+            const double nearest {std::min({std::abs(left), std::abs(right), std::abs(bottom), std::abs(top)})};
+            if (nearest == std::abs(bottom))
+                return std::clamp(left, 0.0, width_);
+            if (nearest == std::abs(right))
+                return width_ + std::clamp(bottom, 0.0, height_);
+            if (nearest == std::abs(top))
+                return width_ + height_ + std::clamp(right, 0.0, width_);
+            const double position {2.0 * width_ + height_ + std::clamp(top, 0.0, height_)};
+            return (position >= perimeter_) ? (position - perimeter_) : position;
+        }
+
+        /// @brief Counter-clockwise distance along the border from `from` to `to`.
+        double border_distance(const double from, const double to) const noexcept
+        {
+            const double distance {to - from};
+            return (distance < 0.0) ? (distance + perimeter_) : distance;
+        }
+
+        /// @brief Clips the segment a-b; the crossing points are snapped onto the border they cross.
+        bool clip_segment(const P& a, const P& b, segment_clip& clip) const noexcept
+        {
+            const double dx {b.x - a.x};
+            const double dy {b.y - a.y};
+            clip.t0 = 0.0;
+            clip.t1 = 1.0;
+            int entry_side {-1};
+            int exit_side {-1};
+            // Side s keeps the points where p * t <= q: 0 left, 1 right, 2 bottom, 3 top
+            const std::array<double, 4u> p {-dx, dx, -dy, dy};
+            const std::array<double, 4u> q {a.x - min_x_, max_x_ - a.x, a.y - min_y_, max_y_ - a.y};
+            for (int s {}; s < 4; ++s)
+            {
+                if (p[s] == 0.0)
+                {
+                    if (q[s] < 0.0)
+                        return false;
+                    continue;
+                }
+                const double t {q[s] / p[s]};
+                if (p[s] < 0.0)
+                {
+                    if (t > clip.t1)
+                        return false;
+                    if (t > clip.t0)
+                    {
+                        clip.t0 = t;
+                        entry_side = s;
+                    }
+                }
+                else
+                {
+                    if (t < clip.t0)
+                        return false;
+                    if (t < clip.t1)
+                    {
+                        clip.t1 = t;
+                        exit_side = s;
+                    }
+                }
+            }
+            clip.entry = on_side(a, dx, dy, clip.t0, entry_side);
+            clip.exit = on_side(a, dx, dy, clip.t1, exit_side);
+            return true;
+        }
+
+        P on_side(const P& a, const double dx, const double dy, const double t, const int side) const noexcept
+        {
+            const double x {std::clamp(a.x + t * dx, min_x_, max_x_)};
+            const double y {std::clamp(a.y + t * dy, min_y_, max_y_)};
+            switch (side)
+            {
+                case 0: return P {min_x_, y};
+                case 1: return P {max_x_, y};
+                case 2: return P {x, min_y_};
+                case 3: return P {x, max_y_};
+                default: return P {a.x + t * dx, a.y + t * dy};
+            }
+        }
+
+        void push_piece_point(const P& p) noexcept(false)
+        {
+            const std::size_t begin {piece_ends_.empty() ? 0u : piece_ends_.back()};
+            if ((piece_points_.size() == begin) || !same(piece_points_.back(), p))
+                piece_points_.push_back(p);
+        }
+
+        void open_piece(const P& entry) noexcept(false)
+        {
+            piece_points_.resize(piece_ends_.empty() ? 0u : piece_ends_.back());
+            push_piece_point(entry);
+            open_entry_ = border_position(entry);
+        }
+
+        /// @brief Ends the open piece at `exit`; a piece that only touches the border is discarded.
+        void close_piece(const P& exit) noexcept(false)
+        {
+            push_piece_point(exit);
+            const std::size_t begin {piece_ends_.empty() ? 0u : piece_ends_.back()};
+            if ((piece_points_.size() - begin) < 2u)
+            {
+                piece_points_.resize(begin);
+                return;
+            }
+            piece_ends_.push_back(static_cast<std::uint32_t>(piece_points_.size()));
+            piece_entries_.push_back(open_entry_);
+            piece_exits_.push_back(border_position(exit));
+        }
+
+        /// @brief Cuts a ring into its pieces inside the rectangle, starting at a vertex outside it.
+        ring_state trace_ring(const ring_ref& ring) noexcept(false)
+        {
+            std::size_t start {ring.size};
+            for (std::size_t i {}; i < ring.size; ++i)
+                if (!inside(vertex(ring, i)))
+                {
+                    start = i;
+                    break;
+                }
+            if (start == ring.size)
+                return ring_state::inside;
+
+            const std::size_t pieces_before {piece_ends_.size()};
+            segment_clip clip {};
+            for (std::size_t k {}; k < ring.size; ++k)
+            {
+                const P& a {vertex(ring, start + k)};
+                const P& b {vertex(ring, start + k + 1u)};
+                const bool a_inside {inside(a)};
+                const bool b_inside {inside(b)};
+                if (a_inside && b_inside)
+                    push_piece_point(b);
+                else if (!clip_segment(a, b, clip))
+                    continue;
+                else if (a_inside)
+                    close_piece(clip.exit);
+                else if (b_inside)
+                {
+                    open_piece(clip.entry);
+                    push_piece_point(b);
+                }
+                else if (clip.t0 < clip.t1)
+                {
+                    // A chord through the interior; one running along the border encloses nothing
+                    const P middle {(clip.entry.x + clip.exit.x) / 2.0, (clip.entry.y + clip.exit.y) / 2.0};
+                    if ((middle.x > min_x_) && (middle.x < max_x_) && (middle.y > min_y_) && (middle.y < max_y_))
+                    {
+                        open_piece(clip.entry);
+                        close_piece(clip.exit);
+                    }
+                }
+            }
+            return (piece_ends_.size() > pieces_before) ? ring_state::crossing : ring_state::outside;
+        }
+
+        /// @brief Joins the pieces along the border into the exterior rings `rings_`.
+        void connect_pieces() noexcept(false)
+        {
+            const std::size_t count {piece_ends_.size()};
+            visited_.assign(count, 0u);
+            for (std::size_t first {}; first < count; ++first)
+            {
+                if (visited_[first])
+                    continue;
+                const std::size_t ring_begin {rings_.size()};
+                for (std::size_t j {first};;)
+                {
+                    visited_[j] = 1u;
+                    const std::size_t begin {(j == 0u) ? 0u : piece_ends_[j - 1u]};
+                    for (std::size_t i {begin}; i < piece_ends_[j]; ++i)
+                        if ((rings_.size() == ring_begin) || !same(rings_.back(), piece_points_[i]))
+                            rings_.push_back(piece_points_[i]);
+
+                    // The nearest entry counter-clockwise; closing the ring wins ties
+                    const double exit {piece_exits_[j]};
+                    std::size_t next {first};
+                    double nearest {border_distance(exit, piece_entries_[first])};
+                    for (std::size_t k {}; k < count; ++k)
+                        if (!visited_[k] && (border_distance(exit, piece_entries_[k]) < nearest))
+                        {
+                            nearest = border_distance(exit, piece_entries_[k]);
+                            next = k;
+                        }
+                    append_corners(exit, nearest);
+                    if (next == first)
+                        break;
+                    j = next;
+                }
+
+                const std::span<const P> ring {std::span<const P> {rings_}.subspan(ring_begin)};
+                if ((ring.size() > 1u) && same(ring.front(), ring.back()))
+                    rings_.pop_back();
+                if ((rings_.size() - ring_begin < 3u) || !(signed_area2(std::span<const P> {rings_}.subspan(ring_begin)) > 0.0))
+                    rings_.resize(ring_begin); // Pieces that only run along the border enclose nothing
+                else
+                    ring_ends_.push_back(static_cast<std::uint32_t>(rings_.size()));
+            }
+        }
+
+        /// @brief Appends the corners passed from border position `from` over `distance`, in order.
+        void append_corners(const double from, const double distance) noexcept(false)
+        {
+            const std::array<P, 4u> points {corners()};
+            const std::array<double, 4u> positions {0.0, width_, width_ + height_, 2.0 * width_ + height_};
+            std::array<std::pair<double, std::size_t>, 4u> passed {};
+            std::size_t count {};
+            for (std::size_t c {}; c < 4u; ++c)
+            {
+                const double d {border_distance(from, positions[c])};
+                if ((d > 0.0) && (d < distance))
+                    passed[count++] = {d, c};
+            }
+            std::sort(passed.begin(), passed.begin() + static_cast<std::ptrdiff_t>(count));
+            for (std::size_t i {}; i < count; ++i)
+                rings_.push_back(points[passed[i].second]);
+        }
+
+        void append_ring(std::vector<P>& points, std::vector<std::uint32_t>& ends, const ring_ref& ring) const noexcept(false)
+        {
+            for (std::size_t i {}; i < ring.size; ++i)
+                points.push_back(vertex(ring, i));
+            ends.push_back(static_cast<std::uint32_t>(points.size()));
+        }
+
+        /// @brief Even-odd test of the rectangle center against the rings outside the rectangle.
+        bool contains_center() const noexcept
+        {
+            const P center {(min_x_ + max_x_) / 2.0, (min_y_ + max_y_) / 2.0};
+            bool inside_polygon {};
+            for (const ring_ref& ring: outside_rings_)
+                if (contains(std::span<const P> {input_}.subspan(ring.begin, ring.size), center))
+                    inside_polygon = !inside_polygon;
+            return inside_polygon;
+        }
+
+        /// @brief Even-odd point in ring test.
+        static bool contains(const std::span<const P> ring, const P& p) noexcept
+        {
+            bool inside_ring {};
+            for (std::size_t i {}, j {ring.size() - 1u}; i < ring.size(); j = i++)
+                if (((ring[i].y > p.y) != (ring[j].y > p.y)) &&
+                    (p.x < (ring[j].x - ring[i].x) * (p.y - ring[i].y) / (ring[j].y - ring[i].y) + ring[i].x))
+                    inside_ring = !inside_ring;
+            return inside_ring;
+        }
+
+        double min_x_ {}, min_y_ {}, max_x_ {}, max_y_ {}; /// The rectangle.
+        double width_ {}, height_ {}, perimeter_ {};       /// Its extent along the border.
+
+        std::vector<P> input_ {};                   /// Vertices of the rings of the current polygon.
+        std::vector<std::uint32_t> input_ends_ {};  /// End of every ring in `input_`.
+        std::vector<P> piece_points_ {};            /// Vertices of the pieces inside the rectangle.
+        std::vector<std::uint32_t> piece_ends_ {};  /// End of every piece in `piece_points_`.
+        std::vector<double> piece_entries_ {};      /// Border position where every piece starts.
+        std::vector<double> piece_exits_ {};        /// Border position where every piece ends.
+        double open_entry_ {};                      /// Border position where the open piece starts.
+        std::vector<std::uint8_t> visited_ {};      /// Pieces already in an output ring.
+        std::vector<inside_ring> inside_rings_ {};  /// Rings within the rectangle.
+        std::vector<ring_ref> outside_rings_ {};    /// Rings off the rectangle interior.
+        std::vector<std::uint8_t> hole_used_ {};    /// Holes already given to an exterior.
+        std::vector<P> rings_ {};                   /// Output exteriors of the current polygon.
+        std::vector<std::uint32_t> ring_ends_ {};   /// End of every exterior in `rings_`.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,59 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file run_checkpoint.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/bounding_box.hpp"
+    #include "kmx/gis/shard_plan.hpp"
+    #include <cstdint>
+    #include <string>
+    #include <string_view>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Checkpointing of a bbox run (`--checkpoint <seconds>`, `--resume`).
+    struct checkpoint_settings
+    {
+        std::uint32_t interval_seconds {}; /// Seconds between checkpoints (0: no checkpoints).
+        bool resume {};                    /// Continue from the checkpoint of the output, if there is one.
+
+        static constexpr std::uint32_t default_interval_seconds {60u}; /// Interval used by `--resume` alone.
+
+        /// @brief True if checkpoints are written.
+        bool is_enabled() const noexcept { return interval_seconds > 0u; }
+    };
+
+    /// @brief The progress of a bbox run, written next to its output as `<output>.checkpoint`.
+    /// The output up to `output_offset` holds exactly the rows of the first `features` features, and the input can be
+    /// read on from `input_offset`; a resumed run truncates the output there and seeks its source instead of starting
+    /// over. The bbox rows are written in input order, so there are no partial aggregates beyond these counters.
+    /// The file is replaced atomically (written aside, then renamed), so an interrupted run leaves either the previous
+    /// or the new checkpoint behind, never a torn one.
+    struct run_checkpoint
+    {
+        std::string input {};           /// Input path, as given on the command line.
+        std::uint64_t input_size {};    /// Size of the input in bytes (0 for URLs), to detect a changed input.
+        shard_spec shard {};            /// The shard of the run.
+        std::string window {};          /// The window of the run (`format_window`).
+        std::uint64_t features {};      /// Number of features of the (restricted) input whose rows were written.
+        std::uint64_t input_offset {};  /// Input offset just past those features (`feature_batch::end_offset`).
+        std::uint64_t output_offset {}; /// Size of the output holding their rows.
+
+        /// @brief Path of the checkpoint of the output `output_path`.
+        static std::string path_for(const std::string& output_path) { return output_path + ".checkpoint"; }
+
+        /// @brief Formats a window so that it compares exactly after a round trip ("none" if invalid).
+        static std::string format_window(const bounding_box& window) noexcept(false);
+
+        /// @brief Replaces the checkpoint at `path` atomically.
+        /// @throws std::runtime_error If the file cannot be written.
+        void write(const std::string& path) const noexcept(false);
+        /// @brief Reads a checkpoint written by `write`.
+        /// @throws std::runtime_error If the file cannot be read or a key is missing or malformed.
+        static run_checkpoint read(const std::string& path) noexcept(false);
+
+    private:
+        static constexpr std::string_view signature_ {"uat_bbox checkpoint 1"}; /// First line of every checkpoint.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,67 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file segment_index.hpp
+#pragma once
+#ifndef PCH
+    #include <algorithm>
+    #include <cstdint>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief A directed line segment.
+    struct line_segment
+    {
+        double x0, y0, x1, y1;
+    };
+
+    /// @brief The edges of one polygon, bucketed into horizontal bands so that point-in-polygon tests and segment queries
+    /// only scan the edges near the query. Keeps its buffers between polygons, so keep one per worker thread.
+    class segment_index
+    {
+    public:
+        /// @brief Removes all segments.
+        void clear() noexcept { segments_.clear(); }
+        /// @brief Adds a segment; `build` must be called before querying.
+        void add(const line_segment& segment) noexcept(false) { segments_.push_back(segment); }
+        /// @brief Buckets the segments added so far into bands (CSR layout) and computes their extent.
+        void build() noexcept(false);
+
+        /// @brief The segments in insertion order.
+        const std::vector<line_segment>& segments() const noexcept { return segments_; }
+        /// @brief True if the index holds no segment.
+        bool empty() const noexcept { return segments_.empty(); }
+        /// @brief Extent of the segments (valid after `build`).
+        double min_x() const noexcept { return min_x_; }
+        double min_y() const noexcept { return min_y_; }
+        double max_x() const noexcept { return max_x_; }
+        double max_y() const noexcept { return max_y_; }
+
+        /// @brief Even-odd point-in-polygon test against the indexed edges.
+        bool contains(double x, double y) const noexcept;
+
+        /// @brief Calls `f(segment_index)` for every segment of the bands overlapping `[y0, y1]`.
+        /// A segment spanning several bands is reported once per band.
+        template <class F>
+        void visit(const double y0, const double y1, F&& f) const
+        {
+            if (segments_.empty() || (y1 < min_y_) || (y0 > max_y_))
+                return;
+            for (std::uint32_t b {band_of(y0)}, last {band_of(y1)}; b <= last; ++b)
+                for (std::uint32_t k {band_offsets_[b]}; k < band_offsets_[b + 1u]; ++k)
+                    f(band_segments_[k]);
+        }
+
+    private:
+        /// @brief Band holding `y`, clamped to the valid bands.
+        std::uint32_t band_of(double y) const noexcept;
+
+        std::vector<line_segment> segments_ {};          /// Indexed segments.
+        std::vector<std::uint32_t> band_offsets_ {};     /// CSR offsets of the bands.
+        std::vector<std::uint32_t> band_segments_ {};    /// CSR segment lists of the bands.
+        std::vector<std::uint32_t> cursor_ {};           /// Scratch fill cursors.
+        double min_x_ {}, min_y_ {}, max_x_ {}, max_y_ {}; /// Extent of the segments.
+        double band_height_ {1.0};                       /// Height of one band.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,79 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file shapefile_dataset.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/bounding_box.hpp"
+    #include "kmx/gis/mapped_file.hpp"
+    #include <cstdint>
+    #include <optional>
+    #include <string>
+    #include <string_view>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief A field descriptor of a dBASE (.dbf) table.
+    struct dbf_field
+    {
+        std::string name {};       /// Field name (at most 10 characters).
+        char type {};              /// dBASE type code ('C', 'N', 'F', 'D', 'L', ...).
+        std::uint32_t offset {};   /// Offset of the value within a record (after the deletion flag).
+        std::uint32_t length {};   /// Width of the value in bytes.
+    };
+
+    /// @brief A memory-mapped ESRI Shapefile: the .shp geometry file, its .shx record index and its .dbf attribute table.
+    /// The .shx gives the offset of every record, so any record can be addressed by index from worker threads; bounding
+    /// boxes are read from the record headers of the .shp without walking the vertices, attribute values are sliced
+    /// out of the fixed-width .dbf records. All accessors are `const` and may be used concurrently.
+    class shapefile_dataset
+    {
+    public:
+        /// @brief Maps and validates the .shp file and the .shx and .dbf files next to it.
+        /// @param shp_path Path to the .shp file.
+        /// @throws std::runtime_error If a file is missing or not a valid shapefile component.
+        explicit shapefile_dataset(const std::string& shp_path) noexcept(false);
+
+        /// @brief Shape type of the file (5 = Polygon, 15 = PolygonZ, 25 = PolygonM, ...).
+        std::int32_t shape_type() const noexcept { return shape_type_; }
+        /// @brief Name of a shape type code, for diagnostics.
+        static std::string_view shape_type_name(std::int32_t type) noexcept;
+        /// @brief Number of records (the smaller of the .shx and .dbf counts).
+        std::size_t record_count() const noexcept { return record_count_; }
+
+        /// @brief Offset of record `index` in the .shp file, from the .shx.
+        std::uint64_t record_offset(std::size_t index) const noexcept;
+        /// @brief Size of the .shp file in bytes.
+        std::uint64_t shp_size() const noexcept { return shp_.size(); }
+
+        /// @brief Bounding box of record `index`, read from its record header (invalid for null shapes).
+        bounding_box record_bbox(std::size_t index) const noexcept;
+
+        /// @brief Finds a .dbf field by name, ignoring case (dBASE names are often upper case).
+        std::optional<std::size_t> find_field(std::string_view name) const noexcept;
+        /// @brief The .dbf fields.
+        const std::vector<dbf_field>& fields() const noexcept { return fields_; }
+        /// @brief The value of `field` in record `index`, without its padding spaces.
+        std::string_view field_text(std::size_t index, std::size_t field) const noexcept;
+        /// @brief The code page declared by the .cpg file next to the .shp (empty if there is none).
+        const std::string& code_page() const noexcept { return code_page_; }
+
+    private:
+        /// @brief Reads the .dbf header and field descriptors.
+        void parse_dbf_header() noexcept(false);
+
+        static constexpr std::size_t main_header_size_ {100u}; /// Size of the .shp and .shx file headers.
+        static constexpr std::int32_t file_code_ {9994};       /// Big-endian file code at the start of .shp and .shx.
+
+        mapped_file shp_;                  /// Geometry records.
+        mapped_file shx_;                  /// Record offsets.
+        mapped_file dbf_;                  /// Attribute records.
+        std::int32_t shape_type_ {};       /// Shape type from the .shp header.
+        std::size_t record_count_ {};      /// Number of addressable records.
+        std::size_t dbf_header_size_ {};   /// Offset of the first .dbf record.
+        std::size_t dbf_record_size_ {};   /// Size of one .dbf record, including the deletion flag.
+        std::vector<dbf_field> fields_ {}; /// .dbf field descriptors.
+        std::string code_page_ {};         /// Contents of the .cpg file.
+    };
+
+} // namespace kmx::gis
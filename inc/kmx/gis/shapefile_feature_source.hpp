@@ -0,0 +1,40 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file shapefile_feature_source.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/feature_source.hpp"
+    #include "kmx/gis/shapefile_dataset.hpp"
+#endif
+
+namespace kmx::gis
+{
+    /// @brief `feature_source` over a memory-mapped ESRI Shapefile.
+    /// Batches carry the record header boxes instead of rings, so the vertices are never walked; the projected
+    /// properties are sliced out of the .dbf records as stored (see `code_page()` for their encoding).
+    class shapefile_feature_source final: public feature_source
+    {
+    public:
+        /// @brief Maps and validates the .shp file and its .shx and .dbf companions.
+        /// @throws std::runtime_error If a file is missing or not a valid shapefile component.
+        explicit shapefile_feature_source(const std::string& shp_path) noexcept(false);
+
+        void print_info() const noexcept(false) override;
+        std::string_view geometry_type_name() const noexcept override;
+        bool is_polygonal() const noexcept override;
+        std::uint64_t feature_count() const noexcept override { return range_end_ - range_begin_; }
+        std::vector<std::optional<std::size_t>> project(std::span<const std::string_view> names) noexcept(false) override;
+        /// @brief Splits the records by their .shx offsets.
+        std::optional<shard_range> restrict_to_shard(const shard_spec& shard) noexcept(false) override;
+        /// @brief Jumps to the record at `position`; the offset is not needed.
+        bool seek(std::uint64_t position, std::uint64_t offset) noexcept(false) override;
+        bool next_batch(feature_batch& batch, std::size_t max_features) noexcept(false) override;
+
+    private:
+        shapefile_dataset dataset_;                         /// The mapped .shp/.shx/.dbf files.
+        std::vector<std::optional<std::size_t>> fields_ {}; /// Projected .dbf field indices.
+        std::size_t range_begin_ {};                        /// First record of the shard.
+        std::size_t range_end_ {};                          /// One past the last record of the shard.
+        std::size_t next_index_ {};                         /// Index of the next record to deliver.
+    };
+
+} // namespace kmx::gis
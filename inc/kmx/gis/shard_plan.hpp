@@ -0,0 +1,81 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file shard_plan.hpp
+#pragma once
+#ifndef PCH
+    #include <cstdint>
+    #include <functional>
+    #include <optional>
+    #include <string>
+    #include <string_view>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Selects slice `index` of `count` of an input (`--shard <index>/<count>`, `index` counted from 0).
+    struct shard_spec
+    {
+        std::uint32_t index {}; /// The slice handled by this process.
+        std::uint32_t count {}; /// Number of slices (0 or 1: the whole input).
+
+        /// @brief True if the input is split at all.
+        bool is_sharded() const noexcept { return count > 1u; }
+
+        /// @brief Parses "<index>/<count>".
+        /// @return The spec, or `std::nullopt` if `text` is malformed or `index` is not below `count`.
+        static std::optional<shard_spec> parse(std::string_view text) noexcept;
+    };
+
+    /// @brief The contiguous part of an input assigned to one shard.
+    struct shard_range
+    {
+        std::uint64_t first_feature {}; /// Index of the first feature of the shard.
+        std::uint64_t end_feature {};   /// One past the index of the last feature of the shard.
+        std::uint64_t first_byte {};    /// Offset of the first feature (in the source's own offset space).
+        std::uint64_t end_byte {};      /// Offset just past the last feature.
+    };
+
+    /// @brief Splits inputs into byte-balanced contiguous shards.
+    /// Shard `i` of `n` takes the features starting in `[size * i / n, size * (i + 1) / n)` of the feature section, so
+    /// every process derives the same boundaries from the feature offsets alone, without coordinating with the others.
+    class shard_plan
+    {
+    public:
+        /// @brief Returns the offset of feature `index`; offsets must be ascending.
+        using offset_function = std::function<std::uint64_t(std::uint64_t index)>;
+
+        /// @brief Computes the range of one shard.
+        /// @param feature_count Number of features.
+        /// @param section_size Size of the feature section (the offset just past the last feature).
+        /// @param offset_of Offset of a feature within the section.
+        /// @param shard The shard to compute.
+        static shard_range split(std::uint64_t feature_count, std::uint64_t section_size, const offset_function& offset_of,
+                                 const shard_spec& shard) noexcept(false);
+    };
+
+    /// @brief Describes the partial output of one shard, written next to it as `<output>.manifest`.
+    /// The parts of a sharded run are merged deterministically by ordering their manifests by `first_feature`; the
+    /// ranges of all shards of one input tile its features without gaps or overlaps.
+    struct shard_manifest
+    {
+        std::string input {};         /// Input path, as given on the command line.
+        std::uint64_t input_size {};  /// Size of the input in bytes, to detect parts made from different files.
+        shard_spec shard {};          /// The shard this part was made from.
+        shard_range range {};         /// The features of the shard.
+        std::uint64_t features {};    /// Number of rows written (fewer than the range with a window).
+        std::string output {};        /// Path of the partial output.
+
+        /// @brief Path of the manifest of the partial output `output_path`.
+        static std::string path_for(const std::string& output_path) { return output_path + ".manifest"; }
+
+        /// @brief Writes the manifest as "key=value" lines.
+        /// @throws std::runtime_error If the file cannot be written.
+        void write(const std::string& path) const noexcept(false);
+        /// @brief Reads a manifest written by `write`.
+        /// @throws std::runtime_error If the file cannot be read or a key is missing or malformed.
+        static shard_manifest read(const std::string& path) noexcept(false);
+
+    private:
+        static constexpr std::string_view signature_ {"uat_bbox shard manifest 1"}; /// First line of every manifest.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,71 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file spatial_partitioner.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/bounding_box.hpp"
+    #include "kmx/gis/fgb_dataset.hpp"
+    #include "kmx/thread_pool.hpp"
+    #include <cstdint>
+    #include <span>
+    #include <string>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief What one shard file of a partition holds (a row of the manifest).
+    struct partition_shard
+    {
+        std::string file {};        /// File name inside the output directory.
+        std::uint64_t features {};  /// Number of features.
+        std::uint64_t bytes {};     /// Size of the feature section.
+        bounding_box extent {};     /// Extent of the feature boxes.
+        std::uint32_t first_key {}; /// Smallest Hilbert key of the shard.
+        std::uint32_t last_key {};  /// Largest Hilbert key of the shard.
+    };
+
+    /// @brief Cuts a FlatGeobuf layer into spatially compact, size-balanced shard files for distributed processing.
+    /// Every feature is keyed by the Hilbert value of its bounding box centre over the layer extent (in parallel, from
+    /// the index leaves when the file has an index). A strided sample of keys and feature sizes is sorted and split at
+    /// equal cumulative byte sizes, so each of the N contiguous Hilbert ranges holds about the same amount of data. The
+    /// shards are written concurrently as indexed FlatGeobuf files in Hilbert order, each with its own packed R-tree,
+    /// and the feature bytes are copied verbatim. A `manifest.csv` lists the file, size, extent and key range of each.
+    class spatial_partitioner
+    {
+    public:
+        /// @brief Constructs the partitioner.
+        /// @param input_fgb_path Path to the input FlatGeobuf file.
+        /// @param output_directory Directory receiving `shard_<i>.fgb` and `manifest.csv` (created if missing).
+        /// @param num_threads Number of worker threads.
+        /// @param shard_count Number of shards (at least 1).
+        spatial_partitioner(const std::string& input_fgb_path, const std::string& output_directory, std::uint32_t num_threads,
+                            std::uint32_t shard_count) noexcept(false);
+
+        /// @brief Partitions the layer and writes the shards and the manifest.
+        /// @return True on success, false on controlled failure.
+        bool partition() noexcept(false);
+
+        static constexpr std::uint32_t default_shard_count {16u}; /// Default `--shards`.
+
+    private:
+        /// @brief Extent of all feature boxes.
+        bounding_box layer_extent() noexcept(false);
+        /// @brief Hilbert key of every feature's bounding box centre over `extent`.
+        std::vector<std::uint32_t> hilbert_keys(const bounding_box& extent) noexcept(false);
+        /// @brief Chooses `shard_count_ - 1` split keys from a sample, at equal cumulative byte sizes.
+        std::vector<std::uint32_t> split_keys(std::span<const std::uint32_t> keys) const noexcept(false);
+        /// @brief Writes the features `members` (sorted by key) as shard file `shard.file`.
+        bool write_shard(std::span<const std::uint64_t> members, std::span<const std::uint32_t> keys, partition_shard& shard) const
+            noexcept(false);
+        /// @brief Writes `manifest.csv`.
+        bool write_manifest(std::span<const partition_shard> shards) const noexcept(false);
+
+        static constexpr std::size_t sample_size_ {1u << 16}; /// Features sampled to choose the split keys.
+
+        const std::string output_directory_; /// Directory of the shard files.
+        const std::uint32_t shard_count_;    /// Number of shards.
+        thread_pool thread_pool_;            /// Thread pool for parallel processing.
+        fgb_dataset dataset_;                /// Mapped input file.
+    };
+
+} // namespace kmx::gis
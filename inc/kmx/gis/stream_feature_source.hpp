@@ -0,0 +1,106 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file stream_feature_source.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/feature_source.hpp"
+    #include "kmx/gis/mapped_file.hpp"
+    #include "kmx/gis/polygon_buffer.hpp"
+    #include "kmx/thread_pool.hpp"
+    #include <cstdint>
+    #include <string>
+    #include <utility>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Layouts of the geometry streams read by `stream_feature_source`.
+    enum class stream_format : std::uint8_t
+    {
+        wkb,     /// Concatenated binary WKB geometries, without attributes.
+        hex_wkb, /// PostgreSQL `COPY ... TO` text: tab-separated lines with a hex (E)WKB geometry column.
+        wkt_csv  /// CSV with a header row and a WKT geometry column.
+    };
+
+    /// @brief `feature_source` over WKB and WKT exports (e.g. from PostGIS), read without converting them first.
+    /// The mapped file is cut into chunks at record boundaries (newlines for the text formats, geometry ends for
+    /// binary WKB) and the chunks are parsed in parallel on the caller's thread pool into owned coordinates; the
+    /// batches then point into those. Parsing happens once, on the first `next_batch` (or `seek`, which starts it at
+    /// the resume offset). Records that cannot be parsed are reported and skipped. Text fields must not contain newlines.
+    class stream_feature_source final: public feature_source
+    {
+    public:
+        /// @brief Maps the file and locates the geometry column (text formats).
+        /// @param path Path to the file.
+        /// @param format The layout of the file.
+        /// @param pool Thread pool used for parsing; must outlive the source.
+        /// @throws std::runtime_error If the file cannot be mapped or has no recognizable geometry column.
+        stream_feature_source(const std::string& path, stream_format format, thread_pool& pool) noexcept(false);
+
+        /// @brief The stream format implied by the extension of `path` (.wkb, .hexwkb/.copy/.tsv, .csv), if any.
+        static std::optional<stream_format> format_of(std::string_view path) noexcept;
+
+        void print_info() const noexcept(false) override;
+        std::string_view geometry_type_name() const noexcept override;
+        bool is_polygonal() const noexcept override { return true; }
+        /// @brief Number of parsed features, plus the skipped ones after `seek` (0 before parsing).
+        std::uint64_t feature_count() const noexcept override { return feature_count_; }
+        std::vector<std::optional<std::size_t>> project(std::span<const std::string_view> names) noexcept(false) override;
+        /// @brief Parses the stream from `offset` on, so the records before it are neither read nor parsed again.
+        bool seek(std::uint64_t position, std::uint64_t offset) noexcept(false) override;
+        /// @brief The mapped stream and the parsed geometries (the source keeps the whole input; see `limit_buffering`).
+        std::uint64_t resident_bytes() const noexcept override;
+        bool next_batch(feature_batch& batch, std::size_t max_features) noexcept(false) override;
+
+    private:
+        /// @brief The features parsed from one chunk of the file.
+        struct parsed_chunk
+        {
+            std::size_t begin {};                                  /// Offset of the chunk in the file.
+            std::size_t end {};                                    /// Offset just after the chunk.
+            std::size_t record_count {};                           /// Lines (text) or geometries (WKB) in the chunk.
+            polygon_buffer geometry {};                            /// Rings of all parsed features.
+            std::vector<std::uint32_t> ring_offsets {0u};          /// Rings of feature `i`: `[ring_offsets[i], ring_offsets[i + 1])`.
+            std::vector<std::size_t> feature_ends {};              /// Offset just past the record of each feature.
+            std::vector<std::vector<std::string>> properties {};   /// Projected columns: `properties[column][i]`.
+            std::vector<std::pair<std::size_t, std::string>> errors {}; /// Skipped records: (record within chunk, reason).
+
+            /// @brief Number of parsed features.
+            std::size_t size() const noexcept { return ring_offsets.size() - 1u; }
+        };
+
+        /// @brief Reads the header line (if any) and finds the geometry column of a text stream.
+        void read_header() noexcept(false);
+        /// @brief Cuts the data into chunks at record boundaries.
+        void split_chunks() noexcept(false);
+        /// @brief Parses all chunks in parallel and reports the skipped records.
+        void parse() noexcept(false);
+        /// @brief Parses the records of one chunk.
+        void parse_chunk(parsed_chunk& chunk) const noexcept(false);
+        /// @brief Splits a text line into unescaped fields (CSV quoting or COPY text escapes, per the format).
+        void split_fields(std::string_view line, std::vector<std::string>& fields) const noexcept(false);
+        /// @brief Parses a geometry field (hex WKB or WKT, per the format) into `out`.
+        bool read_geometry_field(std::string_view text, std::vector<std::uint8_t>& wkb, polygon_buffer& out) const noexcept(false);
+        /// @brief The next line starting at `offset` (without its line break), advancing `offset` past it.
+        std::string_view next_line(std::size_t& offset, std::size_t end) const noexcept;
+
+        static constexpr std::size_t min_chunk_size_ {64u * 1024u}; /// Smallest chunk worth a task.
+        static constexpr std::size_t chunks_per_thread_ {8u};        /// Chunks per worker thread, for load balancing.
+
+        mapped_file file_;                                   /// The mapped stream.
+        stream_format format_;                               /// Layout of the stream.
+        thread_pool& pool_;                                  /// Thread pool used for parsing.
+        std::vector<std::string> column_names_ {};           /// Column names (text formats).
+        std::size_t geometry_column_ {};                     /// Index of the geometry column (text formats).
+        std::size_t data_offset_ {};                         /// Offset of the first record.
+        std::size_t first_record_number_ {1u};               /// 1-based number of the first record (lines after a header).
+        std::vector<std::optional<std::size_t>> columns_ {}; /// Projected column indices.
+        std::vector<parsed_chunk> chunks_ {};                /// Parsed chunks, in file order.
+        bool parsed_ {};                                     /// True once `parse` ran.
+        std::uint64_t feature_count_ {};                     /// Number of parsed features.
+        std::size_t next_chunk_ {};                          /// Chunk of the next feature to deliver.
+        std::size_t next_in_chunk_ {};                       /// Index of the next feature within its chunk.
+        std::uint64_t next_index_ {};                        /// Index of the next feature to deliver.
+    };
+
+} // namespace kmx::gis
@@ -0,0 +1,65 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file tournament_tree.hpp
+#pragma once
+#ifndef PCH
+    #include <cstddef>
+    #include <utility>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief A loser tree selecting the smallest head among `k` sorted sequences, for k-way merges.
+    /// Leaves are sequence indices; `less(a, b)` compares the current heads of sequences `a` and `b` and must rank
+    /// exhausted sequences after all others. After the winner advances, `replay` restores the tree with one comparison
+    /// per level (`log2(k)`), against the losers stored on the path only. Ties go to the lower sequence index, so a
+    /// merge through the tree is stable and deterministic.
+    template <class Less>
+    class tournament_tree
+    {
+    public:
+        /// @brief Plays the initial tournament.
+        /// @param leaf_count Number of sequences (at least 1).
+        /// @param less Compares the heads of two sequences.
+        tournament_tree(const std::size_t leaf_count, Less less) noexcept(false):
+            less_ {std::move(less)},
+            leaf_count_ {leaf_count},
+            losers_(leaf_count)
+        {
+            // winners[n] is the winner of the subtree of node n; leaf i sits at node leaf_count + i.
+            std::vector<std::size_t> winners(2u * leaf_count);
+            for (std::size_t i {}; i < leaf_count; ++i)
+                winners[leaf_count + i] = i;
+            for (std::size_t node {leaf_count - 1u}; node > 0u; --node)
+            {
+                const std::size_t left {winners[2u * node]}, right {winners[2u * node + 1u]};
+                const bool left_wins {beats(left, right)};
+                winners[node] = left_wins ? left : right;
+                losers_[node] = left_wins ? right : left;
+            }
+            losers_[0] = (leaf_count > 1u) ? winners[1] : 0u;
+        }
+
+        /// @brief The sequence whose head is the smallest.
+        std::size_t winner() const noexcept { return losers_[0]; }
+
+        /// @brief Replays the path of `leaf` after its head changed (normally the winner, after it advanced).
+        void replay(const std::size_t leaf) noexcept(false)
+        {
+            std::size_t winner {leaf};
+            for (std::size_t node {(leaf_count_ + leaf) / 2u}; node > 0u; node /= 2u)
+                if (beats(losers_[node], winner))
+                    std::swap(losers_[node], winner);
+            losers_[0] = winner;
+        }
+
+    private:
+        /// @brief Strict total order on the heads: `less`, then the sequence index.
+        bool beats(const std::size_t a, const std::size_t b) { return less_(a, b) || (!less_(b, a) && (a < b)); }
+
+        Less less_;                        /// Compares the heads of two sequences.
+        std::size_t leaf_count_;           /// Number of sequences.
+        std::vector<std::size_t> losers_;  /// Loser of every internal node; the overall winner in slot 0.
+    };
+
+} // namespace kmx::gis
@@ -4,6 +4,7 @@
 #ifndef PCH
     #include "kmx/gis/bounding_box.hpp"
     #include <cstdint>
+    #include <span>
     #include <string>
 #endif
 
@@ -68,34 +69,35 @@ namespace kmx::gis
         bool operator!=(const county_code& other) const { return !(*this == other); }
     };
 
-    /// @brief Holds input data required for a parallel task that calculates a feature's bounding box.
-    /// This structure is designed to be passed by value or moved into a task.
-    struct task_input_data
+    /// @brief A non-owning view of one polygon ring whose coordinates live in the FlatGeobuf buffer.
+    /// Rings are closed (the last point repeats the first) as required by the FlatGeobuf specification.
+    /// FlatGeobuf keeps Z and M in separate arrays, so `xy` always holds plain interleaved X/Y pairs.
+    struct ring_view
     {
-        /// @brief The name of the UAT (Unitate Administrativ Teritorială).
-        std::string uat_name {};
-        /// @brief The code of the UAT (e.g., SIRUTA code). Defaults to 0 if not found.
-        std::uint32_t uat_code {};
-        /// @brief The county identifier (e.g., "SJ", "BH"). Defaults to placeholder if not found.
-        county_code county_mn {};
-        /// @brief A pointer to the constant FlatBuffer Geometry table associated with the feature.
-        /// This points to data within the main file buffer and should not outlive it.
-        const FlatGeobuf::Geometry* geometry_ptr {};
-        /// @brief The number of double values that constitute a single coordinate point (e.g., 2 for XY, 3 for XYZ).
-        std::uint32_t coordinate_stride {};
-        /// @brief The specific geometry type of this feature or feature part, as defined by `FlatGeobuf::GeometryType`.
-        FlatGeobuf::GeometryType actual_geometry_type {};
+        /// @brief Pointer to the first coordinate of the ring inside the `xy` array of its geometry.
+        const double* xy {};
+        /// @brief Number of points in the ring.
+        std::uint32_t point_count {};
+        /// @brief Index of the polygon this ring belongs to (0 for a single Polygon, part index for a MultiPolygon).
+        std::uint32_t polygon_index {};
+        /// @brief True for the first (exterior) ring of its polygon, false for holes.
+        bool is_exterior {};
+
+        /// @brief X coordinate of point `i`.
+        double x(const std::uint32_t i) const noexcept { return xy[static_cast<std::size_t>(i) * 2u]; }
+        /// @brief Y coordinate of point `i`.
+        double y(const std::uint32_t i) const noexcept { return xy[static_cast<std::size_t>(i) * 2u + 1u]; }
     };
 
     /// @brief Holds the result produced by a parallel bounding box calculation task.
     /// This structure is returned from a task and contains the feature's UAT name, UAT code, county code, and its computed bounding box.
     struct task_result
     {
-        /// @brief The name of the UAT, corresponding to `task_input_data::uat_name`.
+        /// @brief The name of the UAT (Unitate Administrativ Teritorială).
         std::string uat_name {};
-        /// @brief The code of the UAT, corresponding to `task_input_data::uat_code`. Defaults to 0 if not found.
+        /// @brief The code of the UAT (e.g., SIRUTA code). Defaults to 0 if not found.
         std::uint32_t uat_code {};
-        /// @brief The county identifier, corresponding to `task_input_data::county_mn`.
+        /// @brief The county identifier (e.g., "SJ", "BH"). Defaults to placeholder if not found.
         county_code county_mn {};
         /// @brief The calculated `bounding_box` for the feature's geometry.
         bounding_box bbox {};
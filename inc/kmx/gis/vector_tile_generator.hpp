@@ -0,0 +1,85 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file vector_tile_generator.hpp
+#pragma once
+#ifndef PCH
+    #include "flatgeobuf/packedrtree.h"
+    #include "kmx/gis/fgb_dataset.hpp"
+    #include "kmx/gis/mvt_encoder.hpp"
+    #include "kmx/gis/types.hpp"
+    #include "kmx/gis/web_mercator.hpp"
+    #include "kmx/thread_pool.hpp"
+    #include <cstdint>
+    #include <memory>
+    #include <optional>
+    #include <string>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Zoom range and geometry processing options of the tile generator.
+    struct vector_tile_settings
+    {
+        /// @brief First zoom level to generate.
+        std::uint32_t min_zoom {0u};
+        /// @brief Last zoom level to generate.
+        std::uint32_t max_zoom {14u};
+        /// @brief Tile extent in integer tile units.
+        std::uint32_t extent {4096u};
+        /// @brief Clip buffer around each tile, in tile units.
+        std::uint32_t buffer {64u};
+        /// @brief Douglas-Peucker tolerance, in tile units.
+        double simplify_tolerance {1.0};
+    };
+
+    /// @brief Generates Mapbox Vector Tiles for a polygon FlatGeobuf layer into a "<z>/<x>/<y>.pbf" directory tree (XYZ
+    /// scheme) with a `metadata.json` in the style of MBTiles metadata.
+    /// Feature boxes are projected to Web Mercator once and indexed in a packed R-tree; each tile then queries the tree,
+    /// transforms the candidate rings to tile coordinates, clips them to the buffered tile, simplifies, quantizes and
+    /// encodes them together with the feature properties. Tiles of a zoom level are processed in parallel.
+    /// Geometry is read from the mapped file; for sources that are not already Web Mercator, the coordinates of each
+    /// candidate feature are projected per tile into a scratch buffer of the tile worker, reused across features, so
+    /// memory does not grow with the file (a feature is projected again for every tile it touches).
+    class vector_tile_generator
+    {
+    public:
+        /// @brief Constructs the generator.
+        /// @param input_fgb_path Path to the input FlatGeobuf file (must be Polygon or MultiPolygon).
+        /// @param output_directory Root directory of the tile tree.
+        /// @param num_threads Number of worker threads.
+        /// @param settings Zoom range and geometry options.
+        /// @throws std::runtime_error If the file cannot be opened or its CRS cannot be projected to Web Mercator.
+        vector_tile_generator(const std::string& input_fgb_path, const std::string& output_directory, std::uint32_t num_threads,
+                              const vector_tile_settings& settings) noexcept(false);
+
+        /// @brief Generates all tiles and the metadata file.
+        /// @return True on success, false on controlled failure.
+        bool generate() noexcept(false);
+
+    private:
+        /// @brief Projects the boxes of all features and builds the Web Mercator R-tree over them.
+        void project_features() noexcept(false);
+        /// @brief Collects the rings of a feature in Web Mercator.
+        /// @param projected Scratch buffer the rings are projected into and redirected to (unused for Web Mercator sources).
+        void collect_projected_rings(std::uint64_t feature_index, std::vector<ring_view>& out_rings, std::vector<double>& projected) const
+            noexcept(false);
+        /// @brief Generates the tiles of one zoom level.
+        /// @return Number of tiles written, or `std::nullopt` if a tile could not be written.
+        std::optional<std::uint64_t> generate_zoom(std::uint32_t zoom) noexcept(false);
+        /// @brief Appends key/value tag pairs for the properties of a feature.
+        void append_tags(const FlatGeobuf::Feature* feature, mvt_layer_builder& layer,
+                         std::vector<std::uint32_t>& tags) const noexcept(false);
+        /// @brief Writes `metadata.json` describing the tile set.
+        bool write_metadata() const noexcept(false);
+
+        const std::string output_directory_;                /// Root directory of the tile tree.
+        const vector_tile_settings settings_;               /// Zoom range and geometry options.
+        thread_pool thread_pool_;                           /// Thread pool for parallel processing.
+        fgb_dataset dataset_;                               /// Mapped input file.
+        web_mercator_projection projection_;                /// Source CRS to Web Mercator.
+        std::string layer_name_ {};                         /// Name of the tile layer.
+        std::unique_ptr<FlatGeobuf::PackedRTree> index_ {}; /// R-tree of the Web Mercator feature boxes.
+        FlatGeobuf::NodeItem extent_ {};                    /// Web Mercator extent of the layer.
+    };
+
+} // namespace kmx::gis
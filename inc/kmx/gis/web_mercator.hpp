@@ -0,0 +1,67 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file web_mercator.hpp
+#pragma once
+#ifndef PCH
+    #include "flatgeobuf/header_generated.h"
+    #include <cstdint>
+    #include <numbers>
+    #include <utility>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Projects coordinates of a FlatGeobuf layer to Web Mercator (EPSG:3857) metres.
+    /// Supported source CRSs are EPSG:3857 (identity), EPSG:4326 (x = longitude, y = latitude) and Stereo 70
+    /// (EPSG:3844 / EPSG:31700), the CRS of the Romanian UAT layer. Stereo 70 is converted with the inverse oblique
+    /// stereographic projection on the Krassovsky ellipsoid followed by the 7-parameter Pulkovo 1942(58) to WGS 84
+    /// transformation (EPSG:15994, about 3 m accuracy).
+    class web_mercator_projection
+    {
+    public:
+        /// @brief Radius of the Web Mercator sphere.
+        static constexpr double earth_radius {6378137.0};
+        /// @brief Half of the side of the square Web Mercator world.
+        static constexpr double half_world_size {std::numbers::pi * earth_radius};
+
+        /// @brief Selects the projection for the CRS declared in a FlatGeobuf header.
+        /// @param fbs_header Pointer to the FlatBuffer Header object.
+        /// @throws std::runtime_error If the header declares no CRS or an unsupported one.
+        explicit web_mercator_projection(const FlatGeobuf::Header* fbs_header) noexcept(false);
+
+        /// @brief True if the source coordinates already are Web Mercator metres.
+        bool is_identity() const noexcept { return source_ == source_crs::web_mercator; }
+        /// @brief The EPSG code of the source CRS.
+        std::int32_t source_code() const noexcept { return source_code_; }
+
+        /// @brief Projects a source coordinate to Web Mercator metres.
+        std::pair<double, double> project(double x, double y) const noexcept;
+        /// @brief Converts Web Mercator metres back to WGS 84 longitude and latitude in degrees.
+        static std::pair<double, double> to_lon_lat(double mx, double my) noexcept;
+
+    private:
+        /// @brief Source coordinate systems with a dedicated code path.
+        enum class source_crs : std::uint8_t
+        {
+            web_mercator,
+            geographic,
+            stereo_70,
+        };
+
+        /// @brief Converts WGS 84 longitude and latitude (radians) to Web Mercator metres.
+        static std::pair<double, double> from_radians(double lon, double lat) noexcept;
+        /// @brief Converts Stereo 70 easting and northing to WGS 84 longitude and latitude (radians).
+        std::pair<double, double> stereo_70_to_wgs84(double easting, double northing) const noexcept;
+
+        source_crs source_ {};         /// Selected code path.
+        std::int32_t source_code_ {};  /// EPSG code of the source CRS.
+
+        // Constants of the inverse oblique stereographic projection (EPSG method 9809), see `web_mercator.cpp`.
+        double n_ {};     /// Conformal sphere exponent.
+        double c_ {};     /// Conformal latitude constant.
+        double chi0_ {};  /// Conformal latitude of the origin.
+        double r_k0_ {};  /// Conformal sphere radius times the scale factor.
+        double g_ {};     /// 2 R k0 tan(pi/4 - chi0/2).
+        double h_ {};     /// 4 R k0 tan(chi0) + g.
+    };
+
+} // namespace kmx::gis
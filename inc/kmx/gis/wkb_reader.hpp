@@ -0,0 +1,48 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file wkb_reader.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/polygon_buffer.hpp"
+    #include <cstdint>
+    #include <span>
+    #include <string_view>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Stateless decoder of Well-Known Binary polygons (OGC/ISO WKB and PostGIS EWKB), plain or hex encoded.
+    /// Polygon and MultiPolygon geometries are accepted in either byte order, with or without an EWKB SRID and
+    /// with Z and/or M values, which are dropped: rings are stored as plain X/Y in a `polygon_buffer`.
+    class wkb_reader
+    {
+    public:
+        /// @brief Decodes hexadecimal text (either case) into bytes; 16 characters per step with SSE2 where available.
+        /// @param hex The hex digits (an even number of them).
+        /// @param out Receives the bytes (cleared first).
+        /// @return False if `hex` has an odd length or a character that is not a hex digit.
+        static bool hex_decode(std::string_view hex, std::vector<std::uint8_t>& out) noexcept(false);
+
+        /// @brief Decodes one polygonal WKB geometry from the start of `wkb`.
+        /// @param wkb The bytes; may continue past the geometry (binary WKB streams).
+        /// @param out Receives the rings; left unchanged on failure.
+        /// @return The size of the geometry in bytes, or 0 if it is malformed, truncated or not polygonal.
+        static std::size_t read_polygonal(std::span<const std::uint8_t> wkb, polygon_buffer& out) noexcept(false);
+
+        /// @brief Measures one WKB geometry from the start of `wkb` without decoding its coordinates.
+        /// Walks the ring and point counts only, so a binary stream can be split into features cheaply.
+        /// @return The size of the geometry in bytes, or 0 if it is malformed, truncated or not polygonal.
+        static std::size_t measure(std::span<const std::uint8_t> wkb) noexcept;
+
+    private:
+        /// @brief Decodes (or, without `out`, only measures) a Polygon or MultiPolygon geometry.
+        static std::size_t read_geometry(std::span<const std::uint8_t> wkb, polygon_buffer* out) noexcept(false);
+        /// @brief Decodes (or measures) the rings of a Polygon whose type header has been read.
+        static bool read_polygon_body(std::span<const std::uint8_t> wkb, std::size_t& offset, bool little_endian,
+                                      std::uint32_t dimensions, std::uint32_t polygon_index, polygon_buffer* out) noexcept(false);
+
+        static constexpr std::uint32_t polygon_type_ {3u};       /// WKB type code of Polygon.
+        static constexpr std::uint32_t multi_polygon_type_ {6u}; /// WKB type code of MultiPolygon.
+    };
+
+} // namespace kmx::gis
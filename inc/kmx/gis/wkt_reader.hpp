@@ -0,0 +1,45 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file wkt_reader.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/polygon_buffer.hpp"
+    #include <cstdint>
+    #include <string_view>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Single-pass parser of Well-Known Text polygons.
+    /// Accepts POLYGON and MULTIPOLYGON in any case, with an optional EWKT `SRID=...;` prefix, `Z`/`M`/`ZM` tags and
+    /// `EMPTY`; numbers are parsed with `std::from_chars`, extra ordinates are dropped.
+    class wkt_reader
+    {
+    public:
+        /// @brief Parses a polygonal WKT geometry.
+        /// @param wkt The text; surrounding whitespace is ignored.
+        /// @param out Receives the rings; left unchanged on failure.
+        /// @return False if the text is not a valid Polygon or MultiPolygon.
+        static bool read_polygonal(std::string_view wkt, polygon_buffer& out) noexcept(false);
+
+    private:
+        /// @brief Parser state over the text.
+        struct cursor
+        {
+            const char* position {}; /// Next character.
+            const char* end {};      /// End of the text.
+
+            /// @brief Skips whitespace and returns true if the next character is `c` (consuming it).
+            bool accept(char c) noexcept;
+            /// @brief Skips whitespace and reads a keyword (letters only), upper-cased into `out`.
+            std::string_view keyword(char (&out)[16u]) noexcept;
+            /// @brief Skips whitespace and parses a number.
+            bool number(double& value) noexcept;
+        };
+
+        /// @brief Parses `( x y ..., x y ... )` as one ring.
+        static bool read_ring(cursor& text, std::uint32_t polygon_index, bool is_exterior, polygon_buffer& out) noexcept(false);
+        /// @brief Parses `( ring, ring ... )` or `EMPTY` as one polygon.
+        static bool read_polygon(cursor& text, std::uint32_t polygon_index, polygon_buffer& out) noexcept(false);
+    };
+
+} // namespace kmx::gis
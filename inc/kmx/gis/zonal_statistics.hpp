@@ -0,0 +1,66 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file zonal_statistics.hpp
+#pragma once
+#ifndef PCH
+    #include "kmx/gis/fgb_dataset.hpp"
+    #include "kmx/gis/raster_dataset.hpp"
+    #include "kmx/thread_pool.hpp"
+    #include <cstdint>
+    #include <limits>
+    #include <string>
+    #include <string_view>
+    #include <vector>
+#endif
+
+namespace kmx::gis
+{
+    /// @brief Statistics of the raster pixels covered by one feature.
+    struct zonal_stats
+    {
+        /// @brief Number of valid covered pixels.
+        std::uint64_t count {};
+        /// @brief Sum of the valid covered pixel values.
+        double sum {};
+        /// @brief Smallest valid covered pixel value.
+        double min {std::numeric_limits<double>::max()};
+        /// @brief Largest valid covered pixel value.
+        double max {std::numeric_limits<double>::lowest()};
+    };
+
+    /// @brief Computes per-feature zonal statistics (count/sum/min/max/mean) of a raster over a polygon FlatGeobuf layer.
+    /// A pixel belongs to a feature if its centre lies inside the feature; each feature is scanline-rasterized over its
+    /// own window of the raster. Features are processed in parallel in the Hilbert order of the raster block holding
+    /// their bounding box centre, so that neighbouring tasks read the same raster pages.
+    /// The raster must use the CRS of the layer.
+    class zonal_statistics
+    {
+    public:
+        /// @brief Constructs the processor.
+        /// @param input_fgb_path Path to the input FlatGeobuf file (must be Polygon or MultiPolygon).
+        /// @param raster_path Path to the raw raster (see `raster_dataset` for the sidecar files).
+        /// @param output_csv_path Path for the output CSV file.
+        /// @param num_threads Number of worker threads.
+        zonal_statistics(const std::string& input_fgb_path, const std::string& raster_path, const std::string& output_csv_path,
+                         std::uint32_t num_threads) noexcept(false);
+
+        /// @brief Computes the statistics and writes `feature_index,uat_code,count,sum,min,max,mean` rows in feature order.
+        /// @return True on success, false on controlled failure.
+        bool compute() noexcept(false);
+
+    private:
+        /// @brief Orders the features by the Hilbert index of the raster block containing their bounding box centre.
+        std::vector<std::uint32_t> tile_aware_order() const noexcept(false);
+        /// @brief Writes the result rows.
+        bool write_results(const std::vector<zonal_stats>& results) const noexcept(false);
+
+        static constexpr std::string_view expected_uat_code_column_ {"natcode"};
+        static constexpr std::uint32_t block_size_ {256u}; /// Side, in pixels, of the raster blocks used for ordering.
+        static constexpr std::size_t features_per_task_ {8u}; /// Consecutive (neighbouring) features per task.
+
+        const std::string output_csv_path_; /// Path to the output CSV file.
+        thread_pool thread_pool_;           /// Thread pool for parallel processing.
+        fgb_dataset dataset_;               /// Mapped FlatGeobuf file.
+        raster_dataset raster_;             /// Mapped raster.
+    };
+
+} // namespace kmx::gis
@@ -2,7 +2,9 @@
 /// @file thread_pool.hpp
 #pragma once
 #ifndef PCH
+    #include <algorithm>
     #include <condition_variable>
+    #include <exception>
     #include <functional>
     #include <future>
     #include <memory>
@@ -28,6 +30,15 @@ namespace kmx::gis
         template <class F, class... Args>
         auto enqueue_task(F&& f, Args&&... args) noexcept(false) -> std::future<typename std::invoke_result_t<F, Args...>>;
 
+        /// @brief Splits `[0, count)` into contiguous chunks of at most `chunk_size` items, runs `f(begin, end)` for each
+        /// chunk on the pool and waits for all of them. The first exception thrown by a chunk is rethrown after all
+        /// chunks have finished.
+        template <class F>
+        void parallel_for(std::size_t count, std::size_t chunk_size, F&& f) noexcept(false);
+
+        /// @brief Number of worker threads.
+        std::size_t size() const noexcept { return workers_.size(); }
+
         thread_pool(const thread_pool&) = delete;
         thread_pool& operator=(const thread_pool&) = delete;
         thread_pool(thread_pool&&) = delete;
@@ -62,4 +73,32 @@ namespace kmx::gis
         return future_result;
     }
 
+    template <class F>
+    void thread_pool::parallel_for(const std::size_t count, const std::size_t chunk_size, F&& f) noexcept(false)
+    {
+        const std::size_t step {(chunk_size > 0u) ? chunk_size : 1u};
+        std::vector<std::future<void>> chunk_futures {};
+        chunk_futures.reserve((count + step - 1u) / step);
+        for (std::size_t begin {}; begin < count; begin += step)
+        {
+            const std::size_t end {std::min(count, begin + step)};
+            chunk_futures.push_back(enqueue_task([&f, begin, end]() { f(begin, end); }));
+        }
+
+        std::exception_ptr first_error {};
+        for (auto& chunk_future: chunk_futures)
+            try
+            {
+                chunk_future.get();
+            }
+            catch (...)
+            {
+                if (!first_error)
+                    first_error = std::current_exception();
+            }
+
+        if (first_error)
+            std::rethrow_exception(first_error);
+    }
+
 } // namespace kmx::gis
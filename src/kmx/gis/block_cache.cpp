@@ -0,0 +1,154 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file block_cache.cpp
+#include "kmx/gis/block_cache.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+namespace kmx::gis
+{
+    cached_block::cached_block(const std::size_t capacity, const std::size_t alignment) noexcept(false):
+        data {static_cast<std::uint8_t*>(std::aligned_alloc(alignment, capacity)), &std::free}
+    {
+        if (data == nullptr)
+            throw std::bad_alloc {};
+    }
+
+    block_cache::block_cache(const std::size_t capacity_bytes, const std::size_t block_size) noexcept(false):
+        block_size_ {(std::max(block_size, alignment_) + alignment_ - 1u) / alignment_ * alignment_},
+        slots_per_shard_ {std::max<std::size_t>(capacity_bytes / block_size_ / shard_count_, 1u)},
+        max_pinned_bytes_ {capacity_bytes / 2u}
+    {
+        for (shard& part: shards_)
+        {
+            part.slots.reserve(slots_per_shard_);
+            part.index.reserve(slots_per_shard_);
+        }
+    }
+
+    std::uint64_t block_cache::source_id(const std::string& name) noexcept(false)
+    {
+        std::lock_guard<std::mutex> lock {sources_mutex_};
+        return sources_.try_emplace(name, sources_.size()).first->second;
+    }
+
+    // Mixes source and block number (splitmix64 finalizer), so consecutive blocks land in different shards.
+    std::size_t block_cache::block_key_hash::operator()(const block_key& key) const noexcept
+    {
+        std::uint64_t value {key.source * 0x9E3779B97F4A7C15ull + key.block};
+        value = (value ^ (value >> 30u)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27u)) * 0x94D049BB133111EBull;
+        return static_cast<std::size_t>(value ^ (value >> 31u));
+    }
+
+    block_cache::shard& block_cache::shard_of(const block_key& key) noexcept
+    {
+        return shards_[block_key_hash {}(key) % shard_count_];
+    }
+
+    std::shared_ptr<const cached_block> block_cache::find(const std::uint64_t source, const std::uint64_t block,
+                                                          const bool pin) noexcept(false)
+    {
+        const block_key key {source, block};
+        shard& part {shard_of(key)};
+        std::lock_guard<std::mutex> lock {part.mutex};
+        const auto found = part.index.find(key);
+        if (found == part.index.end())
+            return {};
+
+        slot& entry {part.slots[found->second]};
+        entry.referenced = true;
+        if (pin && !entry.pinned && ((pinned_bytes_ + entry.data->size) <= max_pinned_bytes_))
+        {
+            entry.pinned = true;
+            pinned_bytes_ += entry.data->size;
+        }
+        ++hits_;
+        return entry.data;
+    }
+
+    bool block_cache::contains(const std::uint64_t source, const std::uint64_t block) noexcept(false)
+    {
+        const block_key key {source, block};
+        shard& part {shard_of(key)};
+        std::lock_guard<std::mutex> lock {part.mutex};
+        return part.index.contains(key);
+    }
+
+    std::shared_ptr<cached_block> block_cache::allocate() const noexcept(false)
+    {
+        return std::make_shared<cached_block>(block_size_, alignment_);
+    }
+
+    // Sweeps the clock hand: referenced blocks lose their bit and survive one more round, pinned ones are skipped.
+    std::size_t block_cache::free_slot(shard& target) noexcept
+    {
+        if (target.slots.size() < slots_per_shard_)
+        {
+            target.slots.emplace_back();
+            return target.slots.size() - 1u;
+        }
+        for (std::size_t step {}; step < 2u * target.slots.size(); ++step)
+        {
+            const std::size_t candidate {target.hand};
+            target.hand = (target.hand + 1u) % target.slots.size();
+            slot& entry {target.slots[candidate]};
+            if (entry.pinned)
+                continue;
+            if (entry.referenced)
+            {
+                entry.referenced = false;
+                continue;
+            }
+            target.index.erase(entry.key);
+            resident_bytes_ -= entry.data->size;
+            entry.data.reset();
+            ++evictions_;
+            return candidate;
+        }
+        return target.slots.size();
+    }
+
+    std::shared_ptr<const cached_block> block_cache::insert(const std::uint64_t source, const std::uint64_t block,
+                                                            std::shared_ptr<cached_block> data, const bool pin) noexcept(false)
+    {
+        const block_key key {source, block};
+        shard& part {shard_of(key)};
+        ++misses_;
+        std::lock_guard<std::mutex> lock {part.mutex};
+        if (const auto found = part.index.find(key); found != part.index.end())
+        {
+            part.slots[found->second].referenced = true;
+            return part.slots[found->second].data;
+        }
+
+        const std::size_t position {free_slot(part)};
+        if (position == part.slots.size())
+            return data; // Every block of the shard is pinned: hand the block out uncached.
+
+        slot& entry {part.slots[position]};
+        entry.key = key;
+        entry.data = std::move(data);
+        entry.referenced = true;
+        entry.pinned = pin && ((pinned_bytes_ + entry.data->size) <= max_pinned_bytes_);
+        part.index.emplace(key, position);
+        resident_bytes_ += entry.data->size;
+        if (entry.pinned)
+            pinned_bytes_ += entry.data->size;
+        return entry.data;
+    }
+
+    block_cache_statistics block_cache::statistics() const noexcept
+    {
+        return {hits_, misses_, evictions_, resident_bytes_, pinned_bytes_};
+    }
+
+    void block_cache::print_statistics() const noexcept(false)
+    {
+        const block_cache_statistics counters {statistics()};
+        std::cout << "Block cache: " << counters.hits << " hits, " << counters.misses << " misses, " << counters.evictions
+                  << " evictions, " << counters.resident_bytes << " bytes resident (" << counters.pinned_bytes << " pinned)." << std::endl;
+    }
+
+} // namespace kmx::gis
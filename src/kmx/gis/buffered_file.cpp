@@ -0,0 +1,186 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file buffered_file.cpp
+#include "kmx/gis/buffered_file.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <unistd.h>
+#include <utility>
+
+namespace kmx::gis
+{
+    buffered_file_reader::buffered_file_reader(const std::string& path, const std::size_t buffer_size) noexcept(false):
+        path_ {path},
+        buffer_(std::max<std::size_t>(buffer_size, 4096u))
+    {
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0)
+            throw std::runtime_error("Cannot open file: " + path + " (" + std::strerror(errno) + ")");
+        ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+
+    buffered_file_reader::~buffered_file_reader() noexcept
+    {
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+
+    // Moves the unread bytes to the front of the buffer and reads more behind them.
+    bool buffered_file_reader::fill() noexcept(false)
+    {
+        if (eof_)
+            return false;
+        if (begin_ > 0u)
+        {
+            std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+            end_ -= begin_;
+            begin_ = 0u;
+        }
+        if (end_ == buffer_.size()) // A line longer than the buffer
+            buffer_.resize(buffer_.size() * 2u);
+
+        for (;;)
+        {
+            const ::ssize_t count {::read(fd_, buffer_.data() + end_, buffer_.size() - end_)};
+            if (count > 0)
+            {
+                end_ += static_cast<std::size_t>(count);
+                return true;
+            }
+            if (count == 0)
+            {
+                eof_ = true;
+                return false;
+            }
+            if (errno != EINTR)
+                throw std::runtime_error("Cannot read file: " + path_ + " (" + std::strerror(errno) + ")");
+        }
+    }
+
+    bool buffered_file_reader::next_line(std::string_view& line) noexcept(false)
+    {
+        std::size_t searched {begin_};
+        for (;;)
+        {
+            const char* const newline {static_cast<const char*>(std::memchr(buffer_.data() + searched, '\n', end_ - searched))};
+            if (newline != nullptr)
+            {
+                const std::size_t end {static_cast<std::size_t>(newline - buffer_.data())};
+                line = {buffer_.data() + begin_, end - begin_};
+                begin_ = end + 1u;
+                break;
+            }
+            searched = end_ - begin_; // Offset of the unsearched bytes once `fill` moved them to the front
+            if (!fill())
+            {
+                if (begin_ == end_)
+                    return false;
+                line = {buffer_.data() + begin_, end_ - begin_}; // Last line without a newline
+                begin_ = end_;
+                break;
+            }
+        }
+        if (!line.empty() && (line.back() == '\r'))
+            line.remove_suffix(1u);
+        return true;
+    }
+
+    bool buffered_file_reader::read_exact(const std::span<std::uint8_t> out) noexcept(false)
+    {
+        const std::string_view bytes {peek(out.size())};
+        if (bytes.size() < out.size())
+            return false;
+        std::memcpy(out.data(), bytes.data(), out.size());
+        begin_ += out.size();
+        return true;
+    }
+
+    std::string_view buffered_file_reader::peek(const std::size_t count) noexcept(false)
+    {
+        while ((end_ - begin_) < count)
+        {
+            if ((begin_ == 0u) && (end_ == buffer_.size()) && (count > buffer_.size()))
+                buffer_.resize(count);
+            if (!fill())
+                break;
+        }
+        return {buffer_.data() + begin_, std::min(count, end_ - begin_)};
+    }
+
+    std::string_view buffered_file_reader::take_buffered() noexcept(false)
+    {
+        if ((begin_ == end_) && !fill())
+            return {};
+        const std::string_view bytes {buffer_.data() + begin_, end_ - begin_};
+        begin_ = end_;
+        return bytes;
+    }
+
+    buffered_file_writer::buffered_file_writer(const std::string& path, const std::size_t buffer_size) noexcept(false):
+        path_ {path},
+        capacity_ {std::max<std::size_t>(buffer_size, 4096u)}
+    {
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0)
+            throw std::runtime_error("Cannot create file: " + path + " (" + std::strerror(errno) + ")");
+        buffer_.reserve(capacity_);
+    }
+
+    buffered_file_writer::~buffered_file_writer() noexcept
+    {
+        if (fd_ < 0)
+            return;
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+        }
+        ::close(fd_);
+    }
+
+    void buffered_file_writer::write(const std::string_view bytes) noexcept(false)
+    {
+        if ((buffer_.size() + bytes.size()) > capacity_)
+            flush();
+        if (bytes.size() >= capacity_)
+            write_through(bytes); // Large blocks go straight to the file
+        else
+            buffer_.insert(buffer_.end(), bytes.begin(), bytes.end());
+    }
+
+    void buffered_file_writer::flush() noexcept(false)
+    {
+        write_through({buffer_.data(), buffer_.size()});
+        buffer_.clear();
+    }
+
+    void buffered_file_writer::write_through(const std::string_view bytes) noexcept(false)
+    {
+        std::size_t done {};
+        while (done < bytes.size())
+        {
+            const ::ssize_t count {::write(fd_, bytes.data() + done, bytes.size() - done)};
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw std::runtime_error("Cannot write file: " + path_ + " (" + std::strerror(errno) + ")");
+            }
+            done += static_cast<std::size_t>(count);
+        }
+        written_ += done;
+    }
+
+    void buffered_file_writer::close() noexcept(false)
+    {
+        flush();
+        const int fd {std::exchange(fd_, -1)};
+        if (::close(fd) != 0)
+            throw std::runtime_error("Cannot write file: " + path_ + " (" + std::strerror(errno) + ")");
+    }
+
+} // namespace kmx::gis
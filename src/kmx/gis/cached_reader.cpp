@@ -0,0 +1,188 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file cached_reader.cpp
+#include "kmx/gis/cached_reader.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace kmx::gis
+{
+    // Owns a read-only file descriptor shared by the loader copies.
+    struct file_descriptor
+    {
+        explicit file_descriptor(const int value) noexcept: fd {value} {}
+        ~file_descriptor() noexcept { ::close(fd); }
+        file_descriptor(const file_descriptor&) = delete;
+        file_descriptor& operator=(const file_descriptor&) = delete;
+
+        int fd; /// The descriptor.
+    };
+
+    cached_reader::cached_reader(block_cache& cache, const std::string& name, const std::uint64_t size, loader load) noexcept(false):
+        cache_ {cache},
+        name_ {name},
+        source_ {cache.source_id(name)},
+        size_ {size},
+        load_ {std::move(load)}
+    {
+    }
+
+    // Opens a URL with an HTTP range reader, or a local file with pread; the cache key includes size and mtime.
+    std::unique_ptr<cached_reader> cached_reader::open(block_cache& cache, const std::string& path) noexcept(false)
+    {
+        if (http_range_reader::is_url(path))
+        {
+            auto http = std::make_shared<http_range_reader>(path);
+            const std::uint64_t size {http->size()};
+            return std::make_unique<cached_reader>(cache, path, size, [http](const std::uint64_t offset, const std::span<std::uint8_t> out)
+                                                   { http->read_into(offset, out); });
+        }
+
+        auto file = std::make_shared<file_descriptor>(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        struct stat file_stat {};
+        if ((file->fd < 0) || (::fstat(file->fd, &file_stat) != 0) || !S_ISREG(file_stat.st_mode))
+            throw std::runtime_error("Cannot open file: " + path + " (" + std::strerror(errno) + ")");
+        const std::uint64_t size {static_cast<std::uint64_t>(file_stat.st_size)};
+        const std::string key {path + '@' + std::to_string(size) + ':' + std::to_string(file_stat.st_mtim.tv_sec) + '.' +
+                               std::to_string(file_stat.st_mtim.tv_nsec)};
+        auto reader = std::make_unique<cached_reader>(
+            cache, key, size,
+            [file, path](const std::uint64_t offset, const std::span<std::uint8_t> out)
+            {
+                for (std::size_t done {}; done < out.size();)
+                {
+                    const ssize_t read_size {::pread(file->fd, out.data() + done, out.size() - done, static_cast<off_t>(offset + done))};
+                    if (read_size < 0 && (errno == EINTR))
+                        continue;
+                    if (read_size <= 0)
+                        throw std::runtime_error("Cannot read file: " + path);
+                    done += static_cast<std::size_t>(read_size);
+                }
+            });
+        reader->name_ = path;
+        return reader;
+    }
+
+    std::size_t cached_reader::block_length(const std::uint64_t block) const noexcept
+    {
+        const std::uint64_t begin {block * cache_.block_size()};
+        return static_cast<std::size_t>(std::min<std::uint64_t>(cache_.block_size(), size_ - begin));
+    }
+
+    void cached_reader::load(const std::uint64_t offset, const std::span<std::uint8_t> out) noexcept(false)
+    {
+        load_(offset, out);
+        ++load_count_;
+        bytes_loaded_ += out.size();
+    }
+
+    // Loads the run into one buffer with a single call, then splits it into cache blocks.
+    void cached_reader::load_run(const block_run& run, const bool pin,
+                                 const std::span<std::shared_ptr<const cached_block>> out) noexcept(false)
+    {
+        const std::uint64_t begin {run.first * cache_.block_size()};
+        const std::uint64_t end {std::min<std::uint64_t>((run.first + run.count) * cache_.block_size(), size_)};
+        std::vector<std::uint8_t> bytes(static_cast<std::size_t>(end - begin));
+        load(begin, bytes);
+
+        for (std::uint64_t i {}; i < run.count; ++i)
+        {
+            std::shared_ptr<cached_block> block {cache_.allocate()};
+            block->size = block_length(run.first + i);
+            std::memcpy(block->data.get(), bytes.data() + i * cache_.block_size(), block->size);
+            std::shared_ptr<const cached_block> resident {cache_.insert(source_, run.first + i, std::move(block), pin)};
+            if (!out.empty())
+                out[static_cast<std::size_t>(i)] = std::move(resident);
+        }
+    }
+
+    void cached_reader::read(const std::uint64_t offset, const std::span<std::uint8_t> out, const bool pin) noexcept(false)
+    {
+        if (out.empty())
+            return;
+        if ((offset > size_) || (out.size() > size_ - offset))
+            throw std::runtime_error("Read outside of the file: " + name_);
+
+        const std::uint64_t first {offset / cache_.block_size()};
+        const std::uint64_t last {(offset + out.size() - 1u) / cache_.block_size()};
+        std::vector<std::shared_ptr<const cached_block>> blocks(static_cast<std::size_t>(last - first + 1u));
+        for (std::uint64_t block {first}; block <= last; ++block)
+            blocks[static_cast<std::size_t>(block - first)] = cache_.find(source_, block, pin);
+
+        // Load each run of missing blocks with one call.
+        for (std::size_t i {}; i < blocks.size();)
+        {
+            if (blocks[i] != nullptr)
+            {
+                ++i;
+                continue;
+            }
+            std::size_t count {1u};
+            while (((i + count) < blocks.size()) && (blocks[i + count] == nullptr) && (count < max_run_blocks_))
+                ++count;
+            load_run({first + i, count}, pin, std::span {blocks}.subspan(i, count));
+            i += count;
+        }
+
+        std::size_t done {};
+        for (std::size_t i {}; i < blocks.size(); ++i)
+        {
+            const std::uint64_t block_begin {(first + i) * cache_.block_size()};
+            const std::size_t skip {static_cast<std::size_t>((offset + done) - block_begin)};
+            const std::size_t step {std::min(out.size() - done, blocks[i]->size - skip)};
+            std::memcpy(out.data() + done, blocks[i]->data.get() + skip, step);
+            done += step;
+        }
+    }
+
+    std::vector<std::uint8_t> cached_reader::read(const byte_range range) noexcept(false)
+    {
+        std::vector<std::uint8_t> bytes(static_cast<std::size_t>(range.length));
+        read(range.offset, bytes);
+        return bytes;
+    }
+
+    void cached_reader::read_uncached(const std::uint64_t offset, const std::span<std::uint8_t> out) noexcept(false)
+    {
+        if ((offset > size_) || (out.size() > size_ - offset))
+            throw std::runtime_error("Read outside of the file: " + name_);
+        if (!out.empty())
+            load(offset, out);
+    }
+
+    // Collects the missing blocks of all ranges, groups them into runs and loads the runs in parallel.
+    void cached_reader::prefetch(const std::span<const byte_range> ranges, thread_pool& pool) noexcept(false)
+    {
+        std::vector<std::uint64_t> blocks {};
+        for (const byte_range& range: ranges)
+        {
+            if ((range.length == 0u) || (range.offset >= size_))
+                continue;
+            const std::uint64_t end {std::min(range.offset + range.length, size_)};
+            for (std::uint64_t block {range.offset / cache_.block_size()}; block <= (end - 1u) / cache_.block_size(); ++block)
+                blocks.push_back(block);
+        }
+        std::sort(blocks.begin(), blocks.end());
+        blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+        std::erase_if(blocks, [this](const std::uint64_t block) { return cache_.contains(source_, block); });
+
+        std::vector<block_run> runs {};
+        for (const std::uint64_t block: blocks)
+            if (!runs.empty() && ((runs.back().first + runs.back().count) == block) && (runs.back().count < max_run_blocks_))
+                ++runs.back().count;
+            else
+                runs.push_back({block, 1u});
+
+        pool.parallel_for(runs.size(), 1u,
+                          [&](const std::size_t begin, const std::size_t end)
+                          {
+                              for (std::size_t r {begin}; r < end; ++r)
+                                  load_run(runs[r], false, {});
+                          });
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,168 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file container_limits.cpp
+#include "kmx/gis/container_limits.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <sched.h>
+#include <thread>
+
+namespace kmx::gis
+{
+    // /proc/self/cgroup lists "<id>:<controllers>:<path>" per hierarchy; v2 is the line "0::<path>". A controller
+    // attached to a v1 hierarchy is absent from v2 (hybrid setups mount v2 at "unified"), so the v1 line wins. Inside a
+    // cgroup namespace the path is "/" and the limits sit at the root; without one, the path may not exist under the
+    // mount (a container mounting only its own subtree), so only the existing directories are kept.
+    std::vector<std::filesystem::path> container_limits::cgroup_directories(const std::string_view v1_controller,
+                                                                            bool& is_v2) noexcept(false)
+    {
+        std::ifstream cgroups {"/proc/self/cgroup"};
+        std::string line {};
+        std::optional<std::filesystem::path> base {};
+        std::string relative {};
+        std::optional<std::string> v2_relative {};
+        while (std::getline(cgroups, line))
+        {
+            const std::size_t first {line.find(':')};
+            const std::size_t second {(first == std::string::npos) ? std::string::npos : line.find(':', first + 1u)};
+            if (second == std::string::npos)
+                continue;
+            const std::string_view controllers {std::string_view {line}.substr(first + 1u, second - first - 1u)};
+            if (controllers.empty() && line.starts_with("0:"))
+                v2_relative = line.substr(second + 1u);
+            for (std::size_t start {}, comma {}; !controllers.empty() && (start <= controllers.size()); start = comma + 1u)
+            {
+                comma = std::min(controllers.find(',', start), controllers.size());
+                if (controllers.substr(start, comma - start) == v1_controller)
+                {
+                    base = std::filesystem::path {cgroup_root_} / std::string {controllers};
+                    relative = line.substr(second + 1u);
+                }
+            }
+        }
+        is_v2 = !base.has_value() && v2_relative.has_value();
+        if (is_v2)
+        {
+            std::error_code error {};
+            const std::filesystem::path root {cgroup_root_};
+            base = std::filesystem::exists(root / "cgroup.controllers", error) ? root : (root / "unified");
+            relative = *v2_relative;
+        }
+
+        std::vector<std::filesystem::path> directories {};
+        if (!base.has_value())
+            return directories;
+        std::error_code error {};
+        for (std::filesystem::path directory {*base / std::filesystem::path {relative}.relative_path()};;
+             directory = directory.parent_path())
+        {
+            if (std::filesystem::is_directory(directory, error))
+                directories.push_back(directory);
+            if ((directory == *base) || !directory.has_relative_path() || (directory.parent_path() == directory))
+                break;
+        }
+        return directories;
+    }
+
+    std::string container_limits::first_word(const std::filesystem::path& path) noexcept(false)
+    {
+        std::ifstream file {path};
+        std::string word {};
+        file >> word;
+        return word;
+    }
+
+    std::optional<std::uint64_t> container_limits::parse_number(const std::string_view text) noexcept
+    {
+        std::uint64_t value {};
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if ((error != std::errc {}) || (end != text.data() + text.size()))
+            return std::nullopt;
+        return value;
+    }
+
+    std::optional<std::uint64_t> container_limits::memory_limit() noexcept(false)
+    {
+        bool is_v2 {};
+        std::optional<std::uint64_t> limit {};
+        for (const std::filesystem::path& directory: cgroup_directories("memory", is_v2))
+        {
+            const std::optional<std::uint64_t> value {
+                parse_number(first_word(directory / (is_v2 ? "memory.max" : "memory.limit_in_bytes")))};
+            if (!value.has_value() || (*value >= v1_unlimited_)) // "max", empty or unset
+                continue;
+            limit = std::min(limit.value_or(*value), *value);
+        }
+        return limit;
+    }
+
+    // v2 writes "<quota> <period>" (quota "max" if unset) to one file; v1 splits them, with a quota of -1 if unset
+    std::optional<double> container_limits::cpu_quota() noexcept(false)
+    {
+        bool is_v2 {};
+        std::optional<double> limit {};
+        for (const std::filesystem::path& directory: cgroup_directories("cpu", is_v2))
+        {
+            std::string quota_text {};
+            std::string period_text {};
+            if (is_v2)
+            {
+                std::ifstream file {directory / "cpu.max"};
+                file >> quota_text >> period_text;
+            }
+            else
+            {
+                quota_text = first_word(directory / "cpu.cfs_quota_us");
+                period_text = first_word(directory / "cpu.cfs_period_us");
+            }
+            const std::optional<std::uint64_t> quota {parse_number(quota_text)};
+            const std::optional<std::uint64_t> period {parse_number(period_text)};
+            if (!quota.has_value() || !period.has_value() || (*quota == 0u) || (*period == 0u))
+                continue;
+            const double cpus {static_cast<double>(*quota) / static_cast<double>(*period)};
+            limit = std::min(limit.value_or(cpus), cpus);
+        }
+        return limit;
+    }
+
+    // The mask is sized for the CPUs of the host, which may exceed the fixed 1024 of `cpu_set_t`
+    std::uint32_t container_limits::affinity_cpus() noexcept
+    {
+        const int cpu_count {static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u))};
+        for (int capacity {std::max(cpu_count, CPU_SETSIZE)}; capacity <= (1 << 20); capacity *= 2)
+        {
+            cpu_set_t* const mask {CPU_ALLOC(capacity)};
+            if (mask == nullptr)
+                return 0u;
+            const std::size_t size {CPU_ALLOC_SIZE(capacity)};
+            CPU_ZERO_S(size, mask);
+            const bool read {::sched_getaffinity(0, size, mask) == 0};
+            const int error {read ? 0 : errno};
+            const int count {read ? CPU_COUNT_S(size, mask) : 0};
+            CPU_FREE(mask);
+            if (read)
+                return static_cast<std::uint32_t>(count);
+            if (error != EINVAL) // EINVAL: the kernel mask is larger than `capacity`
+                return 0u;
+        }
+        return 0u;
+    }
+
+    // A fractional quota is rounded down: a thread more than the quota only gets throttled, and throttled workers hold
+    // their chunks back from the ordered writer
+    cpu_allowance container_limits::cpus() noexcept(false)
+    {
+        cpu_allowance allowance {};
+        allowance.online = std::thread::hardware_concurrency();
+        allowance.affinity = affinity_cpus();
+        allowance.quota = cpu_quota();
+        std::uint32_t usable {(allowance.affinity > 0u) ? allowance.affinity : allowance.online};
+        if (allowance.quota.has_value())
+            usable = std::min(usable, static_cast<std::uint32_t>(std::floor(*allowance.quota)));
+        allowance.effective = std::max(usable, 1u);
+        return allowance;
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,98 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file csv_format.cpp
+#include "kmx/gis/csv_format.hpp"
+#include <iomanip>
+
+namespace kmx::gis
+{
+    // Writes a string field, quoting it if necessary.
+    void csv_format::write_escaped(std::ostream& out, const std::string_view value) noexcept(false)
+    {
+        static constexpr char quote_char {'"'};
+        static constexpr std::string_view escaped_quote {"\"\""};
+
+        // Check if the string contains characters that need escaping (comma, double quote, newline)
+        if (value.find_first_of(",\"\n") == std::string_view::npos)
+        {
+            out << value;
+            return;
+        }
+
+        out << quote_char;
+        for (const char c: value)
+            if (c == quote_char)
+                out << escaped_quote;
+            else
+                out << c;
+        out << quote_char;
+    }
+
+    // Writes the CSV header row to the output file stream.
+    void csv_format::write_bbox_header(std::ostream& out_file) noexcept(false)
+    {
+        out_file << "uat_name" << delimiter << "uat_code" << delimiter << "county_code_mn" << delimiter << "min_x"
+                 << delimiter << "min_y" << delimiter << "max_x" << delimiter << "max_y" << delimiter << "bbox_area_km2"
+                 << newline_;
+    }
+
+    // Writes a single CSV data row for a feature to the output file stream.
+    void csv_format::write_bbox_row(std::ostream& out_file, const std::string_view uat_name, const std::uint32_t uat_code,
+                                    const county_code& county_mn, const bounding_box& bbox) noexcept(false)
+    {
+        // Write UAT name (escaped)
+        write_escaped(out_file, uat_name);
+        // Add delimiter
+        out_file << delimiter;
+
+        // Write UAT code directly
+        out_file << uat_code;
+
+        // Add delimiter
+        out_file << delimiter;
+        // Write County MN code (escaped, using its to_string method)
+        write_escaped(out_file, county_mn.to_string());
+        // Add delimiter
+        out_file << delimiter;
+
+        // Store and restore original stream flags and precision for coordinate formatting
+        const std::ios_base::fmtflags original_flags_coords {out_file.flags()};
+        const std::streamsize original_precision_coords {out_file.precision()};
+        out_file << std::fixed << std::setprecision(bounding_box::csv_coordinate_precision);
+
+        if (bbox.is_valid)
+            out_file << bbox.min_x << delimiter << bbox.min_y << delimiter << bbox.max_x << delimiter << bbox.max_y;
+        // Write empty fields if bbox is not valid
+        else
+            out_file << delimiter << delimiter << delimiter;
+
+        // Restore original stream flags and precision after writing coordinates
+        out_file.flags(original_flags_coords);
+        out_file.precision(original_precision_coords);
+
+        // Add delimiter
+        out_file << delimiter;
+
+        // Calculate and write bounding box area if valid
+        if (bbox.is_valid)
+        {
+            const double width_m {(bbox.max_x - bbox.min_x)};
+            const double height_m {(bbox.max_y - bbox.min_y)};
+            const double area_sq_m {(width_m * height_m)};
+            const double area_sq_km {(area_sq_m / square_meters_in_square_kilometer_)};
+
+            // Store and restore original stream flags and precision for area formatting
+            const std::ios_base::fmtflags original_flags_area {out_file.flags()};
+            const std::streamsize original_precision_area {out_file.precision()};
+
+            // Write area with fixed precision (1 decimal place)
+            out_file << std::fixed << std::setprecision(1) << area_sq_km;
+
+            // Restore original stream flags and precision
+            out_file.flags(original_flags_area);
+            out_file.precision(original_precision_area);
+        }
+        // End the CSV row
+        out_file << newline_;
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,168 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file duplicate_finder.cpp
+#include "kmx/gis/duplicate_finder.hpp"
+#include "kmx/gis/feature_properties.hpp"
+#include "kmx/gis/fgb_writer.hpp"
+#include "kmx/gis/geometry_processor.hpp"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <optional>
+
+namespace kmx::gis
+{
+    duplicate_finder::duplicate_finder(const std::string& input_fgb_path, const std::string& output_path,
+                                       const std::uint32_t num_threads) noexcept(false):
+        output_path_ {output_path},
+        thread_pool_ {num_threads},
+        dataset_ {input_fgb_path}
+    {
+        std::cout << "Thread pool initialized with " << num_threads << " threads.\n";
+    }
+
+    bool duplicate_finder::canonicalize(const std::uint64_t index, std::vector<ring_view>& rings, std::vector<std::uint64_t>& words) const
+        noexcept(false)
+    {
+        const FlatGeobuf::Feature* const feature {dataset_.feature(index)};
+        geometry_processor::collect_rings(feature->geometry(), dataset_.geometry_type_of(feature->geometry()), rings);
+        return geometry_hash::canonicalize(rings, words);
+    }
+
+    bool duplicate_finder::find() noexcept(false)
+    {
+        const std::uint64_t feature_count {dataset_.feature_count()};
+        const std::size_t chunk_size {std::max<std::size_t>(1u, feature_count / (thread_pool_.size() * 8u + 1u))};
+
+        // Hashing pass: every canonical form goes into the map, which chains the features of every hash
+        std::vector<std::uint64_t> next_same_hash(feature_count, no_feature_);
+        thread_pool_.parallel_for(feature_count, chunk_size,
+                                  [&](const std::size_t begin, const std::size_t end)
+                                  {
+                                      scratch buffers {};
+                                      const std::size_t ahead {dataset_.prefetch_distance()};
+                                      for (std::size_t i {begin}; i < end; ++i)
+                                      {
+                                          if ((i + ahead) < end)
+                                              dataset_.prefetch_feature(i + ahead);
+                                          if (!canonicalize(i, buffers.rings, buffers.words))
+                                              continue;
+                                          const geometry_hash hash {geometry_hash::of_words(buffers.words)};
+                                          shard& part {shard_of(hash)};
+                                          std::lock_guard<std::mutex> lock {part.mutex};
+                                          const auto [it, inserted] = part.chains.try_emplace(hash, i);
+                                          if (!inserted)
+                                          {
+                                              next_same_hash[i] = it->second;
+                                              it->second = i;
+                                          }
+                                      }
+                                  });
+
+        // Confirmation pass (the map is read-only now), one task per shard: the features of a chain are compared, in
+        // index order, with every distinct geometry of the chain met so far; a feature equal to none of them starts one
+        std::vector<std::uint64_t> duplicate_of(feature_count);
+        std::iota(duplicate_of.begin(), duplicate_of.end(), std::uint64_t {});
+        std::atomic<std::uint64_t> collisions {};
+        thread_pool_.parallel_for(shard_count_, 1u,
+                                  [&](const std::size_t begin, const std::size_t end)
+                                  {
+                                      scratch buffers {};
+                                      for (std::size_t s {begin}; s < end; ++s)
+                                          for (const auto& [hash, head]: shards_[s].chains)
+                                          {
+                                              if (next_same_hash[head] == no_feature_)
+                                                  continue;
+                                              buffers.members.clear();
+                                              for (std::uint64_t i {head}; i != no_feature_; i = next_same_hash[i])
+                                                  buffers.members.push_back(i);
+                                              std::sort(buffers.members.begin(), buffers.members.end());
+
+                                              buffers.leaders.clear();
+                                              for (const std::uint64_t i: buffers.members)
+                                              {
+                                                  const std::size_t distinct {buffers.leaders.size()};
+                                                  if (buffers.forms.size() == distinct)
+                                                      buffers.forms.emplace_back();
+                                                  canonicalize(i, buffers.rings, buffers.forms[distinct]);
+                                                  std::size_t match {};
+                                                  while ((match < distinct) && (buffers.forms[match] != buffers.forms[distinct]))
+                                                      ++match;
+                                                  if (match < distinct)
+                                                      duplicate_of[i] = buffers.leaders[match];
+                                                  else
+                                                      buffers.leaders.push_back(i);
+                                              }
+                                              collisions.fetch_add(buffers.leaders.size() - 1u, std::memory_order_relaxed);
+                                          }
+                                  });
+
+        std::uint64_t duplicates {};
+        std::vector<std::uint8_t> is_group(feature_count);
+        for (std::uint64_t i {}; i < feature_count; ++i)
+            if (duplicate_of[i] != i)
+            {
+                ++duplicates;
+                is_group[duplicate_of[i]] = 1u;
+            }
+        std::cout << "Found " << duplicates << " duplicate features of " << std::count(is_group.begin(), is_group.end(), 1u)
+                  << " geometries among " << feature_count << " features (" << collisions.load()
+                  << " hash collisions between distinct geometries resolved)." << std::endl;
+
+        return output_path_.ends_with(".fgb") ? write_deduplicated(duplicate_of) : write_report(duplicate_of);
+    }
+
+    // Keeps the first feature of every group, in file order.
+    bool duplicate_finder::write_deduplicated(const std::vector<std::uint64_t>& duplicate_of) const noexcept(false)
+    {
+        std::vector<fgb_feature_entry> entries {};
+        for (std::uint64_t i {}; i < duplicate_of.size(); ++i)
+            if (duplicate_of[i] == i)
+                entries.push_back({dataset_.feature_bytes(i), dataset_.feature_bbox(i)});
+
+        const fgb_writer writer {dataset_.header()};
+        if (!writer.write(output_path_, entries))
+            return false;
+        std::cout << "Kept " << entries.size() << " of " << duplicate_of.size() << " features." << std::endl;
+        std::cout << "Output written to: " << output_path_ << std::endl;
+        return true;
+    }
+
+    bool duplicate_finder::write_report(const std::vector<std::uint64_t>& duplicate_of) const noexcept(false)
+    {
+        std::ofstream output_file {output_path_};
+        if (!output_file.is_open())
+        {
+            std::cerr << "Error: Could not open CSV file for writing: " << output_path_ << std::endl;
+            return false;
+        }
+
+        const std::optional<std::size_t> code_column {dataset_.find_column(expected_uat_code_column_)};
+        if (!code_column.has_value())
+            std::cout << "Warning: Could not find the expected UAT code property '" << expected_uat_code_column_
+                      << "'. UAT codes will be written as 0." << std::endl;
+        const auto uat_code = [&](const std::uint64_t index)
+        {
+            if (!code_column.has_value())
+                return std::uint32_t {};
+            return feature_properties::parse_uint32(
+                       feature_properties::get_string_value(dataset_.feature(index), dataset_.header(), *code_column))
+                .value_or(0u);
+        };
+
+        output_file << "feature_index,uat_code,duplicate_of,duplicate_of_uat_code\n";
+        for (std::uint64_t i {}; i < duplicate_of.size(); ++i)
+            if (duplicate_of[i] != i)
+                output_file << i << ',' << uat_code(i) << ',' << duplicate_of[i] << ',' << uat_code(duplicate_of[i]) << '\n';
+
+        if (!output_file)
+        {
+            std::cerr << "Error: Failed writing CSV file: " << output_path_ << std::endl;
+            return false;
+        }
+        std::cout << "Output written to: " << output_path_ << std::endl;
+        return true;
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,344 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file feature_properties.cpp
+#include "kmx/gis/feature_properties.hpp"
+#include <cctype>    // For std::isspace
+#include <charconv>  // For std::from_chars
+#include <iomanip>   // For std::setprecision, std::fixed
+#include <iostream>  // For std::cerr, std::endl
+#include <sstream>   // For std::ostringstream
+#include <system_error>
+
+namespace kmx::gis
+{
+    // Precision for floating-point properties when converted to string.
+    static constexpr int property_double_precision {15};
+
+    /// @brief Helper template to read a scalar value from a byte pointer and convert it to a string.
+    template <typename T>
+    static std::string read_scalar_as_string_static_helper(const std::uint8_t* value_ptr,
+                                                           const flatbuffers::uoffset_t remaining_size_at_value,
+                                                           flatbuffers::uoffset_t& bytes_read_for_this_scalar) noexcept(false)
+    {
+        bytes_read_for_this_scalar = {}; // Initialize bytes read
+        // Check if there's enough data to read the scalar
+        if (sizeof(T) > remaining_size_at_value)
+            return {};
+
+        bytes_read_for_this_scalar = sizeof(T);
+        return std::to_string(::flatbuffers::ReadScalar<T>(value_ptr));
+    }
+
+    /// @brief Specialization of read_scalar_as_string_static_helper for float, with specific precision.
+    template <>
+    std::string read_scalar_as_string_static_helper<float>(const std::uint8_t* value_ptr,
+                                                           const flatbuffers::uoffset_t remaining_size_at_value,
+                                                           flatbuffers::uoffset_t& bytes_read_for_this_scalar) noexcept(false)
+    {
+        bytes_read_for_this_scalar = {};
+        if (sizeof(float) > remaining_size_at_value)
+            return {};
+
+        bytes_read_for_this_scalar = sizeof(float);
+        std::ostringstream oss {}; // std::ostringstream can allocate
+        oss << std::fixed << std::setprecision(property_double_precision) << ::flatbuffers::ReadScalar<float>(value_ptr);
+        return oss.str();
+    }
+
+    /// @brief Specialization of read_scalar_as_string_static_helper for double, with specific precision.
+    template <>
+    std::string read_scalar_as_string_static_helper<double>(const std::uint8_t* value_ptr,
+                                                            const flatbuffers::uoffset_t remaining_size_at_value,
+                                                            flatbuffers::uoffset_t& bytes_read_for_this_scalar) noexcept(false)
+    {
+        bytes_read_for_this_scalar = {};
+        if (sizeof(double) > remaining_size_at_value)
+            return {};
+
+        bytes_read_for_this_scalar = sizeof(double);
+        std::ostringstream oss {}; // std::ostringstream can allocate
+        oss << std::fixed << std::setprecision(property_double_precision) << ::flatbuffers::ReadScalar<double>(value_ptr);
+        return oss.str();
+    }
+
+    // Finds the index of a property (column) by its name.
+    std::optional<std::size_t> feature_properties::find_column_index(const FlatGeobuf::Header* const fbs_header,
+                                                                     const std::string_view property_name_to_find) noexcept
+    {
+        // Check for null header or columns
+        if ((fbs_header == nullptr) || (fbs_header->columns() == nullptr))
+            return {}; // Return empty optional
+
+        const auto* const fbs_columns {fbs_header->columns()};
+        // Iterate through columns to find a match by name
+        for (flatbuffers::uoffset_t i {}; i < fbs_columns->size(); ++i)
+        {
+            const FlatGeobuf::Column* const col {fbs_columns->Get(i)};
+            // Check if column and its name exist, then compare the name
+            if ((col != nullptr) && (col->name() != nullptr) && (col->name()->string_view() == property_name_to_find))
+                return static_cast<std::size_t>(i); // Return index if found
+        }
+
+        return {}; // Property not found
+    }
+
+    // Retrieves the string value of a specific property for a feature by its column index.
+    std::string feature_properties::get_string_value(const FlatGeobuf::Feature* const fbs_feature,
+                                                     const FlatGeobuf::Header* const fbs_header,
+                                                     const std::size_t target_column_index) noexcept(false)
+    {
+        // Validate input parameters
+        if ((fbs_feature == nullptr) || (fbs_feature->properties() == nullptr) || (fbs_header == nullptr) ||
+            (fbs_header->columns() == nullptr) || (target_column_index >= fbs_header->columns()->size()))
+            return {};
+
+        const auto* const properties_fbs_vector {fbs_feature->properties()};
+        const std::uint8_t* const properties_data_ptr {properties_fbs_vector->data()};
+        const flatbuffers::uoffset_t properties_blob_size {properties_fbs_vector->size()};
+        flatbuffers::uoffset_t current_offset_in_blob {};
+
+        // Properties are stored as: (uint16_t column_index, T value)...
+        while (current_offset_in_blob < properties_blob_size)
+        {
+            // Check if we can read the column index (uint16_t)
+            if ((current_offset_in_blob + sizeof(std::uint16_t)) > properties_blob_size)
+                break; // Not enough data for another column index
+
+            const std::uint16_t current_fbs_col_idx {
+                ::flatbuffers::ReadScalar<std::uint16_t>(properties_data_ptr + current_offset_in_blob)};
+            current_offset_in_blob += sizeof(std::uint16_t);
+
+            // Validate column index from properties data
+            if (current_fbs_col_idx >= fbs_header->columns()->size())
+            {
+                std::cerr << "Warning: Corrupt property column index " << current_fbs_col_idx
+                          << " encountered for feature. Offset: " << (current_offset_in_blob - sizeof(std::uint16_t)) << std::endl;
+                return {};
+            }
+
+            const FlatGeobuf::Column* const column_schema {fbs_header->columns()->Get(current_fbs_col_idx)};
+            // Should not happen if index is valid
+            if (column_schema == nullptr)
+            {
+                std::cerr << "Warning: Could not get column schema for index " << current_fbs_col_idx << "." << std::endl;
+                return {};
+            }
+
+            const FgbColumnType col_type {column_schema->type()};
+
+            // If this is the target column, read its value
+            if (static_cast<std::size_t>(current_fbs_col_idx) == target_column_index)
+            {
+                flatbuffers::uoffset_t bytes_read_for_this_value {};
+                return read_and_convert_value_at_offset(col_type, properties_data_ptr, current_offset_in_blob, properties_blob_size,
+                                                        bytes_read_for_this_value);
+            }
+            // Otherwise, skip this property's value to get to the next one
+            else
+            {
+                const flatbuffers::uoffset_t bytes_to_skip_for_value =
+                    skip_value_at_offset(col_type, properties_data_ptr, current_offset_in_blob, properties_blob_size);
+
+                // Ensure skipping does not go past the end of the blob
+                if (bytes_to_skip_for_value > (properties_blob_size - current_offset_in_blob))
+                {
+                    std::cerr << "Warning: Property skipping would read past blob end for column index " << current_fbs_col_idx << " (type "
+                              << static_cast<int>(col_type) << "). Offset: " << current_offset_in_blob << std::endl;
+                    break;
+                }
+
+                current_offset_in_blob += bytes_to_skip_for_value;
+            }
+        }
+
+        return {}; // Target column not found
+    }
+
+    // Trims surrounding whitespace and parses the remainder as an unsigned 32-bit integer.
+    std::optional<std::uint32_t> feature_properties::parse_uint32(std::string_view text) noexcept
+    {
+        const auto is_space = [](const char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; };
+        while (!text.empty() && is_space(text.front()))
+            text.remove_prefix(1u);
+        while (!text.empty() && is_space(text.back()))
+            text.remove_suffix(1u);
+        if (text.empty())
+            return {};
+
+        std::uint32_t value {};
+        const char* const p_end {text.data() + text.size()};
+        const auto result = std::from_chars(text.data(), p_end, value);
+        // Only a successful and full parse is accepted
+        if ((result.ec != std::errc()) || (result.ptr != p_end))
+            return {};
+        return value;
+    }
+
+    // Reads a property value from the properties blob and converts it to a string.
+    std::string feature_properties::read_and_convert_value_at_offset(const FgbColumnType col_type,
+                                                                     const std::uint8_t* const properties_data_start,
+                                                                     const flatbuffers::uoffset_t value_offset_in_blob,
+                                                                     const flatbuffers::uoffset_t properties_blob_size,
+                                                                     flatbuffers::uoffset_t& bytes_read_for_value) noexcept(false)
+    {
+        bytes_read_for_value = {}; // Initialize bytes read
+        // Check if offset is out of bounds
+        if (value_offset_in_blob >= properties_blob_size)
+            return {};
+
+        const std::uint8_t* const current_value_ptr {properties_data_start + value_offset_in_blob};
+        const flatbuffers::uoffset_t remaining_size_from_value_ptr {properties_blob_size - value_offset_in_blob};
+
+        // Handle different property types
+        switch (col_type)
+        {
+            case FgbColumnType::Byte:
+                return read_scalar_as_string_static_helper<std::int8_t>(current_value_ptr, remaining_size_from_value_ptr,
+                                                                        bytes_read_for_value);
+            case FgbColumnType::UByte:
+                return read_scalar_as_string_static_helper<std::uint8_t>(current_value_ptr, remaining_size_from_value_ptr,
+                                                                         bytes_read_for_value);
+            case FgbColumnType::Bool:
+            {
+                std::string bool_val_str {read_scalar_as_string_static_helper<std::uint8_t>(
+                    current_value_ptr, remaining_size_from_value_ptr, bytes_read_for_value)};
+                // Convert "0" to "false", non-"0" (typically "1") to "true"
+                return bool_val_str.empty() ? std::string {} : ((bool_val_str == "0") ? "false" : "true");
+            }
+            case FgbColumnType::Short:
+                return read_scalar_as_string_static_helper<std::int16_t>(current_value_ptr, remaining_size_from_value_ptr,
+                                                                         bytes_read_for_value);
+            case FgbColumnType::UShort:
+                return read_scalar_as_string_static_helper<std::uint16_t>(current_value_ptr, remaining_size_from_value_ptr,
+                                                                          bytes_read_for_value);
+            case FgbColumnType::Int:
+                return read_scalar_as_string_static_helper<std::int32_t>(current_value_ptr, remaining_size_from_value_ptr,
+                                                                         bytes_read_for_value);
+            case FgbColumnType::UInt:
+                return read_scalar_as_string_static_helper<std::uint32_t>(current_value_ptr, remaining_size_from_value_ptr,
+                                                                          bytes_read_for_value);
+            case FgbColumnType::Long:
+                return read_scalar_as_string_static_helper<std::int64_t>(current_value_ptr, remaining_size_from_value_ptr,
+                                                                         bytes_read_for_value);
+            case FgbColumnType::ULong:
+                return read_scalar_as_string_static_helper<std::uint64_t>(current_value_ptr, remaining_size_from_value_ptr,
+                                                                          bytes_read_for_value);
+            case FgbColumnType::Float:
+                return read_scalar_as_string_static_helper<float>(current_value_ptr, remaining_size_from_value_ptr, bytes_read_for_value);
+            case FgbColumnType::Double:
+                return read_scalar_as_string_static_helper<double>(current_value_ptr, remaining_size_from_value_ptr, bytes_read_for_value);
+            case FgbColumnType::String:
+            {
+                // String is stored as: uint32_t length, followed by char data[length]
+                // Check for enough data for string length
+                if (sizeof(std::uint32_t) > remaining_size_from_value_ptr)
+                    return {};
+                // Read string length
+                const std::uint32_t len {::flatbuffers::ReadScalar<std::uint32_t>(current_value_ptr)};
+                // Check for enough data for string content based on declared length
+                if ((sizeof(std::uint32_t) + len) > remaining_size_from_value_ptr)
+                {
+                    std::cerr << "Warning: String property declared length " << len << " exceeds available data ("
+                              << (remaining_size_from_value_ptr - sizeof(std::uint32_t)) << " bytes)." << std::endl;
+                    return {};
+                }
+                bytes_read_for_value = sizeof(std::uint32_t) + len;
+                return std::string(reinterpret_cast<const char*>(current_value_ptr + sizeof(std::uint32_t)), len);
+            }
+            // Other types like DateTime, Json, Binary are not handled here explicitly
+            default:
+                std::cerr << "Warning: Unhandled property type encountered in read_and_convert: " << static_cast<int>(col_type)
+                          << std::endl;
+                return {};
+        }
+    }
+
+    // Calculates the number of bytes a property value occupies in the properties blob, to skip it.
+    flatbuffers::uoffset_t feature_properties::skip_value_at_offset(const FgbColumnType col_type,
+                                                                    const std::uint8_t* const properties_data_start,
+                                                                    const flatbuffers::uoffset_t value_offset_in_blob,
+                                                                    const flatbuffers::uoffset_t properties_blob_size) noexcept
+    {
+        // Nothing to skip if offset is out of bounds
+        if (value_offset_in_blob >= properties_blob_size)
+            return {};
+
+        const std::uint8_t* const value_ptr {properties_data_start + value_offset_in_blob};
+        const flatbuffers::uoffset_t remaining_size {properties_blob_size - value_offset_in_blob};
+        flatbuffers::uoffset_t bytes_to_skip {};
+
+        // Helper lambda to check if we can skip 'needed' bytes
+        auto can_skip = [&](std::size_t needed) { return (needed <= remaining_size); };
+
+        switch (col_type)
+        {
+            case FgbColumnType::Byte:
+                bytes_to_skip = sizeof(std::int8_t);
+                break;
+            case FgbColumnType::UByte:
+                bytes_to_skip = sizeof(std::uint8_t);
+                break;
+            case FgbColumnType::Bool:
+                bytes_to_skip = sizeof(std::uint8_t);
+                break; // Bool is stored as byte
+            case FgbColumnType::Short:
+                bytes_to_skip = sizeof(std::int16_t);
+                break;
+            case FgbColumnType::UShort:
+                bytes_to_skip = sizeof(std::uint16_t);
+                break;
+            case FgbColumnType::Int:
+                bytes_to_skip = sizeof(std::int32_t);
+                break;
+            case FgbColumnType::UInt:
+                bytes_to_skip = sizeof(std::uint32_t);
+                break;
+            case FgbColumnType::Long:
+                bytes_to_skip = sizeof(std::int64_t);
+                break;
+            case FgbColumnType::ULong:
+                bytes_to_skip = sizeof(std::uint64_t);
+                break;
+            case FgbColumnType::Float:
+                bytes_to_skip = sizeof(float);
+                break;
+            case FgbColumnType::Double:
+                bytes_to_skip = sizeof(double);
+                break;
+            // Json, DateTime (ISO 8601 text) and Binary are length-prefixed like String
+            case FgbColumnType::String:
+            case FgbColumnType::Json:
+            case FgbColumnType::DateTime:
+            case FgbColumnType::Binary:
+            {
+                // Cannot even read length
+                if (!can_skip(sizeof(std::uint32_t)))
+                    return remaining_size; // Skip all remaining as a precaution
+                const std::uint32_t len {::flatbuffers::ReadScalar<std::uint32_t>(value_ptr)};
+                bytes_to_skip = sizeof(std::uint32_t) + len;
+                break;
+            }
+            default: // Unknown and any other unhandled types
+                std::cerr << "Warning: Attempting to skip unhandled or complex property type " << static_cast<int>(col_type)
+                          << " in skip_value_at_offset. Assuming length-prefixed like String/Binary." << std::endl;
+                // Attempt to read length as if it were a string/binary, as this is a common pattern for variable-size types.
+                if (!can_skip(sizeof(std::uint32_t)))
+                {
+                    std::cerr << "  Cannot even read length for presumed variable-size type. Skipping all remaining." << std::endl;
+                    return remaining_size;
+                }
+                const std::uint32_t len {::flatbuffers::ReadScalar<std::uint32_t>(value_ptr)};
+                bytes_to_skip = sizeof(std::uint32_t) + len;
+                if (!can_skip(bytes_to_skip))
+                {
+                    std::cerr << "  Calculated skip size " << bytes_to_skip << " for unhandled type " << static_cast<int>(col_type)
+                              << " exceeds remaining data (" << remaining_size << "). Skipping all remaining." << std::endl;
+                    return remaining_size;
+                }
+                break;
+        }
+
+        // Ensure we don't skip more than available
+        return can_skip(bytes_to_skip) ? bytes_to_skip : remaining_size;
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,53 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file feature_source.cpp
+#include "kmx/gis/feature_source.hpp"
+#include "kmx/gis/fgb_feature_source.hpp"
+#include "kmx/gis/ranged_fgb_feature_source.hpp"
+#include "kmx/gis/shapefile_feature_source.hpp"
+#include "kmx/gis/stream_feature_source.hpp"
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace kmx::gis
+{
+    // Opens the source matching the file type of `path`.
+    std::unique_ptr<feature_source> feature_source::open(const std::string& path, thread_pool& pool,
+                                                         block_cache* const cache) noexcept(false)
+    {
+        if (http_range_reader::is_url(path))
+        {
+            if (cache == nullptr)
+                throw std::runtime_error("A block cache is required to read " + path);
+            return std::make_unique<ranged_fgb_feature_source>(path, pool, *cache);
+        }
+        if (has_extension(path, ".shp"))
+            return std::make_unique<shapefile_feature_source>(path);
+        if (const std::optional<stream_format> format {stream_feature_source::format_of(path)}; format.has_value())
+            return std::make_unique<stream_feature_source>(path, *format, pool);
+        if (cache != nullptr)
+            return std::make_unique<ranged_fgb_feature_source>(path, pool, *cache);
+        return std::make_unique<fgb_feature_source>(path);
+    }
+
+    // Reads and drops the features before `position`.
+    bool feature_source::seek(const std::uint64_t position, const std::uint64_t offset) noexcept(false)
+    {
+        static_cast<void>(offset);
+        static constexpr std::size_t skip_batch_size {4096u};
+        feature_batch batch {};
+        for (std::uint64_t remaining {position}; remaining > 0u; remaining -= batch.size)
+            if (!next_batch(batch, static_cast<std::size_t>(std::min<std::uint64_t>(remaining, skip_batch_size))))
+                return false;
+        return true;
+    }
+
+    // True if `path` ends with `extension`, ignoring case.
+    bool feature_source::has_extension(const std::string_view path, const std::string_view extension) noexcept
+    {
+        return (path.size() > extension.size()) &&
+               std::equal(extension.begin(), extension.end(), path.end() - extension.size(),
+                          [](const char a, const char b) { return a == std::tolower(static_cast<unsigned char>(b)); });
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,324 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file fgb_augmenter.cpp
+#include "kmx/gis/fgb_augmenter.hpp"
+#include "flatgeobuf/packedrtree.h"
+#include "kmx/gis/feature_properties.hpp"
+#include "kmx/gis/fgb_writer.hpp"
+#include "kmx/gis/geometry_processor.hpp"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <limits>
+#include <optional>
+
+namespace kmx::gis
+{
+    template <class T>
+    static T read_scalar(const std::span<const std::uint8_t> bytes, const std::size_t offset) noexcept
+    {
+        T value {};
+        std::memcpy(&value, bytes.data() + offset, sizeof(T));
+        return value;
+    }
+
+    template <class T>
+    static void write_scalar(std::vector<std::uint8_t>& bytes, const std::size_t offset, const T value) noexcept
+    {
+        std::memcpy(bytes.data() + offset, &value, sizeof(T));
+    }
+
+    // Pads `bytes` with zeros from `base` on to a multiple of `alignment`.
+    static void pad_to(std::vector<std::uint8_t>& bytes, const std::size_t base, const std::size_t alignment) noexcept(false)
+    {
+        bytes.resize(base + (bytes.size() - base + alignment - 1u) / alignment * alignment);
+    }
+
+    /// @brief Location of the properties vector inside a size-prefixed feature buffer.
+    struct properties_slot
+    {
+        std::size_t field;    /// Offset of the table field holding the vector offset.
+        std::size_t vector;   /// Offset of the vector length.
+        std::uint32_t length; /// Length of the blob.
+    };
+
+    // Follows root offset, vtable and field offset through the raw bytes, checking every step against the buffer.
+    static std::optional<properties_slot> find_properties_slot(const std::span<const std::uint8_t> bytes) noexcept
+    {
+        static constexpr std::size_t slot {FlatGeobuf::Feature::VT_PROPERTIES};
+        const std::size_t size {bytes.size()};
+        if (size < 2u * sizeof(std::uint32_t))
+            return std::nullopt;
+        const std::size_t table {sizeof(std::uint32_t) + read_scalar<std::uint32_t>(bytes, sizeof(std::uint32_t))};
+        if ((table + sizeof(std::int32_t)) > size)
+            return std::nullopt;
+        const std::int64_t vtable {static_cast<std::int64_t>(table) - read_scalar<std::int32_t>(bytes, table)};
+        if ((vtable < 0) || (static_cast<std::size_t>(vtable) + sizeof(std::uint16_t) > size))
+            return std::nullopt;
+        const std::size_t vtable_size {read_scalar<std::uint16_t>(bytes, static_cast<std::size_t>(vtable))};
+        if ((vtable_size < slot + sizeof(std::uint16_t)) || (static_cast<std::size_t>(vtable) + vtable_size > size))
+            return std::nullopt;
+        const std::uint16_t field_offset {read_scalar<std::uint16_t>(bytes, static_cast<std::size_t>(vtable) + slot)};
+        const std::size_t field {table + field_offset};
+        if ((field_offset == 0u) || ((field + sizeof(std::uint32_t)) > size))
+            return std::nullopt;
+        const std::size_t vector {field + read_scalar<std::uint32_t>(bytes, field)};
+        if ((vector + sizeof(std::uint32_t)) > size)
+            return std::nullopt;
+        const std::uint32_t length {read_scalar<std::uint32_t>(bytes, vector)};
+        if ((vector + sizeof(std::uint32_t) + length) > size)
+            return std::nullopt;
+        return properties_slot {field, vector, length};
+    }
+
+    template <class T>
+    static flatbuffers::Offset<flatbuffers::Vector<T>> copy_vector(flatbuffers::FlatBufferBuilder& fbb,
+                                                                   const flatbuffers::Vector<T>* const vector) noexcept(false)
+    {
+        return (vector != nullptr) ? fbb.CreateVector(vector->data(), vector->size()) : flatbuffers::Offset<flatbuffers::Vector<T>> {};
+    }
+
+    // Deep-copies a geometry, parts first (a FlatBufferBuilder cannot nest objects).
+    static flatbuffers::Offset<FlatGeobuf::Geometry> copy_geometry(flatbuffers::FlatBufferBuilder& fbb,
+                                                                   const FlatGeobuf::Geometry* const geometry) noexcept(false)
+    {
+        if (geometry == nullptr)
+            return {};
+        flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<FlatGeobuf::Geometry>>> parts {};
+        if (geometry->parts() != nullptr)
+        {
+            std::vector<flatbuffers::Offset<FlatGeobuf::Geometry>> copies {};
+            for (flatbuffers::uoffset_t i {}; i < geometry->parts()->size(); ++i)
+                copies.push_back(copy_geometry(fbb, geometry->parts()->Get(i)));
+            parts = fbb.CreateVector(copies);
+        }
+        const auto ends = copy_vector(fbb, geometry->ends());
+        const auto xy = copy_vector(fbb, geometry->xy());
+        const auto z = copy_vector(fbb, geometry->z());
+        const auto m = copy_vector(fbb, geometry->m());
+        const auto t = copy_vector(fbb, geometry->t());
+        const auto tm = copy_vector(fbb, geometry->tm());
+        return FlatGeobuf::CreateGeometry(fbb, ends, xy, z, m, t, tm, geometry->type(), parts);
+    }
+
+    fgb_augmenter::fgb_augmenter(const std::string& input_fgb_path, const std::string& output_fgb_path,
+                                 const std::uint32_t num_threads) noexcept(false):
+        output_fgb_path_ {output_fgb_path},
+        thread_pool_ {num_threads},
+        dataset_ {input_fgb_path}
+    {
+        std::cout << "Thread pool initialized with " << num_threads << " threads.\n";
+    }
+
+    // Null values (the box of an empty geometry) are left out of the blob, as FlatGeobuf writers do.
+    fgb_augmenter::rewrite_kind fgb_augmenter::rewrite_feature(const std::uint64_t index, const bounding_box& bbox,
+                                                               std::vector<ring_view>& rings, std::vector<std::uint8_t>& out) const
+        noexcept(false)
+    {
+        const std::span<const std::uint8_t> source {dataset_.feature_bytes(index)};
+        const FlatGeobuf::Feature* const feature {dataset_.feature(index)};
+        // Property indices of features with their own schema refer to it, not to the header
+        if (feature->columns() != nullptr)
+        {
+            out.insert(out.end(), source.begin(), source.end());
+            return rewrite_kind::copied;
+        }
+
+        geometry_processor::collect_rings(feature->geometry(), dataset_.geometry_type_of(feature->geometry()), rings);
+        std::array<std::uint8_t, appended_columns.size() * (sizeof(std::uint16_t) + sizeof(double))> pairs {};
+        std::size_t pairs_size {};
+        const auto add_pair = [&](const std::size_t column, const double value)
+        {
+            const auto column_index = static_cast<std::uint16_t>(first_column_ + column);
+            std::memcpy(pairs.data() + pairs_size, &column_index, sizeof(column_index));
+            std::memcpy(pairs.data() + pairs_size + sizeof(column_index), &value, sizeof(value));
+            pairs_size += sizeof(column_index) + sizeof(value);
+        };
+        if (bbox.is_valid)
+        {
+            add_pair(0u, bbox.min_x);
+            add_pair(1u, bbox.min_y);
+            add_pair(2u, bbox.max_x);
+            add_pair(3u, bbox.max_y);
+        }
+        add_pair(4u, geometry_processor::area_of_rings(rings));
+        const std::span<const std::uint8_t> added {pairs.data(), pairs_size};
+
+        const std::size_t base {out.size()};
+        const std::optional<properties_slot> slot {find_properties_slot(source)};
+        if (!slot.has_value())
+        {
+            flatbuffers::FlatBufferBuilder fbb {};
+            const auto geometry = copy_geometry(fbb, feature->geometry());
+            std::vector<std::uint8_t> blob {};
+            if (feature->properties() != nullptr)
+                blob.assign(feature->properties()->data(), feature->properties()->data() + feature->properties()->size());
+            blob.insert(blob.end(), added.begin(), added.end());
+            const auto properties = fbb.CreateVector(blob);
+            fbb.FinishSizePrefixed(FlatGeobuf::CreateFeature(fbb, geometry, properties));
+            out.insert(out.end(), fbb.GetBufferPointer(), fbb.GetBufferPointer() + fbb.GetSize());
+            return rewrite_kind::re_encoded;
+        }
+
+        // FlatBuffers are built back to front, so the blob is often the last object: anything but padding after it
+        // (at least a 4-byte vector) means it cannot grow without moving a neighbour
+        const std::size_t blob_end {slot->vector + sizeof(std::uint32_t) + slot->length};
+        rewrite_kind kind {};
+        if ((source.size() - blob_end) < sizeof(std::uint32_t))
+        {
+            out.insert(out.end(), source.begin(), source.begin() + static_cast<std::ptrdiff_t>(blob_end));
+            out.insert(out.end(), added.begin(), added.end());
+            write_scalar<std::uint32_t>(out, base + slot->vector, static_cast<std::uint32_t>(slot->length + added.size()));
+            kind = rewrite_kind::extended;
+        }
+        else
+        {
+            // The field offset is unsigned and forward, which an appended vector satisfies
+            out.insert(out.end(), source.begin(), source.end());
+            pad_to(out, base, sizeof(std::uint32_t));
+            const std::size_t vector {out.size() - base};
+            out.resize(out.size() + sizeof(std::uint32_t));
+            write_scalar<std::uint32_t>(out, base + vector, static_cast<std::uint32_t>(slot->length + added.size()));
+            const std::size_t blob {slot->vector + sizeof(std::uint32_t)};
+            out.insert(out.end(), source.begin() + static_cast<std::ptrdiff_t>(blob),
+                       source.begin() + static_cast<std::ptrdiff_t>(blob_end));
+            out.insert(out.end(), added.begin(), added.end());
+            write_scalar<std::uint32_t>(out, base + slot->field, static_cast<std::uint32_t>(vector - slot->field));
+            kind = rewrite_kind::repointed;
+        }
+        // Keep the 8-byte alignment of the builder and update the size prefix
+        pad_to(out, base, sizeof(double));
+        write_scalar<std::uint32_t>(out, base, static_cast<std::uint32_t>(out.size() - base - sizeof(std::uint32_t)));
+        return kind;
+    }
+
+    fgb_augmenter::rewritten_batch fgb_augmenter::rewrite_batch(const std::uint64_t begin, const std::uint64_t end,
+                                                                const std::span<const bounding_box> boxes) const noexcept(false)
+    {
+        rewritten_batch batch {};
+        batch.sizes.reserve(end - begin);
+        batch.bytes.reserve(dataset_.feature_offset(end - 1u) - dataset_.feature_offset(begin) + (end - begin) * 64u);
+        std::vector<ring_view> rings {};
+        const std::size_t ahead {dataset_.prefetch_distance()};
+        for (std::uint64_t i {begin}; i < end; ++i)
+        {
+            if ((i + ahead) < end)
+                dataset_.prefetch_feature(i + ahead);
+            const std::size_t before {batch.bytes.size()};
+            ++batch.kinds[static_cast<std::size_t>(rewrite_feature(i, boxes[i], rings, batch.bytes))];
+            batch.sizes.push_back(batch.bytes.size() - before);
+        }
+        return batch;
+    }
+
+    bool fgb_augmenter::augment() noexcept(false)
+    {
+        const FgbGeometryType header_geom_type {dataset_.geometry_type()};
+        if ((header_geom_type != FgbGeometryType::Polygon) && (header_geom_type != FgbGeometryType::MultiPolygon))
+        {
+            std::cerr << "Error: Augmenting requires Polygon/MultiPolygon FGB files. Found: "
+                      << FlatGeobuf::EnumNameGeometryType(header_geom_type) << std::endl;
+            return false;
+        }
+        for (const std::string_view column: appended_columns)
+            if (dataset_.find_column(column).has_value())
+            {
+                std::cerr << "Error: The input already has a '" << column << "' column." << std::endl;
+                return false;
+            }
+        const std::size_t column_count {(dataset_.header()->columns() != nullptr) ? dataset_.header()->columns()->size() : 0u};
+        if ((column_count + appended_columns.size()) > std::numeric_limits<std::uint16_t>::max())
+        {
+            std::cerr << "Error: The input has too many columns to append to: " << column_count << std::endl;
+            return false;
+        }
+        first_column_ = static_cast<std::uint16_t>(column_count);
+
+        const std::uint64_t feature_count {dataset_.feature_count()};
+        std::vector<bounding_box> boxes(feature_count);
+        const std::size_t chunk_size {std::max<std::size_t>(1u, feature_count / (thread_pool_.size() * 8u + 1u))};
+        thread_pool_.parallel_for(feature_count, chunk_size,
+                                  [&](const std::size_t begin, const std::size_t end)
+                                  {
+                                      for (std::size_t i {begin}; i < end; ++i)
+                                          boxes[i] = dataset_.feature_bbox(i);
+                                  });
+        bounding_box envelope {};
+        for (const bounding_box& bbox: boxes)
+            if (bbox.is_valid)
+            {
+                envelope.update(bbox.min_x, bbox.min_y);
+                envelope.update(bbox.max_x, bbox.max_y);
+            }
+
+        std::ofstream output_file {output_fgb_path_, std::ios::binary | std::ios::trunc};
+        if (!output_file.is_open())
+        {
+            std::cerr << "Error: Could not open FGB file for writing: " << output_fgb_path_ << std::endl;
+            return false;
+        }
+        const fgb_writer writer {dataset_.header(), index_node_size_};
+        const std::vector<std::uint8_t> header {writer.build_header(feature_count, envelope, appended_columns)};
+        const std::uint64_t index_size {(feature_count != 0u) ? FlatGeobuf::PackedRTree::size(feature_count, index_node_size_) : 0u};
+        output_file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        output_file.seekp(static_cast<std::streamoff>(header.size() + index_size));
+
+        // Batches are rewritten on the pool and written in input order, at most `max_in_flight` pending at a time
+        const std::size_t max_in_flight {thread_pool_.size() * batches_per_thread_ + 1u};
+        std::deque<std::future<rewritten_batch>> in_flight {};
+        std::vector<std::uint64_t> sizes {};
+        sizes.reserve(feature_count);
+        std::array<std::uint64_t, 4u> kinds {};
+        const auto write_oldest = [&]
+        {
+            const rewritten_batch batch {in_flight.front().get()};
+            in_flight.pop_front();
+            output_file.write(reinterpret_cast<const char*>(batch.bytes.data()), static_cast<std::streamsize>(batch.bytes.size()));
+            sizes.insert(sizes.end(), batch.sizes.begin(), batch.sizes.end());
+            for (std::size_t k {}; k < kinds.size(); ++k)
+                kinds[k] += batch.kinds[k];
+        };
+        // The pending batches read `boxes`, so all of them finish before an exception (enqueueing, or thrown by a batch)
+        // leaves this function; the first one is rethrown
+        try
+        {
+            for (std::uint64_t begin {}; begin < feature_count; begin += batch_size_)
+            {
+                const std::uint64_t end {std::min<std::uint64_t>(begin + batch_size_, feature_count)};
+                in_flight.push_back(thread_pool_.enqueue_task([this, begin, end, &boxes] { return rewrite_batch(begin, end, boxes); }));
+                if (in_flight.size() >= max_in_flight)
+                    write_oldest();
+            }
+            while (!in_flight.empty())
+                write_oldest();
+        }
+        catch (...)
+        {
+            for (const std::future<rewritten_batch>& pending: in_flight)
+                if (pending.valid())
+                    pending.wait();
+            throw;
+        }
+
+        // All sizes are known now; the index goes into the space reserved after the header
+        const std::vector<std::uint8_t> index {writer.build_index(boxes, sizes)};
+        output_file.seekp(static_cast<std::streamoff>(header.size()));
+        output_file.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size()));
+        output_file.close();
+        if (!output_file || (index.size() != index_size))
+        {
+            std::cerr << "Error: Failed writing FGB file: " << output_fgb_path_ << std::endl;
+            return false;
+        }
+
+        std::cout << "Augmented " << feature_count << " features: " << kinds[static_cast<std::size_t>(rewrite_kind::extended)]
+                  << " extended in place, " << kinds[static_cast<std::size_t>(rewrite_kind::repointed)] << " re-pointed, "
+                  << kinds[static_cast<std::size_t>(rewrite_kind::re_encoded)] << " re-encoded, "
+                  << kinds[static_cast<std::size_t>(rewrite_kind::copied)] << " copied (own schema)." << std::endl;
+        std::cout << "Output written to: " << output_fgb_path_ << std::endl;
+        return true;
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,211 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file fgb_dataset.cpp
+#include "kmx/gis/fgb_dataset.hpp"
+#include "kmx/gis/feature_properties.hpp"
+#include "kmx/gis/geometry_processor.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace kmx::gis
+{
+    fgb_dataset::fgb_dataset(const std::string& fgb_path) noexcept(false): file_ {fgb_path}
+    {
+        parse_header();
+        if (!has_index() || !load_leaf_offsets())
+            scan_feature_offsets();
+        if (!feature_offsets_.empty())
+        {
+            const std::uint64_t mean_size {std::max<std::uint64_t>(1u, features_size() / feature_offsets_.size())};
+            prefetch_distance_ =
+                static_cast<std::size_t>(std::clamp<std::uint64_t>(prefetch_window_bytes_ / mean_size, 1u, max_prefetch_distance_));
+        }
+    }
+
+    // Validates the magic bytes and locates the header table.
+    void fgb_dataset::parse_header() noexcept(false)
+    {
+        // FlatGeobuf magic bytes; the fourth byte is the major version and the last one the patch version.
+        static constexpr std::array<std::uint8_t, magic_size_> expected_magic_bytes {0x66u, 0x67u, 0x62u, 0x03u,
+                                                                                     0x66u, 0x67u, 0x62u, 0x00u};
+
+        const std::uint8_t* const data {file_.data()};
+        if ((file_.size() < (magic_size_ + sizeof(std::uint32_t))) ||
+            (std::memcmp(data, expected_magic_bytes.data(), 4u) != 0) ||
+            (std::memcmp(data + 4u, expected_magic_bytes.data() + 4u, 3u) != 0))
+            throw std::runtime_error("Not a FlatGeobuf file: " + file_.path());
+
+        const std::uint32_t header_size {::flatbuffers::ReadScalar<std::uint32_t>(data + magic_size_)};
+        const std::size_t header_start {magic_size_ + sizeof(std::uint32_t)};
+        if ((header_start + header_size) > file_.size())
+            throw std::runtime_error("FlatGeobuf header is truncated: " + file_.path());
+
+        header_ = FlatGeobuf::GetHeader(data + header_start);
+        header_end_ = header_start + header_size;
+        features_offset_ = header_end_;
+
+        if (header_->has_z())
+            coordinate_stride_++;
+        if (header_->has_m())
+            coordinate_stride_++;
+
+        // The packed R-tree, if any, sits between the header and the first feature.
+        if ((header_->index_node_size() > 0u) && (header_->features_count() > 0u))
+        {
+            const std::uint64_t index_size {FlatGeobuf::PackedRTree::size(header_->features_count(), header_->index_node_size())};
+            if ((header_end_ + index_size) > file_.size())
+                throw std::runtime_error("FlatGeobuf spatial index is truncated: " + file_.path());
+            index_bytes_ = file_.bytes().subspan(header_end_, static_cast<std::size_t>(index_size));
+            features_offset_ += static_cast<std::size_t>(index_size);
+        }
+    }
+
+    // Takes the feature offsets from the R-tree leaves; a prescan would read a page of every feature.
+    bool fgb_dataset::load_leaf_offsets() noexcept(false)
+    {
+        const std::size_t leaf_count {static_cast<std::size_t>(header_->features_count())};
+        const std::size_t node_count {index_bytes_.size() / sizeof(FlatGeobuf::NodeItem)};
+        const std::uint8_t* const leaves {index_bytes_.data() + (node_count - leaf_count) * sizeof(FlatGeobuf::NodeItem)};
+        const std::uint64_t section_size {features_size()};
+
+        feature_offsets_.resize(leaf_count);
+        for (std::size_t i {}; i < leaf_count; ++i)
+        {
+            FlatGeobuf::NodeItem leaf {};
+            std::memcpy(&leaf, leaves + i * sizeof(FlatGeobuf::NodeItem), sizeof(leaf));
+            const bool in_order {(i == 0u) ? (leaf.offset == 0u) : (leaf.offset > feature_offsets_[i - 1u])};
+            if (!in_order || ((leaf.offset + sizeof(std::uint32_t)) > section_size))
+            {
+                feature_offsets_.clear();
+                return false;
+            }
+            feature_offsets_[i] = leaf.offset;
+        }
+
+        // The last feature has to fit as well; a truncated file is left to the prescan, which finds where it ends.
+        const std::size_t last {features_offset_ + static_cast<std::size_t>(feature_offsets_.back())};
+        if ((last + sizeof(std::uint32_t) + ::flatbuffers::ReadScalar<std::uint32_t>(file_.data() + last)) > file_.size())
+        {
+            feature_offsets_.clear();
+            return false;
+        }
+        return true;
+    }
+
+    // Walks the feature size prefixes to record the offset of every feature.
+    void fgb_dataset::scan_feature_offsets() noexcept
+    {
+        const std::uint64_t declared_count {header_->features_count()};
+        if (declared_count > 0u)
+            feature_offsets_.reserve(static_cast<std::size_t>(declared_count));
+
+        const std::size_t file_size {file_.size()};
+        std::size_t offset {features_offset_};
+        // A zero feature count means "unknown" in FlatGeobuf, in which case we read until the end of the file.
+        while ((declared_count == 0u) || (feature_offsets_.size() < declared_count))
+        {
+            if ((offset + sizeof(std::uint32_t)) > file_size)
+                break;
+            const std::uint32_t feature_size {::flatbuffers::ReadScalar<std::uint32_t>(file_.data() + offset)};
+            if ((offset + sizeof(std::uint32_t) + feature_size) > file_size)
+                break;
+            feature_offsets_.push_back(offset - features_offset_);
+            offset += sizeof(std::uint32_t) + feature_size;
+        }
+
+        if ((declared_count > 0u) && (feature_offsets_.size() != declared_count))
+            std::cerr << "Warning: " << file_.path() << " declares " << declared_count << " features but only "
+                      << feature_offsets_.size() << " could be located." << std::endl;
+    }
+
+    FlatGeobuf::GeometryType fgb_dataset::geometry_type_of(const FlatGeobuf::Geometry* const geometry) const noexcept
+    {
+        if ((geometry == nullptr) || (geometry->type() == FlatGeobuf::GeometryType::Unknown))
+            return header_->geometry_type();
+        return geometry->type();
+    }
+
+    std::span<const std::uint8_t> fgb_dataset::feature_bytes(const std::uint64_t index) const noexcept
+    {
+        const std::size_t offset {features_offset_ + static_cast<std::size_t>(feature_offsets_[index])};
+        const std::uint32_t feature_size {::flatbuffers::ReadScalar<std::uint32_t>(file_.data() + offset)};
+        return file_.bytes().subspan(offset, sizeof(std::uint32_t) + feature_size);
+    }
+
+    const FlatGeobuf::Feature* fgb_dataset::feature(const std::uint64_t index) const noexcept
+    {
+        return FlatGeobuf::GetSizePrefixedFeature(file_.data() + features_offset_ + feature_offsets_[index]);
+    }
+
+    std::optional<std::uint64_t> fgb_dataset::feature_index_at(const std::uint64_t offset) const noexcept
+    {
+        const auto it = std::lower_bound(feature_offsets_.begin(), feature_offsets_.end(), offset);
+        if ((it == feature_offsets_.end()) || (*it != offset))
+            return {};
+        return static_cast<std::uint64_t>(it - feature_offsets_.begin());
+    }
+
+    std::optional<std::size_t> fgb_dataset::find_column(const std::string_view name) const noexcept
+    {
+        return feature_properties::find_column_index(header_, name);
+    }
+
+    std::vector<std::uint64_t> fgb_dataset::search(const bounding_box& query) const noexcept(false)
+    {
+        std::vector<std::uint64_t> result {};
+        if (!query.is_valid)
+            return result;
+
+        if (has_index())
+        {
+            const FlatGeobuf::NodeItem query_item {query.min_x, query.min_y, query.max_x, query.max_y, 0u};
+            const auto read_node = [this](std::uint8_t* const buffer, const std::size_t offset, const std::size_t length)
+            { std::memcpy(buffer, index_bytes_.data() + offset, length); };
+            const auto hits = FlatGeobuf::PackedRTree::streamSearch(header_->features_count(), header_->index_node_size(), query_item,
+                                                                    read_node);
+            result.reserve(hits.size());
+            for (const auto& hit: hits)
+                if (const auto index = feature_index_at(hit.offset); index.has_value())
+                    result.push_back(*index);
+        }
+        else
+            for (std::uint64_t i {}; i < feature_count(); ++i)
+            {
+                const bounding_box bbox {feature_bbox(i)};
+                if (bbox.is_valid && (bbox.max_x >= query.min_x) && (bbox.min_x <= query.max_x) && (bbox.max_y >= query.min_y) &&
+                    (bbox.min_y <= query.max_y))
+                    result.push_back(i);
+            }
+
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    bounding_box fgb_dataset::feature_bbox(const std::uint64_t index) const noexcept
+    {
+        // Features are stored in leaf order, so leaf `index` describes feature `index` unless the file was written differently.
+        if (has_index())
+        {
+            const std::size_t leaf_count {static_cast<std::size_t>(header_->features_count())};
+            const std::size_t node_count {index_bytes_.size() / sizeof(FlatGeobuf::NodeItem)};
+            if (index < leaf_count)
+            {
+                FlatGeobuf::NodeItem leaf {};
+                std::memcpy(&leaf, index_bytes_.data() + (node_count - leaf_count + index) * sizeof(FlatGeobuf::NodeItem), sizeof(leaf));
+                if (leaf.offset == feature_offsets_[index])
+                {
+                    bounding_box bbox {};
+                    bbox.update(leaf.minX, leaf.minY);
+                    bbox.update(leaf.maxX, leaf.maxY);
+                    return bbox;
+                }
+            }
+        }
+
+        const FlatGeobuf::Geometry* const geometry {feature(index)->geometry()};
+        return geometry_processor::calculate_for_geometry(geometry, coordinate_stride_, geometry_type_of(geometry));
+    }
+
+} // namespace kmx::gis
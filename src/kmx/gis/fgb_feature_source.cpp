@@ -0,0 +1,159 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file fgb_feature_source.cpp
+#include "kmx/gis/fgb_feature_source.hpp"
+#include "kmx/gis/feature_properties.hpp"
+#include "kmx/gis/geometry_processor.hpp"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace kmx::gis
+{
+    // Maps and validates the FlatGeobuf file.
+    fgb_feature_source::fgb_feature_source(const std::string& fgb_path) noexcept(false):
+        dataset_ {fgb_path},
+        range_end_ {dataset_.feature_count()}
+    {
+    }
+
+    // Prints basic information from the FGB header to standard output.
+    void fgb_feature_source::print_info() const noexcept(false)
+    {
+        const FlatGeobuf::Header* const header {dataset_.header()};
+        std::cout << "Processing FGB file: " << ((header->name() != nullptr) ? header->name()->str() : std::string {}) << std::endl;
+        std::cout << "Header Geometry Type: " << geometry_type_name() << std::endl;
+        std::cout << "Feature count (from header): " << header->features_count() << std::endl;
+        if (header->has_z())
+            std::cout << "Data includes Z coordinates." << std::endl;
+        if (header->has_m())
+            std::cout << "Data includes M coordinates." << std::endl;
+    }
+
+    // Name of the header geometry type.
+    std::string_view fgb_feature_source::geometry_type_name() const noexcept
+    {
+        return FlatGeobuf::EnumNameGeometryType(dataset_.geometry_type());
+    }
+
+    // True for Polygon and MultiPolygon layers.
+    bool fgb_feature_source::is_polygonal() const noexcept
+    {
+        const FgbGeometryType type {dataset_.geometry_type()};
+        return (type == FgbGeometryType::Polygon) || (type == FgbGeometryType::MultiPolygon);
+    }
+
+    // Number of features of the shard, or of window candidates after `restrict_to`.
+    std::uint64_t fgb_feature_source::feature_count() const noexcept
+    {
+        return selection_.has_value() ? selection_->size() : (range_end_ - range_begin_);
+    }
+
+    // Selects the window candidates within the shard.
+    bool fgb_feature_source::restrict_to(const bounding_box& window) noexcept(false)
+    {
+        selection_ = dataset_.search(window);
+        std::erase_if(*selection_, [this](const std::uint64_t index) { return (index < range_begin_) || (index >= range_end_); });
+        next_index_ = 0u;
+        return true;
+    }
+
+    // Splits the features by their offsets.
+    std::optional<shard_range> fgb_feature_source::restrict_to_shard(const shard_spec& shard) noexcept(false)
+    {
+        const shard_range range {shard_plan::split(dataset_.feature_count(), dataset_.features_size(),
+                                                   [this](const std::uint64_t index) { return dataset_.feature_offset(index); }, shard)};
+        range_begin_ = range.first_feature;
+        range_end_ = range.end_feature;
+        if (selection_.has_value())
+            std::erase_if(*selection_, [this](const std::uint64_t index) { return (index < range_begin_) || (index >= range_end_); });
+        next_index_ = 0u;
+        return range;
+    }
+
+    // Jumps to the feature at `position` of the shard or window selection.
+    bool fgb_feature_source::seek(const std::uint64_t position, const std::uint64_t offset) noexcept(false)
+    {
+        static_cast<void>(offset);
+        if (position > feature_count())
+            return false;
+        next_index_ = position;
+        return true;
+    }
+
+    std::uint64_t fgb_feature_source::offset_at(const std::uint64_t position) const noexcept
+    {
+        const std::uint64_t index {range_begin_ + position};
+        return (index < range_end_) ? dataset_.feature_offset(index) : ((range_end_ < dataset_.feature_count())
+                                                                            ? dataset_.feature_offset(range_end_)
+                                                                            : dataset_.features_size());
+    }
+
+    // The window is irrelevant for a mapping: the kernel reads ahead and the run gives the pages back. A huge page copy
+    // has no pages to give back and stays accounted as a whole.
+    void fgb_feature_source::limit_buffering(const std::uint64_t bytes) noexcept(false)
+    {
+        static_cast<void>(bytes);
+        if (selection_.has_value() || dataset_.is_anonymous())
+            return;
+        streaming_ = true;
+        released_offset_ = offset_at(next_index_);
+        dataset_.advise_sequential();
+    }
+
+    // Whole pages only; the one shared with the next feature is released with it.
+    void fgb_feature_source::release(const std::uint64_t position) noexcept(false)
+    {
+        if (!streaming_ || selection_.has_value())
+            return;
+        const std::uint64_t end {offset_at(std::min(position, feature_count()))};
+        if (end <= released_offset_)
+            return;
+        dataset_.release_features(released_offset_, end);
+        released_offset_ = end;
+    }
+
+    std::uint64_t fgb_feature_source::resident_bytes() const noexcept
+    {
+        if (!streaming_)
+            return dataset_.file_bytes().size();
+        return dataset_.features_offset() + offset_at(std::min(next_index_, feature_count())) - released_offset_;
+    }
+
+    // Resolves the property names against the header columns.
+    std::vector<std::optional<std::size_t>> fgb_feature_source::project(const std::span<const std::string_view> names) noexcept(false)
+    {
+        columns_.clear();
+        for (const std::string_view name: names)
+            columns_.push_back(dataset_.find_column(name));
+        return columns_;
+    }
+
+    // Reads the next features: ring views into the mapping plus the projected properties.
+    bool fgb_feature_source::next_batch(feature_batch& batch, const std::size_t max_features) noexcept(false)
+    {
+        batch.reset(range_begin_ + next_index_, columns_.size());
+        const std::uint64_t end {std::min<std::uint64_t>(feature_count(), next_index_ + max_features)};
+        const std::size_t ahead {dataset_.prefetch_distance()};
+        for (; next_index_ < end; ++next_index_)
+        {
+            if (const std::uint64_t next {next_index_ + ahead}; next < feature_count())
+                dataset_.prefetch_feature(selection_.has_value() ? (*selection_)[next] : (range_begin_ + next));
+            const std::uint64_t index {selection_.has_value() ? (*selection_)[next_index_] : (range_begin_ + next_index_)};
+            if (selection_.has_value())
+                batch.indices.push_back(index);
+            const FlatGeobuf::Feature* const feature {dataset_.feature(index)};
+            const FlatGeobuf::Geometry* const geometry {(feature != nullptr) ? feature->geometry() : nullptr};
+            geometry_processor::collect_rings(geometry, dataset_.geometry_type_of(geometry), scratch_rings_);
+            batch.rings.insert(batch.rings.end(), scratch_rings_.begin(), scratch_rings_.end());
+            batch.ring_offsets.push_back(static_cast<std::uint32_t>(batch.rings.size()));
+
+            for (std::size_t c {}; c < columns_.size(); ++c)
+                batch.properties[c].push_back((columns_[c].has_value() && (feature != nullptr))
+                                                  ? feature_properties::get_string_value(feature, dataset_.header(), *columns_[c])
+                                                  : std::string {});
+            ++batch.size;
+        }
+        return batch.size > 0u;
+    }
+
+} // namespace kmx::gis
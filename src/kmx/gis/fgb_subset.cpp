@@ -0,0 +1,166 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file fgb_subset.cpp
+#include "kmx/gis/fgb_subset.hpp"
+#include "kmx/gis/feature_properties.hpp"
+#include "kmx/gis/fgb_writer.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+namespace kmx::gis
+{
+    // Writes all of `bytes` to `fd`, retrying short writes.
+    static bool write_all(const int fd, std::span<const std::uint8_t> bytes) noexcept
+    {
+        while (!bytes.empty())
+        {
+            const ssize_t written {::write(fd, bytes.data(), bytes.size())};
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+            bytes = bytes.subspan(static_cast<std::size_t>(written));
+        }
+        return true;
+    }
+
+    // Copies `length` bytes at `offset` of `input_fd` to the end of `output_fd` inside the kernel.
+    // Returns the number of bytes copied before the kernel refused (e.g. across file systems on older kernels).
+    static std::size_t kernel_copy(const int input_fd, const int output_fd, const std::size_t offset, const std::size_t length) noexcept
+    {
+        auto input_offset = static_cast<loff_t>(offset);
+        std::size_t copied {};
+        while (copied < length)
+        {
+            const ssize_t n {::copy_file_range(input_fd, &input_offset, output_fd, nullptr, length - copied, 0u)};
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                break;
+            copied += static_cast<std::size_t>(n);
+        }
+        return copied;
+    }
+
+    fgb_subset_writer::fgb_subset_writer(const std::string& input_fgb_path, const std::string& output_fgb_path,
+                                         const std::uint32_t num_threads, fgb_subset_filter filter) noexcept(false):
+        output_fgb_path_ {output_fgb_path},
+        filter_ {std::move(filter)},
+        thread_pool_ {num_threads},
+        dataset_ {input_fgb_path}
+    {
+        std::cout << "Thread pool initialized with " << num_threads << " threads.\n";
+    }
+
+    std::optional<std::vector<std::uint64_t>> fgb_subset_writer::select() noexcept(false)
+    {
+        // The spatial criterion goes through the index; the attribute one is evaluated on the remaining candidates
+        std::vector<std::uint64_t> candidates {};
+        if (filter_.window.is_valid)
+            candidates = dataset_.search(filter_.window);
+        else
+        {
+            candidates.resize(dataset_.feature_count());
+            for (std::uint64_t i {}; i < candidates.size(); ++i)
+                candidates[i] = i;
+        }
+        if (filter_.column.empty())
+            return candidates;
+
+        const std::optional<std::size_t> column {dataset_.find_column(filter_.column)};
+        if (!column.has_value())
+        {
+            std::cerr << "Error: Could not find the filter property '" << filter_.column << "'." << std::endl;
+            return std::nullopt;
+        }
+        std::vector<std::string> values {filter_.values};
+        std::sort(values.begin(), values.end());
+
+        std::vector<std::uint8_t> matches(candidates.size());
+        const std::size_t chunk_size {std::max<std::size_t>(1u, candidates.size() / (thread_pool_.size() * 8u + 1u))};
+        thread_pool_.parallel_for(candidates.size(), chunk_size,
+                                  [&](const std::size_t begin, const std::size_t end)
+                                  {
+                                      for (std::size_t k {begin}; k < end; ++k)
+                                      {
+                                          const std::string value {feature_properties::get_string_value(
+                                              dataset_.feature(candidates[k]), dataset_.header(), *column)};
+                                          matches[k] = std::binary_search(values.begin(), values.end(), value) ? 1u : 0u;
+                                      }
+                                  });
+
+        std::vector<std::uint64_t> selected {};
+        for (std::size_t k {}; k < candidates.size(); ++k)
+            if (matches[k] != 0u)
+                selected.push_back(candidates[k]);
+        return selected;
+    }
+
+    bool fgb_subset_writer::copy_features(const int output_fd, const std::span<const std::uint64_t> selected) const noexcept(false)
+    {
+        const int input_fd {::open(dataset_.path().c_str(), O_RDONLY | O_CLOEXEC)};
+        std::size_t kernel_copied {};
+        bool ok {true};
+        for (std::size_t k {}; ok && (k < selected.size());)
+        {
+            // A run of consecutive features is one contiguous byte range of the input
+            std::size_t run_end {k + 1u};
+            while ((run_end < selected.size()) && (selected[run_end] == selected[run_end - 1u] + 1u))
+                ++run_end;
+            const std::span<const std::uint8_t> first {dataset_.feature_bytes(selected[k])};
+            const std::span<const std::uint8_t> last {dataset_.feature_bytes(selected[run_end - 1u])};
+            const std::span<const std::uint8_t> run {first.data(), static_cast<std::size_t>(last.data() + last.size() - first.data())};
+            k = run_end;
+
+            std::size_t copied {};
+            if ((input_fd >= 0) && (run.size() >= raw_copy_threshold_))
+                copied = kernel_copy(input_fd, output_fd, static_cast<std::size_t>(run.data() - dataset_.file_bytes().data()), run.size());
+            kernel_copied += copied;
+            ok = write_all(output_fd, run.subspan(copied));
+        }
+        if (input_fd >= 0)
+            ::close(input_fd);
+        std::cout << "Copied " << kernel_copied << " bytes in the kernel." << std::endl;
+        return ok;
+    }
+
+    bool fgb_subset_writer::write() noexcept(false)
+    {
+        const std::optional<std::vector<std::uint64_t>> selection {select()};
+        if (!selection.has_value())
+            return false;
+        const std::vector<std::uint64_t>& selected {*selection};
+
+        std::vector<fgb_feature_entry> entries(selected.size());
+        for (std::size_t k {}; k < selected.size(); ++k)
+            entries[k] = {dataset_.feature_bytes(selected[k]), dataset_.feature_bbox(selected[k])};
+        std::cout << "Selected " << selected.size() << " of " << dataset_.feature_count() << " features." << std::endl;
+
+        const fgb_writer writer {dataset_.header()};
+        const std::vector<std::uint8_t> header {writer.build_header(entries.size(), fgb_writer::envelope_of(entries))};
+        const std::vector<std::uint8_t> index {writer.build_index(entries)};
+
+        const int output_fd {::open(output_fgb_path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)};
+        if (output_fd < 0)
+        {
+            std::cerr << "Error: Could not open FGB file for writing: " << output_fgb_path_ << " (" << std::strerror(errno) << ")"
+                      << std::endl;
+            return false;
+        }
+        const bool ok {write_all(output_fd, header) && write_all(output_fd, index) && copy_features(output_fd, selected)};
+        const bool closed {::close(output_fd) == 0};
+        if (!ok || !closed)
+        {
+            std::cerr << "Error: Failed writing FGB file: " << output_fgb_path_ << std::endl;
+            return false;
+        }
+        std::cout << "Output written to: " << output_fgb_path_ << std::endl;
+        return true;
+    }
+
+} // namespace kmx::gis
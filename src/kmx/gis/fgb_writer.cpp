@@ -0,0 +1,175 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file fgb_writer.cpp
+#include "kmx/gis/fgb_writer.hpp"
+#include <fstream>
+#include <iostream>
+
+namespace kmx::gis
+{
+    // Copies an optional string into `fbb`.
+    static flatbuffers::Offset<flatbuffers::String> copy_string(flatbuffers::FlatBufferBuilder& fbb,
+                                                                const flatbuffers::String* const value) noexcept(false)
+    {
+        return (value != nullptr) ? fbb.CreateString(value->c_str(), value->size()) : flatbuffers::Offset<flatbuffers::String> {};
+    }
+
+    fgb_writer::fgb_writer(const FlatGeobuf::Header* const source_header, const std::uint16_t index_node_size,
+                           const std::optional<FlatGeobuf::GeometryType> geometry_type) noexcept:
+        source_header_ {source_header},
+        index_node_size_ {index_node_size},
+        geometry_type_ {geometry_type}
+    {
+    }
+
+    // Copies the columns of a schema vector into `fbb`, appending their offsets to `copies`.
+    static void append_column_copies(flatbuffers::FlatBufferBuilder& fbb, const fgb_writer::column_vector& columns,
+                                     std::vector<flatbuffers::Offset<FlatGeobuf::Column>>& copies) noexcept(false)
+    {
+        copies.reserve(copies.size() + columns.size());
+        for (flatbuffers::uoffset_t i {}; i < columns.size(); ++i)
+        {
+            const FlatGeobuf::Column* const column {columns.Get(i)};
+            const auto name = copy_string(fbb, column->name());
+            const auto title = copy_string(fbb, column->title());
+            const auto description = copy_string(fbb, column->description());
+            const auto metadata = copy_string(fbb, column->metadata());
+            copies.push_back(FlatGeobuf::CreateColumn(fbb, name, column->type(), title, description, column->width(),
+                                                      column->precision(), column->scale(), column->nullable(), column->unique(),
+                                                      column->primary_key(), metadata));
+        }
+    }
+
+    flatbuffers::Offset<fgb_writer::column_vector> fgb_writer::copy_columns(flatbuffers::FlatBufferBuilder& fbb,
+                                                                            const column_vector* const columns) noexcept(false)
+    {
+        if (columns == nullptr)
+            return {};
+        std::vector<flatbuffers::Offset<FlatGeobuf::Column>> copies {};
+        append_column_copies(fbb, *columns, copies);
+        return fbb.CreateVector(copies);
+    }
+
+    std::vector<std::uint8_t> fgb_writer::build_header(const std::uint64_t features_count, const bounding_box& envelope,
+                                                       const std::span<const std::string_view> appended_columns) const noexcept(false)
+    {
+        const FlatGeobuf::Header& source {*source_header_};
+        flatbuffers::FlatBufferBuilder fbb {};
+        const auto name = copy_string(fbb, source.name());
+        flatbuffers::Offset<flatbuffers::Vector<double>> envelope_offset {};
+        if (envelope.is_valid)
+            envelope_offset = fbb.CreateVector(std::vector<double> {envelope.min_x, envelope.min_y, envelope.max_x, envelope.max_y});
+        flatbuffers::Offset<column_vector> columns {};
+        if (appended_columns.empty())
+            columns = copy_columns(fbb, source.columns());
+        else
+        {
+            std::vector<flatbuffers::Offset<FlatGeobuf::Column>> copies {};
+            if (source.columns() != nullptr)
+                append_column_copies(fbb, *source.columns(), copies);
+            for (const std::string_view column: appended_columns)
+            {
+                const auto column_name = fbb.CreateString(column.data(), column.size());
+                copies.push_back(FlatGeobuf::CreateColumn(fbb, column_name, FlatGeobuf::ColumnType::Double));
+            }
+            columns = fbb.CreateVector(copies);
+        }
+        flatbuffers::Offset<FlatGeobuf::Crs> crs {};
+        if (source.crs() != nullptr)
+        {
+            const FlatGeobuf::Crs& c {*source.crs()};
+            const auto org = copy_string(fbb, c.org());
+            const auto crs_name = copy_string(fbb, c.name());
+            const auto crs_description = copy_string(fbb, c.description());
+            const auto wkt = copy_string(fbb, c.wkt());
+            const auto code_string = copy_string(fbb, c.code_string());
+            crs = FlatGeobuf::CreateCrs(fbb, org, c.code(), crs_name, crs_description, wkt, code_string);
+        }
+        const auto title = copy_string(fbb, source.title());
+        const auto description = copy_string(fbb, source.description());
+        const auto metadata = copy_string(fbb, source.metadata());
+        // An index is only written for non-empty files
+        const std::uint16_t node_size {(features_count != 0u) ? index_node_size_ : std::uint16_t {}};
+        const FlatGeobuf::GeometryType geometry_type {geometry_type_.value_or(source.geometry_type())};
+        fbb.FinishSizePrefixed(FlatGeobuf::CreateHeader(fbb, name, envelope_offset, geometry_type, source.has_z(), source.has_m(),
+                                                        source.has_t(), source.has_tm(), columns, features_count, node_size, crs, title,
+                                                        description, metadata));
+
+        std::vector<std::uint8_t> bytes {};
+        bytes.reserve(magic_bytes.size() + fbb.GetSize());
+        bytes.insert(bytes.end(), magic_bytes.begin(), magic_bytes.end());
+        bytes.insert(bytes.end(), fbb.GetBufferPointer(), fbb.GetBufferPointer() + fbb.GetSize());
+        return bytes;
+    }
+
+    bounding_box fgb_writer::envelope_of(const std::span<const fgb_feature_entry> features) noexcept
+    {
+        bounding_box envelope {};
+        for (const fgb_feature_entry& feature: features)
+            if (feature.bbox.is_valid)
+            {
+                envelope.update(feature.bbox.min_x, feature.bbox.min_y);
+                envelope.update(feature.bbox.max_x, feature.bbox.max_y);
+            }
+        return envelope;
+    }
+
+    std::vector<std::uint8_t> fgb_writer::build_index(const std::span<const fgb_feature_entry> features) const noexcept(false)
+    {
+        std::vector<bounding_box> boxes(features.size());
+        std::vector<std::uint64_t> sizes(features.size());
+        for (std::size_t i {}; i < features.size(); ++i)
+        {
+            boxes[i] = features[i].bbox;
+            sizes[i] = features[i].bytes.size();
+        }
+        return build_index(boxes, sizes);
+    }
+
+    std::vector<std::uint8_t> fgb_writer::build_index(const std::span<const bounding_box> boxes,
+                                                      const std::span<const std::uint64_t> sizes) const noexcept(false)
+    {
+        if (boxes.empty())
+            return {};
+
+        std::vector<FlatGeobuf::NodeItem> leaves(boxes.size());
+        FlatGeobuf::NodeItem extent {FlatGeobuf::NodeItem::create(0u)};
+        std::uint64_t offset {};
+        for (std::size_t i {}; i < boxes.size(); ++i)
+        {
+            const bounding_box& bbox {boxes[i]};
+            leaves[i] = {bbox.min_x, bbox.min_y, bbox.max_x, bbox.max_y, offset};
+            extent.expand(leaves[i]);
+            offset += sizes[i];
+        }
+
+        FlatGeobuf::PackedRTree tree {leaves, extent, index_node_size_};
+        std::vector<std::uint8_t> bytes {};
+        bytes.reserve(FlatGeobuf::PackedRTree::size(boxes.size(), index_node_size_));
+        tree.streamWrite([&](const std::uint8_t* const data, const std::size_t size) { bytes.insert(bytes.end(), data, data + size); });
+        return bytes;
+    }
+
+    bool fgb_writer::write(const std::string& path, const std::span<const fgb_feature_entry> features) const noexcept(false)
+    {
+        std::ofstream output_file {path, std::ios::binary};
+        if (!output_file.is_open())
+        {
+            std::cerr << "Error: Could not open FGB file for writing: " << path << std::endl;
+            return false;
+        }
+        const std::vector<std::uint8_t> header {build_header(features.size(), envelope_of(features))};
+        const std::vector<std::uint8_t> index {build_index(features)};
+        output_file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        output_file.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size()));
+        for (const fgb_feature_entry& feature: features)
+            output_file.write(reinterpret_cast<const char*>(feature.bytes.data()), static_cast<std::streamsize>(feature.bytes.size()));
+
+        if (!output_file)
+        {
+            std::cerr << "Error: Failed writing FGB file: " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,120 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file geometry_hash.cpp
+#include "kmx/gis/geometry_hash.hpp"
+#include <bit>
+#include <tuple>
+
+namespace kmx::gis
+{
+    /// @brief A ring vertex, with -0.0 folded into 0.0 so that equal coordinates have equal bit patterns.
+    struct canonical_vertex
+    {
+        double x;
+        double y;
+
+        bool operator==(const canonical_vertex&) const noexcept = default;
+        bool operator<(const canonical_vertex& other) const noexcept { return std::tie(x, y) < std::tie(other.x, other.y); }
+    };
+
+    static canonical_vertex vertex_at(const ring_view& ring, const std::uint32_t i) noexcept
+    {
+        return {ring.x(i) + 0.0, ring.y(i) + 0.0};
+    }
+
+    // Index of step `k` of the walk over `count` vertices that starts at `start`, forwards or backwards.
+    static std::uint32_t walk_index(const std::uint32_t start, const bool forward, const std::uint32_t k,
+                                    const std::uint32_t count) noexcept
+    {
+        return forward ? ((start + k) % count) : ((start + count - k) % count);
+    }
+
+    // Compares two walks over the first `count` vertices of `ring` lexicographically.
+    static bool walk_less(const ring_view& ring, const std::uint32_t count, const std::uint32_t a, const bool a_forward,
+                          const std::uint32_t b, const bool b_forward) noexcept
+    {
+        for (std::uint32_t k {}; k < count; ++k)
+        {
+            const canonical_vertex va {vertex_at(ring, walk_index(a, a_forward, k, count))};
+            const canonical_vertex vb {vertex_at(ring, walk_index(b, b_forward, k, count))};
+            if (va < vb)
+                return true;
+            if (vb < va)
+                return false;
+        }
+        return false;
+    }
+
+    // The smallest walk of each ring is its canonical form: a ring repeating its smallest vertex has several candidates.
+    bool geometry_hash::canonicalize(const std::span<const ring_view> rings, std::vector<std::uint64_t>& words) noexcept(false)
+    {
+        words.clear();
+        for (const ring_view& ring: rings)
+        {
+            std::uint32_t count {ring.point_count};
+            if ((count > 1u) && (vertex_at(ring, 0u) == vertex_at(ring, count - 1u)))
+                --count;
+
+            std::uint32_t start {};
+            for (std::uint32_t i {1u}; i < count; ++i)
+                if (vertex_at(ring, i) < vertex_at(ring, start))
+                    start = i;
+            bool forward {true};
+            const canonical_vertex smallest {vertex_at(ring, start)};
+            for (std::uint32_t i {}; i < count; ++i)
+                if (vertex_at(ring, i) == smallest)
+                    for (const bool direction: {true, false})
+                        if (walk_less(ring, count, i, direction, start, forward))
+                        {
+                            start = i;
+                            forward = direction;
+                        }
+
+            words.push_back((static_cast<std::uint64_t>(ring.polygon_index) << 32u) | count);
+            for (std::uint32_t k {}; k < count; ++k)
+            {
+                const canonical_vertex vertex {vertex_at(ring, walk_index(start, forward, k, count))};
+                words.push_back(std::bit_cast<std::uint64_t>(vertex.x));
+                words.push_back(std::bit_cast<std::uint64_t>(vertex.y));
+            }
+        }
+        return !words.empty();
+    }
+
+    // MurmurHash3 x64 128 over the words; on little-endian hosts this equals the reference function over their bytes.
+    geometry_hash geometry_hash::of_words(const std::span<const std::uint64_t> words) noexcept
+    {
+        static constexpr std::uint64_t c1 {0x87C37B91114253D5ull};
+        static constexpr std::uint64_t c2 {0x4CF5AD432745937Full};
+        const auto mix = [](std::uint64_t k) noexcept
+        {
+            k = (k ^ (k >> 33u)) * 0xFF51AFD7ED558CCDull;
+            k = (k ^ (k >> 33u)) * 0xC4CEB9FE1A85EC53ull;
+            return k ^ (k >> 33u);
+        };
+
+        std::uint64_t h1 {};
+        std::uint64_t h2 {};
+        std::size_t i {};
+        for (; (i + 1u) < words.size(); i += 2u)
+        {
+            h1 ^= std::rotl(words[i] * c1, 31) * c2;
+            h1 = (std::rotl(h1, 27) + h2) * 5u + 0x52DCE729u;
+            h2 ^= std::rotl(words[i + 1u] * c2, 33) * c1;
+            h2 = (std::rotl(h2, 31) + h1) * 5u + 0x38495AB5u;
+        }
+        if (i < words.size())
+            h1 ^= std::rotl(words[i] * c1, 31) * c2;
+
+        const std::uint64_t length {words.size() * sizeof(std::uint64_t)};
+        h1 ^= length;
+        h2 ^= length;
+        h1 += h2;
+        h2 += h1;
+        h1 = mix(h1);
+        h2 = mix(h2);
+        h1 += h2;
+        h2 += h1;
+        return {h1, h2};
+    }
+
+} // namespace kmx::gis
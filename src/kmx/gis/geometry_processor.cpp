@@ -3,6 +3,8 @@
 #include "kmx/gis/geometry_processor.hpp"
 #include "flatgeobuf/feature_generated.h" // For FlatGeobuf::Geometry, FlatGeobuf::GeometryType
 #include "flatgeobuf/header_generated.h"  // For FlatGeobuf::GeometryType enum
+#include <algorithm>
+#include <cmath>
 
 namespace kmx::gis
 {
@@ -91,4 +93,112 @@ namespace kmx::gis
         return bbox;
     }
 
+    // Appends the rings of a single polygon to `out_rings`.
+    void geometry_processor::append_polygon_rings(const FlatGeobuf::Geometry& polygon_fbs, const std::uint32_t polygon_index,
+                                                  std::vector<ring_view>& out_rings) noexcept(false)
+    {
+        const auto* const coords_vector = polygon_fbs.xy();
+        if ((coords_vector == nullptr) || (coords_vector->size() < 2u))
+            return;
+
+        const double* const coords_data {coords_vector->data()};
+        const std::uint32_t point_count {coords_vector->size() / 2u};
+        const auto* const ends = polygon_fbs.ends();
+
+        // Without `ends` the whole coordinate array is the exterior ring.
+        if ((ends == nullptr) || (ends->size() == 0u))
+        {
+            out_rings.push_back({coords_data, point_count, polygon_index, true});
+            return;
+        }
+
+        std::uint32_t ring_start {};
+        for (flatbuffers::uoffset_t i {}; i < ends->size(); ++i)
+        {
+            const std::uint32_t ring_end {std::min(ends->Get(i), point_count)};
+            if (ring_end > ring_start)
+                out_rings.push_back(
+                    {coords_data + static_cast<std::size_t>(ring_start) * 2u, ring_end - ring_start, polygon_index, i == 0u});
+            ring_start = ring_end;
+        }
+    }
+
+    // Collects zero-copy views of all rings of a Polygon or MultiPolygon geometry.
+    void geometry_processor::collect_rings(const FlatGeobuf::Geometry* const geometry_fbs,
+                                           const FlatGeobuf::GeometryType actual_geometry_type,
+                                           std::vector<ring_view>& out_rings) noexcept(false)
+    {
+        out_rings.clear();
+        if (geometry_fbs == nullptr)
+            return;
+
+        const auto* const parts = geometry_fbs->parts();
+        if ((actual_geometry_type == FlatGeobuf::GeometryType::MultiPolygon) && (parts != nullptr))
+        {
+            for (flatbuffers::uoffset_t i {}; i < parts->size(); ++i)
+                if (const FlatGeobuf::Geometry* const polygon_fbs = parts->Get(i); polygon_fbs != nullptr)
+                    append_polygon_rings(*polygon_fbs, i, out_rings);
+        }
+        // Some writers store the rings of a Polygon as parts; each part then holds one ring.
+        else if (parts != nullptr)
+        {
+            for (flatbuffers::uoffset_t i {}; i < parts->size(); ++i)
+                if (const FlatGeobuf::Geometry* const ring_fbs = parts->Get(i); ring_fbs != nullptr)
+                {
+                    const std::size_t first_ring {out_rings.size()};
+                    append_polygon_rings(*ring_fbs, 0u, out_rings);
+                    for (std::size_t r {first_ring}; r < out_rings.size(); ++r)
+                        out_rings[r].is_exterior = (i == 0u) && (r == first_ring);
+                }
+        }
+        else
+            append_polygon_rings(*geometry_fbs, 0u, out_rings);
+    }
+
+    // Tests whether a point lies inside a set of rings using the even-odd rule.
+    bool geometry_processor::contains_point(const std::span<const ring_view> rings, const double x, const double y) noexcept
+    {
+        bool inside {};
+        for (const ring_view& ring: rings)
+        {
+            if (ring.point_count < 3u)
+                continue;
+            // Classic crossing test over the edges (i - 1, i), starting with the closing edge.
+            for (std::uint32_t i {}, j {ring.point_count - 1u}; i < ring.point_count; j = i++)
+            {
+                const double yi {ring.y(i)};
+                const double yj {ring.y(j)};
+                if (((yi > y) != (yj > y)) && (x < (ring.x(j) - ring.x(i)) * (y - yi) / (yj - yi) + ring.x(i)))
+                    inside = !inside;
+            }
+        }
+        return inside;
+    }
+
+    // Computes the bounding box of a set of rings.
+    bounding_box geometry_processor::bbox_of_rings(const std::span<const ring_view> rings) noexcept
+    {
+        bounding_box bbox {};
+        for (const ring_view& ring: rings)
+            for (std::uint32_t i {}; i < ring.point_count; ++i)
+                bbox.update(ring.x(i), ring.y(i));
+        return bbox;
+    }
+
+    // Computes the area of a set of rings with the shoelace formula.
+    double geometry_processor::area_of_rings(const std::span<const ring_view> rings) noexcept
+    {
+        double area {};
+        for (const ring_view& ring: rings)
+        {
+            if (ring.point_count < 3u)
+                continue;
+            double twice_area {};
+            for (std::uint32_t i {}, j {ring.point_count - 1u}; i < ring.point_count; j = i++)
+                twice_area += (ring.x(j) - ring.x(i)) * (ring.y(j) + ring.y(i));
+            area += (ring.is_exterior ? 0.5 : -0.5) * std::abs(twice_area);
+        }
+        return area;
+    }
+
 } // namespace kmx::gis
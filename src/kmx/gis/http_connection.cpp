@@ -0,0 +1,175 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file http_connection.cpp
+#include "kmx/gis/http_connection.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace kmx::gis
+{
+    http_connection::http_connection(const int socket_fd) noexcept: fd_ {socket_fd}
+    {
+    }
+
+    http_connection::~http_connection() noexcept
+    {
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+
+    // Resolves the host and connects to the first address that accepts.
+    int http_connection::connect_to(const std::string& host, const std::uint16_t port) noexcept(false)
+    {
+        addrinfo hints {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* addresses {};
+        const std::string service {std::to_string(port)};
+        if (const int error {::getaddrinfo(host.c_str(), service.c_str(), &hints, &addresses)}; error != 0)
+            throw std::runtime_error("Cannot resolve host: " + host + " (" + ::gai_strerror(error) + ")");
+
+        int fd {-1};
+        for (const addrinfo* address {addresses}; (address != nullptr) && (fd < 0); address = address->ai_next)
+        {
+            fd = ::socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+            if ((fd >= 0) && (::connect(fd, address->ai_addr, address->ai_addrlen) != 0))
+            {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+        const int connect_error {errno};
+        ::freeaddrinfo(addresses);
+        if (fd < 0)
+            throw std::runtime_error("Cannot connect to " + host + ":" + service + " (" + std::strerror(connect_error) + ")");
+
+        // Range requests are small and latency-bound.
+        const int enable {1};
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+        return fd;
+    }
+
+    bool http_connection::send_all(std::span<const std::uint8_t> data) noexcept
+    {
+        while (!data.empty())
+        {
+            // MSG_NOSIGNAL: a peer that went away must not raise SIGPIPE.
+            const ssize_t sent {::send(fd_, data.data(), data.size(), MSG_NOSIGNAL)};
+            if (sent < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+            data = data.subspan(static_cast<std::size_t>(sent));
+        }
+        return true;
+    }
+
+    bool http_connection::send_all(const std::string_view text) noexcept
+    {
+        return send_all(std::span<const std::uint8_t> {reinterpret_cast<const std::uint8_t*>(text.data()), text.size()});
+    }
+
+    // Receives more bytes into the buffer.
+    bool http_connection::fill() noexcept(false)
+    {
+        const std::size_t old_size {buffer_.size()};
+        buffer_.resize(old_size + receive_chunk_);
+        ssize_t received {};
+        do
+            received = ::recv(fd_, buffer_.data() + old_size, receive_chunk_, 0);
+        while ((received < 0) && (errno == EINTR));
+        buffer_.resize(old_size + static_cast<std::size_t>(std::max<ssize_t>(received, 0)));
+        return received > 0;
+    }
+
+    bool http_connection::read_head(std::string& head) noexcept(false)
+    {
+        std::size_t end {};
+        while ((end = buffer_.find("\r\n\r\n")) == std::string::npos)
+            if ((buffer_.size() > max_head_size_) || !fill())
+                return false;
+        head.assign(buffer_, 0u, end);
+        buffer_.erase(0u, end + 4u);
+        return true;
+    }
+
+    bool http_connection::read_body(std::span<std::uint8_t> out) noexcept
+    {
+        // Bytes that arrived together with the head come first.
+        const std::size_t buffered {std::min(out.size(), buffer_.size())};
+        std::memcpy(out.data(), buffer_.data(), buffered);
+        buffer_.erase(0u, buffered);
+        out = out.subspan(buffered);
+        while (!out.empty())
+        {
+            const ssize_t received {::recv(fd_, out.data(), out.size(), 0)};
+            if (received < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+            if (received == 0)
+                return false;
+            out = out.subspan(static_cast<std::size_t>(received));
+        }
+        return true;
+    }
+
+    bool http_connection::discard_body(std::uint64_t size) noexcept
+    {
+        std::uint8_t scratch[4096u];
+        while (size > 0u)
+        {
+            const std::size_t step {static_cast<std::size_t>(std::min<std::uint64_t>(size, sizeof(scratch)))};
+            if (!read_body({scratch, step}))
+                return false;
+            size -= step;
+        }
+        return true;
+    }
+
+    void http_connection::set_receive_timeout(const std::uint32_t seconds) noexcept
+    {
+        const timeval timeout {static_cast<time_t>(seconds), 0};
+        ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+
+    // Finds a header line "Name: value" in a message head.
+    std::optional<std::string_view> http_connection::header_value(const std::string_view head, const std::string_view name) noexcept
+    {
+        // Header lines start after the start line.
+        for (std::size_t start {head.find("\r\n")}; start != std::string_view::npos;)
+        {
+            start += 2u;
+            const std::size_t end {std::min(head.find("\r\n", start), head.size())};
+            const std::string_view line {head.substr(start, end - start)};
+            const std::size_t colon {line.find(':')};
+            if ((colon == name.size()) &&
+                std::equal(name.begin(), name.end(), line.begin(),
+                           [](const char a, const char b)
+                           { return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b)); }))
+            {
+                std::string_view value {line.substr(colon + 1u)};
+                while (!value.empty() && ((value.front() == ' ') || (value.front() == '\t')))
+                    value.remove_prefix(1u);
+                while (!value.empty() && ((value.back() == ' ') || (value.back() == '\t')))
+                    value.remove_suffix(1u);
+                return value;
+            }
+            start = (end < head.size()) ? end : std::string_view::npos;
+        }
+        return std::nullopt;
+    }
+
+} // namespace kmx::gis
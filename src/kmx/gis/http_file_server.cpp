@@ -0,0 +1,261 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file http_file_server.cpp
+#include "kmx/gis/http_file_server.hpp"
+#include "kmx/gis/cached_reader.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <iostream>
+#include <netinet/in.h>
+#include <optional>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace kmx::gis
+{
+    // Parses an unsigned decimal number that must span the whole text.
+    static std::optional<std::uint64_t> parse_number(const std::string_view text) noexcept
+    {
+        std::uint64_t value {};
+        const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (text.empty() || (ec != std::errc {}) || (ptr != text.data() + text.size()))
+            return std::nullopt;
+        return value;
+    }
+
+    // Resolves a "bytes=a-b" / "bytes=a-" / "bytes=-n" range against the file size; `std::nullopt` if unsatisfiable.
+    // Multi-range requests are answered with the whole file, which RFC 9110 permits.
+    static std::optional<std::pair<std::uint64_t, std::uint64_t>> parse_range(const std::string_view value, const std::uint64_t size,
+                                                                                bool& ignored) noexcept
+    {
+        ignored = !value.starts_with("bytes=") || (value.find(',') != std::string_view::npos);
+        const std::size_t dash {value.find('-')};
+        if (ignored || (dash == std::string_view::npos))
+        {
+            ignored = true;
+            return std::pair<std::uint64_t, std::uint64_t> {0u, size};
+        }
+        const std::string_view first_text {value.substr(6u, dash - 6u)};
+        const std::string_view last_text {value.substr(dash + 1u)};
+        if (first_text.empty())
+        {
+            // Suffix range: the last n bytes.
+            const std::optional<std::uint64_t> suffix {parse_number(last_text)};
+            if (!suffix.has_value() || (*suffix == 0u) || (size == 0u))
+                return std::nullopt;
+            const std::uint64_t length {std::min(*suffix, size)};
+            return std::pair<std::uint64_t, std::uint64_t> {size - length, length};
+        }
+        const std::optional<std::uint64_t> first {parse_number(first_text)};
+        const std::optional<std::uint64_t> last {last_text.empty() ? std::optional<std::uint64_t> {size - 1u} : parse_number(last_text)};
+        if (!first.has_value() || !last.has_value() || (*first >= size) || (*last < *first))
+            return std::nullopt;
+        return std::pair<std::uint64_t, std::uint64_t> {*first, std::min(*last, size - 1u) - *first + 1u};
+    }
+
+    http_file_server::http_file_server(const std::string& root_path, const std::uint16_t port,
+                                       const std::uint32_t num_threads, const std::uint64_t cache_bytes) noexcept(false):
+        root_ {std::filesystem::is_directory(root_path) ? root_path : std::filesystem::path {root_path}.parent_path().string()},
+        port_ {port},
+        block_cache_ {static_cast<std::size_t>(cache_bytes)},
+        thread_pool_ {num_threads}
+    {
+        if (root_.empty())
+            root_ = ".";
+        std::cout << "Thread pool initialized with " << num_threads << " threads.\n";
+    }
+
+    // Maps a request target to a file below the root.
+    std::string http_file_server::resolve_target(const std::string_view target) const noexcept(false)
+    {
+        // Drop the query and undo percent-encoding.
+        const std::string_view path {target.substr(0u, target.find('?'))};
+        std::string decoded {};
+        for (std::size_t i {}; i < path.size(); ++i)
+        {
+            std::uint8_t value {};
+            if ((path[i] == '%') && ((i + 2u) < path.size()) &&
+                (std::from_chars(path.data() + i + 1u, path.data() + i + 3u, value, 16).ptr == path.data() + i + 3u))
+            {
+                decoded += static_cast<char>(value);
+                i += 2u;
+            }
+            else
+                decoded += path[i];
+        }
+        if (decoded.empty() || (decoded.front() != '/') || (decoded.find('\0') != std::string::npos))
+            return {};
+        // No segment may climb out of the root.
+        for (const auto& segment: std::filesystem::path {decoded})
+            if (segment == "..")
+                return {};
+        return root_ + decoded;
+    }
+
+    // Answers one request.
+    bool http_file_server::handle_request(http_connection& connection, const std::string& head) noexcept(false)
+    {
+        if ((++requests_ % statistics_interval_) == 0u)
+            block_cache_.print_statistics();
+
+        const std::size_t first_space {head.find(' ')};
+        const std::size_t second_space {head.find(' ', first_space + 1u)};
+        const std::size_t line_end {std::min(head.find("\r\n"), head.size())};
+        if ((first_space == std::string::npos) || (second_space == std::string::npos) || (second_space > line_end))
+        {
+            connection.send_all("HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+            return false;
+        }
+        const std::string_view method {std::string_view {head}.substr(0u, first_space)};
+        const std::string_view target {std::string_view {head}.substr(first_space + 1u, second_space - first_space - 1u)};
+        const std::string_view version {std::string_view {head}.substr(second_space + 1u, line_end - second_space - 1u)};
+        const std::optional<std::string_view> connection_header {http_connection::header_value(head, "Connection")};
+        const bool keep_alive {(version == "HTTP/1.1") ? (connection_header != "close") : (connection_header == "keep-alive")};
+        const std::string connection_line {keep_alive ? "Connection: keep-alive\r\n" : "Connection: close\r\n"};
+
+        // Request bodies are not used; drop them to keep the connection in sync.
+        if (const std::optional<std::string_view> length {http_connection::header_value(head, "Content-Length")}; length.has_value())
+            if (!connection.discard_body(parse_number(*length).value_or(0u)))
+                return false;
+
+        const bool is_head {method == "HEAD"};
+        if (!is_head && (method != "GET"))
+            return connection.send_all("HTTP/1.1 405 Method Not Allowed\r\nAllow: GET, HEAD\r\nContent-Length: 0\r\n" + connection_line +
+                                       "\r\n") &&
+                   keep_alive;
+
+        const std::string path {resolve_target(target)};
+        const int fd {path.empty() ? -1 : ::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+        struct stat file_stat {};
+        if ((fd < 0) || (::fstat(fd, &file_stat) != 0) || !S_ISREG(file_stat.st_mode))
+        {
+            if (fd >= 0)
+                ::close(fd);
+            return connection.send_all("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n" + connection_line + "\r\n") && keep_alive;
+        }
+
+        const std::uint64_t size {static_cast<std::uint64_t>(file_stat.st_size)};
+        std::optional<std::pair<std::uint64_t, std::uint64_t>> range {std::pair<std::uint64_t, std::uint64_t> {0u, size}};
+        bool whole_file {true};
+        if (const std::optional<std::string_view> range_header {http_connection::header_value(head, "Range")}; range_header.has_value())
+            range = parse_range(*range_header, size, whole_file);
+        if (!range.has_value())
+        {
+            ::close(fd);
+            return connection.send_all("HTTP/1.1 416 Range Not Satisfiable\r\nContent-Range: bytes */" + std::to_string(size) +
+                                       "\r\nContent-Length: 0\r\n" + connection_line + "\r\n") &&
+                   keep_alive;
+        }
+
+        const auto [offset, length] = *range;
+        std::string response_head {whole_file ? "HTTP/1.1 200 OK\r\n" : "HTTP/1.1 206 Partial Content\r\n"};
+        if (!whole_file)
+            response_head += "Content-Range: bytes " + std::to_string(offset) + '-' + std::to_string(offset + length - 1u) + '/' +
+                             std::to_string(size) + "\r\n";
+        response_head += "Accept-Ranges: bytes\r\nContent-Type: application/octet-stream\r\nContent-Length: " + std::to_string(length) +
+                         "\r\n" + connection_line + "\r\n";
+        bool sent {connection.send_all(response_head)};
+
+        // The cache key carries size and modification time, so a replaced file is not served from stale blocks.
+        const std::string key {path + '@' + std::to_string(size) + ':' + std::to_string(file_stat.st_mtim.tv_sec) + '.' +
+                               std::to_string(file_stat.st_mtim.tv_nsec)};
+        cached_reader reader {block_cache_, key, size,
+                              [fd](const std::uint64_t position, const std::span<std::uint8_t> out)
+                              {
+                                  for (std::size_t done {}; done < out.size();)
+                                  {
+                                      const ssize_t read_size {
+                                          ::pread(fd, out.data() + done, out.size() - done, static_cast<off_t>(position + done))};
+                                      if ((read_size < 0) && (errno == EINTR))
+                                          continue;
+                                      if (read_size <= 0)
+                                          throw std::runtime_error("The file shrank while being served.");
+                                      done += static_cast<std::size_t>(read_size);
+                                  }
+                              }};
+
+        std::vector<std::uint8_t> buffer(is_head ? 0u : static_cast<std::size_t>(std::min<std::uint64_t>(length, send_chunk_)));
+        for (std::uint64_t done {}; sent && !is_head && (done < length);)
+        {
+            const std::size_t step_size {static_cast<std::size_t>(std::min<std::uint64_t>(length - done, buffer.size()))};
+            const std::span<std::uint8_t> step {buffer.data(), step_size};
+            try
+            {
+                reader.read(offset + done, step);
+            }
+            catch (const std::exception&)
+            {
+                sent = false; // The response cannot be completed.
+                break;
+            }
+            sent = connection.send_all(step);
+            done += step.size();
+        }
+        ::close(fd);
+        return sent && keep_alive;
+    }
+
+    // Serves the requests of one connection.
+    void http_file_server::handle_connection(const int socket_fd) noexcept
+    {
+        try
+        {
+            http_connection connection {socket_fd};
+            connection.set_receive_timeout(idle_timeout_seconds_);
+            std::string head {};
+            while (connection.read_head(head) && handle_request(connection, head))
+                ;
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Warning: Connection failed: " << e.what() << std::endl;
+        }
+    }
+
+    // Accepts connections and hands them to the workers.
+    bool http_file_server::serve() noexcept(false)
+    {
+        const int listen_fd {::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+        if (listen_fd < 0)
+        {
+            std::cerr << "Error: Cannot create a socket: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        const int enable {1};
+        ::setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+        sockaddr_in address {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port_);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if ((::bind(listen_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) || (::listen(listen_fd, SOMAXCONN) != 0))
+        {
+            std::cerr << "Error: Cannot listen on port " << port_ << ": " << std::strerror(errno) << std::endl;
+            ::close(listen_fd);
+            return false;
+        }
+
+        std::cout << "Serving " << root_ << " on http://127.0.0.1:" << port_ << "/" << std::endl;
+        for (;;)
+        {
+            const int socket_fd {::accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC)};
+            if (socket_fd < 0)
+            {
+                if ((errno == EINTR) || (errno == ECONNABORTED))
+                    continue;
+                std::cerr << "Error: accept failed: " << std::strerror(errno) << std::endl;
+                ::close(listen_fd);
+                return false;
+            }
+            // The future is not needed: the handler reports its own errors.
+            static_cast<void>(thread_pool_.enqueue_task([this, socket_fd] { handle_connection(socket_fd); }));
+        }
+    }
+
+} // namespace kmx::gis
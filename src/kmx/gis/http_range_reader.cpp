@@ -0,0 +1,154 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file http_range_reader.cpp
+#include "kmx/gis/http_range_reader.hpp"
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+
+namespace kmx::gis
+{
+    static constexpr std::string_view url_scheme {"http://"};
+
+    // Parses an unsigned decimal number that must span the whole text.
+    static std::optional<std::uint64_t> parse_number(const std::string_view text) noexcept
+    {
+        std::uint64_t value {};
+        const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if ((ec != std::errc {}) || (ptr != text.data() + text.size()))
+            return std::nullopt;
+        return value;
+    }
+
+    // Status code of a response head ("HTTP/1.1 206 Partial Content").
+    static unsigned parse_status(const std::string_view head) noexcept
+    {
+        const std::size_t space {head.find(' ')};
+        if (!head.starts_with("HTTP/1.") || (space == std::string_view::npos))
+            return 0u;
+        return static_cast<unsigned>(parse_number(head.substr(space + 1u, 3u)).value_or(0u));
+    }
+
+    // Parses the URL and queries the size of the file with a one-byte range request.
+    http_range_reader::http_range_reader(const std::string& url) noexcept(false): url_ {url}
+    {
+        if (!is_url(url_))
+            throw std::runtime_error("Only http:// URLs are supported: " + url_);
+        const std::string_view rest {std::string_view {url_}.substr(url_scheme.size())};
+        const std::size_t slash {std::min(rest.find('/'), rest.size())};
+        const std::string_view authority {rest.substr(0u, slash)};
+        target_ = (slash < rest.size()) ? std::string {rest.substr(slash)} : std::string {"/"};
+
+        const std::size_t colon {authority.rfind(':')};
+        host_ = authority.substr(0u, colon);
+        if (colon != std::string_view::npos)
+        {
+            const std::optional<std::uint64_t> port {parse_number(authority.substr(colon + 1u))};
+            if (!port.has_value() || (*port == 0u) || (*port > 65535u))
+                throw std::runtime_error("Invalid port in URL: " + url_);
+            port_ = static_cast<std::uint16_t>(*port);
+        }
+        if (host_.empty())
+            throw std::runtime_error("Missing host in URL: " + url_);
+
+        std::string head {};
+        std::uint64_t content_length {};
+        std::unique_ptr<http_connection> connection {request("GET", "Range: bytes=0-0\r\n", head, content_length)};
+        const unsigned status {parse_status(head)};
+        const std::optional<std::string_view> content_range {http_connection::header_value(head, "Content-Range")};
+        const std::size_t total_start {content_range.has_value() ? content_range->rfind('/') : std::string_view::npos};
+        const std::optional<std::uint64_t> total {
+            (total_start != std::string_view::npos) ? parse_number(content_range->substr(total_start + 1u)) : std::nullopt};
+        if ((status != 206u) || !total.has_value())
+            throw std::runtime_error("Server does not support range requests (HTTP status " + std::to_string(status) + "): " + url_);
+        size_ = *total;
+        if (connection->discard_body(content_length) && (http_connection::header_value(head, "Connection") != "close"))
+            release(std::move(connection));
+    }
+
+    http_range_reader::~http_range_reader() noexcept = default;
+
+    bool http_range_reader::is_url(const std::string_view path) noexcept
+    {
+        return path.starts_with(url_scheme);
+    }
+
+    std::unique_ptr<http_connection> http_range_reader::acquire() noexcept(false)
+    {
+        {
+            std::lock_guard<std::mutex> lock {idle_mutex_};
+            if (!idle_.empty())
+            {
+                std::unique_ptr<http_connection> connection {std::move(idle_.back())};
+                idle_.pop_back();
+                return connection;
+            }
+        }
+        return std::make_unique<http_connection>(http_connection::connect_to(host_, port_));
+    }
+
+    void http_range_reader::release(std::unique_ptr<http_connection> connection) noexcept(false)
+    {
+        std::lock_guard<std::mutex> lock {idle_mutex_};
+        idle_.push_back(std::move(connection));
+    }
+
+    // Sends one request and reads the response head.
+    std::unique_ptr<http_connection> http_range_reader::request(const std::string_view method, const std::string& extra_headers,
+                                                                std::string& head, std::uint64_t& content_length) noexcept(false)
+    {
+        std::string message {method};
+        message += ' ';
+        message += target_;
+        message += " HTTP/1.1\r\nHost: " + host_;
+        if (port_ != 80u)
+            message += ':' + std::to_string(port_);
+        message += "\r\n" + extra_headers + "Connection: keep-alive\r\n\r\n";
+
+        // A pooled connection may have been closed by the server meanwhile; retry once on a new one.
+        for (int attempt {}; attempt < 2; ++attempt)
+        {
+            std::unique_ptr<http_connection> connection {
+                (attempt == 0) ? acquire() : std::make_unique<http_connection>(http_connection::connect_to(host_, port_))};
+            if (!connection->send_all(message) || !connection->read_head(head))
+                continue;
+
+            ++request_count_;
+            if (http_connection::header_value(head, "Transfer-Encoding").has_value())
+                throw std::runtime_error("Chunked responses are not supported: " + url_);
+            const std::optional<std::string_view> length_text {http_connection::header_value(head, "Content-Length")};
+            content_length = length_text.has_value() ? parse_number(*length_text).value_or(0u) : 0u;
+            return connection;
+        }
+        throw std::runtime_error("HTTP request failed: " + url_);
+    }
+
+    void http_range_reader::read_into(const std::uint64_t offset, const std::span<std::uint8_t> out) noexcept(false)
+    {
+        if (out.empty())
+            return;
+        if ((offset > size_) || (out.size() > size_ - offset))
+            throw std::runtime_error("Range outside of the remote file: " + url_);
+
+        const std::string range {"Range: bytes=" + std::to_string(offset) + '-' + std::to_string(offset + out.size() - 1u) + "\r\n"};
+        std::string head {};
+        std::uint64_t content_length {};
+        std::unique_ptr<http_connection> connection {request("GET", range, head, content_length)};
+        const unsigned status {parse_status(head)};
+        if ((status != 206u) || (content_length != out.size()))
+            throw std::runtime_error("Unexpected response to a range request (HTTP status " + std::to_string(status) + "): " + url_);
+        if (!connection->read_body(out))
+            throw std::runtime_error("Connection lost while reading: " + url_);
+        bytes_received_ += out.size();
+
+        if (http_connection::header_value(head, "Connection") != "close")
+            release(std::move(connection));
+    }
+
+    std::vector<std::uint8_t> http_range_reader::read(const byte_range range) noexcept(false)
+    {
+        std::vector<std::uint8_t> bytes(static_cast<std::size_t>(range.length));
+        read_into(range.offset, bytes);
+        return bytes;
+    }
+
+} // namespace kmx::gis
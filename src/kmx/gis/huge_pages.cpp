@@ -0,0 +1,145 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file huge_pages.cpp
+#include "kmx/gis/huge_pages.hpp"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <linux/perf_event.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace kmx::gis
+{
+    std::optional<huge_page_mode> huge_pages::parse(const std::string_view text) noexcept
+    {
+        if (text == "off")
+            return huge_page_mode::off;
+        if (text == "thp")
+            return huge_page_mode::transparent;
+        if (text == "hugetlb")
+            return huge_page_mode::hugetlb;
+        return std::nullopt;
+    }
+
+    std::string_view huge_pages::name(const huge_page_mode mode) noexcept
+    {
+        switch (mode)
+        {
+            case huge_page_mode::transparent: return "thp";
+            case huge_page_mode::hugetlb: return "hugetlb";
+            case huge_page_mode::off: break;
+        }
+        return "off";
+    }
+
+    // Only the whole huge pages inside the range can be backed by huge pages.
+    void huge_pages::advise(void* const address, const std::size_t size) noexcept
+    {
+        if ((mode() == huge_page_mode::off) || (size < min_size))
+            return;
+        const std::uintptr_t begin {(reinterpret_cast<std::uintptr_t>(address) + page_size - 1u) / page_size * page_size};
+        const std::uintptr_t end {(reinterpret_cast<std::uintptr_t>(address) + size) / page_size * page_size};
+        if ((end > begin) && (::madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE) == 0))
+            transparent_buffers_.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    void* huge_pages::map_anonymous(const std::size_t size) noexcept
+    {
+        if (mode() == huge_page_mode::hugetlb)
+        {
+            static constexpr int flags {MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB};
+            void* const memory {::mmap(nullptr, mapping_size(size), PROT_READ | PROT_WRITE, flags, -1, 0)};
+            if (memory != MAP_FAILED)
+            {
+                hugetlb_buffers_.fetch_add(1u, std::memory_order_relaxed);
+                return memory;
+            }
+            fallbacks_.fetch_add(1u, std::memory_order_relaxed); // No reserved pages (vm.nr_hugepages) are free
+        }
+
+        // Every mapping covers whole huge pages, so `unmap_anonymous` needs nothing but the size; untouched pages cost
+        // no memory. For transparent huge pages, over-allocate by one page to start on a 2 MiB boundary and return the
+        // unused head and tail at once.
+        const std::size_t length {mapping_size(size)};
+        const bool aligned {mode() != huge_page_mode::off};
+        const std::size_t reserved {aligned ? (length + page_size) : length};
+        void* const memory {::mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+        if (memory == MAP_FAILED)
+            return nullptr;
+        if (!aligned)
+            return memory;
+        const std::uintptr_t raw {reinterpret_cast<std::uintptr_t>(memory)};
+        const std::uintptr_t begin {(raw + page_size - 1u) / page_size * page_size};
+        if (begin > raw)
+            ::munmap(memory, begin - raw);
+        if ((begin + length) < (raw + reserved))
+            ::munmap(reinterpret_cast<void*>(begin + length), raw + reserved - begin - length);
+        advise(reinterpret_cast<void*>(begin), length);
+        return reinterpret_cast<void*>(begin);
+    }
+
+    void huge_pages::unmap_anonymous(void* const address, const std::size_t size) noexcept
+    {
+        if (address != nullptr)
+            ::munmap(address, mapping_size(size));
+    }
+
+    void huge_pages::print_statistics() noexcept(false)
+    {
+        if (mode() == huge_page_mode::off)
+            return;
+        std::cout << "Huge pages: " << hugetlb_buffers_.load() << " buffers on hugetlbfs pages, " << transparent_buffers_.load()
+                  << " advised for transparent huge pages, " << fallbacks_.load() << " hugetlbfs fallbacks." << std::endl;
+    }
+
+    // Opens two counters, for all threads the process starts from now on.
+    tlb_counters::tlb_counters() noexcept
+    {
+        static constexpr std::array<std::uint64_t, 2u> results {PERF_COUNT_HW_CACHE_RESULT_ACCESS, PERF_COUNT_HW_CACHE_RESULT_MISS};
+        for (std::size_t i {}; i < fds_.size(); ++i)
+        {
+            ::perf_event_attr attributes {};
+            attributes.type = PERF_TYPE_HW_CACHE;
+            attributes.size = sizeof(attributes);
+            attributes.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8u) | (results[i] << 16u);
+            attributes.exclude_kernel = 1u;
+            attributes.exclude_hv = 1u;
+            attributes.inherit = 1u;
+            fds_[i] = static_cast<int>(::syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+        }
+        if ((fds_[0] < 0) || (fds_[1] < 0))
+            std::cerr << "Warning: dTLB counters are unavailable (" << std::strerror(errno)
+                      << "); check /proc/sys/kernel/perf_event_paranoid." << std::endl;
+    }
+
+    tlb_counters::~tlb_counters() noexcept
+    {
+        try
+        {
+            print();
+        }
+        catch (...)
+        {
+        }
+        for (const int fd: fds_)
+            if (fd >= 0)
+                ::close(fd);
+    }
+
+    void tlb_counters::print() const noexcept(false)
+    {
+        std::array<std::uint64_t, 2u> counts {};
+        for (std::size_t i {}; i < fds_.size(); ++i)
+            if ((fds_[i] < 0) || (::read(fds_[i], &counts[i], sizeof(counts[i])) != static_cast<::ssize_t>(sizeof(counts[i]))))
+                return;
+        const double rate {(counts[0] > 0u) ? (100.0 * static_cast<double>(counts[1]) / static_cast<double>(counts[0])) : 0.0};
+        const huge_page_mode mode {huge_pages::mode()};
+        std::cout << "dTLB with --huge-pages " << huge_pages::name(mode) << ": " << counts[0] << " loads, " << counts[1] << " misses ("
+                  << rate << "%)." << std::endl;
+        std::cout << ((mode == huge_page_mode::off) ? "This is the control run; compare with --huge-pages thp or hugetlb"
+                                                    : "Compare with a control run using --huge-pages off")
+                  << " on the same input, mode and -t." << std::endl;
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,231 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file layer_diff.cpp
+#include "kmx/gis/layer_diff.hpp"
+#include "kmx/gis/csv_format.hpp"
+#include "kmx/gis/feature_properties.hpp"
+#include "kmx/gis/geometry_processor.hpp"
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+
+namespace kmx::gis
+{
+    layer_diff::layer_diff(const std::string& input_fgb_path, const std::string& previous_fgb_path, const std::string& output_csv_path,
+                           const std::uint32_t num_threads, const std::string& key_column) noexcept(false):
+        output_csv_path_ {output_csv_path},
+        key_column_ {key_column},
+        thread_pool_ {num_threads},
+        dataset_ {input_fgb_path},
+        previous_ {previous_fgb_path}
+    {
+        std::cout << "Thread pool initialized with " << num_threads << " threads.\n";
+    }
+
+    std::vector<layer_diff::feature_digest> layer_diff::digest(const fgb_dataset& dataset, const std::size_t key_column) noexcept(false)
+    {
+        const std::uint64_t feature_count {dataset.feature_count()};
+        std::vector<feature_digest> digests(feature_count);
+        const std::size_t chunk_size {std::max<std::size_t>(1u, feature_count / (thread_pool_.size() * 8u + 1u))};
+        thread_pool_.parallel_for(feature_count, chunk_size,
+                                  [&](const std::size_t begin, const std::size_t end)
+                                  {
+                                      std::vector<ring_view> rings {};
+                                      std::vector<std::uint64_t> words {};
+                                      const std::size_t ahead {dataset.prefetch_distance()};
+                                      for (std::size_t i {begin}; i < end; ++i)
+                                      {
+                                          if ((i + ahead) < end)
+                                              dataset.prefetch_feature(i + ahead);
+                                          const FlatGeobuf::Feature* const feature {dataset.feature(i)};
+                                          feature_digest& entry {digests[i]};
+                                          entry.key = feature_properties::get_string_value(feature, dataset.header(), key_column);
+                                          entry.key_hash = std::hash<std::string> {}(entry.key);
+                                          geometry_processor::collect_rings(feature->geometry(),
+                                                                            dataset.geometry_type_of(feature->geometry()), rings);
+                                          if (!geometry_hash::canonicalize(rings, words))
+                                              continue;
+                                          entry.hash = geometry_hash::of_words(words);
+                                          entry.bbox = geometry_processor::bbox_of_rings(rings);
+                                          entry.area = geometry_processor::area_of_rings(rings);
+                                      }
+                                  });
+        return digests;
+    }
+
+    // A counting sort, so every partition keeps its features in file order.
+    std::vector<std::uint64_t> layer_diff::partition(const std::span<const feature_digest> digests,
+                                                     std::vector<std::uint64_t>& starts) noexcept(false)
+    {
+        starts.assign(partition_count_ + 1u, 0u);
+        for (const feature_digest& entry: digests)
+            ++starts[partition_of(entry.key_hash) + 1u];
+        std::partial_sum(starts.begin(), starts.end(), starts.begin());
+        std::vector<std::uint64_t> members(digests.size());
+        std::vector<std::uint64_t> next {starts.begin(), starts.end() - 1};
+        for (std::uint64_t i {}; i < digests.size(); ++i)
+            members[next[partition_of(digests[i].key_hash)]++] = i;
+        return members;
+    }
+
+    bool layer_diff::diff() noexcept(false)
+    {
+        const std::optional<std::size_t> key_column {dataset_.find_column(key_column_)};
+        const std::optional<std::size_t> previous_key_column {previous_.find_column(key_column_)};
+        if (!key_column.has_value() || !previous_key_column.has_value())
+        {
+            std::cerr << "Error: Key column '" << key_column_ << "' not found in "
+                      << (key_column.has_value() ? previous_.path() : dataset_.path()) << "." << std::endl;
+            return false;
+        }
+
+        const std::vector<feature_digest> previous {digest(previous_, *previous_key_column)};
+        const std::vector<feature_digest> current {digest(dataset_, *key_column)};
+        std::vector<std::uint64_t> previous_starts {};
+        std::vector<std::uint64_t> current_starts {};
+        const std::vector<std::uint64_t> previous_members {partition(previous, previous_starts)};
+        const std::vector<std::uint64_t> current_members {partition(current, current_starts)};
+
+        // Hash join of every partition: the previous features are the build side, the new ones probe it
+        std::array<std::vector<change>, partition_count_> partition_changes {};
+        std::array<std::uint64_t, partition_count_> partition_unchanged {};
+        thread_pool_.parallel_for(
+            partition_count_, 1u,
+            [&](const std::size_t begin, const std::size_t end)
+            {
+                for (std::size_t p {begin}; p < end; ++p)
+                {
+                    // Each key maps to the cursor of its chain of previous features, in file order
+                    const std::span<const std::uint64_t> olds {previous_members.data() + previous_starts[p],
+                                                               previous_members.data() + previous_starts[p + 1u]};
+                    std::vector<std::size_t> chain(olds.size(), olds.size());
+                    std::unordered_map<std::string_view, std::size_t> cursor {};
+                    cursor.reserve(olds.size());
+                    for (std::size_t k {olds.size()}; k-- > 0u;)
+                    {
+                        const auto [it, inserted] = cursor.try_emplace(previous[olds[k]].key, k);
+                        if (!inserted)
+                        {
+                            chain[k] = it->second;
+                            it->second = k;
+                        }
+                    }
+
+                    std::vector<change>& changes {partition_changes[p]};
+                    for (std::uint64_t j {current_starts[p]}; j < current_starts[p + 1u]; ++j)
+                    {
+                        const std::uint64_t index {current_members[j]};
+                        const feature_digest& entry {current[index]};
+                        const auto it = cursor.find(entry.key);
+                        if ((it == cursor.end()) || (it->second == olds.size()))
+                        {
+                            changes.push_back({change_kind::added, no_feature_, index});
+                            continue;
+                        }
+                        const std::uint64_t old_index {olds[it->second]};
+                        it->second = chain[it->second];
+                        const feature_digest& old_entry {previous[old_index]};
+                        const bool same_box {(entry.bbox.is_valid == old_entry.bbox.is_valid) &&
+                                             (!entry.bbox.is_valid ||
+                                              (std::tie(entry.bbox.min_x, entry.bbox.min_y, entry.bbox.max_x, entry.bbox.max_y) ==
+                                               std::tie(old_entry.bbox.min_x, old_entry.bbox.min_y, old_entry.bbox.max_x,
+                                                        old_entry.bbox.max_y)))};
+                        if ((entry.hash == old_entry.hash) && same_box && (entry.area == old_entry.area))
+                            ++partition_unchanged[p];
+                        else
+                            changes.push_back({change_kind::changed, old_index, index});
+                    }
+
+                    // The rest of every chain was not matched
+                    for (const auto& [key, first]: cursor)
+                        for (std::size_t k {first}; k < olds.size(); k = chain[k])
+                            changes.push_back({change_kind::removed, olds[k], no_feature_});
+                }
+            });
+
+        std::vector<change> changes {};
+        std::array<std::uint64_t, 3u> kinds {};
+        for (std::vector<change>& part: partition_changes)
+        {
+            for (const change& row: part)
+                ++kinds[static_cast<std::size_t>(row.kind)];
+            changes.insert(changes.end(), part.begin(), part.end());
+            part = {};
+        }
+        std::cout << "Compared " << previous.size() << " previous and " << current.size() << " new features by '" << key_column_
+                  << "': " << kinds[0] << " added, " << kinds[1] << " removed, " << kinds[2] << " changed, "
+                  << std::accumulate(partition_unchanged.begin(), partition_unchanged.end(), std::uint64_t {}) << " unchanged."
+                  << std::endl;
+        return write_changes(changes, previous, current);
+    }
+
+    bool layer_diff::write_changes(std::vector<change>& changes, const std::span<const feature_digest> previous,
+                                   const std::span<const feature_digest> current) const noexcept(false)
+    {
+        const auto key_of = [&](const change& row) -> const std::string&
+        { return (row.current != no_feature_) ? current[row.current].key : previous[row.previous].key; };
+        std::sort(changes.begin(), changes.end(),
+                  [&](const change& a, const change& b)
+                  { return std::tie(key_of(a), a.previous, a.current) < std::tie(key_of(b), b.previous, b.current); });
+
+        std::ofstream output_file {output_csv_path_};
+        if (!output_file.is_open())
+        {
+            std::cerr << "Error: Could not open CSV file for writing: " << output_csv_path_ << std::endl;
+            return false;
+        }
+
+        static constexpr std::array<std::string_view, 3u> kind_names {"added", "removed", "changed"};
+        const auto write_index = [&](const std::uint64_t index)
+        {
+            output_file << csv_format::delimiter;
+            if (index != no_feature_)
+                output_file << index;
+        };
+        output_file << std::fixed << std::setprecision(bounding_box::csv_coordinate_precision);
+        output_file << "status,key,previous_feature,new_feature,min_x,min_y,max_x,max_y,area,d_min_x,d_min_y,d_max_x,d_max_y,d_area\n";
+        for (const change& row: changes)
+        {
+            output_file << kind_names[static_cast<std::size_t>(row.kind)] << csv_format::delimiter;
+            csv_format::write_escaped(output_file, key_of(row));
+            write_index(row.previous);
+            write_index(row.current);
+
+            // Removed rows describe the previous geometry, the others the new one
+            const feature_digest& entry {(row.current != no_feature_) ? current[row.current] : previous[row.previous]};
+            output_file << csv_format::delimiter;
+            entry.bbox.write_to_stream(output_file);
+            output_file << csv_format::delimiter << entry.area;
+            if (row.kind != change_kind::changed)
+            {
+                output_file << ",,,,,\n";
+                continue;
+            }
+            const feature_digest& old_entry {previous[row.previous]};
+            output_file << csv_format::delimiter;
+            if (entry.bbox.is_valid && old_entry.bbox.is_valid)
+                output_file << (entry.bbox.min_x - old_entry.bbox.min_x) << csv_format::delimiter
+                            << (entry.bbox.min_y - old_entry.bbox.min_y) << csv_format::delimiter
+                            << (entry.bbox.max_x - old_entry.bbox.max_x) << csv_format::delimiter
+                            << (entry.bbox.max_y - old_entry.bbox.max_y);
+            else
+                output_file << bounding_box::invalid_bbox_csv_marker;
+            output_file << csv_format::delimiter << (entry.area - old_entry.area) << '\n';
+        }
+
+        if (!output_file)
+        {
+            std::cerr << "Error: Failed writing CSV file: " << output_csv_path_ << std::endl;
+            return false;
+        }
+        std::cout << "Output written to: " << output_csv_path_ << std::endl;
+        return true;
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,497 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file lookup_grid.cpp
+#include "kmx/gis/lookup_grid.hpp"
+#include "kmx/gis/feature_properties.hpp"
+#include "kmx/gis/geometry_processor.hpp"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+
+namespace kmx::gis
+{
+    using grid_header = lookup_grid_file_header;
+
+    // Rounds a byte offset up to the 8-byte alignment used for all sections.
+    static constexpr std::uint64_t align_section(const std::uint64_t offset) noexcept
+    {
+        return (offset + 7u) & ~std::uint64_t {7u};
+    }
+
+    lookup_grid_builder::lookup_grid_builder(const std::string& input_fgb_path, const std::string& output_grid_path,
+                                             const std::uint32_t num_threads, const lookup_grid_settings& settings) noexcept(false):
+        input_fgb_path_ {input_fgb_path},
+        output_grid_path_ {output_grid_path},
+        settings_ {settings},
+        thread_pool_ {num_threads},
+        dataset_ {input_fgb_path}
+    {
+        std::cout << "Thread pool initialized with " << num_threads << " threads.\n";
+    }
+
+    bool lookup_grid_builder::build() noexcept(false)
+    {
+        const FgbGeometryType header_geom_type {dataset_.geometry_type()};
+        if ((header_geom_type != FgbGeometryType::Polygon) && (header_geom_type != FgbGeometryType::MultiPolygon))
+        {
+            std::cerr << "Error: Lookup grids require Polygon/MultiPolygon FGB files. Found: "
+                      << FlatGeobuf::EnumNameGeometryType(header_geom_type) << std::endl;
+            return false;
+        }
+
+        const std::uint64_t feature_count {dataset_.feature_count()};
+        if ((feature_count == 0u) || (feature_count > max_feature_count_))
+        {
+            std::cerr << "Error: Unsupported feature count for a lookup grid: " << feature_count << std::endl;
+            return false;
+        }
+        if (!(settings_.cell_size > 0.0) || (settings_.refine_factor == 0u))
+        {
+            std::cerr << "Error: Cell size and refine factor must be positive." << std::endl;
+            return false;
+        }
+
+        // Dataset extent from the per-feature boxes (R-tree leaves when indexed).
+        bounding_box extent {};
+        std::mutex extent_mutex {};
+        thread_pool_.parallel_for(static_cast<std::size_t>(feature_count), 4096u,
+                                  [&](const std::size_t begin, const std::size_t end)
+                                  {
+                                      bounding_box local {};
+                                      for (std::size_t i {begin}; i < end; ++i)
+                                          if (const bounding_box bbox {dataset_.feature_bbox(i)}; bbox.is_valid)
+                                          {
+                                              local.update(bbox.min_x, bbox.min_y);
+                                              local.update(bbox.max_x, bbox.max_y);
+                                          }
+                                      if (!local.is_valid)
+                                          return;
+                                      std::lock_guard<std::mutex> lock {extent_mutex};
+                                      extent.update(local.min_x, local.min_y);
+                                      extent.update(local.max_x, local.max_y);
+                                  });
+        if (!extent.is_valid)
+        {
+            std::cerr << "Error: The input has no valid geometries." << std::endl;
+            return false;
+        }
+
+        const double coarse_cols_real {std::max(1.0, std::ceil((extent.max_x - extent.min_x) / settings_.cell_size))};
+        const double coarse_rows_real {std::max(1.0, std::ceil((extent.max_y - extent.min_y) / settings_.cell_size))};
+        const double fine_cells_real {coarse_cols_real * coarse_rows_real * settings_.refine_factor * settings_.refine_factor};
+        if (fine_cells_real > static_cast<double>(max_fine_cells_))
+        {
+            std::cerr << "Error: Grid of " << fine_cells_real << " fine cells is too large; increase the cell size." << std::endl;
+            return false;
+        }
+
+        const auto coarse_cols = static_cast<std::uint32_t>(coarse_cols_real);
+        const auto coarse_rows = static_cast<std::uint32_t>(coarse_rows_real);
+        const double fine_cell_size {settings_.cell_size / settings_.refine_factor};
+        const raster_grid fine_grid {extent.min_x,
+                                     extent.min_y,
+                                     fine_cell_size,
+                                     fine_cell_size,
+                                     coarse_cols * settings_.refine_factor,
+                                     coarse_rows * settings_.refine_factor};
+
+        std::cout << "Grid: " << coarse_cols << " x " << coarse_rows << " coarse cells of " << settings_.cell_size << ", refined "
+                  << settings_.refine_factor << "x to " << fine_cell_size << "." << std::endl;
+
+        rasterize_features(fine_grid);
+        return write_grid_file(fine_grid, extent, coarse_cols, coarse_rows);
+    }
+
+    // Rasterizes all features onto `fine_cells_`, collecting (fine cell, feature) candidate pairs.
+    void lookup_grid_builder::rasterize_features(const raster_grid& fine_grid) noexcept(false)
+    {
+        fine_cells_.assign(static_cast<std::size_t>(fine_grid.cell_count()), grid_header::empty_cell);
+        candidates_.clear();
+        std::mutex candidates_mutex {};
+
+        const std::size_t feature_count {static_cast<std::size_t>(dataset_.feature_count())};
+        const std::size_t chunk_size {std::max<std::size_t>(1u, feature_count / (thread_pool_.size() * 8u + 1u))};
+
+        thread_pool_.parallel_for(
+            feature_count, chunk_size,
+            [&](const std::size_t begin, const std::size_t end)
+            {
+                polygon_rasterizer rasterizer {};
+                std::vector<ring_view> rings {};
+                std::vector<cell_span> spans {};
+                std::vector<std::uint64_t> boundary_cells {};
+                std::vector<std::pair<std::uint64_t, std::uint32_t>> local_candidates {};
+                const std::size_t ahead {dataset_.prefetch_distance()};
+
+                for (std::size_t i {begin}; i < end; ++i)
+                {
+                    if ((i + ahead) < end)
+                        dataset_.prefetch_feature(i + ahead);
+                    const auto feature_id = static_cast<std::uint32_t>(i);
+                    const FlatGeobuf::Geometry* const geometry {dataset_.feature(i)->geometry()};
+                    geometry_processor::collect_rings(geometry, dataset_.geometry_type_of(geometry), rings);
+                    if (rings.empty())
+                        continue;
+
+                    // Interior cells. Features of a partition never overlap, so a conflict only happens for
+                    // overlapping inputs; the cell then degrades to a boundary cell listing both features.
+                    rasterizer.fill(rings, fine_grid, spans);
+                    for (const cell_span& span: spans)
+                        for (std::uint32_t col {span.col_begin}; col < span.col_end; ++col)
+                        {
+                            const std::uint64_t cell {static_cast<std::uint64_t>(span.row) * fine_grid.cols + col};
+                            std::atomic_ref<std::uint32_t> value {fine_cells_[static_cast<std::size_t>(cell)]};
+                            std::uint32_t current {value.load(std::memory_order_relaxed)};
+                            while (true)
+                            {
+                                if (current == grid_header::empty_cell)
+                                {
+                                    if (value.compare_exchange_weak(current, feature_id, std::memory_order_relaxed))
+                                        break;
+                                }
+                                else if (current == boundary_marker_)
+                                {
+                                    local_candidates.emplace_back(cell, feature_id);
+                                    break;
+                                }
+                                else if (value.compare_exchange_weak(current, boundary_marker_, std::memory_order_relaxed))
+                                {
+                                    local_candidates.emplace_back(cell, current);
+                                    local_candidates.emplace_back(cell, feature_id);
+                                    break;
+                                }
+                            }
+                        }
+
+                    // Boundary cells always need the exact test; whoever owned the cell before becomes a candidate too.
+                    rasterizer.trace(rings, fine_grid, boundary_cells);
+                    for (const std::uint64_t cell: boundary_cells)
+                    {
+                        std::atomic_ref<std::uint32_t> value {fine_cells_[static_cast<std::size_t>(cell)]};
+                        const std::uint32_t previous {value.exchange(boundary_marker_, std::memory_order_relaxed)};
+                        if ((previous != grid_header::empty_cell) && (previous != boundary_marker_))
+                            local_candidates.emplace_back(cell, previous);
+                        local_candidates.emplace_back(cell, feature_id);
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock {candidates_mutex};
+                candidates_.insert(candidates_.end(), local_candidates.begin(), local_candidates.end());
+            });
+
+        std::sort(candidates_.begin(), candidates_.end());
+        candidates_.erase(std::unique(candidates_.begin(), candidates_.end()), candidates_.end());
+        std::cout << "Rasterized " << feature_count << " features, " << candidates_.size() << " boundary candidates." << std::endl;
+    }
+
+    // Reads the UAT code of every feature for the code table.
+    std::vector<std::uint32_t> lookup_grid_builder::read_uat_codes() const noexcept(false)
+    {
+        std::vector<std::uint32_t> codes(static_cast<std::size_t>(dataset_.feature_count()), 0u);
+        const std::optional<std::size_t> code_column {dataset_.find_column(expected_uat_code_column_)};
+        if (!code_column.has_value())
+        {
+            std::cout << "Warning: Could not find the expected UAT code property '" << expected_uat_code_column_
+                      << "'. The code table will hold zeros." << std::endl;
+            return codes;
+        }
+
+        for (std::size_t i {}; i < codes.size(); ++i)
+            codes[i] = feature_properties::parse_uint32(
+                           feature_properties::get_string_value(dataset_.feature(i), dataset_.header(), *code_column))
+                           .value_or(0u);
+        return codes;
+    }
+
+    // Compresses the fine grid into the two-level representation and writes the file.
+    bool lookup_grid_builder::write_grid_file(const raster_grid& fine_grid, const bounding_box& extent, const std::uint32_t coarse_cols,
+                                              const std::uint32_t coarse_rows) noexcept(false)
+    {
+        const std::uint32_t factor {settings_.refine_factor};
+        const std::size_t block_cells {static_cast<std::size_t>(factor) * factor};
+        const std::size_t coarse_count {static_cast<std::size_t>(coarse_cols) * coarse_rows};
+
+        // Candidate lists: [count, feature...] per boundary cell, addressed by word offset.
+        std::vector<std::uint64_t> candidate_cells {};
+        std::vector<std::uint32_t> candidate_list_offsets {};
+        std::vector<std::uint32_t> candidate_words {};
+        for (std::size_t k {}; k < candidates_.size();)
+        {
+            std::size_t group_end {k};
+            while ((group_end < candidates_.size()) && (candidates_[group_end].first == candidates_[k].first))
+                ++group_end;
+            candidate_cells.push_back(candidates_[k].first);
+            candidate_list_offsets.push_back(static_cast<std::uint32_t>(candidate_words.size()));
+            candidate_words.push_back(static_cast<std::uint32_t>(group_end - k));
+            for (std::size_t g {k}; g < group_end; ++g)
+                candidate_words.push_back(candidates_[g].second);
+            k = group_end;
+        }
+        if (candidate_words.size() >= grid_header::reference_flag)
+        {
+            // Boundary candidates grow with the fine cell count, i.e. with the refine factor over the cell size
+            std::cerr << "Error: Too many boundary candidates for the grid format; decrease --refine or increase --cell-size."
+                      << std::endl;
+            return false;
+        }
+
+        // A coarse cell is uniform when all of its fine cells hold the same feature (or are all empty).
+        std::vector<std::uint32_t> coarse(coarse_count, grid_header::empty_cell);
+        const auto classify_rows = [&](const std::size_t row_begin, const std::size_t row_end)
+        {
+            for (std::size_t cy {row_begin}; cy < row_end; ++cy)
+                for (std::size_t cx {}; cx < coarse_cols; ++cx)
+                {
+                    const std::size_t first {(cy * factor) * fine_grid.cols + cx * factor};
+                    const std::uint32_t value {fine_cells_[first]};
+                    bool uniform {value != boundary_marker_};
+                    for (std::size_t fy {}; uniform && (fy < factor); ++fy)
+                    {
+                        const std::uint32_t* const row {&fine_cells_[first + fy * fine_grid.cols]};
+                        uniform = std::all_of(row, row + factor, [value](const std::uint32_t v) { return v == value; });
+                    }
+                    coarse[cy * coarse_cols + cx] = uniform ? value : boundary_marker_;
+                }
+        };
+        thread_pool_.parallel_for(coarse_rows, 16u, classify_rows);
+
+        std::uint32_t block_count {};
+        for (std::uint32_t& value: coarse)
+            if (value == boundary_marker_)
+                value = grid_header::reference_flag | block_count++;
+
+        std::vector<std::uint32_t> blocks(static_cast<std::size_t>(block_count) * block_cells);
+        const auto fill_blocks = [&](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t c {begin}; c < end; ++c)
+            {
+                if ((coarse[c] == grid_header::empty_cell) || ((coarse[c] & grid_header::reference_flag) == 0u))
+                    continue;
+                const std::size_t block {coarse[c] & ~grid_header::reference_flag};
+                const std::size_t cy {c / coarse_cols};
+                const std::size_t cx {c % coarse_cols};
+                for (std::size_t fy {}; fy < factor; ++fy)
+                    for (std::size_t fx {}; fx < factor; ++fx)
+                    {
+                        const std::uint64_t cell {(cy * factor + fy) * fine_grid.cols + cx * factor + fx};
+                        std::uint32_t value {fine_cells_[static_cast<std::size_t>(cell)]};
+                        // Boundary cells point at their candidate list
+                        if (value == boundary_marker_)
+                        {
+                            const auto it = std::lower_bound(candidate_cells.begin(), candidate_cells.end(), cell);
+                            const auto list = static_cast<std::size_t>(it - candidate_cells.begin());
+                            value = grid_header::reference_flag | candidate_list_offsets[list];
+                        }
+                        blocks[block * block_cells + fy * factor + fx] = value;
+                    }
+            }
+        };
+        thread_pool_.parallel_for(coarse_count, 4096u, fill_blocks);
+        fine_cells_ = {}; // Release the transient grid before writing
+
+        const std::vector<std::uint32_t> codes {read_uat_codes()};
+
+        grid_header header {};
+        header.magic = grid_header::magic_value;
+        header.version = grid_header::current_version;
+        header.refine_factor = factor;
+        header.cols = coarse_cols;
+        header.rows = coarse_rows;
+        header.origin_x = extent.min_x;
+        header.origin_y = extent.min_y;
+        header.cell_size = settings_.cell_size;
+        header.feature_count = dataset_.feature_count();
+        header.source_size = dataset_.file_bytes().size();
+        header.codes_offset = align_section(sizeof(grid_header));
+        header.coarse_offset = align_section(header.codes_offset + codes.size() * sizeof(std::uint32_t));
+        header.blocks_offset = align_section(header.coarse_offset + coarse.size() * sizeof(std::uint32_t));
+        header.block_count = block_count;
+        header.candidates_offset = align_section(header.blocks_offset + blocks.size() * sizeof(std::uint32_t));
+        header.candidates_size = candidate_words.size();
+
+        std::ofstream output_file {output_grid_path_, std::ios::binary | std::ios::trunc};
+        if (!output_file.is_open())
+        {
+            std::cerr << "Error: Could not open grid file for writing: " << output_grid_path_ << std::endl;
+            return false;
+        }
+
+        const auto write_section = [&output_file](const std::uint64_t offset, const void* const data, const std::size_t size)
+        {
+            static constexpr char padding[8u] {};
+            const auto position = static_cast<std::uint64_t>(output_file.tellp());
+            output_file.write(padding, static_cast<std::streamsize>(offset - position));
+            output_file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        };
+        output_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        write_section(header.codes_offset, codes.data(), codes.size() * sizeof(std::uint32_t));
+        write_section(header.coarse_offset, coarse.data(), coarse.size() * sizeof(std::uint32_t));
+        write_section(header.blocks_offset, blocks.data(), blocks.size() * sizeof(std::uint32_t));
+        write_section(header.candidates_offset, candidate_words.data(), candidate_words.size() * sizeof(std::uint32_t));
+        if (!output_file)
+        {
+            std::cerr << "Error: Failed writing grid file: " << output_grid_path_ << std::endl;
+            return false;
+        }
+
+        std::cout << "Grid written to: " << output_grid_path_ << " (" << block_count << " refined blocks of " << coarse_count
+                  << " coarse cells, " << candidate_cells.size() << " boundary cells)." << std::endl;
+        return true;
+    }
+
+    lookup_grid::lookup_grid(const std::string& grid_path) noexcept(false): file_ {grid_path}
+    {
+        if (file_.size() < sizeof(grid_header))
+            throw std::runtime_error("Lookup grid file is too small: " + grid_path);
+        std::memcpy(&header_, file_.data(), sizeof(header_));
+        if ((header_.magic != grid_header::magic_value) || (header_.version != grid_header::current_version))
+            throw std::runtime_error("Not a lookup grid file (or unsupported version): " + grid_path);
+
+        const auto section = [this, &grid_path](const std::uint64_t offset, const std::uint64_t count)
+        {
+            if (((offset % alignof(std::uint32_t)) != 0u) || (offset > file_.size()) ||
+                (count > ((file_.size() - offset) / sizeof(std::uint32_t))))
+                throw std::runtime_error("Lookup grid file is truncated or corrupt: " + grid_path);
+            return std::span<const std::uint32_t> {reinterpret_cast<const std::uint32_t*>(file_.data() + offset),
+                                                   static_cast<std::size_t>(count)};
+        };
+        const std::uint64_t block_cells {static_cast<std::uint64_t>(header_.refine_factor) * header_.refine_factor};
+        codes_ = section(header_.codes_offset, header_.feature_count);
+        coarse_ = section(header_.coarse_offset, static_cast<std::uint64_t>(header_.cols) * header_.rows);
+        blocks_ = section(header_.blocks_offset, header_.block_count * block_cells);
+        candidates_ = section(header_.candidates_offset, header_.candidates_size);
+    }
+
+    lookup_grid_cell lookup_grid::lookup(const double x, const double y) const noexcept
+    {
+        const double u {(x - header_.origin_x) / header_.cell_size};
+        const double v {(y - header_.origin_y) / header_.cell_size};
+        if (!(u >= 0.0) || !(v >= 0.0) || (u >= header_.cols) || (v >= header_.rows))
+            return {};
+
+        const auto cx = static_cast<std::uint32_t>(u);
+        const auto cy = static_cast<std::uint32_t>(v);
+        const std::uint32_t coarse_value {coarse_[static_cast<std::size_t>(cy) * header_.cols + cx]};
+        if ((coarse_value == grid_header::empty_cell) || ((coarse_value & grid_header::reference_flag) == 0u))
+            return {coarse_value};
+
+        const std::uint32_t factor {header_.refine_factor};
+        const std::uint32_t fx {std::min(factor - 1u, static_cast<std::uint32_t>((u - cx) * factor))};
+        const std::uint32_t fy {std::min(factor - 1u, static_cast<std::uint32_t>((v - cy) * factor))};
+        const std::size_t block {coarse_value & ~grid_header::reference_flag};
+        const std::uint32_t fine_value {blocks_[block * factor * factor + fy * factor + fx]};
+        if ((fine_value == grid_header::empty_cell) || ((fine_value & grid_header::reference_flag) == 0u))
+            return {fine_value};
+
+        const std::size_t list_offset {fine_value & ~grid_header::reference_flag};
+        return {grid_header::empty_cell, candidates_.subspan(list_offset + 1u, candidates_[list_offset])};
+    }
+
+    std::optional<std::uint32_t> lookup_grid::locate(const double x, const double y, const fgb_dataset& dataset,
+                                                     std::vector<ring_view>& scratch_rings) const noexcept(false)
+    {
+        const lookup_grid_cell cell {lookup(x, y)};
+        if (cell.candidates.empty())
+        {
+            if (cell.feature == grid_header::empty_cell)
+                return {};
+            return cell.feature;
+        }
+
+        for (const std::uint32_t feature: cell.candidates)
+        {
+            const FlatGeobuf::Geometry* const geometry {dataset.feature(feature)->geometry()};
+            geometry_processor::collect_rings(geometry, dataset.geometry_type_of(geometry), scratch_rings);
+            if (geometry_processor::contains_point(scratch_rings, x, y))
+                return feature;
+        }
+        return {};
+    }
+
+    point_locator::point_locator(const std::string& input_fgb_path, const std::string& grid_path, const std::string& points_csv_path,
+                                 const std::string& output_csv_path, const std::uint32_t num_threads) noexcept(false):
+        points_csv_path_ {points_csv_path},
+        output_csv_path_ {output_csv_path},
+        thread_pool_ {num_threads},
+        dataset_ {input_fgb_path},
+        grid_ {grid_path}
+    {
+        if (grid_.header().source_size != dataset_.file_bytes().size())
+            std::cerr << "Warning: The lookup grid was built from a different version of " << input_fgb_path << "." << std::endl;
+    }
+
+    bool point_locator::process_points() noexcept(false)
+    {
+        std::ifstream points_file {points_csv_path_};
+        if (!points_file.is_open())
+        {
+            std::cerr << "Error: Could not open points file: " << points_csv_path_ << std::endl;
+            return false;
+        }
+
+        struct point
+        {
+            double x {};
+            double y {};
+        };
+        std::vector<point> points {};
+        std::string line {};
+        while (std::getline(points_file, line))
+        {
+            const char* const begin {line.data()};
+            const char* const end {line.data() + line.size()};
+            point p {};
+            const auto x_result = std::from_chars(begin, end, p.x);
+            if ((x_result.ec != std::errc()) || (x_result.ptr == end) || (*x_result.ptr != ','))
+                continue;
+            const auto y_result = std::from_chars(x_result.ptr + 1, end, p.y);
+            if (y_result.ec != std::errc())
+                continue;
+            points.push_back(p);
+        }
+        std::cout << "Read " << points.size() << " points." << std::endl;
+
+        std::vector<std::uint32_t> assignments(points.size(), grid_header::empty_cell);
+        thread_pool_.parallel_for(points.size(), points_per_task_,
+                                  [&](const std::size_t begin, const std::size_t end)
+                                  {
+                                      std::vector<ring_view> rings {};
+                                      for (std::size_t i {begin}; i < end; ++i)
+                                          assignments[i] = grid_.locate(points[i].x, points[i].y, dataset_, rings)
+                                                               .value_or(grid_header::empty_cell);
+                                  });
+
+        std::ofstream output_file {output_csv_path_};
+        if (!output_file.is_open())
+        {
+            std::cerr << "Error: Could not open CSV file for writing: " << output_csv_path_ << std::endl;
+            return false;
+        }
+
+        std::uint64_t located {};
+        output_file << "x,y,feature_index,uat_code\n";
+        output_file.precision(3);
+        output_file << std::fixed;
+        for (std::size_t i {}; i < points.size(); ++i)
+        {
+            output_file << points[i].x << ',' << points[i].y << ',';
+            if (assignments[i] != grid_header::empty_cell)
+            {
+                output_file << assignments[i] << ',' << grid_.uat_code(assignments[i]);
+                ++located;
+            }
+            else
+                output_file << ',';
+            output_file << '\n';
+        }
+
+        std::cout << "Located " << located << " of " << points.size() << " points. Output written to: " << output_csv_path_ << std::endl;
+        return static_cast<bool>(output_file);
+    }
+
+} // namespace kmx::gis
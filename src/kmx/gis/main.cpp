@@ -1,13 +1,205 @@
 /// Copyright (c) 2025 - present KMX Systems. All rights reserved.
 /// @file main.cpp
+#include "kmx/gis/container_limits.hpp"
+#include "kmx/gis/duplicate_finder.hpp"
+#include "kmx/gis/fgb_augmenter.hpp"
+#include "kmx/gis/fgb_subset.hpp"
 #include "kmx/gis/flatgeobuf_processor.hpp"
+#include "kmx/gis/http_file_server.hpp"
+#include "kmx/gis/huge_pages.hpp"
+#include "kmx/gis/layer_diff.hpp"
+#include "kmx/gis/lookup_grid.hpp"
+#include "kmx/gis/part_merger.hpp"
+#include "kmx/gis/polygon_overlay.hpp"
+#include "kmx/gis/quadkey_covering.hpp"
+#include "kmx/gis/region_extract.hpp"
+#include "kmx/gis/spatial_partitioner.hpp"
+#include "kmx/gis/vector_tile_generator.hpp"
+#include "kmx/gis/zonal_statistics.hpp"
+#include <algorithm>
+#include <array>
 #include <iostream>
+#include <optional>
 #include <stdexcept>
 #include <string>
-#include <thread>
+#include <string_view>
+#include <vector>
 
 namespace kmx::gis
 {
+    /// @brief Command line options that consume the following argument as their value.
+    static constexpr std::array<std::string_view, 29u> options_with_value {
+        "-t",            "--threads",  "--mode",       "--cell-size",  "--refine",      "--points",     "--grid",       "--max-level",
+        "--max-cells",   "--min-zoom", "--max-zoom",   "--simplify",   "--raster",      "--zones",      "--zone-field", "--window",
+        "--where",       "--port",     "--cache-size", "--shard",      "--key",         "--checkpoint", "--huge-pages", "--sort-by",
+        "--sort-memory", "--shards",   "--previous",   "--max-memory", "--batch-kib"};
+
+    /// @brief Command line options without a value.
+    static constexpr std::array<std::string_view, 2u> flag_options {"--resume", "--tlb-stats"};
+
+    /// @brief Default connections per usable CPU of the file server, whose threads mostly wait on sockets and disks.
+    static constexpr std::uint32_t serve_threads_per_cpu {4u};
+
+    /// @brief Prints the CPUs the process may use and the thread count chosen from them.
+    /// @param cpus The CPU allowance of the process.
+    /// @param num_threads The worker thread count of the run.
+    /// @param is_default True if `num_threads` was derived from `cpus` rather than given with -t.
+    static void print_cpu_allowance(const cpu_allowance& cpus, const std::uint32_t num_threads, const bool is_default)
+    {
+        std::cout << "CPUs: " << cpus.online << " online, " << cpus.affinity << " in the affinity mask, ";
+        if (cpus.quota.has_value())
+            std::cout << "cgroup quota " << *cpus.quota;
+        else
+            std::cout << "no cgroup quota";
+        std::cout << " -> " << cpus.effective << " usable; " << num_threads << " worker threads"
+                  << (is_default ? " (default)." : " (-t).") << std::endl;
+    }
+
+    /// @brief Prints the huge page statistics when the run ends, however it returns.
+    struct huge_page_report
+    {
+        ~huge_page_report() noexcept
+        {
+            try
+            {
+                huge_pages::print_statistics();
+            }
+            catch (...)
+            {
+            }
+        }
+    };
+
+    /// @brief Checks whether a command line argument is an option that takes a value.
+    /// @param arg The argument to check.
+    /// @return True if `arg` is listed in `options_with_value`.
+    static bool is_option_with_value(const std::string_view arg)
+    {
+        return std::find(options_with_value.begin(), options_with_value.end(), arg) != options_with_value.end();
+    }
+
+    /// @brief Checks whether a flag option is given.
+    /// @param argc The argument count from main().
+    /// @param argv The argument vector from main().
+    /// @param name The option name, including its dashes.
+    /// @return True if the option occurs (not as the value of another option).
+    static bool has_flag(const int argc, const char* const argv[], const std::string_view name)
+    {
+        for (int i {1}; i < argc; ++i)
+            if (is_option_with_value(argv[i]))
+                ++i;
+            else if (argv[i] == name)
+                return true;
+        return false;
+    }
+
+    /// @brief Finds the value of a command line option given as "<name> <value>".
+    /// @param argc The argument count from main().
+    /// @param argv The argument vector from main().
+    /// @param name The option name, including its dashes.
+    /// @return The value following the last occurrence of the option, or `std::nullopt` if it is absent.
+    static std::optional<std::string> find_option_value(const int argc, const char* const argv[], const std::string_view name)
+    {
+        std::optional<std::string> value {};
+        for (int i {1}; (i + 1) < argc; ++i)
+            if (argv[i] == name)
+                value = argv[++i];
+        return value;
+    }
+
+    /// @brief Parses a positive floating point option, falling back to a default on absence or error.
+    /// @param argc The argument count from main().
+    /// @param argv The argument vector from main().
+    /// @param name The option name.
+    /// @param default_value The value to use if the option is not specified or invalid.
+    /// @return The parsed value or `default_value`.
+    static double parse_positive_double_option(const int argc, const char* const argv[], const std::string_view name,
+                                               const double default_value)
+    {
+        const std::optional<std::string> text {find_option_value(argc, argv, name)};
+        if (!text.has_value())
+            return default_value;
+        try
+        {
+            const double value {std::stod(*text)};
+            if (value > 0.0)
+                return value;
+        }
+        catch (const std::exception&)
+        {
+        }
+        std::cerr << "Warning: Invalid value for " << name << ": " << *text << ". Using default (" << default_value << ")." << std::endl;
+        return default_value;
+    }
+
+    /// @brief Parses a positive integer option, falling back to a default on absence or error.
+    /// @param argc The argument count from main().
+    /// @param argv The argument vector from main().
+    /// @param name The option name.
+    /// @param default_value The value to use if the option is not specified or invalid.
+    /// @param min_value The smallest accepted value (1 unless zero is meaningful for the option).
+    /// @return The parsed value or `default_value`.
+    static std::uint32_t parse_positive_uint_option(const int argc, const char* const argv[], const std::string_view name,
+                                                    const std::uint32_t default_value, const std::uint32_t min_value = 1u)
+    {
+        const std::optional<std::string> text {find_option_value(argc, argv, name)};
+        if (!text.has_value())
+            return default_value;
+        try
+        {
+            const unsigned long value {std::stoul(*text)};
+            if ((value >= min_value) && (value <= 0xFFFFFFFFu))
+                return static_cast<std::uint32_t>(value);
+        }
+        catch (const std::exception&)
+        {
+        }
+        std::cerr << "Warning: Invalid value for " << name << ": " << *text << ". Using default (" << default_value << ")." << std::endl;
+        return default_value;
+    }
+
+    /// @brief Parses a "min_x,min_y,max_x,max_y" window option.
+    /// @param argc The argument count from main().
+    /// @param argv The argument vector from main().
+    /// @param name The option name.
+    /// @return The window, or an invalid box if the option is absent or malformed (reported on `std::cerr`).
+    static bounding_box parse_window_option(const int argc, const char* const argv[], const std::string_view name)
+    {
+        bounding_box window {};
+        const std::optional<std::string> text {find_option_value(argc, argv, name)};
+        if (!text.has_value())
+            return window;
+
+        std::array<double, 4u> values {};
+        std::size_t start {};
+        for (std::size_t i {}; i < values.size(); ++i)
+        {
+            const std::size_t comma {(i + 1u < values.size()) ? text->find(',', start) : text->size()};
+            try
+            {
+                std::size_t parsed {};
+                if (comma != std::string::npos)
+                    values[i] = std::stod(text->substr(start, comma - start), &parsed);
+                if ((comma == std::string::npos) || (parsed != comma - start))
+                    throw std::invalid_argument {"window"};
+            }
+            catch (const std::exception&)
+            {
+                std::cerr << "Error: Invalid value for " << name << ": " << *text << ". Expected min_x,min_y,max_x,max_y." << std::endl;
+                return window;
+            }
+            start = comma + 1u;
+        }
+        if ((values[0] > values[2]) || (values[1] > values[3]))
+        {
+            std::cerr << "Error: Invalid value for " << name << ": " << *text << ". The minimum exceeds the maximum." << std::endl;
+            return window;
+        }
+        window.update(values[0], values[1]);
+        window.update(values[2], values[3]);
+        return window;
+    }
+
     /// @brief Parses command line arguments to find a user-specified thread count.
     /// Searches for "-t <count>" or "--threads <count>".
     /// @param argc The argument count from main().
@@ -41,76 +233,451 @@ namespace kmx::gis
         return default_threads;
     }
 
-    /// @brief Extracts positional command line arguments for input and output file paths.
-    /// This is a basic parser and assumes file paths do not conflict with known options like "-t".
-    /// More robust CLI parsing would typically involve a dedicated library.
+    /// @brief Collects the positional command line arguments, skipping options and their values.
     /// @param argc The original argument count.
     /// @param argv The original argument vector.
-    /// @param[out] input_path Reference to a string where the extracted input file path will be stored.
-    /// @param[out] output_path Reference to a string where the extracted output file path will be stored.
-    static void extract_positional_args(const int argc, const char* const argv[], std::string& input_path, std::string& output_path)
+    /// @return The positional arguments in command line order.
+    static std::vector<std::string> collect_positional_args(const int argc, const char* const argv[])
     {
+        std::vector<std::string> args {};
         for (int i {1}; i < argc; ++i)
         {
             const std::string arg_str {argv[i]};
-            if (arg_str == "-t" || arg_str == "--threads")
+            if (is_option_with_value(arg_str))
             {
                 i++;
                 if (i >= argc)
                     break;
             }
-            else if (input_path.empty())
-                input_path = arg_str;
-            else if (output_path.empty())
-                output_path = arg_str;
-            else
-                std::cerr << "Warning: Unknown or superfluous argument: " << arg_str << std::endl;
+            else if (std::find(flag_options.begin(), flag_options.end(), arg_str) == flag_options.end())
+                args.push_back(arg_str);
         }
+        return args;
+    }
+
+    /// @brief Extracts positional command line arguments for input and output file paths.
+    /// This is a basic parser and assumes file paths do not conflict with known options like "-t".
+    /// More robust CLI parsing would typically involve a dedicated library.
+    /// @param argc The original argument count.
+    /// @param argv The original argument vector.
+    /// @param[out] input_path Reference to a string where the extracted input file path will be stored.
+    /// @param[out] output_path Reference to a string where the extracted output file path will be stored.
+    static void extract_positional_args(const int argc, const char* const argv[], std::string& input_path, std::string& output_path)
+    {
+        const std::vector<std::string> args {collect_positional_args(argc, argv)};
+        for (std::size_t i {}; i < args.size(); ++i)
+            if (i == 0u)
+                input_path = args[i];
+            else if (i == 1u)
+                output_path = args[i];
+            else
+                std::cerr << "Warning: Unknown or superfluous argument: " << args[i] << std::endl;
+    }
+
+    /// @brief Prints the command line synopsis to standard error.
+    /// @param program_name The name the program was invoked with.
+    static void print_usage(const char* const program_name)
+    {
+        std::cerr << "Usage: " << program_name
+                  << " <input_polygon.fgb> <output> [--mode <mode>] [-t <num_threads> | --threads <num_threads>]" << std::endl;
+        std::cerr << "  <num_threads> is optional. Default is the usable CPUs - 1 (min 1u): the CPUs of the affinity mask, capped by"
+                  << std::endl;
+        std::cerr << "  the cgroup CPU quota (cpu.max or cpu.cfs_quota_us) rounded down. serve defaults to 4 connections per usable CPU."
+                  << std::endl;
+        std::cerr << "Modes:" << std::endl;
+        std::cerr << "  bbox    (default) Write the bounding box of every feature to the <output> CSV." << std::endl;
+        std::cerr << "          The input may also be an ESRI Shapefile (.shp with its .shx and .dbf), PostgreSQL COPY text with a hex"
+                  << std::endl;
+        std::cerr << "          WKB column (.hexwkb, .copy, .tsv), CSV with a WKT column (.csv) or concatenated binary WKB (.wkb)."
+                  << std::endl;
+        std::cerr << "          An http:// URL is read with range requests; [--window <min_x,min_y,max_x,max_y>] then fetches only"
+                  << std::endl;
+        std::cerr << "          the index nodes and features it needs (FlatGeobuf inputs; local files are then read with pread)."
+                  << std::endl;
+        std::cerr << "          [--cache-size <MiB>] budget of the block cache for these partial reads (default 64)." << std::endl;
+        std::cerr << "          [--shard <i>/<n>] processes only slice i (0 .. n-1) of n byte-balanced contiguous slices of a local"
+                  << std::endl;
+        std::cerr << "          FlatGeobuf or Shapefile input and writes <output>.manifest next to the partial output." << std::endl;
+        std::cerr << "          [--checkpoint <seconds>] saves the progress to <output>.checkpoint at this interval; [--resume]"
+                  << std::endl;
+        std::cerr << "          continues an interrupted run from it (checkpointing every 60 s unless --checkpoint is given)."
+                  << std::endl;
+        std::cerr << "          [--sort-by <field>[,<field>...]] sorts the rows by name, uat_code, county and/or area; beyond"
+                  << std::endl;
+        std::cerr << "          [--sort-memory <MiB>] (default 512) sorted runs are spilled next to the output and merged. Not with"
+                  << std::endl;
+        std::cerr << "          --shard, since merge --key cannot reproduce the name collation or a multi-field order." << std::endl;
+        std::cerr << "          [--max-memory <MiB>] budget of the run (default: 3/4 of the cgroup memory limit, if any); inputs"
+                  << std::endl;
+        std::cerr << "          larger than half of it are streamed (FlatGeobuf), and the peak per subsystem is reported." << std::endl;
+        std::cerr << "          The active workers and the batch volume are tuned in trials over the first 5% of the features and"
+                  << std::endl;
+        std::cerr << "          printed; -t fixes the workers and [--batch-kib <KiB>] the batch volume." << std::endl;
+        std::cerr << "  grid    Precompute a point lookup grid. <output> defaults to <input>.grid." << std::endl;
+        std::cerr << "          [--cell-size <units>] coarse cell size (default 2000), [--refine <k>] fine cells per axis (default 8)."
+                  << std::endl;
+        std::cerr << "  locate  Assign the points of --points <x,y csv> to features using --grid <file> (default <input>.grid)."
+                  << std::endl;
+        std::cerr << "  cover   Write the quadtree cell covering of every feature, sorted by cell id (CSV if <output> ends in .csv)."
+                  << std::endl;
+        std::cerr << "          [--max-level <n>] deepest level, at most 30 (default 16), [--max-cells <n>] cells per feature (default 64)."
+                  << std::endl;
+        std::cerr << "  tiles   Write Mapbox Vector Tiles to the <output> directory as <z>/<x>/<y>.pbf plus metadata.json." << std::endl;
+        std::cerr << "          [--min-zoom <z>] (default 0), [--max-zoom <z>] (default 14), [--simplify <tile units>] (default 1)."
+                  << std::endl;
+        std::cerr << "  zonal   Write count/sum/min/max/mean of the pixels of --raster <ENVI raw raster> covered by every feature."
+                  << std::endl;
+        std::cerr << "  extract Write the features intersecting --window <min_x,min_y,max_x,max_y>, clipped to it, to the <output> FGB."
+                  << std::endl;
+        std::cerr << "  subset  Copy the features matching --where <column>=<value>[,<value>...] and/or intersecting --window" << std::endl;
+        std::cerr << "          <min_x,min_y,max_x,max_y> verbatim to the <output> FGB, with a rebuilt index." << std::endl;
+        std::cerr << "  augment Rewrite the input to the <output> FGB with min_x, min_y, max_x, max_y and area Double columns"
+                  << std::endl;
+        std::cerr << "          appended to every feature (property blobs extended without re-encoding where possible)." << std::endl;
+        std::cerr << "  dedup   Find the features with identical geometries (any start vertex or winding) and write the" << std::endl;
+        std::cerr << "          deduplicated layer if <output> ends in .fgb, otherwise a CSV report of the duplicates." << std::endl;
+        std::cerr << "  diff    Compare the input with --previous <older version.fgb>, matching features by [--key <column>]"
+                  << std::endl;
+        std::cerr << "          (default natcode), and write the added, removed and changed ones with their bbox and area deltas."
+                  << std::endl;
+        std::cerr << "  partition" << std::endl;
+        std::cerr << "          Cut the layer into [--shards <n>] (default 16) Hilbert-range shards of equal byte size, written as"
+                  << std::endl;
+        std::cerr << "          indexed <output>/shard_<i>.fgb files, with their extents in <output>/manifest.csv." << std::endl;
+        std::cerr << "  overlay Write the intersection area of every feature with the polygons of --zones <polygon.fgb>." << std::endl;
+        std::cerr << "          [--zone-field <name>] zone property written as zone_id (default: zone feature index)." << std::endl;
+        std::cerr << "  serve   Serve the files of the <input> directory over HTTP/1.1 with range support on 127.0.0.1 (no <output>)."
+                  << std::endl;
+        std::cerr << "          [--port <n>] (default 8080), [--cache-size <MiB>] block cache budget (default 256). Meant for tests"
+                  << std::endl;
+        std::cerr << "          and benchmarks of the http:// inputs." << std::endl;
+        std::cerr << "  merge   <part> [<part>...] <output>: k-way merge of partial outputs. Without --key, the parts of a --shard run"
+                  << std::endl;
+        std::cerr << "          are concatenated in feature order using their manifests; with [--key <column>], CSV parts sorted by"
+                  << std::endl;
+        std::cerr << "          that column are merged into one sorted CSV. Binary covering tables are merged by cell id." << std::endl;
+        std::cerr << "Options:  [--huge-pages off|thp|hugetlb] backs the input mappings and large arrays with 2 MiB pages"
+                  << std::endl;
+        std::cerr << "          (transparent, or reserved hugetlbfs pages falling back to transparent ones); [--tlb-stats] prints"
+                  << std::endl;
+        std::cerr << "          the dTLB loads and misses of the run. Each run measures one mode: compare a run with --huge-pages off"
+                  << std::endl;
+        std::cerr << "          against one with thp or hugetlb on the same input, mode and -t." << std::endl;
     }
 
     /// @brief Main application logic, encapsulated within the `kmx::gis` namespace.
-    /// This function handles command line argument parsing, initializes the `flatgeobuf_processor`,
-    /// and executes the feature processing workflow.
+    /// This function handles command line argument parsing, initializes the processor for the selected mode,
+    /// and executes its workflow.
     /// @param argc The command line argument count passed from `::main`.
     /// @param argv The command line argument vector passed from `::main`.
     /// @return An integer exit code: 0 for success, non-zero for various error conditions.
     static int run_application(const int argc, const char* const argv[])
     {
-        if (argc < 3)
+        const char* const program_name {(argc > 0 && argv[0]) ? argv[0] : "fgb_bbox_extractor"};
+        if (argc < 2)
         {
-            std::cerr << "Usage: " << (argc > 0 && argv[0] ? argv[0] : "fgb_bbox_extractor")
-                      << " <input_polygon.fgb> <output.csv> [-t <num_threads> | --threads <num_threads>]" << std::endl;
-            std::cerr << "  <num_threads> is optional. Default is std::thread::hardware_concurrency() - 1 (min 1u)." << std::endl;
+            print_usage(program_name);
             return 1;
         }
 
         std::string input_fgb_path {};
-        std::string output_csv_path {};
+        std::string output_path {};
+        std::vector<std::string> part_paths {};
 
-        extract_positional_args(argc, argv, input_fgb_path, output_csv_path);
+        const std::string mode {find_option_value(argc, argv, "--mode").value_or("bbox")};
+        if (mode == "merge")
+        {
+            // Every positional argument but the last one is a part.
+            part_paths = collect_positional_args(argc, argv);
+            if (part_paths.size() >= 2u)
+            {
+                output_path = part_paths.back();
+                part_paths.pop_back();
+                input_fgb_path = part_paths.front();
+            }
+        }
+        else
+            extract_positional_args(argc, argv, input_fgb_path, output_path);
+        // The grid is written next to the input unless an explicit output is given.
+        if ((mode == "grid") && output_path.empty())
+            output_path = lookup_grid_builder::default_grid_path(input_fgb_path);
 
-        if (input_fgb_path.empty() || output_csv_path.empty())
+        // The file server takes only the directory to serve.
+        if (input_fgb_path.empty() || (output_path.empty() && (mode != "serve")))
         {
             std::cerr << "Error: Input and output file paths must be specified correctly." << std::endl;
-            std::cerr << "Usage: " << (argc > 0 && argv[0] ? argv[0] : "fgb_bbox_extractor")
-                      << " <input_polygon.fgb> <output.csv> [-t <num_threads> | --threads <num_threads>]" << std::endl;
+            print_usage(program_name);
             return 1;
         }
 
-        const std::uint32_t num_cores {std::thread::hardware_concurrency()};
-        std::uint32_t default_num_threads {(num_cores > 1u) ? (num_cores - 1u) : 1u};
-        if (num_cores == 0u)
+        // One usable CPU is left to the thread reading the input and writing the output.
+        const cpu_allowance cpus {container_limits::cpus()};
+        const std::uint32_t default_num_threads {(mode == "serve") ? (cpus.effective * serve_threads_per_cpu)
+                                                                   : std::max(cpus.effective, 2u) - 1u};
+
+        const std::uint32_t num_threads_to_use {parse_thread_count(argc, argv, default_num_threads)};
+        const bool threads_given {find_option_value(argc, argv, "-t").has_value() ||
+                                  find_option_value(argc, argv, "--threads").has_value()};
+        print_cpu_allowance(cpus, num_threads_to_use, !threads_given);
+
+        if (const std::optional<std::string> text {find_option_value(argc, argv, "--huge-pages")}; text.has_value())
         {
-            std::cerr << "Warning: std::thread::hardware_concurrency() returned 0. Defaulting to 1 thread." << std::endl;
-            default_num_threads = 1u;
+            const std::optional<huge_page_mode> huge_page {huge_pages::parse(*text)};
+            if (!huge_page.has_value())
+            {
+                std::cerr << "Error: Invalid value for --huge-pages: " << *text << ". Expected off, thp or hugetlb." << std::endl;
+                return 1;
+            }
+            huge_pages::set_mode(*huge_page);
         }
+        // Destroyed after the processors and their thread pools, so the counts include the worker threads.
+        std::optional<tlb_counters> tlb {};
+        if (has_flag(argc, argv, "--tlb-stats"))
+            tlb.emplace();
+        const huge_page_report report {};
 
-        const std::uint32_t num_threads_to_use {parse_thread_count(argc, argv, default_num_threads)};
+        if ((mode != "bbox") && find_option_value(argc, argv, "--shard").has_value())
+        {
+            std::cerr << "Error: --shard is only supported in bbox mode." << std::endl;
+            return 1;
+        }
+        if ((mode != "bbox") && find_option_value(argc, argv, "--max-memory").has_value())
+        {
+            std::cerr << "Error: --max-memory is only supported in bbox mode." << std::endl;
+            return 1;
+        }
+        if ((mode != "bbox") && find_option_value(argc, argv, "--batch-kib").has_value())
+        {
+            std::cerr << "Error: --batch-kib is only supported in bbox mode." << std::endl;
+            return 1;
+        }
+        const bool checkpoints {find_option_value(argc, argv, "--checkpoint").has_value() || has_flag(argc, argv, "--resume")};
+        if ((mode != "bbox") && checkpoints)
+        {
+            std::cerr << "Error: --checkpoint and --resume are only supported in bbox mode." << std::endl;
+            return 1;
+        }
+        const std::optional<std::string> sort_by {find_option_value(argc, argv, "--sort-by")};
+        // Sorted parts of a --shard run use the name collation and field order of the spec, which merge --key cannot reproduce.
+        const bool sharded {find_option_value(argc, argv, "--shard").has_value()};
+        if (sort_by.has_value() && ((mode != "bbox") || checkpoints || sharded))
+        {
+            std::cerr << "Error: --sort-by is only supported in bbox mode, without --checkpoint, --resume or --shard." << std::endl;
+            return 1;
+        }
 
         try
         {
-            flatgeobuf_processor processor {input_fgb_path, output_csv_path, num_threads_to_use};
-            return processor.process_features() ? 0 : 1;
+            if (mode == "bbox")
+            {
+                const bounding_box window {parse_window_option(argc, argv, "--window")};
+                if (!window.is_valid && find_option_value(argc, argv, "--window").has_value())
+                    return 1;
+                const std::uint64_t cache_mib {parse_positive_uint_option(argc, argv, "--cache-size", 64u)};
+                shard_spec shard {};
+                if (const std::optional<std::string> text {find_option_value(argc, argv, "--shard")}; text.has_value())
+                {
+                    const std::optional<shard_spec> parsed {shard_spec::parse(*text)};
+                    if (!parsed.has_value())
+                    {
+                        std::cerr << "Error: Invalid value for --shard: " << *text << ". Expected <i>/<n> with 0 <= i < n." << std::endl;
+                        return 1;
+                    }
+                    shard = *parsed;
+                }
+                checkpoint_settings checkpoint {};
+                checkpoint.resume = has_flag(argc, argv, "--resume");
+                checkpoint.interval_seconds = parse_positive_uint_option(
+                    argc, argv, "--checkpoint", checkpoint.resume ? checkpoint_settings::default_interval_seconds : 0u);
+                result_sort_spec sort {};
+                if (sort_by.has_value())
+                {
+                    const std::optional<result_sort_spec> parsed {result_sort_spec::parse(*sort_by)};
+                    if (!parsed.has_value())
+                    {
+                        std::cerr << "Error: Invalid value for --sort-by: " << *sort_by << ". Expected name, uat_code, county or area."
+                                  << std::endl;
+                        return 1;
+                    }
+                    sort = *parsed;
+                }
+                const std::uint64_t sort_mib {parse_positive_uint_option(argc, argv, "--sort-memory", 512u)};
+                const std::uint64_t max_memory_mib {parse_positive_uint_option(argc, argv, "--max-memory", 0u)};
+                // An explicit -t fixes the active workers; --batch-kib fixes the batch volume.
+                tuning_settings tuning {};
+                tuning.tune_workers = !threads_given;
+                tuning.batch_bytes = parse_positive_uint_option(argc, argv, "--batch-kib", 0u) * pipeline_tuner::kibibyte;
+                flatgeobuf_processor processor {input_fgb_path, output_path, num_threads_to_use, window, cache_mib * 1024u * 1024u,
+                                                shard, checkpoint, sort, sort_mib * 1024u * 1024u, max_memory_mib * 1024u * 1024u, tuning};
+                return processor.process_features() ? 0 : 1;
+            }
+
+            if (mode == "grid")
+            {
+                const lookup_grid_settings defaults {};
+                const lookup_grid_settings settings {parse_positive_double_option(argc, argv, "--cell-size", defaults.cell_size),
+                                                     parse_positive_uint_option(argc, argv, "--refine", defaults.refine_factor)};
+                lookup_grid_builder builder {input_fgb_path, output_path, num_threads_to_use, settings};
+                return builder.build() ? 0 : 1;
+            }
+
+            if (mode == "cover")
+            {
+                const quadkey_covering_settings defaults {};
+                const quadkey_covering_settings settings {parse_positive_uint_option(argc, argv, "--max-level", defaults.max_level),
+                                                          parse_positive_uint_option(argc, argv, "--max-cells", defaults.max_cells)};
+                quadkey_covering_builder builder {input_fgb_path, output_path, num_threads_to_use, settings};
+                return builder.build() ? 0 : 1;
+            }
+
+            if (mode == "tiles")
+            {
+                const vector_tile_settings defaults {};
+                vector_tile_settings settings {};
+                settings.min_zoom = parse_positive_uint_option(argc, argv, "--min-zoom", defaults.min_zoom, 0u);
+                settings.max_zoom = parse_positive_uint_option(argc, argv, "--max-zoom", defaults.max_zoom, 0u);
+                settings.simplify_tolerance = parse_positive_double_option(argc, argv, "--simplify", defaults.simplify_tolerance);
+                vector_tile_generator generator {input_fgb_path, output_path, num_threads_to_use, settings};
+                return generator.generate() ? 0 : 1;
+            }
+
+            if (mode == "zonal")
+            {
+                const std::optional<std::string> raster_path {find_option_value(argc, argv, "--raster")};
+                if (!raster_path.has_value())
+                {
+                    std::cerr << "Error: --mode zonal requires --raster <file>." << std::endl;
+                    return 1;
+                }
+                zonal_statistics statistics {input_fgb_path, *raster_path, output_path, num_threads_to_use};
+                return statistics.compute() ? 0 : 1;
+            }
+
+            if (mode == "extract")
+            {
+                const bounding_box window {parse_window_option(argc, argv, "--window")};
+                if (!window.is_valid)
+                {
+                    std::cerr << "Error: --mode extract requires --window <min_x,min_y,max_x,max_y>." << std::endl;
+                    return 1;
+                }
+                region_extract extractor {input_fgb_path, output_path, num_threads_to_use, window};
+                return extractor.extract() ? 0 : 1;
+            }
+
+            if (mode == "subset")
+            {
+                fgb_subset_filter filter {};
+                filter.window = parse_window_option(argc, argv, "--window");
+                if (!filter.window.is_valid && find_option_value(argc, argv, "--window").has_value())
+                    return 1;
+                if (const std::optional<std::string> where {find_option_value(argc, argv, "--where")}; where.has_value())
+                {
+                    const std::size_t equals {where->find('=')};
+                    if ((equals == 0u) || (equals == std::string::npos))
+                    {
+                        std::cerr << "Error: Invalid value for --where: " << *where << ". Expected <column>=<value>[,<value>...]."
+                                  << std::endl;
+                        return 1;
+                    }
+                    filter.column = where->substr(0u, equals);
+                    for (std::size_t start {equals + 1u}, comma {}; start <= where->size(); start = comma + 1u)
+                    {
+                        comma = std::min(where->find(',', start), where->size());
+                        filter.values.push_back(where->substr(start, comma - start));
+                    }
+                }
+                if (filter.column.empty() && !filter.window.is_valid)
+                {
+                    std::cerr << "Error: --mode subset requires --where <column>=<values> and/or --window <min_x,min_y,max_x,max_y>."
+                              << std::endl;
+                    return 1;
+                }
+                fgb_subset_writer writer {input_fgb_path, output_path, num_threads_to_use, std::move(filter)};
+                return writer.write() ? 0 : 1;
+            }
+
+            if (mode == "augment")
+            {
+                fgb_augmenter augmenter {input_fgb_path, output_path, num_threads_to_use};
+                return augmenter.augment() ? 0 : 1;
+            }
+
+            if (mode == "dedup")
+            {
+                duplicate_finder finder {input_fgb_path, output_path, num_threads_to_use};
+                return finder.find() ? 0 : 1;
+            }
+
+            if (mode == "diff")
+            {
+                const std::optional<std::string> previous_path {find_option_value(argc, argv, "--previous")};
+                if (!previous_path.has_value())
+                {
+                    std::cerr << "Error: --mode diff requires --previous <file>." << std::endl;
+                    return 1;
+                }
+                layer_diff differ {input_fgb_path, *previous_path, output_path, num_threads_to_use,
+                                   find_option_value(argc, argv, "--key").value_or(std::string {layer_diff::default_key_column})};
+                return differ.diff() ? 0 : 1;
+            }
+
+            if (mode == "partition")
+            {
+                const std::uint32_t shards {parse_positive_uint_option(argc, argv, "--shards", spatial_partitioner::default_shard_count)};
+                spatial_partitioner partitioner {input_fgb_path, output_path, num_threads_to_use, shards};
+                return partitioner.partition() ? 0 : 1;
+            }
+
+            if (mode == "overlay")
+            {
+                const std::optional<std::string> zones_path {find_option_value(argc, argv, "--zones")};
+                if (!zones_path.has_value())
+                {
+                    std::cerr << "Error: --mode overlay requires --zones <file>." << std::endl;
+                    return 1;
+                }
+                polygon_overlay overlay {input_fgb_path, *zones_path, output_path, num_threads_to_use,
+                                         find_option_value(argc, argv, "--zone-field").value_or("")};
+                return overlay.process() ? 0 : 1;
+            }
+
+            if (mode == "serve")
+            {
+                const std::uint32_t port {parse_positive_uint_option(argc, argv, "--port", 8080u)};
+                if (port > 65535u)
+                {
+                    std::cerr << "Error: Invalid value for --port: " << port << "." << std::endl;
+                    return 1;
+                }
+                const std::uint64_t cache_mib {parse_positive_uint_option(argc, argv, "--cache-size", 256u)};
+                http_file_server server {input_fgb_path, static_cast<std::uint16_t>(port), num_threads_to_use, cache_mib * 1024u * 1024u};
+                return server.serve() ? 0 : 1;
+            }
+
+            if (mode == "merge")
+            {
+                part_merger merger {std::move(part_paths), output_path, find_option_value(argc, argv, "--key").value_or("")};
+                return merger.merge() ? 0 : 1;
+            }
+
+            if (mode == "locate")
+            {
+                const std::optional<std::string> points_path {find_option_value(argc, argv, "--points")};
+                if (!points_path.has_value())
+                {
+                    std::cerr << "Error: --mode locate requires --points <file>." << std::endl;
+                    return 1;
+                }
+                const std::string grid_path {
+                    find_option_value(argc, argv, "--grid").value_or(lookup_grid_builder::default_grid_path(input_fgb_path))};
+                point_locator locator {input_fgb_path, grid_path, *points_path, output_path, num_threads_to_use};
+                return locator.process_points() ? 0 : 1;
+            }
+
+            std::cerr << "Error: Unknown mode '" << mode << "'." << std::endl;
+            print_usage(program_name);
+            return 1;
         }
         catch (const std::exception& e)
         {
@@ -0,0 +1,110 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file mapped_file.cpp
+#include "kmx/gis/mapped_file.hpp"
+#include "kmx/gis/huge_pages.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace kmx::gis
+{
+    mapped_file::mapped_file(const std::string& file_path) noexcept(false): path_ {file_path}
+    {
+        const int fd {::open(file_path.c_str(), O_RDONLY | O_CLOEXEC)};
+        if (fd < 0)
+            throw std::runtime_error("Cannot open file: " + file_path + " (" + std::strerror(errno) + ")");
+
+        struct stat file_stat {};
+        if (::fstat(fd, &file_stat) != 0)
+        {
+            const int error {errno};
+            ::close(fd);
+            throw std::runtime_error("Cannot stat file: " + file_path + " (" + std::strerror(error) + ")");
+        }
+
+        size_ = static_cast<std::size_t>(file_stat.st_size);
+        // An empty file cannot be mapped; it is represented by a null data pointer.
+        if (size_ == 0u)
+        {
+            ::close(fd);
+            return;
+        }
+
+        if ((huge_pages::mode() == huge_page_mode::hugetlb) && (size_ >= huge_pages::min_size) && load_into_huge_pages(fd))
+        {
+            ::close(fd);
+            return;
+        }
+
+        void* const mapping {::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0)};
+        const int map_error {errno};
+        ::close(fd); // The mapping keeps its own reference to the file.
+        if (mapping == MAP_FAILED)
+            throw std::runtime_error("Cannot map file: " + file_path + " (" + std::strerror(map_error) + ")");
+
+        data_ = static_cast<const std::uint8_t*>(mapping);
+        huge_pages::advise(mapping, size_);
+    }
+
+    mapped_file::~mapped_file() noexcept
+    {
+        if (anonymous_)
+            huge_pages::unmap_anonymous(const_cast<std::uint8_t*>(data_), size_);
+        else if (data_ != nullptr)
+            ::munmap(const_cast<std::uint8_t*>(data_), size_);
+    }
+
+    void mapped_file::advise_sequential() const noexcept
+    {
+        if (!anonymous_ && (data_ != nullptr))
+            ::madvise(const_cast<std::uint8_t*>(data_), size_, MADV_SEQUENTIAL);
+    }
+
+    // Page-out drops the page cache pages too (they count against a cgroup limit); older kernels only unmap them.
+    void mapped_file::release(const std::size_t offset, const std::size_t length) const noexcept
+    {
+        if (anonymous_ || (data_ == nullptr) || (offset >= size_))
+            return;
+        static const std::size_t page_size {static_cast<std::size_t>(::sysconf(_SC_PAGESIZE))};
+        const std::size_t begin {offset / page_size * page_size};
+        const std::size_t end {std::min(offset + length, size_) / page_size * page_size};
+        if (end <= begin)
+            return;
+        void* const address {const_cast<std::uint8_t*>(data_) + begin};
+#if defined(MADV_PAGEOUT)
+        if (::madvise(address, end - begin, MADV_PAGEOUT) == 0)
+            return;
+#endif
+        ::madvise(address, end - begin, MADV_DONTNEED);
+    }
+
+    // Reads the whole file with large `pread`s into anonymous memory backed by huge pages.
+    bool mapped_file::load_into_huge_pages(const int fd) noexcept
+    {
+        std::uint8_t* const memory {static_cast<std::uint8_t*>(huge_pages::map_anonymous(size_))};
+        if (memory == nullptr)
+            return false;
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        for (std::size_t done {}; done < size_;)
+        {
+            const ::ssize_t count {::pread(fd, memory + done, size_ - done, static_cast<::off_t>(done))};
+            if ((count < 0) && (errno == EINTR))
+                continue;
+            if (count <= 0)
+            {
+                huge_pages::unmap_anonymous(memory, size_);
+                return false;
+            }
+            done += static_cast<std::size_t>(count);
+        }
+        data_ = memory;
+        anonymous_ = true;
+        return true;
+    }
+
+} // namespace kmx::gis
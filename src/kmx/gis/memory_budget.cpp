@@ -0,0 +1,67 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file memory_budget.cpp
+#include "kmx/gis/memory_budget.hpp"
+#include "kmx/gis/container_limits.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace kmx::gis
+{
+    memory_budget::memory_budget(const std::uint64_t max_memory_bytes) noexcept(false)
+    {
+        if (max_memory_bytes > 0u)
+        {
+            limit_ = max_memory_bytes;
+            limit_source_ = "--max-memory";
+        }
+        if (const std::optional<std::uint64_t> cgroup {container_limits::memory_limit()}; cgroup.has_value())
+        {
+            const std::uint64_t usable {static_cast<std::uint64_t>(static_cast<double>(*cgroup) * cgroup_share)};
+            if (!limit_.has_value() || (usable < *limit_))
+            {
+                limit_ = usable;
+                limit_source_ = "cgroup memory limit";
+            }
+        }
+    }
+
+    std::uint64_t memory_budget::share(const double fraction, const std::uint64_t unlimited) const noexcept
+    {
+        return limit_.has_value() ? static_cast<std::uint64_t>(static_cast<double>(*limit_) * fraction) : unlimited;
+    }
+
+    void memory_budget::set(const memory_subsystem subsystem, const std::uint64_t bytes) noexcept
+    {
+        const std::size_t i {index_of(subsystem)};
+        current_[i] = bytes;
+        peak_[i] = std::max(peak_[i], bytes);
+    }
+
+    void memory_budget::remove(const memory_subsystem subsystem, const std::uint64_t bytes) noexcept
+    {
+        set(subsystem, current(subsystem) - std::min(current(subsystem), bytes));
+    }
+
+    void memory_budget::print_report() const noexcept(false)
+    {
+        const auto mib = [](const std::uint64_t bytes) { return static_cast<double>(bytes) / static_cast<double>(mebibyte); };
+        const std::ios_base::fmtflags original_flags {std::cout.flags()};
+        const std::streamsize original_precision {std::cout.precision()};
+        std::cout << std::fixed;
+        std::cout.precision(1);
+        std::cout << "Peak memory by subsystem (MiB):";
+        std::uint64_t total {};
+        for (std::size_t i {}; i < subsystem_count_; ++i)
+        {
+            std::cout << ' ' << subsystem_names_[i] << ' ' << mib(peak_[i]) << ((i + 1u < subsystem_count_) ? "," : "");
+            total += peak_[i];
+        }
+        std::cout << "; sum of peaks " << mib(total);
+        if (limit_.has_value())
+            std::cout << " of a " << mib(*limit_) << " MiB budget (" << limit_source_ << ")";
+        std::cout << '.' << std::endl;
+        std::cout.flags(original_flags);
+        std::cout.precision(original_precision);
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,204 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file mvt_encoder.cpp
+#include "kmx/gis/mvt_encoder.hpp"
+#include <bit>
+#include <utility>
+
+namespace kmx::gis
+{
+    // Field numbers of the vector tile schema (vector_tile.proto, version 2.1).
+    static constexpr std::uint32_t tile_layers_field {3u};
+    static constexpr std::uint32_t layer_name_field {1u};
+    static constexpr std::uint32_t layer_features_field {2u};
+    static constexpr std::uint32_t layer_keys_field {3u};
+    static constexpr std::uint32_t layer_values_field {4u};
+    static constexpr std::uint32_t layer_extent_field {5u};
+    static constexpr std::uint32_t layer_version_field {15u};
+    static constexpr std::uint32_t layer_version {2u};
+    static constexpr std::uint32_t feature_id_field {1u};
+    static constexpr std::uint32_t feature_tags_field {2u};
+    static constexpr std::uint32_t feature_type_field {3u};
+    static constexpr std::uint32_t feature_geometry_field {4u};
+    static constexpr std::uint32_t value_string_field {1u};
+    static constexpr std::uint32_t value_double_field {3u};
+    static constexpr std::uint32_t value_int_field {4u};
+    static constexpr std::uint32_t value_uint_field {5u};
+    static constexpr std::uint32_t value_bool_field {7u};
+
+    void protobuf_writer::write_varint(std::uint64_t value) noexcept(false)
+    {
+        while (value >= 0x80u)
+        {
+            buffer_.push_back(static_cast<char>((value & 0x7Fu) | 0x80u));
+            value >>= 7u;
+        }
+        buffer_.push_back(static_cast<char>(value));
+    }
+
+    void protobuf_writer::write_key(const std::uint32_t field, const wire_type type) noexcept(false)
+    {
+        write_varint((static_cast<std::uint64_t>(field) << 3u) | static_cast<std::uint32_t>(type));
+    }
+
+    void protobuf_writer::write_uint_field(const std::uint32_t field, const std::uint64_t value) noexcept(false)
+    {
+        write_key(field, wire_type::varint);
+        write_varint(value);
+    }
+
+    void protobuf_writer::write_sint_field(const std::uint32_t field, const std::int64_t value) noexcept(false)
+    {
+        write_key(field, wire_type::varint);
+        write_varint(zigzag(value));
+    }
+
+    void protobuf_writer::write_double_field(const std::uint32_t field, const double value) noexcept(false)
+    {
+        write_key(field, wire_type::fixed64);
+        auto bits = std::bit_cast<std::uint64_t>(value);
+        for (int i {}; i < 8; ++i, bits >>= 8u)
+            buffer_.push_back(static_cast<char>(bits & 0xFFu));
+    }
+
+    void protobuf_writer::write_bytes_field(const std::uint32_t field, const std::string_view bytes) noexcept(false)
+    {
+        write_key(field, wire_type::length_delimited);
+        write_varint(bytes.size());
+        buffer_.append(bytes);
+    }
+
+    void protobuf_writer::write_raw(const std::string_view bytes) noexcept(false)
+    {
+        buffer_.append(bytes);
+    }
+
+    void protobuf_writer::write_packed_field(const std::uint32_t field, const std::span<const std::uint32_t> values) noexcept(false)
+    {
+        std::size_t size {};
+        for (std::uint32_t value: values)
+            for (size += 1u; value >= 0x80u; value >>= 7u)
+                ++size;
+        write_key(field, wire_type::length_delimited);
+        write_varint(size);
+        for (const std::uint32_t value: values)
+            write_varint(value);
+    }
+
+    mvt_layer_builder::mvt_layer_builder(std::string name, const std::uint32_t extent) noexcept:
+        name_ {std::move(name)},
+        extent_ {extent}
+    {
+    }
+
+    std::uint32_t mvt_layer_builder::key_index(const std::string_view key) noexcept(false)
+    {
+        const auto [it, inserted] = key_map_.try_emplace(std::string {key}, static_cast<std::uint32_t>(keys_.size()));
+        if (inserted)
+            keys_.emplace_back(key);
+        return it->second;
+    }
+
+    std::uint32_t mvt_layer_builder::value_index(const protobuf_writer& encoded_value) noexcept(false)
+    {
+        const auto [it, inserted] = value_map_.try_emplace(encoded_value.data(), static_cast<std::uint32_t>(values_.size()));
+        if (inserted)
+            values_.push_back(encoded_value.data());
+        return it->second;
+    }
+
+    std::uint32_t mvt_layer_builder::string_value_index(const std::string_view value) noexcept(false)
+    {
+        scratch_.clear();
+        scratch_.write_bytes_field(value_string_field, value);
+        return value_index(scratch_);
+    }
+
+    std::uint32_t mvt_layer_builder::double_value_index(const double value) noexcept(false)
+    {
+        scratch_.clear();
+        scratch_.write_double_field(value_double_field, value);
+        return value_index(scratch_);
+    }
+
+    std::uint32_t mvt_layer_builder::int_value_index(const std::int64_t value) noexcept(false)
+    {
+        scratch_.clear();
+        scratch_.write_uint_field(value_int_field, static_cast<std::uint64_t>(value));
+        return value_index(scratch_);
+    }
+
+    std::uint32_t mvt_layer_builder::uint_value_index(const std::uint64_t value) noexcept(false)
+    {
+        scratch_.clear();
+        scratch_.write_uint_field(value_uint_field, value);
+        return value_index(scratch_);
+    }
+
+    std::uint32_t mvt_layer_builder::bool_value_index(const bool value) noexcept(false)
+    {
+        scratch_.clear();
+        scratch_.write_uint_field(value_bool_field, value ? 1u : 0u);
+        return value_index(scratch_);
+    }
+
+    void mvt_layer_builder::encode_ring(const std::span<const tile_point> ring, tile_point& cursor,
+                                        std::vector<std::uint32_t>& out_geometry) noexcept(false)
+    {
+        const auto command = [](const std::uint32_t id, const std::size_t count)
+        { return (id & 0x7u) | (static_cast<std::uint32_t>(count) << 3u); };
+        const auto append_delta = [&](const tile_point& p)
+        {
+            out_geometry.push_back(static_cast<std::uint32_t>(protobuf_writer::zigzag(std::int64_t {p.x} - cursor.x)));
+            out_geometry.push_back(static_cast<std::uint32_t>(protobuf_writer::zigzag(std::int64_t {p.y} - cursor.y)));
+            cursor = p;
+        };
+
+        out_geometry.push_back(command(command_move_to, 1u));
+        append_delta(ring.front());
+        out_geometry.push_back(command(command_line_to, ring.size() - 1u));
+        for (std::size_t i {1u}; i < ring.size(); ++i)
+            append_delta(ring[i]);
+        out_geometry.push_back(command(command_close_path, 1u));
+    }
+
+    void mvt_layer_builder::add_polygon(const std::uint64_t id, const std::span<const std::uint32_t> tags,
+                                        const std::span<const std::uint32_t> geometry) noexcept(false)
+    {
+        scratch_.clear();
+        scratch_.write_uint_field(feature_id_field, id);
+        if (!tags.empty())
+            scratch_.write_packed_field(feature_tags_field, tags);
+        scratch_.write_uint_field(feature_type_field, geometry_type_polygon);
+        scratch_.write_packed_field(feature_geometry_field, geometry);
+        features_.write_bytes_field(layer_features_field, scratch_.data());
+        ++feature_count_;
+    }
+
+    void mvt_layer_builder::write_tile(std::string& out_tile) noexcept(false)
+    {
+        protobuf_writer layer {};
+        layer.write_uint_field(layer_version_field, layer_version);
+        layer.write_bytes_field(layer_name_field, name_);
+        layer.write_raw(features_.data());
+        for (const std::string& key: keys_)
+            layer.write_bytes_field(layer_keys_field, key);
+        for (const std::string& value: values_)
+            layer.write_bytes_field(layer_values_field, value);
+        layer.write_uint_field(layer_extent_field, extent_);
+
+        protobuf_writer tile {};
+        tile.write_bytes_field(tile_layers_field, layer.data());
+        out_tile = tile.data();
+    }
+
+    void mvt_layer_builder::clear() noexcept
+    {
+        features_.clear();
+        feature_count_ = 0u;
+        keys_.clear();
+        key_map_.clear();
+        values_.clear();
+        value_map_.clear();
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,369 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file part_merger.cpp
+#include "kmx/gis/part_merger.hpp"
+#include "kmx/gis/buffered_file.hpp"
+#include "kmx/gis/csv_format.hpp"
+#include "kmx/gis/quadkey_covering.hpp"
+#include "kmx/gis/shard_plan.hpp"
+#include "kmx/gis/tournament_tree.hpp"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+namespace kmx::gis
+{
+    /// @brief The key of a CSV record: a number if the whole field parses as one, its text otherwise.
+    struct merge_key
+    {
+        bool numeric {};        /// True if `number` holds the value.
+        double number {};       /// Numeric value.
+        std::string_view text;  /// Field text (without enclosing quotes).
+
+        /// @brief Numbers before text, numbers by value, text bytewise.
+        bool operator<(const merge_key& other) const noexcept
+        {
+            if (numeric != other.numeric)
+                return numeric;
+            return numeric ? (number < other.number) : (text < other.text);
+        }
+    };
+
+    // Field `column` of a CSV record, without its enclosing quotes (doubled quotes are kept).
+    static std::optional<std::string_view> csv_field(const std::string_view line, const std::size_t column) noexcept
+    {
+        std::size_t start {};
+        for (std::size_t c {};; ++c)
+        {
+            std::size_t end {start};
+            const bool quoted {(start < line.size()) && (line[start] == '"')};
+            if (quoted)
+                for (++end; end < line.size(); ++end)
+                    if (line[end] == '"')
+                    {
+                        if (((end + 1u) < line.size()) && (line[end + 1u] == '"'))
+                            ++end;
+                        else
+                            break;
+                    }
+            end = std::min(line.find(csv_format::delimiter, end), line.size());
+            if (c == column)
+            {
+                std::string_view field {line.substr(start, end - start)};
+                if (quoted && (field.size() >= 2u) && (field.back() == '"'))
+                    field = field.substr(1u, field.size() - 2u);
+                return field;
+            }
+            if (end == line.size())
+                return std::nullopt;
+            start = end + 1u;
+        }
+    }
+
+    // The key of a field.
+    static merge_key make_key(const std::string_view field) noexcept
+    {
+        merge_key key {};
+        key.text = field;
+        const auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), key.number);
+        key.numeric = !field.empty() && (error == std::errc {}) && (end == field.data() + field.size()) && !std::isnan(key.number);
+        return key;
+    }
+
+    part_merger::part_merger(std::vector<std::string> part_paths, const std::string& output_path, const std::string& key_column) noexcept(
+        false):
+        part_paths_ {std::move(part_paths)},
+        output_path_ {output_path},
+        key_column_ {key_column}
+    {
+    }
+
+    // Read buffer size per part, so that all buffers together stay within the budget.
+    std::size_t part_merger::buffer_size() const noexcept
+    {
+        return std::clamp(memory_budget_ / (part_paths_.size() + 1u), min_buffer_size_, max_buffer_size_);
+    }
+
+    bool part_merger::merge() noexcept(false)
+    {
+        if (part_paths_.empty())
+        {
+            std::cerr << "Error: No parts to merge." << std::endl;
+            return false;
+        }
+        if (std::find(part_paths_.begin(), part_paths_.end(), output_path_) != part_paths_.end())
+        {
+            std::cerr << "Error: The output " << output_path_ << " is also one of the parts." << std::endl;
+            return false;
+        }
+
+        const std::array<char, 8u>& magic {quadkey_cover_file_header::magic_value};
+        const bool cover_tables {buffered_file_reader {part_paths_.front(), min_buffer_size_}.peek(magic.size()) ==
+                                 std::string_view {magic.data(), magic.size()}};
+        std::cout << "Merging " << part_paths_.size() << " parts into " << output_path_ << " with " << (buffer_size() / 1024u)
+                  << " KiB buffers." << std::endl;
+        if (cover_tables)
+        {
+            if (!key_column_.empty())
+                std::cout << "Warning: Covering tables are always merged by cell id; --key is ignored." << std::endl;
+            return merge_cover_tables();
+        }
+        return key_column_.empty() ? concatenate_in_manifest_order() : merge_csv_by_key();
+    }
+
+    // Orders the parts by their manifests and concatenates them.
+    bool part_merger::concatenate_in_manifest_order() noexcept(false)
+    {
+        std::vector<std::pair<shard_manifest, std::string>> parts {};
+        for (const std::string& path: part_paths_)
+            parts.emplace_back(shard_manifest::read(shard_manifest::path_for(path)), path);
+        std::sort(parts.begin(), parts.end(),
+                  [](const auto& a, const auto& b) { return a.first.shard.index < b.first.shard.index; });
+
+        // All shards of the same input must be present exactly once, and their ranges must follow each other.
+        const shard_manifest& first {parts.front().first};
+        std::vector<bool> seen(first.shard.count);
+        for (std::size_t i {}; i < parts.size(); ++i)
+        {
+            const shard_manifest& manifest {parts[i].first};
+            if ((manifest.input_size != first.input_size) || (manifest.shard.count != first.shard.count))
+            {
+                std::cerr << "Error: " << parts[i].second << " comes from a different input or shard count than "
+                          << parts.front().second << "." << std::endl;
+                return false;
+            }
+            if (manifest.input != first.input)
+                std::cout << "Warning: " << parts[i].second << " names its input " << manifest.input << " instead of " << first.input
+                          << "; the sizes match." << std::endl;
+            if (seen[manifest.shard.index])
+            {
+                std::cerr << "Error: Shard " << manifest.shard.index << " is given twice." << std::endl;
+                return false;
+            }
+            seen[manifest.shard.index] = true;
+            if ((i > 0u) && (manifest.range.first_feature != parts[i - 1u].first.range.end_feature))
+            {
+                std::cerr << "Error: The feature ranges of " << parts[i - 1u].second << " and " << parts[i].second << " do not adjoin."
+                          << std::endl;
+                return false;
+            }
+        }
+        if (const auto missing = std::find(seen.begin(), seen.end(), false); missing != seen.end())
+        {
+            std::cerr << "Error: Shard " << (missing - seen.begin()) << '/' << first.shard.count << " is missing." << std::endl;
+            return false;
+        }
+
+        buffered_file_writer output {output_path_, buffer_size()};
+        std::string header {};
+        for (std::size_t i {}; i < parts.size(); ++i)
+        {
+            buffered_file_reader reader {parts[i].second, buffer_size()};
+            std::string_view line {};
+            if (!reader.next_line(line))
+                continue;
+            if (i == 0u)
+            {
+                header = line;
+                output.write(header);
+                output.write("\n");
+            }
+            else if (line != header)
+            {
+                std::cerr << "Error: The header of " << parts[i].second << " differs from the one of " << parts.front().second << "."
+                          << std::endl;
+                return false;
+            }
+            for (std::string_view bytes {reader.take_buffered()}; !bytes.empty(); bytes = reader.take_buffered())
+                output.write(bytes);
+        }
+        output.close();
+        std::cout << "Concatenated " << parts.size() << " shards in feature order (" << output.size() << " bytes)." << std::endl;
+        std::cout << "Output written to: " << output_path_ << std::endl;
+        return true;
+    }
+
+    // Merges CSV parts sorted by the key column.
+    bool part_merger::merge_csv_by_key() noexcept(false)
+    {
+        /// @brief The head record of one part.
+        struct cursor
+        {
+            std::unique_ptr<buffered_file_reader> reader {};
+            std::string_view line {};
+            merge_key key {};
+            std::uint64_t line_number {};
+            bool done {};
+        };
+
+        std::vector<cursor> cursors(part_paths_.size());
+        std::string header {};
+        std::optional<std::size_t> key_index {};
+        for (std::size_t i {}; i < cursors.size(); ++i)
+        {
+            cursors[i].reader = std::make_unique<buffered_file_reader>(part_paths_[i], buffer_size());
+            std::string_view line {};
+            cursors[i].done = !cursors[i].reader->next_line(line);
+            if (cursors[i].done)
+                continue;
+            cursors[i].line_number = 1u;
+            if (!key_index.has_value())
+            {
+                header = line;
+                for (std::size_t c {}; const std::optional<std::string_view> name {csv_field(header, c)}; ++c)
+                    if (*name == key_column_)
+                    {
+                        key_index = c;
+                        break;
+                    }
+                if (!key_index.has_value())
+                {
+                    std::cerr << "Error: " << part_paths_[i] << " has no column '" << key_column_ << "'." << std::endl;
+                    return false;
+                }
+            }
+            else if (line != header)
+            {
+                std::cerr << "Error: The header of " << part_paths_[i] << " differs from the one of the first part." << std::endl;
+                return false;
+            }
+        }
+
+        // Advances a part to its next record.
+        const auto advance = [&](cursor& part)
+        {
+            if (part.done || !part.reader->next_line(part.line))
+            {
+                part.done = true;
+                return;
+            }
+            ++part.line_number;
+            part.key = make_key(csv_field(part.line, *key_index).value_or(std::string_view {}));
+        };
+        for (cursor& part: cursors)
+            advance(part);
+
+        buffered_file_writer output {output_path_, buffer_size()};
+        if (key_index.has_value())
+        {
+            output.write(header);
+            output.write("\n");
+        }
+
+        const auto less = [&](const std::size_t a, const std::size_t b)
+        { return !cursors[a].done && (cursors[b].done || (cursors[a].key < cursors[b].key)); };
+        tournament_tree<decltype(less)> tree {cursors.size(), less};
+
+        // The last written key, to detect parts that are not sorted.
+        bool has_last {};
+        bool last_numeric {};
+        double last_number {};
+        std::string last_text {};
+        std::uint64_t rows {};
+        for (std::size_t winner {tree.winner()}; !cursors[winner].done; winner = tree.winner())
+        {
+            cursor& part {cursors[winner]};
+            const merge_key last {last_numeric, last_number, last_text};
+            if (has_last && (part.key < last))
+            {
+                std::cerr << "\nError: " << part_paths_[winner] << " is not sorted by '" << key_column_ << "' (line " << part.line_number
+                          << ")." << std::endl;
+                return false;
+            }
+            has_last = true;
+            last_numeric = part.key.numeric;
+            last_number = part.key.number;
+            last_text.assign(part.key.text);
+
+            output.write(part.line);
+            output.write("\n");
+            if ((++rows % progress_report_interval_) == 0u)
+                std::cout << "Merged " << rows << " rows...\r" << std::flush;
+            advance(part);
+            tree.replay(winner);
+        }
+        output.close();
+        std::cout << "\nMerged " << rows << " rows by '" << key_column_ << "' (" << output.size() << " bytes)." << std::endl;
+        std::cout << "Output written to: " << output_path_ << std::endl;
+        return true;
+    }
+
+    // Merges binary covering tables by cell id and feature.
+    bool part_merger::merge_cover_tables() noexcept(false)
+    {
+        /// @brief The head entry of one table.
+        struct cursor
+        {
+            std::unique_ptr<buffered_file_reader> reader {};
+            quadkey_cover_entry entry {};
+            std::uint64_t remaining {};
+            bool done {};
+        };
+
+        const auto as_bytes = [](auto& value) { return std::span<std::uint8_t> {reinterpret_cast<std::uint8_t*>(&value), sizeof(value)}; };
+        std::vector<cursor> cursors(part_paths_.size());
+        quadkey_cover_file_header header {};
+        for (std::size_t i {}; i < cursors.size(); ++i)
+        {
+            cursors[i].reader = std::make_unique<buffered_file_reader>(part_paths_[i], buffer_size());
+            quadkey_cover_file_header part_header {};
+            if (!cursors[i].reader->read_exact(as_bytes(part_header)) || (part_header.magic != quadkey_cover_file_header::magic_value) ||
+                (part_header.version != quadkey_cover_file_header::current_version))
+            {
+                std::cerr << "Error: " << part_paths_[i] << " is not a covering table of version "
+                          << quadkey_cover_file_header::current_version << "." << std::endl;
+                return false;
+            }
+            if ((i > 0u) && ((part_header.max_level != header.max_level) || (part_header.root_origin_x != header.root_origin_x) ||
+                             (part_header.root_origin_y != header.root_origin_y) || (part_header.root_size != header.root_size)))
+            {
+                std::cerr << "Error: " << part_paths_[i] << " uses a different root domain or max level than " << part_paths_.front()
+                          << "." << std::endl;
+                return false;
+            }
+            const std::uint64_t entry_count {part_header.entry_count + ((i > 0u) ? header.entry_count : 0u)};
+            header = part_header;
+            header.entry_count = entry_count;
+            cursors[i].remaining = part_header.entry_count;
+        }
+
+        const auto advance = [&](cursor& part)
+        {
+            part.done = part.done || (part.remaining == 0u);
+            if (part.done)
+                return;
+            if (!part.reader->read_exact(as_bytes(part.entry)))
+                throw std::runtime_error("Covering table is truncated: " + part.reader->path());
+            --part.remaining;
+        };
+        for (cursor& part: cursors)
+            advance(part);
+
+        buffered_file_writer output {output_path_, buffer_size()};
+        output.write(as_bytes(header));
+        const auto less = [&](const std::size_t a, const std::size_t b)
+        { return !cursors[a].done && (cursors[b].done || (cursors[a].entry < cursors[b].entry)); };
+        tournament_tree<decltype(less)> tree {cursors.size(), less};
+        std::uint64_t rows {};
+        for (std::size_t winner {tree.winner()}; !cursors[winner].done; winner = tree.winner())
+        {
+            output.write(as_bytes(cursors[winner].entry));
+            if ((++rows % progress_report_interval_) == 0u)
+                std::cout << "Merged " << rows << " / " << header.entry_count << " entries...\r" << std::flush;
+            advance(cursors[winner]);
+            tree.replay(winner);
+        }
+        output.close();
+        std::cout << "\nMerged " << rows << " covering entries by cell id." << std::endl;
+        std::cout << "Output written to: " << output_path_ << std::endl;
+        return true;
+    }
+
+} // namespace kmx::gis
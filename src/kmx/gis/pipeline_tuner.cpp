@@ -0,0 +1,223 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file pipeline_tuner.cpp
+#include "kmx/gis/pipeline_tuner.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace kmx::gis
+{
+    pipeline_tuner::worker_slot::worker_slot(pipeline_tuner& tuner) noexcept(false): tuner_ {tuner}
+    {
+        std::unique_lock<std::mutex> lock {tuner_.gate_mutex_};
+        tuner_.gate_.wait(lock, [this] { return tuner_.running_ < tuner_.active_workers_; });
+        ++tuner_.running_;
+    }
+
+    pipeline_tuner::worker_slot::~worker_slot() noexcept
+    {
+        try
+        {
+            {
+                std::lock_guard<std::mutex> lock {tuner_.gate_mutex_};
+                --tuner_.running_;
+            }
+            tuner_.gate_.notify_one();
+        }
+        catch (...)
+        {
+            // Swallow all exceptions to ensure destructor is noexcept.
+        }
+    }
+
+    // The worker candidates are all of them, 3/4, 1/2 and 1/4, without repeats.
+    pipeline_tuner::pipeline_tuner(const std::size_t max_workers, const tuning_settings& settings) noexcept(false):
+        max_workers_ {std::max<std::size_t>(max_workers, 1u)},
+        settings_ {settings},
+        active_workers_ {max_workers_}
+    {
+        for (const std::size_t quarters: {4u, 3u, 2u, 1u})
+        {
+            const std::size_t workers {std::max<std::size_t>(max_workers_ * quarters / 4u, 1u)};
+            if (worker_candidates_.empty() || (worker_candidates_.back() != workers))
+                worker_candidates_.push_back(workers);
+        }
+    }
+
+    void pipeline_tuner::start(const std::uint64_t feature_count) noexcept(false)
+    {
+        trials_.clear();
+        stage_begin_ = {};
+        candidate_ = {};
+        batch_bytes_ = settings_.batch_bytes;
+        features_read_ = {};
+        bytes_read_ = {};
+        tuning_features_ = static_cast<std::uint64_t>(static_cast<double>(feature_count) * tuning_share);
+        set_active_workers(max_workers_);
+        const bool fixed {(settings_.batch_bytes > 0u) && (!settings_.tune_workers || (worker_candidates_.size() < 2u))};
+        stage_ = (fixed || (tuning_features_ == 0u)) ? stage::done : stage::warm_up;
+        trial_bytes_ = {};
+        trial_batches_ = {};
+        trial_start_ = clock::now();
+    }
+
+    std::size_t pipeline_tuner::features_in(const std::uint64_t batch_bytes) const noexcept
+    {
+        if ((batch_bytes == 0u) || (features_read_ == 0u))
+            return default_batch_features;
+        const std::uint64_t feature_bytes {std::max<std::uint64_t>(bytes_read_ / features_read_, 1u)};
+        return static_cast<std::size_t>(std::clamp<std::uint64_t>(batch_bytes / feature_bytes, 1u, max_batch_features_));
+    }
+
+    std::size_t pipeline_tuner::batch_features() const noexcept
+    {
+        return features_in(batch_bytes_);
+    }
+
+    // Half of the rest is kept for the worker trials.
+    bool pipeline_tuner::volume_trial_fits() const noexcept
+    {
+        const std::uint64_t trial_features {trial_batches_per_worker_ * max_workers_ * features_in(batch_volumes_[candidate_])};
+        const std::uint64_t remaining {tuning_features_ - std::min(tuning_features_, features_read_)};
+        return trial_features <= (settings_.tune_workers ? (remaining / 2u) : remaining);
+    }
+
+    std::size_t pipeline_tuner::active_workers() const noexcept
+    {
+        std::lock_guard<std::mutex> lock {gate_mutex_};
+        return active_workers_;
+    }
+
+    void pipeline_tuner::record_batch(const std::size_t features, const std::uint64_t bytes) noexcept
+    {
+        features_read_ += features;
+        bytes_read_ += bytes;
+        trial_bytes_ += bytes;
+        ++trial_batches_;
+    }
+
+    // A trial needs a few batches per worker, or its throughput would mostly measure the fill and drain of the pipeline.
+    bool pipeline_tuner::trial_complete() const noexcept
+    {
+        if (stage_ == stage::done)
+            return false;
+        if (features_read_ >= tuning_features_)
+            return true;
+        return ((clock::now() - trial_start_) >= trial_duration_) && (trial_batches_ >= trial_batches_per_worker_ * active_workers());
+    }
+
+    void pipeline_tuner::next_trial() noexcept(false)
+    {
+        const double seconds {std::chrono::duration<double>(clock::now() - trial_start_).count()};
+        if (stage_ != stage::warm_up)
+            trials_.push_back({active_workers(), batch_bytes_, static_cast<double>(trial_bytes_) / std::max(seconds, 1e-9)});
+        trial_bytes_ = {};
+        trial_batches_ = {};
+        if (features_read_ >= tuning_features_)
+        {
+            finish();
+            return;
+        }
+
+        // The volume candidates grow, so once one does not fit in the budget the larger ones do not either
+        ++candidate_;
+        const std::size_t candidates {(stage_ == stage::batch_volume) ? batch_volumes_.size() : worker_candidates_.size()};
+        if ((stage_ == stage::warm_up) || (candidate_ >= candidates) || ((stage_ == stage::batch_volume) && !volume_trial_fits()))
+            advance_stage();
+        else
+            apply_candidate();
+        trial_start_ = clock::now();
+    }
+
+    void pipeline_tuner::advance_stage() noexcept(false)
+    {
+        if (const trial* const best {best_of_stage()}; best != nullptr)
+        {
+            batch_bytes_ = best->batch_bytes;
+            set_active_workers(best->workers);
+        }
+        stage_ = (stage_ == stage::warm_up) ? stage::batch_volume : stage::workers;
+        if ((stage_ == stage::batch_volume) && (settings_.batch_bytes > 0u))
+            stage_ = stage::workers;
+        if ((stage_ == stage::workers) && (!settings_.tune_workers || (worker_candidates_.size() < 2u)))
+        {
+            stage_ = stage::done;
+            return;
+        }
+        candidate_ = {};
+        stage_begin_ = trials_.size();
+        apply_candidate();
+    }
+
+    void pipeline_tuner::apply_candidate() noexcept(false)
+    {
+        if (stage_ == stage::batch_volume)
+            batch_bytes_ = batch_volumes_[candidate_];
+        else if (stage_ == stage::workers)
+            set_active_workers(worker_candidates_[candidate_]);
+    }
+
+    void pipeline_tuner::finish() noexcept(false)
+    {
+        if (const trial* const best {best_of_stage()}; best != nullptr)
+        {
+            batch_bytes_ = best->batch_bytes;
+            set_active_workers(best->workers);
+        }
+        stage_ = stage::done;
+    }
+
+    // The fastest trial; among the worker counts, the fewest workers within `worker_tolerance` of the fastest.
+    const pipeline_tuner::trial* pipeline_tuner::best_of_stage() const noexcept
+    {
+        const trial* best {};
+        for (std::size_t i {stage_begin_}; i < trials_.size(); ++i)
+            if ((best == nullptr) || (trials_[i].bytes_per_second > best->bytes_per_second))
+                best = &trials_[i];
+        if ((best == nullptr) || (stage_ != stage::workers))
+            return best;
+        const trial* fewest {best};
+        for (std::size_t i {stage_begin_}; i < trials_.size(); ++i)
+            if ((trials_[i].bytes_per_second >= best->bytes_per_second * (1.0 - worker_tolerance)) &&
+                (trials_[i].workers < fewest->workers))
+                fewest = &trials_[i];
+        return fewest;
+    }
+
+    void pipeline_tuner::set_active_workers(const std::size_t workers) noexcept(false)
+    {
+        {
+            std::lock_guard<std::mutex> lock {gate_mutex_};
+            active_workers_ = std::clamp<std::size_t>(workers, 1u, max_workers_);
+        }
+        gate_.notify_all();
+    }
+
+    void pipeline_tuner::print_choice() const noexcept(false)
+    {
+        const std::ios_base::fmtflags original_flags {std::cout.flags()};
+        const std::streamsize original_precision {std::cout.precision()};
+        std::cout << std::fixed;
+        std::cout.precision(1);
+        if (!trials_.empty())
+        {
+            std::cout << "Tuning trials (workers x batch KiB: MiB/s):";
+            for (const trial& entry: trials_)
+                std::cout << ' ' << entry.workers << 'x' << (entry.batch_bytes / kibibyte) << ": "
+                          << (entry.bytes_per_second / static_cast<double>(kibibyte * kibibyte));
+            std::cout << std::endl;
+        }
+        const std::size_t workers {active_workers()};
+        std::cout << "Pipeline: " << workers << " of " << max_workers_ << " workers active, batches of ";
+        if (batch_bytes_ > 0u)
+            std::cout << (batch_bytes_ / kibibyte) << " KiB (~" << batch_features() << " features)";
+        else
+            std::cout << default_batch_features << " features";
+        std::cout << (trials_.empty() ? " (not tuned)" : " (tuned)") << ". Reproduce with -t " << workers;
+        if (batch_bytes_ > 0u)
+            std::cout << " --batch-kib " << (batch_bytes_ / kibibyte);
+        std::cout << '.' << std::endl;
+        std::cout.flags(original_flags);
+        std::cout.precision(original_precision);
+    }
+
+} // namespace kmx::gis
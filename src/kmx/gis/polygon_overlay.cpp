@@ -0,0 +1,308 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file polygon_overlay.cpp
+#include "kmx/gis/polygon_overlay.hpp"
+#include "kmx/gis/csv_format.hpp"
+#include "kmx/gis/feature_properties.hpp"
+#include "kmx/gis/geometry_processor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+namespace kmx::gis
+{
+    // Twice the signed area of a ring (positive when counter-clockwise).
+    static double signed_area2(const ring_view& ring) noexcept
+    {
+        double sum {};
+        for (std::uint32_t i {}, j {ring.point_count - 1u}; i < ring.point_count; j = i++)
+            sum += ring.x(j) * ring.y(i) - ring.x(i) * ring.y(j);
+        return sum;
+    }
+
+    void polygon_intersector::prepare(const std::span<const ring_view> rings, segment_index& out_edges) const noexcept(false)
+    {
+        out_edges.clear();
+        for (const ring_view& ring: rings)
+        {
+            if (ring.point_count < 3u)
+                continue;
+            // Walking the ring backwards flips its orientation
+            const bool reverse {(signed_area2(ring) > 0.0) != ring.is_exterior};
+            const auto point = [&](std::uint32_t i)
+            {
+                i %= ring.point_count;
+                if (reverse)
+                    i = ring.point_count - 1u - i;
+                return std::pair {ring.x(i) - origin_x_, ring.y(i) - origin_y_};
+            };
+            // Unclosed rings get their closing edge; closed ones produce a zero-length edge that contributes nothing
+            for (std::uint32_t i {}; i < ring.point_count; ++i)
+            {
+                const auto [x0, y0] = point(i);
+                const auto [x1, y1] = point(i + 1u);
+                if ((x0 != x1) || (y0 != y1))
+                    out_edges.add({x0, y0, x1, y1});
+            }
+        }
+        out_edges.build();
+    }
+
+    void polygon_intersector::set_subject(const std::span<const ring_view> rings) noexcept(false)
+    {
+        const bounding_box bbox {geometry_processor::bbox_of_rings(rings)};
+        origin_x_ = bbox.is_valid ? bbox.min_x : 0.0;
+        origin_y_ = bbox.is_valid ? bbox.min_y : 0.0;
+        const double extent {bbox.is_valid ? std::max(bbox.max_x - bbox.min_x, bbox.max_y - bbox.min_y) : 0.0};
+        distance_tolerance_ = relative_tolerance_ * std::max(extent, 1.0);
+        prepare(rings, subject_);
+    }
+
+    double polygon_intersector::boundary_integral(const segment_index& edges, const segment_index& other,
+                                                  const bool include_shared) noexcept(false)
+    {
+        double sum {};
+        const std::vector<line_segment>& other_segments {other.segments()};
+        for (const line_segment& e: edges.segments())
+        {
+            // Edges outside the other polygon's extent lie entirely outside it
+            if ((std::max(e.x0, e.x1) < other.min_x()) || (std::min(e.x0, e.x1) > other.max_x()) ||
+                (std::max(e.y0, e.y1) < other.min_y()) || (std::min(e.y0, e.y1) > other.max_y()))
+                continue;
+
+            const double dx {e.x1 - e.x0}, dy {e.y1 - e.y0};
+            const double length2 {dx * dx + dy * dy};
+            const double length {std::sqrt(length2)};
+            const double t_tolerance {distance_tolerance_ / length};
+            cuts_.assign({0.0, 1.0});
+            overlaps_.clear();
+            other.visit(std::min(e.y0, e.y1), std::max(e.y0, e.y1),
+                        [&](const std::uint32_t k)
+                        {
+                            const line_segment& g {other_segments[k]};
+                            if ((std::max(g.x0, g.x1) < std::min(e.x0, e.x1)) || (std::min(g.x0, g.x1) > std::max(e.x0, e.x1)))
+                                return;
+                            const double fx {g.x1 - g.x0}, fy {g.y1 - g.y0};
+                            const double wx {g.x0 - e.x0}, wy {g.y0 - e.y0};
+                            const double denom {dx * fy - dy * fx};
+                            const double f_length {std::hypot(fx, fy)};
+                            if (std::abs(denom) > relative_tolerance_ * length * f_length)
+                            {
+                                const double t {(wx * fy - wy * fx) / denom};
+                                const double u {(wx * dy - wy * dx) / denom};
+                                const double u_tolerance {distance_tolerance_ / f_length};
+                                if ((t > 0.0) && (t < 1.0) && (u >= -u_tolerance) && (u <= 1.0 + u_tolerance))
+                                    cuts_.push_back(t);
+                                return;
+                            }
+                            // Parallel: only collinear edges matter, and only where their projections overlap
+                            if (std::abs(wx * dy - wy * dx) > distance_tolerance_ * length)
+                                return;
+                            const double s0 {(wx * dx + wy * dy) / length2};
+                            const double s1 {((g.x1 - e.x0) * dx + (g.y1 - e.y0) * dy) / length2};
+                            const double lo {std::max(std::min(s0, s1), 0.0)}, hi {std::min(std::max(s0, s1), 1.0)};
+                            if (hi - lo <= t_tolerance)
+                                return;
+                            cuts_.push_back(lo);
+                            cuts_.push_back(hi);
+                            overlaps_.push_back({lo, hi, (dx * fx + dy * fy) > 0.0});
+                        });
+
+            std::sort(cuts_.begin(), cuts_.end());
+            double t0 {};
+            for (const double t1: cuts_)
+            {
+                if (t1 - t0 <= t_tolerance)
+                    continue;
+                const double mid {(t0 + t1) / 2.0};
+                bool same {}, opposite {};
+                for (const overlap& o: overlaps_)
+                    if ((mid > o.t0) && (mid < o.t1))
+                        (o.same_direction ? same : opposite) = true;
+
+                // Shared pieces bound the intersection only when both polygons lie on the same side of them
+                bool inside {};
+                if (same || opposite)
+                    inside = same && include_shared;
+                else
+                    inside = other.contains(e.x0 + dx * mid, e.y0 + dy * mid);
+                if (inside)
+                {
+                    const double ax {e.x0 + dx * t0}, ay {e.y0 + dy * t0};
+                    const double bx {e.x0 + dx * t1}, by {e.y0 + dy * t1};
+                    sum += ax * by - bx * ay;
+                }
+                t0 = t1;
+            }
+        }
+        return sum;
+    }
+
+    double polygon_intersector::intersection_area(const std::span<const ring_view> rings) noexcept(false)
+    {
+        prepare(rings, clip_);
+        if (subject_.empty() || clip_.empty() || (clip_.max_x() < subject_.min_x()) || (clip_.min_x() > subject_.max_x()) ||
+            (clip_.max_y() < subject_.min_y()) || (clip_.min_y() > subject_.max_y()))
+            return 0.0;
+
+        const double area {(boundary_integral(subject_, clip_, true) + boundary_integral(clip_, subject_, false)) / 2.0};
+        // Polygons merely touching along a boundary leave rounding noise only
+        const double noise {distance_tolerance_ * std::max(subject_.max_x() - subject_.min_x(), subject_.max_y() - subject_.min_y())};
+        return (area > noise) ? area : 0.0;
+    }
+
+    polygon_overlay::polygon_overlay(const std::string& input_fgb_path, const std::string& zones_fgb_path,
+                                     const std::string& output_csv_path, const std::uint32_t num_threads,
+                                     const std::string& zone_id_column) noexcept(false):
+        output_csv_path_ {output_csv_path},
+        zone_id_column_ {zone_id_column},
+        thread_pool_ {num_threads},
+        dataset_ {input_fgb_path},
+        zones_ {zones_fgb_path}
+    {
+        std::cout << "Thread pool initialized with " << num_threads << " threads.\n";
+    }
+
+    // Queries the zone layer with each UAT's bounding box, in parallel; the result is ordered by UAT, then zone.
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> polygon_overlay::find_candidate_pairs() noexcept(false)
+    {
+        const std::size_t feature_count {dataset_.feature_count()};
+        std::vector<std::vector<std::uint32_t>> zones_of(feature_count);
+        const std::size_t chunk_size {std::max<std::size_t>(1u, feature_count / (thread_pool_.size() * 8u + 1u))};
+        thread_pool_.parallel_for(feature_count, chunk_size,
+                                  [&](const std::size_t begin, const std::size_t end)
+                                  {
+                                      for (std::size_t i {begin}; i < end; ++i)
+                                      {
+                                          const bounding_box bbox {dataset_.feature_bbox(i)};
+                                          if (!bbox.is_valid)
+                                              continue;
+                                          for (const std::uint64_t zone: zones_.search(bbox))
+                                              zones_of[i].push_back(static_cast<std::uint32_t>(zone));
+                                      }
+                                  });
+
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs {};
+        for (std::uint32_t i {}; i < feature_count; ++i)
+            for (const std::uint32_t zone: zones_of[i])
+                pairs.emplace_back(i, zone);
+        return pairs;
+    }
+
+    bool polygon_overlay::process() noexcept(false)
+    {
+        for (const fgb_dataset* const layer: {&dataset_, &zones_})
+        {
+            const FgbGeometryType header_geom_type {layer->geometry_type()};
+            if ((header_geom_type != FgbGeometryType::Polygon) && (header_geom_type != FgbGeometryType::MultiPolygon))
+            {
+                std::cerr << "Error: Polygon overlay requires Polygon/MultiPolygon FGB files. Found: "
+                          << FlatGeobuf::EnumNameGeometryType(header_geom_type) << std::endl;
+                return false;
+            }
+            if (layer->feature_count() > std::numeric_limits<std::uint32_t>::max())
+            {
+                std::cerr << "Error: Too many features for polygon overlay: " << layer->feature_count() << std::endl;
+                return false;
+            }
+        }
+
+        const auto crs_code = [](const fgb_dataset& layer)
+        { return (layer.header()->crs() != nullptr) ? layer.header()->crs()->code() : 0; };
+        if (crs_code(dataset_) != crs_code(zones_))
+        {
+            std::cerr << "Error: The layers use different coordinate reference systems: EPSG:" << crs_code(dataset_) << " and EPSG:"
+                      << crs_code(zones_) << std::endl;
+            return false;
+        }
+        if (!zones_.has_index())
+            std::cout << "Warning: The zone layer has no spatial index; candidate zones are found by a linear scan." << std::endl;
+
+        const std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs {find_candidate_pairs()};
+        std::cout << "Found " << pairs.size() << " candidate (UAT, zone) pairs." << std::endl;
+
+        std::vector<double> areas(pairs.size());
+        thread_pool_.parallel_for(pairs.size(), pairs_per_task_,
+                                  [&](const std::size_t begin, const std::size_t end)
+                                  {
+                                      polygon_intersector intersector {};
+                                      std::vector<ring_view> rings {};
+                                      std::uint32_t subject {std::numeric_limits<std::uint32_t>::max()};
+                                      for (std::size_t k {begin}; k < end; ++k)
+                                      {
+                                          // Pairs are grouped by UAT, so the subject is prepared once per run of pairs
+                                          if (pairs[k].first != subject)
+                                          {
+                                              subject = pairs[k].first;
+                                              const FlatGeobuf::Geometry* const geometry {dataset_.feature(subject)->geometry()};
+                                              geometry_processor::collect_rings(geometry, dataset_.geometry_type_of(geometry), rings);
+                                              intersector.set_subject(rings);
+                                          }
+                                          const FlatGeobuf::Geometry* const geometry {zones_.feature(pairs[k].second)->geometry()};
+                                          geometry_processor::collect_rings(geometry, zones_.geometry_type_of(geometry), rings);
+                                          areas[k] = intersector.intersection_area(rings);
+                                      }
+                                  });
+
+        return write_results(pairs, areas);
+    }
+
+    // Writes one row per pair with a positive intersection area.
+    bool polygon_overlay::write_results(const std::vector<std::pair<std::uint32_t, std::uint32_t>>& pairs,
+                                        const std::vector<double>& areas) const noexcept(false)
+    {
+        std::ofstream output_file {output_csv_path_};
+        if (!output_file.is_open())
+        {
+            std::cerr << "Error: Could not open CSV file for writing: " << output_csv_path_ << std::endl;
+            return false;
+        }
+
+        const std::optional<std::size_t> code_column {dataset_.find_column(expected_uat_code_column_)};
+        if (!code_column.has_value())
+            std::cout << "Warning: Could not find the expected UAT code property '" << expected_uat_code_column_
+                      << "'. UAT codes will be written as 0." << std::endl;
+        std::optional<std::size_t> zone_column {};
+        if (!zone_id_column_.empty())
+        {
+            zone_column = zones_.find_column(zone_id_column_);
+            if (!zone_column.has_value())
+                std::cout << "Warning: Could not find the zone property '" << zone_id_column_
+                          << "'. Zone feature indices will be written instead." << std::endl;
+        }
+
+        output_file.precision(15);
+        output_file << "uat_code,zone_id,area\n";
+        std::size_t row_count {};
+        for (std::size_t k {}; k < pairs.size(); ++k)
+        {
+            if (areas[k] <= 0.0)
+                continue;
+            const auto [uat, zone] = pairs[k];
+            std::uint32_t uat_code {};
+            if (code_column.has_value())
+                uat_code = feature_properties::parse_uint32(
+                               feature_properties::get_string_value(dataset_.feature(uat), dataset_.header(), *code_column))
+                               .value_or(0u);
+            output_file << uat_code << csv_format::delimiter;
+            if (zone_column.has_value())
+                csv_format::write_escaped(output_file,
+                                          feature_properties::get_string_value(zones_.feature(zone), zones_.header(), *zone_column));
+            else
+                output_file << zone;
+            output_file << csv_format::delimiter << areas[k] << '\n';
+            ++row_count;
+        }
+
+        if (!output_file)
+        {
+            std::cerr << "Error: Failed writing CSV file: " << output_csv_path_ << std::endl;
+            return false;
+        }
+        std::cout << "Wrote " << row_count << " intersecting pairs." << std::endl;
+        std::cout << "Output written to: " << output_csv_path_ << std::endl;
+        return true;
+    }
+
+} // namespace kmx::gis
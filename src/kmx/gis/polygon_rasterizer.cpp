@@ -0,0 +1,170 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file polygon_rasterizer.cpp
+#include "kmx/gis/polygon_rasterizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace kmx::gis
+{
+    // Clamps a fractional cell coordinate range to the integer index range [0, limit].
+    static std::int64_t clamp_index(const double value, const std::uint32_t limit) noexcept
+    {
+        if (!(value > 0.0)) // Also catches NaN
+            return 0;
+        if (value >= static_cast<double>(limit))
+            return limit;
+        return static_cast<std::int64_t>(value);
+    }
+
+    // Scanline fill: finds the cells whose centres lie inside the rings (even-odd rule).
+    void polygon_rasterizer::fill(const std::span<const ring_view> rings, const raster_grid& grid,
+                                  std::vector<cell_span>& out_spans) noexcept(false)
+    {
+        out_spans.clear();
+        crossings_.clear();
+        if ((grid.cols == 0u) || (grid.rows == 0u))
+            return;
+
+        for (const ring_view& ring: rings)
+        {
+            if (ring.point_count < 3u)
+                continue;
+            for (std::uint32_t i {}, j {ring.point_count - 1u}; i < ring.point_count; j = i++)
+            {
+                const double vi {grid.row_of(ring.y(i))};
+                const double vj {grid.row_of(ring.y(j))};
+                if (vi == vj)
+                    continue; // Horizontal edges never cross a row centre line in a way that matters for parity
+
+                // Rows whose centre line r + 0.5 satisfies min(vi, vj) <= r + 0.5 < max(vi, vj)
+                const double v_low {std::min(vi, vj)};
+                const double v_high {std::max(vi, vj)};
+                const std::int64_t row_begin {clamp_index(std::ceil(v_low - 0.5), grid.rows)};
+                const std::int64_t row_end {clamp_index(std::ceil(v_high - 0.5), grid.rows)};
+                if (row_begin >= row_end)
+                    continue;
+
+                const double ui {grid.column_of(ring.x(i))};
+                const double slope {(grid.column_of(ring.x(j)) - ui) / (vj - vi)};
+                for (std::int64_t r {row_begin}; r < row_end; ++r)
+                {
+                    const double vc {static_cast<double>(r) + 0.5};
+                    crossings_.push_back({static_cast<std::uint32_t>(r), ui + (vc - vi) * slope});
+                }
+            }
+        }
+
+        std::sort(crossings_.begin(), crossings_.end(), [](const crossing& a, const crossing& b)
+                  { return (a.row != b.row) ? (a.row < b.row) : (a.column < b.column); });
+
+        // Consecutive crossings of the same row delimit inside runs; a cell is inside if its centre c + 0.5 is in [a, b).
+        for (std::size_t k {}; (k + 1u) < crossings_.size();)
+        {
+            const crossing& enter {crossings_[k]};
+            const crossing& leave {crossings_[k + 1u]};
+            if (enter.row != leave.row)
+            {
+                ++k; // Unpaired crossing (degenerate ring); resynchronise on the next row
+                continue;
+            }
+
+            const std::int64_t col_begin {clamp_index(std::ceil(enter.column - 0.5), grid.cols)};
+            const std::int64_t col_end {clamp_index(std::ceil(leave.column - 0.5), grid.cols)};
+            if (col_begin < col_end)
+                out_spans.push_back({enter.row, static_cast<std::uint32_t>(col_begin), static_cast<std::uint32_t>(col_end)});
+            k += 2u;
+        }
+    }
+
+    // Conservative boundary trace: finds every cell touched by at least one ring edge.
+    void polygon_rasterizer::trace(const std::span<const ring_view> rings, const raster_grid& grid,
+                                   std::vector<std::uint64_t>& out_cells) noexcept(false)
+    {
+        out_cells.clear();
+        if ((grid.cols == 0u) || (grid.rows == 0u))
+            return;
+
+        for (const ring_view& ring: rings)
+            for (std::uint32_t i {1u}; i < ring.point_count; ++i)
+                trace_segment(grid.column_of(ring.x(i - 1u)), grid.row_of(ring.y(i - 1u)), grid.column_of(ring.x(i)),
+                              grid.row_of(ring.y(i)), grid, out_cells);
+
+        std::sort(out_cells.begin(), out_cells.end());
+        out_cells.erase(std::unique(out_cells.begin(), out_cells.end()), out_cells.end());
+    }
+
+    // Walks the cells of one edge (fractional grid units) and appends their ids.
+    void polygon_rasterizer::trace_segment(double u0, double v0, double u1, double v1, const raster_grid& grid,
+                                           std::vector<std::uint64_t>& out_cells) noexcept(false)
+    {
+        // Liang-Barsky clip against [0, cols] x [0, rows] so that edges far outside the grid cost nothing.
+        const double du {u1 - u0};
+        const double dv {v1 - v0};
+        double t_enter {0.0};
+        double t_leave {1.0};
+        const double p[4] {-du, du, -dv, dv};
+        const double q[4] {u0, static_cast<double>(grid.cols) - u0, v0, static_cast<double>(grid.rows) - v0};
+        for (int k {}; k < 4; ++k)
+        {
+            if (p[k] == 0.0)
+            {
+                if (q[k] < 0.0)
+                    return; // Parallel to and outside this boundary
+                continue;
+            }
+            const double t {q[k] / p[k]};
+            if (p[k] < 0.0)
+                t_enter = std::max(t_enter, t);
+            else
+                t_leave = std::min(t_leave, t);
+        }
+        if (t_enter > t_leave)
+            return;
+
+        const double cu0 {u0 + t_enter * du};
+        const double cv0 {v0 + t_enter * dv};
+        const double cu1 {u0 + t_leave * du};
+        const double cv1 {v0 + t_leave * dv};
+
+        const auto cell_of = [](const double value, const std::uint32_t limit)
+        { return std::clamp<std::int64_t>(static_cast<std::int64_t>(std::floor(value)), 0, static_cast<std::int64_t>(limit) - 1); };
+        std::int64_t col {cell_of(cu0, grid.cols)};
+        std::int64_t row {cell_of(cv0, grid.rows)};
+        const std::int64_t end_col {cell_of(cu1, grid.cols)};
+        const std::int64_t end_row {cell_of(cv1, grid.rows)};
+
+        // Amanatides-Woo traversal; the number of steps is fixed up front so rounding can never make it run away.
+        const std::int64_t step_col {(end_col > col) ? 1 : -1};
+        const std::int64_t step_row {(end_row > row) ? 1 : -1};
+        constexpr double infinity {std::numeric_limits<double>::infinity()};
+        const double abs_du {std::abs(cu1 - cu0)};
+        const double abs_dv {std::abs(cv1 - cv0)};
+        const double t_delta_col {(abs_du > 0.0) ? (1.0 / abs_du) : infinity};
+        const double t_delta_row {(abs_dv > 0.0) ? (1.0 / abs_dv) : infinity};
+        double t_max_col {(abs_du > 0.0) ? (((step_col > 0) ? (static_cast<double>(col + 1) - cu0) : (cu0 - static_cast<double>(col))) *
+                                            t_delta_col)
+                                         : infinity};
+        double t_max_row {(abs_dv > 0.0) ? (((step_row > 0) ? (static_cast<double>(row + 1) - cv0) : (cv0 - static_cast<double>(row))) *
+                                            t_delta_row)
+                                         : infinity};
+
+        const std::int64_t steps {std::abs(end_col - col) + std::abs(end_row - row)};
+        out_cells.push_back(static_cast<std::uint64_t>(row) * grid.cols + static_cast<std::uint64_t>(col));
+        for (std::int64_t s {}; s < steps; ++s)
+        {
+            if ((row == end_row) || ((col != end_col) && (t_max_col < t_max_row)))
+            {
+                col += step_col;
+                t_max_col += t_delta_col;
+            }
+            else
+            {
+                row += step_row;
+                t_max_row += t_delta_row;
+            }
+            out_cells.push_back(static_cast<std::uint64_t>(row) * grid.cols + static_cast<std::uint64_t>(col));
+        }
+    }
+
+} // namespace kmx::gis
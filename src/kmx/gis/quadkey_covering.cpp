@@ -0,0 +1,379 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file quadkey_covering.cpp
+#include "kmx/gis/quadkey_covering.hpp"
+#include "kmx/gis/feature_properties.hpp"
+#include "kmx/gis/geometry_processor.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <mutex>
+
+namespace kmx::gis
+{
+    // Spreads the low 32 bits of `v` to the even bit positions of a 64-bit word.
+    static constexpr std::uint64_t spread_bits(std::uint64_t v) noexcept
+    {
+        v &= 0xFFFFFFFFull;
+        v = (v | (v << 16u)) & 0x0000FFFF0000FFFFull;
+        v = (v | (v << 8u)) & 0x00FF00FF00FF00FFull;
+        v = (v | (v << 4u)) & 0x0F0F0F0F0F0F0F0Full;
+        v = (v | (v << 2u)) & 0x3333333333333333ull;
+        v = (v | (v << 1u)) & 0x5555555555555555ull;
+        return v;
+    }
+
+    // Inverse of `spread_bits`: gathers the even bit positions into the low 32 bits.
+    static constexpr std::uint32_t compact_bits(std::uint64_t v) noexcept
+    {
+        v &= 0x5555555555555555ull;
+        v = (v | (v >> 1u)) & 0x3333333333333333ull;
+        v = (v | (v >> 2u)) & 0x0F0F0F0F0F0F0F0Full;
+        v = (v | (v >> 4u)) & 0x00FF00FF00FF00FFull;
+        v = (v | (v >> 8u)) & 0x0000FFFF0000FFFFull;
+        v = (v | (v >> 16u)) & 0x00000000FFFFFFFFull;
+        return static_cast<std::uint32_t>(v);
+    }
+
+    std::uint64_t quadkey::make_id(const std::uint32_t level, const std::uint32_t x, const std::uint32_t y) noexcept
+    {
+        const std::uint32_t shift {2u * (max_level - level)};
+        const std::uint64_t morton {spread_bits(x) | (spread_bits(y) << 1u)};
+        return (morton << (shift + 1u)) | (std::uint64_t {1u} << shift);
+    }
+
+    std::uint32_t quadkey::level_of(const std::uint64_t id) noexcept
+    {
+        return max_level - static_cast<std::uint32_t>(std::countr_zero(id)) / 2u;
+    }
+
+    std::pair<std::uint32_t, std::uint32_t> quadkey::position_of(const std::uint64_t id) noexcept
+    {
+        const std::uint64_t morton {id >> (2u * (max_level - level_of(id)) + 1u)};
+        return {compact_bits(morton), compact_bits(morton >> 1u)};
+    }
+
+    std::uint64_t quadkey::range_min(const std::uint64_t id) noexcept
+    {
+        return id - ((id & (~id + 1u)) - 1u);
+    }
+
+    std::uint64_t quadkey::range_max(const std::uint64_t id) noexcept
+    {
+        return id + ((id & (~id + 1u)) - 1u);
+    }
+
+    std::string quadkey::to_string(const std::uint64_t id) noexcept(false)
+    {
+        const std::uint32_t level {level_of(id)};
+        const auto [x, y] = position_of(id);
+        std::string result(level, '0');
+        for (std::uint32_t l {}; l < level; ++l)
+        {
+            const std::uint32_t bit {level - 1u - l};
+            result[l] = static_cast<char>('0' + ((x >> bit) & 1u) + 2u * ((y >> bit) & 1u));
+        }
+        return result;
+    }
+
+    quadkey_coverer::quadkey_coverer(const double root_origin_x, const double root_origin_y, const double root_size,
+                                     const quadkey_covering_settings& settings) noexcept:
+        root_origin_x_ {root_origin_x},
+        root_origin_y_ {root_origin_y},
+        root_size_ {root_size},
+        settings_ {settings}
+    {
+    }
+
+    quadkey_coverer::cell_rect quadkey_coverer::cell_bounds(const std::uint32_t level, const std::uint32_t x,
+                                                            const std::uint32_t y) const noexcept
+    {
+        const double size {std::ldexp(root_size_, -static_cast<int>(level))};
+        const double min_x {root_origin_x_ + x * size};
+        const double min_y {root_origin_y_ + y * size};
+        return {min_x, min_y, min_x + size, min_y + size};
+    }
+
+    // Bounding box rejection, then the edge's line must separate the cell corners for the edge to cross the cell.
+    bool quadkey_coverer::edge_intersects(const line_segment& e, const cell_rect& cell) noexcept
+    {
+        if ((std::max(e.x0, e.x1) < cell.min_x) || (std::min(e.x0, e.x1) > cell.max_x) || (std::max(e.y0, e.y1) < cell.min_y) ||
+            (std::min(e.y0, e.y1) > cell.max_y))
+            return false;
+
+        const double dx {e.x1 - e.x0};
+        const double dy {e.y1 - e.y0};
+        const auto side = [&](const double x, const double y) { return dx * (y - e.y0) - dy * (x - e.x0); };
+        const double s0 {side(cell.min_x, cell.min_y)};
+        const double s1 {side(cell.max_x, cell.min_y)};
+        const double s2 {side(cell.max_x, cell.max_y)};
+        const double s3 {side(cell.min_x, cell.max_y)};
+        const bool all_positive {(s0 > 0.0) && (s1 > 0.0) && (s2 > 0.0) && (s3 > 0.0)};
+        const bool all_negative {(s0 < 0.0) && (s1 < 0.0) && (s2 < 0.0) && (s3 < 0.0)};
+        return !all_positive && !all_negative;
+    }
+
+    void quadkey_coverer::cover(std::span<const ring_view> rings, const std::uint32_t feature,
+                                std::vector<quadkey_cover_entry>& out_entries) noexcept(false)
+    {
+        edges_.clear();
+        for (const ring_view& ring: rings)
+        {
+            if (ring.point_count < 2u)
+                continue;
+            for (std::uint32_t i {}; i < ring.point_count; ++i)
+            {
+                // The closing edge is only needed for rings stored without a repeated first point
+                const std::uint32_t j {(i + 1u < ring.point_count) ? i + 1u : 0u};
+                if ((ring.x(i) != ring.x(j)) || (ring.y(i) != ring.y(j)))
+                    edges_.add({ring.x(i), ring.y(i), ring.x(j), ring.y(j)});
+            }
+        }
+        if (edges_.empty())
+            return;
+        edges_.build();
+        bounding_box extent {};
+        extent.update(edges_.min_x(), edges_.min_y());
+        extent.update(edges_.max_x(), edges_.max_y());
+
+        // Start from the smallest cell that encloses the whole feature
+        const auto cell_index = [&](const double v, const double origin, const std::uint32_t level)
+        {
+            const double cells {std::ldexp(1.0, static_cast<int>(level))};
+            return static_cast<std::uint32_t>(std::clamp(std::floor((v - origin) / root_size_ * cells), 0.0, cells - 1.0));
+        };
+        std::uint32_t level {};
+        while (level < settings_.max_level)
+        {
+            const std::uint32_t x0 {cell_index(extent.min_x, root_origin_x_, level + 1u)};
+            const std::uint32_t y0 {cell_index(extent.min_y, root_origin_y_, level + 1u)};
+            const std::uint32_t x1 {cell_index(extent.max_x, root_origin_x_, level + 1u)};
+            const std::uint32_t y1 {cell_index(extent.max_y, root_origin_y_, level + 1u)};
+            if ((x0 != x1) || (y0 != y1))
+                break;
+            ++level;
+        }
+
+        edge_pool_.resize(edges_.segments().size());
+        for (std::uint32_t i {}; i < edge_pool_.size(); ++i)
+            edge_pool_[i] = i;
+        candidates_.assign(1u, {level, cell_index(extent.min_x, root_origin_x_, level), cell_index(extent.min_y, root_origin_y_, level), 0u,
+                                edge_pool_.size()});
+
+        // Breadth-first refinement: a level is refined only while the result is guaranteed to stay within the budget
+        std::size_t emitted {};
+        while (!candidates_.empty())
+        {
+            const bool refine {(candidates_.front().level < settings_.max_level) &&
+                               (emitted + 4u * candidates_.size() <= settings_.max_cells)};
+            if (!refine)
+            {
+                for (const candidate& c: candidates_)
+                    out_entries.push_back({quadkey::make_id(c.level, c.x, c.y), feature, 0u});
+                break;
+            }
+
+            next_candidates_.clear();
+            next_edge_pool_.clear();
+            for (const candidate& c: candidates_)
+                for (std::uint32_t child {}; child < 4u; ++child)
+                {
+                    const std::uint32_t child_level {c.level + 1u};
+                    const std::uint32_t cx {2u * c.x + (child & 1u)};
+                    const std::uint32_t cy {2u * c.y + (child >> 1u)};
+                    const cell_rect rect {cell_bounds(child_level, cx, cy)};
+
+                    const std::size_t begin {next_edge_pool_.size()};
+                    for (std::size_t k {c.edges_begin}; k < c.edges_end; ++k)
+                        if (edge_intersects(edges_.segments()[edge_pool_[k]], rect))
+                            next_edge_pool_.push_back(edge_pool_[k]);
+
+                    if (next_edge_pool_.size() != begin)
+                        next_candidates_.push_back({child_level, cx, cy, begin, next_edge_pool_.size()});
+                    else if (edges_.contains(0.5 * (rect.min_x + rect.max_x), 0.5 * (rect.min_y + rect.max_y)))
+                    {
+                        out_entries.push_back({quadkey::make_id(child_level, cx, cy), feature, quadkey_cover_entry::interior_flag});
+                        ++emitted;
+                    }
+                }
+
+            candidates_.swap(next_candidates_);
+            edge_pool_.swap(next_edge_pool_);
+        }
+    }
+
+    quadkey_covering_builder::quadkey_covering_builder(const std::string& input_fgb_path, const std::string& output_path,
+                                                       const std::uint32_t num_threads,
+                                                       const quadkey_covering_settings& settings) noexcept(false):
+        output_path_ {output_path},
+        settings_ {settings},
+        thread_pool_ {num_threads},
+        dataset_ {input_fgb_path}
+    {
+        std::cout << "Thread pool initialized with " << num_threads << " threads.\n";
+    }
+
+    bool quadkey_covering_builder::build() noexcept(false)
+    {
+        const FgbGeometryType header_geom_type {dataset_.geometry_type()};
+        if ((header_geom_type != FgbGeometryType::Polygon) && (header_geom_type != FgbGeometryType::MultiPolygon))
+        {
+            std::cerr << "Error: Coverings require Polygon/MultiPolygon FGB files. Found: "
+                      << FlatGeobuf::EnumNameGeometryType(header_geom_type) << std::endl;
+            return false;
+        }
+
+        const std::uint64_t feature_count {dataset_.feature_count()};
+        if ((feature_count == 0u) || (feature_count > std::numeric_limits<std::uint32_t>::max()))
+        {
+            std::cerr << "Error: Unsupported feature count for a covering: " << feature_count << std::endl;
+            return false;
+        }
+        if ((settings_.max_level > quadkey::max_level) || (settings_.max_cells == 0u))
+        {
+            std::cerr << "Error: The max level must be at most " << quadkey::max_level << " and the cell budget positive." << std::endl;
+            return false;
+        }
+
+        // Dataset extent from the per-feature boxes (R-tree leaves when indexed).
+        bounding_box extent {};
+        std::mutex extent_mutex {};
+        thread_pool_.parallel_for(static_cast<std::size_t>(feature_count), 4096u,
+                                  [&](const std::size_t begin, const std::size_t end)
+                                  {
+                                      bounding_box local {};
+                                      for (std::size_t i {begin}; i < end; ++i)
+                                          if (const bounding_box bbox {dataset_.feature_bbox(i)}; bbox.is_valid)
+                                          {
+                                              local.update(bbox.min_x, bbox.min_y);
+                                              local.update(bbox.max_x, bbox.max_y);
+                                          }
+                                      if (!local.is_valid)
+                                          return;
+                                      std::lock_guard<std::mutex> lock {extent_mutex};
+                                      extent.update(local.min_x, local.min_y);
+                                      extent.update(local.max_x, local.max_y);
+                                  });
+        if (!extent.is_valid)
+        {
+            std::cerr << "Error: The input has no valid geometries." << std::endl;
+            return false;
+        }
+
+        // The root cell is the square anchored at the south-west corner of the extent
+        quadkey_cover_file_header header {};
+        header.magic = quadkey_cover_file_header::magic_value;
+        header.version = quadkey_cover_file_header::current_version;
+        header.max_level = settings_.max_level;
+        header.root_origin_x = extent.min_x;
+        header.root_origin_y = extent.min_y;
+        header.root_size = std::max(extent.max_x - extent.min_x, extent.max_y - extent.min_y);
+        if (!(header.root_size > 0.0))
+            header.root_size = 1.0;
+
+        std::cout << "Covering " << feature_count << " features up to level " << settings_.max_level << " ("
+                  << std::ldexp(header.root_size, -static_cast<int>(settings_.max_level)) << " units), at most " << settings_.max_cells
+                  << " cells each." << std::endl;
+
+        std::vector<std::vector<quadkey_cover_entry>> runs {};
+        std::mutex runs_mutex {};
+        const std::size_t chunk_size {std::max<std::size_t>(1u, feature_count / (thread_pool_.size() * 8u + 1u))};
+        thread_pool_.parallel_for(static_cast<std::size_t>(feature_count), chunk_size,
+                                  [&](const std::size_t begin, const std::size_t end)
+                                  {
+                                      quadkey_coverer coverer {header.root_origin_x, header.root_origin_y, header.root_size, settings_};
+                                      std::vector<ring_view> rings {};
+                                      std::vector<quadkey_cover_entry> local {};
+                                      const std::size_t ahead {dataset_.prefetch_distance()};
+                                      for (std::size_t i {begin}; i < end; ++i)
+                                      {
+                                          if ((i + ahead) < end)
+                                              dataset_.prefetch_feature(i + ahead);
+                                          const FlatGeobuf::Geometry* const geometry {dataset_.feature(i)->geometry()};
+                                          geometry_processor::collect_rings(geometry, dataset_.geometry_type_of(geometry), rings);
+                                          coverer.cover(rings, static_cast<std::uint32_t>(i), local);
+                                      }
+                                      std::sort(local.begin(), local.end());
+
+                                      std::lock_guard<std::mutex> lock {runs_mutex};
+                                      runs.push_back(std::move(local));
+                                  });
+
+        const std::vector<quadkey_cover_entry> entries {sort_and_merge(runs)};
+        header.entry_count = entries.size();
+
+        const auto interior_count = std::count_if(entries.begin(), entries.end(), [](const quadkey_cover_entry& e)
+                                                  { return (e.flags & quadkey_cover_entry::interior_flag) != 0u; });
+        std::cout << "Covering has " << entries.size() << " cells (" << interior_count << " interior)." << std::endl;
+
+        return write_table(entries, header);
+    }
+
+    // Merges the sorted runs pairwise, each round in parallel, until one run is left.
+    std::vector<quadkey_cover_entry>
+    quadkey_covering_builder::sort_and_merge(std::vector<std::vector<quadkey_cover_entry>>& runs) noexcept(false)
+    {
+        if (runs.empty())
+            return {};
+
+        while (runs.size() > 1u)
+        {
+            std::vector<std::vector<quadkey_cover_entry>> merged((runs.size() + 1u) / 2u);
+            thread_pool_.parallel_for(merged.size(), 1u,
+                                      [&](const std::size_t begin, const std::size_t end)
+                                      {
+                                          for (std::size_t i {begin}; i < end; ++i)
+                                          {
+                                              if (2u * i + 1u == runs.size())
+                                              {
+                                                  merged[i] = std::move(runs[2u * i]);
+                                                  continue;
+                                              }
+                                              const auto& a = runs[2u * i];
+                                              const auto& b = runs[2u * i + 1u];
+                                              merged[i].resize(a.size() + b.size());
+                                              std::merge(a.begin(), a.end(), b.begin(), b.end(), merged[i].begin());
+                                          }
+                                      });
+            runs.swap(merged);
+        }
+        return std::move(runs.front());
+    }
+
+    bool quadkey_covering_builder::write_table(const std::vector<quadkey_cover_entry>& entries,
+                                               const quadkey_cover_file_header& header) const noexcept(false)
+    {
+        const bool as_csv {output_path_.ends_with(".csv")};
+        std::ofstream output_file {output_path_, as_csv ? std::ios::out | std::ios::trunc : std::ios::binary | std::ios::trunc};
+        if (!output_file.is_open())
+        {
+            std::cerr << "Error: Could not open covering file for writing: " << output_path_ << std::endl;
+            return false;
+        }
+
+        if (as_csv)
+        {
+            output_file << "cell_id,quadkey,level,feature_index,interior\n";
+            for (const quadkey_cover_entry& entry: entries)
+                output_file << entry.cell_id << ',' << quadkey::to_string(entry.cell_id) << ',' << quadkey::level_of(entry.cell_id) << ','
+                            << entry.feature << ',' << (entry.flags & quadkey_cover_entry::interior_flag) << '\n';
+        }
+        else
+        {
+            output_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            output_file.write(reinterpret_cast<const char*>(entries.data()),
+                              static_cast<std::streamsize>(entries.size() * sizeof(quadkey_cover_entry)));
+        }
+
+        if (!output_file)
+        {
+            std::cerr << "Error: Failed writing covering file: " << output_path_ << std::endl;
+            return false;
+        }
+        std::cout << "Covering written to " << output_path_ << std::endl;
+        return true;
+    }
+
+} // namespace kmx::gis
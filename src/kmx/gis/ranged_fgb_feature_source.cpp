@@ -0,0 +1,389 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file ranged_fgb_feature_source.cpp
+#include "kmx/gis/ranged_fgb_feature_source.hpp"
+#include "flatgeobuf/feature_generated.h"
+#include "flatgeobuf/packedrtree.h"
+#include "kmx/gis/feature_properties.hpp"
+#include "kmx/gis/geometry_processor.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace kmx::gis
+{
+    // Reads and validates the header.
+    ranged_fgb_feature_source::ranged_fgb_feature_source(const std::string& path, thread_pool& pool, block_cache& cache) noexcept(false):
+        reader_ {cached_reader::open(cache, path)},
+        pool_ {pool}
+    {
+        static constexpr std::array<std::uint8_t, 8u> expected_magic_bytes {0x66u, 0x67u, 0x62u, 0x03u, 0x66u, 0x67u, 0x62u, 0x00u};
+        static constexpr std::size_t header_start {expected_magic_bytes.size() + sizeof(std::uint32_t)};
+
+        // One read usually covers the whole header.
+        header_bytes_ = reader_->read({0u, std::min<std::uint64_t>(reader_->size(), initial_read_size_)});
+        if ((header_bytes_.size() < header_start) || (std::memcmp(header_bytes_.data(), expected_magic_bytes.data(), 4u) != 0) ||
+            (std::memcmp(header_bytes_.data() + 4u, expected_magic_bytes.data() + 4u, 3u) != 0))
+            throw std::runtime_error("Not a FlatGeobuf file: " + path);
+
+        const std::uint32_t header_size {::flatbuffers::ReadScalar<std::uint32_t>(header_bytes_.data() + expected_magic_bytes.size())};
+        const std::uint64_t header_end {header_start + static_cast<std::uint64_t>(header_size)};
+        if (header_end > reader_->size())
+            throw std::runtime_error("FlatGeobuf header is truncated: " + path);
+        if (header_end > header_bytes_.size())
+        {
+            const std::size_t fetched {header_bytes_.size()};
+            header_bytes_.resize(static_cast<std::size_t>(header_end));
+            reader_->read(fetched, std::span<std::uint8_t> {header_bytes_}.subspan(fetched));
+        }
+        header_bytes_.resize(static_cast<std::size_t>(header_end));
+        header_ = FlatGeobuf::GetHeader(header_bytes_.data() + header_start);
+
+        index_offset_ = header_end;
+        if ((header_->index_node_size() > 0u) && (header_->features_count() > 0u))
+        {
+            index_size_ = FlatGeobuf::PackedRTree::size(header_->features_count(), header_->index_node_size());
+            pinned_index_size_ = index_size_ - header_->features_count() * sizeof(FlatGeobuf::NodeItem);
+        }
+        features_offset_ = index_offset_ + index_size_;
+        if (features_offset_ > reader_->size())
+            throw std::runtime_error("FlatGeobuf spatial index is truncated: " + path);
+    }
+
+    // Prints basic information from the FGB header to standard output.
+    void ranged_fgb_feature_source::print_info() const noexcept(false)
+    {
+        std::cout << "Processing FGB file with partial reads: " << reader_->name() << " (" << reader_->size() << " bytes)" << std::endl;
+        std::cout << "Header Geometry Type: " << geometry_type_name() << std::endl;
+        std::cout << "Feature count (from header): " << header_->features_count() << std::endl;
+        if (header_->has_z())
+            std::cout << "Data includes Z coordinates." << std::endl;
+        if (header_->has_m())
+            std::cout << "Data includes M coordinates." << std::endl;
+    }
+
+    std::string_view ranged_fgb_feature_source::geometry_type_name() const noexcept
+    {
+        return FlatGeobuf::EnumNameGeometryType(header_->geometry_type());
+    }
+
+    bool ranged_fgb_feature_source::is_polygonal() const noexcept
+    {
+        const FgbGeometryType type {header_->geometry_type()};
+        return (type == FgbGeometryType::Polygon) || (type == FgbGeometryType::MultiPolygon);
+    }
+
+    // The effective type of a feature geometry: its own type, or the header type when the geometry leaves it unset.
+    FgbGeometryType ranged_fgb_feature_source::geometry_type_of(const FlatGeobuf::Geometry* const geometry) const noexcept
+    {
+        if ((geometry == nullptr) || (geometry->type() == FgbGeometryType::Unknown))
+            return header_->geometry_type();
+        return geometry->type();
+    }
+
+    // Number of read features (and the ones skipped on resume), or the header count before reading everything.
+    std::uint64_t ranged_fgb_feature_source::feature_count() const noexcept
+    {
+        return (fetched_ && scan_done_) ? (skipped_ + features_.size()) : header_->features_count();
+    }
+
+    std::vector<std::optional<std::size_t>> ranged_fgb_feature_source::project(
+        const std::span<const std::string_view> names) noexcept(false)
+    {
+        columns_.clear();
+        for (const std::string_view name: names)
+            columns_.push_back(feature_properties::find_column_index(header_, name));
+        return columns_;
+    }
+
+    void ranged_fgb_feature_source::report_transfer(const std::string_view what) const noexcept(false)
+    {
+        std::cout << "Read " << features_.size() << ' ' << what << " with " << reader_->load_count() << " reads, "
+                  << reader_->bytes_loaded() << " bytes in total." << std::endl;
+    }
+
+    // Reads index bytes through the cache; the blocks of the upper levels are pinned, as every query starts there.
+    void ranged_fgb_feature_source::read_index(std::uint8_t* const buffer, const std::size_t offset,
+                                               const std::size_t length) noexcept(false)
+    {
+        reader_->read(index_offset_ + offset, {buffer, length}, offset < pinned_index_size_);
+
+        // Remember the leaf offsets: the offset of leaf i + 1 is where feature i ends.
+        const std::uint64_t node_count {index_size_ / sizeof(FlatGeobuf::NodeItem)};
+        const std::uint64_t leaf_begin {node_count - header_->features_count()};
+        for (std::size_t position {}; (position + sizeof(FlatGeobuf::NodeItem)) <= length; position += sizeof(FlatGeobuf::NodeItem))
+        {
+            const std::uint64_t node {(offset + position) / sizeof(FlatGeobuf::NodeItem)};
+            if (node >= leaf_begin)
+            {
+                FlatGeobuf::NodeItem item {};
+                std::memcpy(&item, buffer + position, sizeof(item));
+                leaf_offsets_[node - leaf_begin] = item.offset;
+            }
+        }
+    }
+
+    // Starts a full read of the feature section at `start`: all of it, or its first window when buffering is limited.
+    void ranged_fgb_feature_source::read_all_features(const std::uint64_t start, const std::uint64_t first_index) noexcept(false)
+    {
+        features_.clear();
+        skipped_ = first_index;
+        scan_offset_ = start;
+        scan_done_ = false;
+        fetched_ = true;
+        read_window();
+    }
+
+    // Reads the section from `scan_offset_` in parallel ranges, past the cache, and splits it into features; a feature
+    // cut by the window end is read again with the next window.
+    bool ranged_fgb_feature_source::read_window() noexcept(false)
+    {
+        const std::uint64_t section_size {reader_->size() - std::min(features_offset_, reader_->size())};
+        const std::uint64_t remaining {section_size - std::min(scan_offset_, section_size)};
+        // A zero feature count means "unknown" in FlatGeobuf, in which case we read until the end of the section.
+        const std::uint64_t declared_count {header_->features_count()};
+        const auto all_located = [&] { return (declared_count > 0u) && ((skipped_ + features_.size()) >= declared_count); };
+        if (scan_done_ || (remaining == 0u) || all_located())
+        {
+            finish_scan();
+            return false;
+        }
+
+        std::uint64_t window_size {(scan_window_ > 0u) ? std::min(scan_window_, remaining) : remaining};
+        for (;;)
+        {
+            std::vector<std::uint8_t> section(static_cast<std::size_t>(window_size));
+            const std::uint64_t section_offset {features_offset_ + scan_offset_};
+            const std::size_t range_count {static_cast<std::size_t>((window_size + scan_read_size_ - 1u) / scan_read_size_)};
+            pool_.parallel_for(range_count, 1u,
+                               [&](const std::size_t begin, const std::size_t end)
+                               {
+                                   for (std::size_t r {begin}; r < end; ++r)
+                                   {
+                                       const std::size_t offset {r * scan_read_size_};
+                                       const std::size_t length {std::min<std::size_t>(scan_read_size_, section.size() - offset)};
+                                       reader_->read_uncached(section_offset + offset,
+                                                              std::span<std::uint8_t> {section}.subspan(offset, length));
+                                   }
+                               });
+
+            const std::size_t first_feature {features_.size()};
+            std::size_t offset {};
+            std::uint64_t needed {};
+            while (!all_located() && ((offset + sizeof(std::uint32_t)) <= section.size()))
+            {
+                const std::size_t size {sizeof(std::uint32_t) + ::flatbuffers::ReadScalar<std::uint32_t>(section.data() + offset)};
+                if ((offset + size) > section.size())
+                {
+                    needed = size;
+                    break;
+                }
+                features_.push_back({std::span<const std::uint8_t> {section}.subspan(offset, size), skipped_ + features_.size(),
+                                     scan_offset_ + offset});
+                offset += size;
+            }
+
+            // A feature larger than the window is read with a window of its own size
+            if ((features_.size() == first_feature) && (needed > window_size) && (needed <= remaining))
+            {
+                window_size = needed;
+                continue;
+            }
+            scan_offset_ += offset;
+            if ((features_.size() == first_feature) || (window_size == remaining))
+                scan_done_ = true; // Truncated, or the rest of the section was read
+            if (features_.size() > first_feature)
+            {
+                buffered_bytes_ += section.size();
+                buffers_.push_back(std::move(section));
+                buffer_ends_.push_back(features_.size());
+            }
+            if (scan_done_)
+                finish_scan();
+            return features_.size() > first_feature;
+        }
+    }
+
+    // Reports the full read once its last window is in.
+    void ranged_fgb_feature_source::finish_scan() noexcept(false)
+    {
+        if (reported_)
+            return;
+        reported_ = true;
+        scan_done_ = true;
+        const std::uint64_t declared_count {header_->features_count()};
+        if ((declared_count > 0u) && (feature_count() != declared_count))
+            std::cerr << "Warning: " << reader_->name() << " declares " << declared_count << " features but only " << feature_count()
+                      << " could be located." << std::endl;
+        report_transfer("features");
+    }
+
+    // Applies to full reads only: the features of a window query are few and were read already.
+    void ranged_fgb_feature_source::limit_buffering(const std::uint64_t bytes) noexcept(false)
+    {
+        if (!fetched_)
+            scan_window_ = std::max<std::uint64_t>(bytes, scan_read_size_);
+    }
+
+    // The buffers are freed front to back, once all of their features lie before `position`.
+    void ranged_fgb_feature_source::release(const std::uint64_t position) noexcept(false)
+    {
+        if (scan_window_ == 0u)
+            return;
+        const std::uint64_t done {position - std::min(position, skipped_)};
+        while ((released_buffers_ < buffers_.size()) && (buffer_ends_[released_buffers_] <= done))
+        {
+            buffered_bytes_ -= buffers_[released_buffers_].size();
+            buffers_[released_buffers_] = {};
+            ++released_buffers_;
+        }
+    }
+
+    // Reads the features at the given (offset, index) hits.
+    void ranged_fgb_feature_source::read_features(const std::vector<std::pair<std::uint64_t, std::uint64_t>>& hits) noexcept(false)
+    {
+        // Feature sizes: up to the next leaf offset seen in the index, or read from the size prefixes.
+        const std::uint64_t section_size {reader_->size() - features_offset_};
+        std::vector<byte_range> ranges(hits.size());
+        std::vector<byte_range> prefix_ranges {};
+        std::vector<std::size_t> prefix_owners {};
+        for (std::size_t i {}; i < hits.size(); ++i)
+        {
+            const auto [offset, index] = hits[i];
+            ranges[i].offset = features_offset_ + offset;
+            if (const auto next = leaf_offsets_.find(index + 1u); next != leaf_offsets_.end() && (next->second > offset))
+                ranges[i].length = next->second - offset;
+            else if ((index + 1u) == header_->features_count())
+                ranges[i].length = section_size - offset;
+            else
+            {
+                prefix_ranges.push_back({ranges[i].offset, sizeof(std::uint32_t)});
+                prefix_owners.push_back(i);
+            }
+        }
+        if (!prefix_ranges.empty())
+        {
+            reader_->prefetch(prefix_ranges, pool_);
+            for (std::size_t p {}; p < prefix_owners.size(); ++p)
+            {
+                std::array<std::uint8_t, sizeof(std::uint32_t)> prefix {};
+                reader_->read(prefix_ranges[p].offset, prefix);
+                ranges[prefix_owners[p]].length = sizeof(std::uint32_t) + ::flatbuffers::ReadScalar<std::uint32_t>(prefix.data());
+            }
+        }
+
+        // Load the blocks of all features in parallel runs, then copy the features out of the cache.
+        reader_->prefetch(ranges, pool_);
+        std::uint64_t total_size {};
+        for (byte_range& range: ranges)
+        {
+            range.length = std::min(range.length, reader_->size() - std::min(range.offset, reader_->size()));
+            total_size += range.length;
+        }
+        std::vector<std::uint8_t>& buffer {buffers_.emplace_back(static_cast<std::size_t>(total_size))};
+        buffered_bytes_ += buffer.size();
+        features_.clear();
+        std::size_t position {};
+        for (std::size_t i {}; i < hits.size(); ++i)
+        {
+            const std::span<std::uint8_t> bytes {std::span {buffer}.subspan(position, static_cast<std::size_t>(ranges[i].length))};
+            reader_->read(ranges[i].offset, bytes);
+            position += bytes.size();
+            if ((bytes.size() < sizeof(std::uint32_t)) ||
+                ((sizeof(std::uint32_t) + ::flatbuffers::ReadScalar<std::uint32_t>(bytes.data())) > bytes.size()))
+            {
+                std::cerr << "Warning: Feature " << hits[i].second << " of " << reader_->name() << " is truncated. Skipping." << std::endl;
+                continue;
+            }
+            features_.push_back({bytes, hits[i].second, hits[i].first});
+        }
+        fetched_ = true;
+        scan_done_ = true;
+        report_transfer("matching features");
+    }
+
+    // Walks the index and reads the matching features.
+    bool ranged_fgb_feature_source::restrict_to(const bounding_box& window) noexcept(false)
+    {
+        next_feature_ = 0u;
+        if (index_size_ == 0u)
+        {
+            // Without an index every feature has to be read; keep the ones whose boxes intersect the window.
+            std::cout << "Warning: " << reader_->name() << " has no spatial index; reading all features." << std::endl;
+            read_all_features();
+            std::erase_if(features_,
+                          [&](const read_feature& entry)
+                          {
+                              const FlatGeobuf::Feature* const feature {FlatGeobuf::GetSizePrefixedFeature(entry.bytes.data())};
+                              const FlatGeobuf::Geometry* const geometry {feature->geometry()};
+                              geometry_processor::collect_rings(geometry, geometry_type_of(geometry), scratch_rings_);
+                              const bounding_box bbox {geometry_processor::bbox_of_rings(scratch_rings_)};
+                              return !bbox.is_valid || (bbox.max_x < window.min_x) || (bbox.min_x > window.max_x) ||
+                                     (bbox.max_y < window.min_y) || (bbox.min_y > window.max_y);
+                          });
+            return true;
+        }
+
+        const FlatGeobuf::NodeItem query_item {window.min_x, window.min_y, window.max_x, window.max_y, 0u};
+        const auto hits = FlatGeobuf::PackedRTree::streamSearch(
+            header_->features_count(), header_->index_node_size(), query_item,
+            [this](std::uint8_t* const buffer, const std::size_t offset, const std::size_t length) { read_index(buffer, offset, length); });
+
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> offsets {};
+        offsets.reserve(hits.size());
+        for (const auto& hit: hits)
+            offsets.emplace_back(hit.offset, hit.index);
+        std::sort(offsets.begin(), offsets.end());
+        read_features(offsets);
+        return true;
+    }
+
+    // Without a window, reads only the features from `offset` on; with one, jumps to the entry at `position`.
+    bool ranged_fgb_feature_source::seek(const std::uint64_t position, const std::uint64_t offset) noexcept(false)
+    {
+        if (!fetched_)
+        {
+            if ((features_offset_ + offset) > reader_->size())
+                return false;
+            read_all_features(offset, position);
+            return true;
+        }
+        if (position > (skipped_ + features_.size()))
+            return false;
+        next_feature_ = static_cast<std::size_t>(position - skipped_);
+        return true;
+    }
+
+    // Delivers the next read features.
+    bool ranged_fgb_feature_source::next_batch(feature_batch& batch, const std::size_t max_features) noexcept(false)
+    {
+        if (!fetched_)
+            read_all_features();
+        while ((next_feature_ == features_.size()) && !scan_done_)
+            read_window();
+        batch.reset(skipped_ + next_feature_, columns_.size());
+        const std::size_t end {std::min(features_.size(), next_feature_ + max_features)};
+        for (; next_feature_ < end; ++next_feature_)
+        {
+            const read_feature& entry {features_[next_feature_]};
+            batch.indices.push_back(entry.index);
+            const FlatGeobuf::Feature* const feature {FlatGeobuf::GetSizePrefixedFeature(entry.bytes.data())};
+            const FlatGeobuf::Geometry* const geometry {feature->geometry()};
+            geometry_processor::collect_rings(geometry, geometry_type_of(geometry), scratch_rings_);
+            batch.rings.insert(batch.rings.end(), scratch_rings_.begin(), scratch_rings_.end());
+            batch.ring_offsets.push_back(static_cast<std::uint32_t>(batch.rings.size()));
+            for (std::size_t c {}; c < columns_.size(); ++c)
+                batch.properties[c].push_back(columns_[c].has_value() ? feature_properties::get_string_value(feature, header_, *columns_[c])
+                                                                      : std::string {});
+            ++batch.size;
+        }
+        if (batch.size > 0u)
+        {
+            const read_feature& last {features_[next_feature_ - 1u]};
+            batch.end_offset = last.offset + last.bytes.size();
+        }
+        return batch.size > 0u;
+    }
+
+} // namespace kmx::gis
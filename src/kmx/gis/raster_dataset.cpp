@@ -0,0 +1,229 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file raster_dataset.cpp
+#include "kmx/gis/raster_dataset.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace kmx::gis
+{
+    // Trims surrounding whitespace.
+    static std::string_view trim(std::string_view text) noexcept
+    {
+        const auto is_space = [](const char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; };
+        while (!text.empty() && is_space(text.front()))
+            text.remove_prefix(1u);
+        while (!text.empty() && is_space(text.back()))
+            text.remove_suffix(1u);
+        return text;
+    }
+
+    // Parses a floating point number, ignoring surrounding whitespace.
+    static std::optional<double> parse_double(const std::string_view text) noexcept
+    {
+        const std::string_view trimmed {trim(text)};
+        double value {};
+        const auto [end, error] = std::from_chars(trimmed.data(), trimmed.data() + trimmed.size(), value);
+        if ((error != std::errc {}) || (end != trimmed.data() + trimmed.size()))
+            return std::nullopt;
+        return value;
+    }
+
+    // Returns the first of `candidates` that exists, or an empty string.
+    static std::string first_existing(const std::vector<std::string>& candidates) noexcept(false)
+    {
+        for (const std::string& candidate: candidates)
+            if (std::filesystem::exists(candidate))
+                return candidate;
+        return {};
+    }
+
+    // Sidecar paths: "<raster><extension>" and "<raster without its extension><extension>".
+    static std::vector<std::string> sidecar_paths(const std::string& raster_path, const std::vector<std::string_view>& extensions)
+    {
+        std::vector<std::string> paths {};
+        for (const std::string_view extension: extensions)
+        {
+            paths.push_back(raster_path + std::string {extension});
+            paths.push_back(std::filesystem::path {raster_path}.replace_extension(extension).string());
+        }
+        return paths;
+    }
+
+    std::size_t raster_dataset::size_of(const raster_data_type type) noexcept
+    {
+        switch (type)
+        {
+            case raster_data_type::uint8:
+                return 1u;
+            case raster_data_type::int16:
+            case raster_data_type::uint16:
+                return 2u;
+            case raster_data_type::int32:
+            case raster_data_type::uint32:
+            case raster_data_type::float32:
+                return 4u;
+            case raster_data_type::float64:
+            case raster_data_type::int64:
+            case raster_data_type::uint64:
+                return 8u;
+        }
+        return 0u;
+    }
+
+    raster_dataset::raster_dataset(const std::string& raster_path) noexcept(false):
+        file_ {raster_path}
+    {
+        if (!parse_header(raster_path))
+            parse_world_file(raster_path);
+    }
+
+    // Parses the ENVI header and sets layout, data type and (if present) the georeference.
+    bool raster_dataset::parse_header(const std::string& raster_path) noexcept(false)
+    {
+        const std::string header_path {first_existing(sidecar_paths(raster_path, {".hdr"}))};
+        if (header_path.empty())
+            throw std::runtime_error("No ENVI header (.hdr) found for raster: " + raster_path);
+
+        std::ifstream header_file {header_path};
+        std::stringstream buffer {};
+        buffer << header_file.rdbuf();
+        const std::string text {buffer.str()};
+        if (trim(text).substr(0u, 4u) != "ENVI")
+            throw std::runtime_error("Not an ENVI header: " + header_path);
+
+        // "key = value" entries; values in braces may span several lines
+        std::map<std::string, std::string, std::less<>> entries {};
+        for (std::size_t position {text.find('\n')}; position != std::string::npos && position < text.size();)
+        {
+            const std::size_t line_end {std::min(text.find('\n', position + 1u), text.size())};
+            const std::size_t equals {text.find('=', position + 1u)};
+            if ((equals == std::string::npos) || (equals > line_end))
+            {
+                position = line_end;
+                continue;
+            }
+
+            std::string key {trim(std::string_view {text}.substr(position + 1u, equals - position - 1u))};
+            std::transform(key.begin(), key.end(), key.begin(), [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            std::size_t value_end {line_end};
+            const std::string_view first_line {trim(std::string_view {text}.substr(equals + 1u, line_end - equals - 1u))};
+            if (!first_line.empty() && (first_line.front() == '{'))
+                value_end = std::min(text.find('}', equals), text.size());
+            std::string_view value {trim(std::string_view {text}.substr(equals + 1u, value_end - equals - 1u))};
+            if (!value.empty() && (value.front() == '{'))
+                value = trim(value.substr(1u));
+            entries[key] = std::string {value};
+            position = std::min(text.find('\n', value_end), text.size());
+        }
+
+        const auto number = [&](const std::string_view key) -> std::optional<double>
+        {
+            const auto it = entries.find(key);
+            return (it != entries.end()) ? parse_double(it->second) : std::nullopt;
+        };
+
+        const std::optional<double> samples {number("samples")};
+        const std::optional<double> lines {number("lines")};
+        const std::optional<double> type_code {number("data type")};
+        if (!samples || !lines || !type_code || (*samples < 1.0) || (*lines < 1.0) || (*samples > 4294967295.0) ||
+            (*lines > 4294967295.0))
+            throw std::runtime_error("ENVI header lacks valid samples/lines/data type: " + header_path);
+
+        data_type_ = static_cast<raster_data_type>(static_cast<std::uint8_t>(*type_code));
+        const std::size_t value_size {size_of(data_type_)};
+        if (value_size == 0u)
+            throw std::runtime_error("Unsupported ENVI data type " + entries["data type"] + " in " + header_path);
+
+        const auto bands = static_cast<std::size_t>(number("bands").value_or(1.0));
+        const auto offset = static_cast<std::size_t>(number("header offset").value_or(0.0));
+        big_endian_ = number("byte order").value_or(0.0) == 1.0;
+        no_data_ = number("data ignore value");
+
+        grid_.cols = static_cast<std::uint32_t>(*samples);
+        grid_.rows = static_cast<std::uint32_t>(*lines);
+        std::string interleave {entries.contains("interleave") ? entries["interleave"] : "bsq"};
+        std::transform(interleave.begin(), interleave.end(), interleave.begin(),
+                       [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (interleave == "bip")
+        {
+            pixel_stride_ = bands * value_size;
+            row_stride_ = grid_.cols * pixel_stride_;
+        }
+        else if ((interleave == "bil") || (interleave == "bsq"))
+        {
+            pixel_stride_ = value_size;
+            row_stride_ = grid_.cols * value_size * ((interleave == "bil") ? bands : 1u);
+        }
+        else
+            throw std::runtime_error("Unsupported ENVI interleave '" + interleave + "' in " + header_path);
+
+        const std::size_t band_bytes {static_cast<std::size_t>(grid_.rows - 1u) * row_stride_ +
+                                      static_cast<std::size_t>(grid_.cols - 1u) * pixel_stride_ + value_size};
+        if ((file_.size() < offset) || (file_.size() - offset < band_bytes))
+            throw std::runtime_error("Raster file is smaller than its ENVI header describes: " + raster_path);
+        pixels_ = file_.data() + offset;
+
+        // map info = {projection, reference pixel x, reference pixel y, easting, northing, pixel width, pixel height, ...}
+        const auto map_info = entries.find("map info");
+        if (map_info == entries.end())
+            return false;
+
+        std::vector<double> values {};
+        std::string_view rest {map_info->second};
+        for (std::size_t index {}; !rest.empty(); ++index)
+        {
+            const std::size_t comma {rest.find(',')};
+            const std::string_view item {rest.substr(0u, comma)};
+            rest = (comma == std::string_view::npos) ? std::string_view {} : rest.substr(comma + 1u);
+            if ((index >= 1u) && (index <= 6u))
+            {
+                const std::optional<double> value {parse_double(item)};
+                if (!value)
+                    throw std::runtime_error("Invalid ENVI map info in " + header_path);
+                values.push_back(*value);
+            }
+        }
+        if ((values.size() != 6u) || !(values[4] > 0.0) || !(values[5] > 0.0))
+            throw std::runtime_error("Invalid ENVI map info in " + header_path);
+
+        // The reference pixel is 1-based and its corner is at (1.0, 1.0)
+        grid_.cell_width = values[4];
+        grid_.cell_height = -values[5];
+        grid_.origin_x = values[2] - (values[0] - 1.0) * values[4];
+        grid_.origin_y = values[3] + (values[1] - 1.0) * values[5];
+        return true;
+    }
+
+    // Reads the georeference from a world file: pixel width, two rotation terms, negative pixel height and the centre of
+    // the upper-left pixel.
+    void raster_dataset::parse_world_file(const std::string& raster_path) noexcept(false)
+    {
+        const std::string world_path {first_existing(sidecar_paths(raster_path, {".wld", ".tfw"}))};
+        if (world_path.empty())
+            throw std::runtime_error("No georeference (ENVI map info or world file) found for raster: " + raster_path);
+
+        std::ifstream world_file {world_path};
+        std::vector<double> values {};
+        for (std::string line {}; (values.size() < 6u) && std::getline(world_file, line);)
+            if (const std::optional<double> value {parse_double(line)}; value.has_value())
+                values.push_back(*value);
+            else if (!trim(line).empty())
+                break;
+        if ((values.size() != 6u) || !(values[0] > 0.0) || (values[1] != 0.0) || (values[2] != 0.0) || (values[3] == 0.0))
+            throw std::runtime_error("Invalid or rotated world file: " + world_path);
+
+        grid_.cell_width = values[0];
+        grid_.cell_height = values[3];
+        grid_.origin_x = values[4] - values[0] / 2.0;
+        grid_.origin_y = values[5] - values[3] / 2.0;
+    }
+
+} // namespace kmx::gis
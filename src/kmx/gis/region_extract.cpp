@@ -0,0 +1,217 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file region_extract.cpp
+#include "kmx/gis/region_extract.hpp"
+#include "kmx/gis/feature_properties.hpp"
+#include "kmx/gis/fgb_writer.hpp"
+#include "kmx/gis/geometry_processor.hpp"
+#include "kmx/gis/ring_clipper.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+
+namespace kmx::gis
+{
+    /// @brief A ring vertex during clipping.
+    struct clip_point
+    {
+        double x;
+        double y;
+    };
+
+    struct region_extract::clip_scratch
+    {
+        flatbuffers::FlatBufferBuilder fbb {};
+        std::vector<ring_view> rings {};
+        ring_clipper<clip_point> clipper {};
+        clipped_polygons<clip_point> clipped {};
+        std::vector<double> xy {};
+        std::vector<std::uint32_t> ends {};
+        std::vector<flatbuffers::Offset<FlatGeobuf::Geometry>> parts {};
+    };
+
+    region_extract::region_extract(const std::string& input_fgb_path, const std::string& output_fgb_path, const std::uint32_t num_threads,
+                                   const bounding_box& window) noexcept(false):
+        output_fgb_path_ {output_fgb_path},
+        window_ {window},
+        thread_pool_ {num_threads},
+        dataset_ {input_fgb_path}
+    {
+        std::cout << "Thread pool initialized with " << num_threads << " threads.\n";
+    }
+
+    bounding_box region_extract::clip_feature(const std::uint64_t index, const bool multi_output, clip_scratch& scratch,
+                                              std::vector<std::uint8_t>& out_bytes, bool& needs_multi) const noexcept(false)
+    {
+        const FlatGeobuf::Feature* const feature {dataset_.feature(index)};
+        const FlatGeobuf::GeometryType type {dataset_.geometry_type_of(feature->geometry())};
+        geometry_processor::collect_rings(feature->geometry(), type, scratch.rings);
+
+        // Every polygon of the feature is clipped on its own; one may fall apart into several
+        scratch.clipper.set_rectangle(window_.min_x, window_.min_y, window_.max_x, window_.max_y);
+        scratch.clipped.clear();
+        bool polygon_open {};
+        for (const ring_view& source: scratch.rings)
+        {
+            if (source.is_exterior)
+            {
+                if (polygon_open)
+                    scratch.clipper.clip_polygon(scratch.clipped);
+                scratch.clipper.begin_polygon();
+                polygon_open = true;
+            }
+            for (std::uint32_t p {}; p < source.point_count; ++p)
+                scratch.clipper.add_point(source.x(p), source.y(p));
+            scratch.clipper.end_ring();
+        }
+        if (polygon_open)
+            scratch.clipper.clip_polygon(scratch.clipped);
+
+        out_bytes.clear();
+        const std::size_t polygon_count {scratch.clipped.polygon_count()};
+        if (polygon_count == 0u)
+            return {};
+        // Features of mixed-type files carry their own type
+        const bool mixed {dataset_.geometry_type() == FlatGeobuf::GeometryType::Unknown};
+        const bool multi {multi_output || (mixed && ((type == FlatGeobuf::GeometryType::MultiPolygon) || (polygon_count > 1u)))};
+        if (!multi && (polygon_count > 1u))
+        {
+            needs_multi = true;
+            return {};
+        }
+
+        flatbuffers::FlatBufferBuilder& fbb {scratch.fbb};
+        fbb.Clear();
+        scratch.parts.clear();
+        bounding_box bbox {};
+        // Single-ring polygons omit `ends`, as GDAL does
+        const auto make_polygon = [&](const FlatGeobuf::GeometryType stored_type)
+        {
+            flatbuffers::Offset<flatbuffers::Vector<std::uint32_t>> ends {};
+            if (scratch.ends.size() > 1u)
+                ends = fbb.CreateVector(scratch.ends);
+            const auto xy = fbb.CreateVector(scratch.xy);
+            return FlatGeobuf::CreateGeometry(fbb, ends, xy, 0, 0, 0, 0, stored_type);
+        };
+        FlatGeobuf::GeometryType stored_type {FlatGeobuf::GeometryType::Unknown};
+        if (mixed)
+            stored_type = multi ? FlatGeobuf::GeometryType::MultiPolygon : FlatGeobuf::GeometryType::Polygon;
+        for (std::size_t polygon {}; polygon < polygon_count; ++polygon)
+        {
+            scratch.xy.clear();
+            scratch.ends.clear();
+            for (std::size_t r {scratch.clipped.first_ring(polygon)}; r < scratch.clipped.polygon_ends[polygon]; ++r)
+            {
+                // Rings are written closed
+                const std::span<const clip_point> ring {scratch.clipped.ring(r)};
+                for (const clip_point& p: ring)
+                {
+                    scratch.xy.push_back(p.x);
+                    scratch.xy.push_back(p.y);
+                    bbox.update(p.x, p.y);
+                }
+                scratch.xy.push_back(ring.front().x);
+                scratch.xy.push_back(ring.front().y);
+                scratch.ends.push_back(static_cast<std::uint32_t>(scratch.xy.size() / 2u));
+            }
+            if (multi)
+                scratch.parts.push_back(make_polygon(FlatGeobuf::GeometryType::Polygon));
+        }
+
+        flatbuffers::Offset<FlatGeobuf::Geometry> geometry {};
+        if (multi)
+        {
+            const auto parts = fbb.CreateVector(scratch.parts);
+            geometry = FlatGeobuf::CreateGeometry(fbb, 0, 0, 0, 0, 0, 0, stored_type, parts);
+        }
+        else
+            geometry = make_polygon(stored_type);
+
+        const flatbuffers::Vector<std::uint8_t>* const properties {feature->properties()};
+        flatbuffers::Offset<flatbuffers::Vector<std::uint8_t>> properties_offset {};
+        if (properties != nullptr)
+            properties_offset = fbb.CreateVector(properties->data(), properties->size());
+        const auto columns = fgb_writer::copy_columns(fbb, feature->columns());
+        fbb.FinishSizePrefixed(FlatGeobuf::CreateFeature(fbb, geometry, properties_offset, columns));
+        out_bytes.assign(fbb.GetBufferPointer(), fbb.GetBufferPointer() + fbb.GetSize());
+        return bbox;
+    }
+
+    bool region_extract::clip_candidates(const std::span<const std::uint64_t> candidates, const bool multi_output,
+                                         std::vector<fgb_feature_entry>& entries,
+                                         std::vector<std::vector<std::uint8_t>>& clipped_bytes) noexcept(false)
+    {
+        // Features of a promoted file are all re-encoded as MultiPolygons
+        const bool copy_inside {multi_output == (dataset_.geometry_type() == FgbGeometryType::MultiPolygon)};
+        std::atomic<bool> needs_multi {};
+        const std::size_t chunk_size {std::max<std::size_t>(1u, candidates.size() / (thread_pool_.size() * 8u + 1u))};
+        thread_pool_.parallel_for(candidates.size(), chunk_size,
+                                  [&](const std::size_t begin, const std::size_t end)
+                                  {
+                                      clip_scratch scratch {};
+                                      bool split {};
+                                      const std::size_t ahead {dataset_.prefetch_distance()};
+                                      for (std::size_t k {begin}; k < end; ++k)
+                                      {
+                                          if ((k + ahead) < end)
+                                              dataset_.prefetch_feature(candidates[k + ahead]);
+                                          const std::uint64_t i {candidates[k]};
+                                          const bounding_box bbox {dataset_.feature_bbox(i)};
+                                          // Features inside the window are copied verbatim
+                                          if (copy_inside && (bbox.min_x >= window_.min_x) && (bbox.max_x <= window_.max_x) &&
+                                              (bbox.min_y >= window_.min_y) && (bbox.max_y <= window_.max_y))
+                                              entries[k] = {dataset_.feature_bytes(i), bbox};
+                                          else
+                                          {
+                                              const bounding_box box {clip_feature(i, multi_output, scratch, clipped_bytes[k], split)};
+                                              entries[k] = {clipped_bytes[k], box};
+                                          }
+                                      }
+                                      if (split)
+                                          needs_multi = true;
+                                  });
+        return needs_multi;
+    }
+
+    bool region_extract::extract() noexcept(false)
+    {
+        const FgbGeometryType header_geom_type {dataset_.geometry_type()};
+        if ((header_geom_type != FgbGeometryType::Polygon) && (header_geom_type != FgbGeometryType::MultiPolygon))
+        {
+            std::cerr << "Error: Region extract requires Polygon/MultiPolygon FGB files. Found: "
+                      << FlatGeobuf::EnumNameGeometryType(header_geom_type) << std::endl;
+            return false;
+        }
+        if (dataset_.coordinate_stride() != 2u)
+        {
+            std::cerr << "Error: Region extract supports XY geometries only (the input has Z or M values)." << std::endl;
+            return false;
+        }
+        if (!dataset_.has_index())
+            std::cout << "Warning: The input has no spatial index; candidates are found by a linear scan." << std::endl;
+
+        const std::vector<std::uint64_t> candidates {dataset_.search(window_)};
+        std::vector<std::vector<std::uint8_t>> clipped_bytes(candidates.size());
+        std::vector<fgb_feature_entry> entries(candidates.size());
+        // A Polygon file becomes a MultiPolygon one if the window cuts one of its polygons into pieces
+        bool multi_output {header_geom_type == FgbGeometryType::MultiPolygon};
+        if (clip_candidates(candidates, multi_output, entries, clipped_bytes))
+        {
+            std::cout << "The window splits polygons into pieces; writing MultiPolygon features." << std::endl;
+            multi_output = true;
+            clip_candidates(candidates, multi_output, entries, clipped_bytes);
+        }
+
+        const std::size_t clipped_count {static_cast<std::size_t>(
+            std::count_if(clipped_bytes.begin(), clipped_bytes.end(), [](const auto& bytes) { return !bytes.empty(); }))};
+        std::erase_if(entries, [](const fgb_feature_entry& entry) { return entry.bytes.empty(); });
+        std::cout << "Found " << candidates.size() << " candidate features; writing " << entries.size() << " ("
+                  << entries.size() - clipped_count << " copied, " << clipped_count << " clipped)." << std::endl;
+
+        const fgb_writer writer {dataset_.header(), 16u, multi_output ? std::optional {FgbGeometryType::MultiPolygon} : std::nullopt};
+        if (!writer.write(output_fgb_path_, entries))
+            return false;
+        std::cout << "Output written to: " << output_fgb_path_ << std::endl;
+        return true;
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,391 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file result_sorter.cpp
+#include "kmx/gis/result_sorter.hpp"
+#include "kmx/gis/buffered_file.hpp"
+#include "kmx/gis/csv_format.hpp"
+#include "kmx/gis/tournament_tree.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+namespace kmx::gis
+{
+    namespace
+    {
+        /// @brief Appends `value` big-endian, so that the bytes compare like the number.
+        template <class T>
+        void append_big_endian(std::string& key, const T value)
+        {
+            for (std::size_t shift {sizeof(T) * 8u}; shift > 0u; shift -= 8u)
+                key.push_back(static_cast<char>(static_cast<std::uint8_t>(value >> (shift - 8u))));
+        }
+
+        /// @brief Maps a double to an unsigned integer of the same order (negative values flipped, positive ones
+        /// shifted above them).
+        std::uint64_t ordered_bits(const double value) noexcept
+        {
+            const std::uint64_t bits {std::bit_cast<std::uint64_t>(value)};
+            return ((bits >> 63u) != 0u) ? ~bits : (bits | (1ull << 63u));
+        }
+
+        /// @brief A letter of the Romanian alphabet spelled with two UTF-8 bytes, and its place in the alphabet.
+        struct collation_letter
+        {
+            std::uint8_t lead;         /// First UTF-8 byte.
+            std::uint8_t trail;        /// Second UTF-8 byte.
+            std::uint8_t after;        /// The ASCII letter it follows.
+        };
+
+        /// @brief ă â î ș ț in both cases, including the cedilla forms ş ţ found in older data.
+        constexpr std::array<collation_letter, 14u> romanian_letters {{
+            {0xC4u, 0x83u, 'a'}, {0xC4u, 0x82u, 'a'}, // ă Ă
+            {0xC3u, 0xA2u, 'a'}, {0xC3u, 0x82u, 'a'}, // â Â
+            {0xC3u, 0xAEu, 'i'}, {0xC3u, 0x8Eu, 'i'}, // î Î
+            {0xC8u, 0x99u, 's'}, {0xC8u, 0x98u, 's'}, // ș Ș
+            {0xC5u, 0x9Fu, 's'}, {0xC5u, 0x9Eu, 's'}, // ş Ş
+            {0xC8u, 0x9Bu, 't'}, {0xC8u, 0x9Au, 't'}, // ț Ț
+            {0xC5u, 0xA3u, 't'}, {0xC5u, 0xA2u, 't'}, // ţ Ţ
+        }};
+
+        /// @brief Appends the collation weights of a name: letters case-insensitively in Romanian alphabet order
+        /// (a < ă < â < b, i < î < j, s < ș < t < ț < u), after digits and punctuation, unknown characters last; then
+        /// the raw bytes, so that names differing only in case or spelling still order deterministically.
+        void append_collation_key(std::string& key, const std::string_view name)
+        {
+            // Three weights per ASCII letter leave room for the two letters that may follow it.
+            const auto letter_weight = [](const char letter, const std::uint8_t rank)
+            { return static_cast<char>(0x80u + (letter - 'a') * 3u + rank); };
+
+            for (std::size_t i {}; i < name.size(); ++i)
+            {
+                const auto byte = static_cast<std::uint8_t>(name[i]);
+                if (byte < 0x80u)
+                {
+                    const char lower {static_cast<char>(((byte >= 'A') && (byte <= 'Z')) ? (byte + ('a' - 'A')) : byte)};
+                    if ((lower >= 'a') && (lower <= 'z'))
+                        key.push_back(letter_weight(lower, 0u));
+                    else
+                        key.push_back(static_cast<char>(std::max<std::uint8_t>(byte, 1u))); // 0 ends the field
+                    continue;
+                }
+                const auto letter = std::find_if(romanian_letters.begin(), romanian_letters.end(),
+                                                 [&](const collation_letter& l)
+                                                 {
+                                                     return ((i + 1u) < name.size()) && (l.lead == byte) &&
+                                                            (l.trail == static_cast<std::uint8_t>(name[i + 1u]));
+                                                 });
+                if (letter == romanian_letters.end())
+                {
+                    key.push_back(static_cast<char>(0xFFu));
+                    key.push_back(static_cast<char>(byte));
+                    continue;
+                }
+                // â follows ă, the other letters follow their base letter directly.
+                const bool circumflex_a {(letter->after == 'a') && (letter->lead == 0xC3u)};
+                key.push_back(letter_weight(letter->after, circumflex_a ? 2u : 1u));
+                ++i;
+            }
+            key.push_back('\0');
+            for (const char c: name)
+                key.push_back((c == '\0') ? '\1' : c);
+            key.push_back('\0');
+        }
+
+        /// @brief Appends a length-prefixed string to a run record.
+        void append_string(std::string& record, const std::string_view text)
+        {
+            append_big_endian(record, static_cast<std::uint32_t>(text.size()));
+            record.append(text);
+        }
+
+        /// @brief Reads a big-endian integer from a run record.
+        template <class T>
+        T read_big_endian(const std::uint8_t* const bytes) noexcept
+        {
+            T value {};
+            for (std::size_t i {}; i < sizeof(T); ++i)
+                value = static_cast<T>((value << 8u) | bytes[i]);
+            return value;
+        }
+    } // namespace
+
+    std::optional<result_sort_spec> result_sort_spec::parse(const std::string_view text) noexcept(false)
+    {
+        result_sort_spec spec {};
+        for (std::size_t start {}; start <= text.size();)
+        {
+            const std::size_t comma {std::min(text.find(',', start), text.size())};
+            const std::string_view name {text.substr(start, comma - start)};
+            if ((name == "name") || (name == "uat_name"))
+                spec.fields.push_back(result_sort_field::name);
+            else if ((name == "uat_code") || (name == "code"))
+                spec.fields.push_back(result_sort_field::uat_code);
+            else if ((name == "county") || (name == "county_code_mn"))
+                spec.fields.push_back(result_sort_field::county);
+            else if ((name == "area") || (name == "bbox_area_km2"))
+                spec.fields.push_back(result_sort_field::area);
+            else
+                return std::nullopt;
+            start = comma + 1u;
+        }
+        return spec;
+    }
+
+    result_sorter::result_sorter(result_sort_spec spec, thread_pool& pool, const std::uint64_t memory_budget,
+                                 std::string run_path_prefix) noexcept(false):
+        spec_ {std::move(spec)},
+        pool_ {pool},
+        memory_budget_ {memory_budget},
+        run_path_prefix_ {std::move(run_path_prefix)}
+    {
+        if (spec_.fields.size() == 1u)
+        {
+            if (spec_.fields.front() == result_sort_field::uat_code)
+                numeric_key_size_ = sizeof(std::uint32_t);
+            else if (spec_.fields.front() == result_sort_field::area)
+                numeric_key_size_ = sizeof(std::uint64_t);
+        }
+    }
+
+    result_sorter::~result_sorter() noexcept
+    {
+        for (const std::string& path: run_paths_)
+            std::remove(path.c_str());
+    }
+
+    // Fields in order, then the input position, which makes every key unique and the sort stable.
+    void result_sorter::encode_key(const task_result& result, const std::uint64_t position, std::string& key) const noexcept(false)
+    {
+        for (const result_sort_field field: spec_.fields)
+            switch (field)
+            {
+                case result_sort_field::name:
+                    append_collation_key(key, result.uat_name);
+                    break;
+                case result_sort_field::uat_code:
+                    append_big_endian(key, result.uat_code);
+                    break;
+                case result_sort_field::county:
+                    key.append(result.county_mn.code, 2u);
+                    break;
+                case result_sort_field::area:
+                {
+                    const bounding_box& bbox {result.bbox};
+                    const std::uint64_t bits {bbox.is_valid ? ordered_bits((bbox.max_x - bbox.min_x) * (bbox.max_y - bbox.min_y))
+                                                            : ~std::uint64_t {}};
+                    append_big_endian(key, bits);
+                    break;
+                }
+            }
+        append_big_endian(key, position);
+    }
+
+    void result_sorter::add(task_result&& result) noexcept(false)
+    {
+        entry& added {buffer_.emplace_back()};
+        encode_key(result, next_position_++, added.key);
+        added.result = std::move(result);
+        buffered_bytes_ += sizeof(entry) + added.key.capacity() + added.result.uat_name.capacity();
+        if (buffered_bytes_ >= memory_budget_)
+            spill();
+    }
+
+    // LSD radix sort by the numeric prefix of the keys, one byte per pass; passes whose byte is the same for the whole
+    // slice are skipped. Being stable, it keeps the input order of equal values.
+    void result_sorter::radix_sort(std::uint32_t* const begin, std::uint32_t* const end) const noexcept(false)
+    {
+        const std::size_t count {static_cast<std::size_t>(end - begin)};
+        std::vector<std::uint32_t> scratch(count);
+        std::uint32_t* source {begin};
+        std::uint32_t* target {scratch.data()};
+        for (std::size_t byte {numeric_key_size_}; byte > 0u; --byte)
+        {
+            std::array<std::size_t, 257u> offsets {};
+            for (std::size_t i {}; i < count; ++i)
+                ++offsets[static_cast<std::uint8_t>(buffer_[source[i]].key[byte - 1u]) + 1u];
+            if (std::find(offsets.begin() + 1, offsets.end(), count) != offsets.end())
+                continue;
+            for (std::size_t d {1u}; d < offsets.size(); ++d)
+                offsets[d] += offsets[d - 1u];
+            for (std::size_t i {}; i < count; ++i)
+                target[offsets[static_cast<std::uint8_t>(buffer_[source[i]].key[byte - 1u])]++] = source[i];
+            std::swap(source, target);
+        }
+        if (source != begin)
+            std::copy(source, source + count, begin);
+    }
+
+    // Sorts slices in parallel and merges them through a tournament tree.
+    std::vector<std::uint32_t> result_sorter::sort_buffer() noexcept(false)
+    {
+        std::vector<std::uint32_t> order(buffer_.size());
+        for (std::size_t i {}; i < order.size(); ++i)
+            order[i] = static_cast<std::uint32_t>(i);
+
+        const std::size_t slice_count {std::clamp<std::size_t>(order.size() / min_slice_size_, 1u, pool_.size())};
+        const std::size_t slice_size {(order.size() + slice_count - 1u) / slice_count};
+        const auto key_less = [this](const std::uint32_t a, const std::uint32_t b) { return buffer_[a].key < buffer_[b].key; };
+        pool_.parallel_for(slice_count, 1u,
+                           [&](const std::size_t first, const std::size_t last)
+                           {
+                               for (std::size_t s {first}; s < last; ++s)
+                               {
+                                   std::uint32_t* const begin {order.data() + std::min(s * slice_size, order.size())};
+                                   std::uint32_t* const end {order.data() + std::min((s + 1u) * slice_size, order.size())};
+                                   if (numeric_key_size_ > 0u)
+                                       radix_sort(begin, end);
+                                   else
+                                       std::sort(begin, end, key_less);
+                               }
+                           });
+        if (slice_count == 1u)
+            return order;
+
+        std::vector<std::size_t> heads(slice_count);
+        for (std::size_t s {}; s < slice_count; ++s)
+            heads[s] = std::min(s * slice_size, order.size());
+        const auto slice_end = [&](const std::size_t s) { return std::min((s + 1u) * slice_size, order.size()); };
+        const auto less = [&](const std::size_t a, const std::size_t b)
+        {
+            const bool a_done {heads[a] == slice_end(a)}, b_done {heads[b] == slice_end(b)};
+            if (a_done || b_done)
+                return !a_done && b_done;
+            return key_less(order[heads[a]], order[heads[b]]);
+        };
+        tournament_tree<decltype(less)> tree {slice_count, less};
+        std::vector<std::uint32_t> merged {};
+        merged.reserve(order.size());
+        while (merged.size() < order.size())
+        {
+            const std::size_t winner {tree.winner()};
+            merged.push_back(order[heads[winner]++]);
+            tree.replay(winner);
+        }
+        return merged;
+    }
+
+    // Run record: key, name, code, county, validity and the four coordinates.
+    void result_sorter::spill() noexcept(false)
+    {
+        const std::string path {run_path_prefix_ + '.' + std::to_string(run_paths_.size())};
+        run_paths_.push_back(path);
+        buffered_file_writer run {path, max_buffer_size_};
+        std::string record {};
+        for (const std::uint32_t index: sort_buffer())
+        {
+            const entry& e {buffer_[index]};
+            record.clear();
+            append_string(record, e.key);
+            append_string(record, e.result.uat_name);
+            append_big_endian(record, e.result.uat_code);
+            record.append(e.result.county_mn.code, 2u);
+            record.push_back(e.result.bbox.is_valid ? '\1' : '\0');
+            for (const double value: {e.result.bbox.min_x, e.result.bbox.min_y, e.result.bbox.max_x, e.result.bbox.max_y})
+                append_big_endian(record, std::bit_cast<std::uint64_t>(value));
+            append_big_endian(record, static_cast<std::uint32_t>(record.size()));
+            run.write(std::string_view {record}.substr(record.size() - sizeof(std::uint32_t)));
+            run.write(std::string_view {record}.substr(0u, record.size() - sizeof(std::uint32_t)));
+        }
+        run.close();
+        std::cout << "\nSpilled sorted run " << run_paths_.size() << " (" << buffer_.size() << " results, " << run.size() << " bytes)."
+                  << std::endl;
+        buffer_ = {};
+        buffered_bytes_ = 0u;
+    }
+
+    void result_sorter::write(std::ostream& out) noexcept(false)
+    {
+        if (run_paths_.empty())
+        {
+            for (const std::uint32_t index: sort_buffer())
+            {
+                const task_result& result {buffer_[index].result};
+                csv_format::write_bbox_row(out, result.uat_name, result.uat_code, result.county_mn, result.bbox);
+            }
+            buffer_ = {};
+            return;
+        }
+        if (!buffer_.empty())
+            spill();
+        merge_runs(out);
+    }
+
+    // One sequential pass over every run; only the head record of each is decoded.
+    void result_sorter::merge_runs(std::ostream& out) noexcept(false)
+    {
+        /// @brief The head record of one run.
+        struct cursor
+        {
+            std::unique_ptr<buffered_file_reader> reader {};
+            std::vector<std::uint8_t> record {};
+            std::string_view key {};
+            bool done {};
+        };
+
+        const std::size_t buffer_size {
+            std::clamp<std::size_t>(static_cast<std::size_t>(memory_budget_ / run_paths_.size()), min_buffer_size_, max_buffer_size_)};
+        std::vector<cursor> cursors(run_paths_.size());
+        const auto advance = [&](cursor& c)
+        {
+            std::array<std::uint8_t, sizeof(std::uint32_t)> size {};
+            if (!c.reader->read_exact(size))
+            {
+                c.done = true;
+                return;
+            }
+            c.record.resize(read_big_endian<std::uint32_t>(size.data()));
+            if (!c.reader->read_exact(c.record))
+                throw std::runtime_error("Sorted run is truncated: " + c.reader->path());
+            c.key = {reinterpret_cast<const char*>(c.record.data()) + sizeof(std::uint32_t),
+                     read_big_endian<std::uint32_t>(c.record.data())};
+        };
+        for (std::size_t r {}; r < cursors.size(); ++r)
+        {
+            cursors[r].reader = std::make_unique<buffered_file_reader>(run_paths_[r], buffer_size);
+            advance(cursors[r]);
+        }
+
+        const auto less = [&](const std::size_t a, const std::size_t b)
+        {
+            if (cursors[a].done || cursors[b].done)
+                return !cursors[a].done && cursors[b].done;
+            return cursors[a].key < cursors[b].key;
+        };
+        tournament_tree<decltype(less)> tree {cursors.size(), less};
+        task_result result {};
+        for (;;)
+        {
+            const std::size_t winner {tree.winner()};
+            cursor& head {cursors[winner]};
+            if (head.done)
+                break;
+            const std::uint8_t* bytes {head.record.data() + sizeof(std::uint32_t) + head.key.size()};
+            const std::uint32_t name_size {read_big_endian<std::uint32_t>(bytes)};
+            result.uat_name.assign(reinterpret_cast<const char*>(bytes) + sizeof(std::uint32_t), name_size);
+            bytes += sizeof(std::uint32_t) + name_size;
+            result.uat_code = read_big_endian<std::uint32_t>(bytes);
+            bytes += sizeof(std::uint32_t);
+            std::memcpy(result.county_mn.code, bytes, 2u);
+            result.bbox.is_valid = bytes[2] != 0u;
+            bytes += 3u;
+            for (double* const value: {&result.bbox.min_x, &result.bbox.min_y, &result.bbox.max_x, &result.bbox.max_y})
+            {
+                *value = std::bit_cast<double>(read_big_endian<std::uint64_t>(bytes));
+                bytes += sizeof(std::uint64_t);
+            }
+            csv_format::write_bbox_row(out, result.uat_name, result.uat_code, result.county_mn, result.bbox);
+            advance(head);
+            tree.replay(winner);
+        }
+        std::cout << "Merged " << run_paths_.size() << " sorted runs." << std::endl;
+        for (const std::string& path: run_paths_)
+            std::remove(path.c_str());
+        run_paths_.clear();
+    }
+
+} // namespace kmx::gis
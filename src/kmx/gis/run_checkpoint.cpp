@@ -0,0 +1,99 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file run_checkpoint.cpp
+#include "kmx/gis/run_checkpoint.hpp"
+#include <array>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <stdexcept>
+
+namespace kmx::gis
+{
+    // Shortest round-trip representation of the four coordinates.
+    std::string run_checkpoint::format_window(const bounding_box& window) noexcept(false)
+    {
+        if (!window.is_valid)
+            return "none";
+        std::string text {};
+        for (const double value: {window.min_x, window.min_y, window.max_x, window.max_y})
+        {
+            std::array<char, 32u> digits {};
+            const auto [end, error] = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+            if (!text.empty())
+                text += ',';
+            text.append(digits.data(), end);
+        }
+        return text;
+    }
+
+    // Writes the checkpoint next to `path` and renames it over `path`, which replaces the old one atomically.
+    void run_checkpoint::write(const std::string& path) const noexcept(false)
+    {
+        const std::string temporary_path {path + ".tmp"};
+        {
+            std::ofstream file {temporary_path, std::ios::trunc};
+            file << signature_ << '\n'
+                 << "input=" << input << '\n'
+                 << "input_size=" << input_size << '\n'
+                 << "shard=" << shard.index << '/' << shard.count << '\n'
+                 << "window=" << window << '\n'
+                 << "features=" << features << '\n'
+                 << "input_offset=" << input_offset << '\n'
+                 << "output_offset=" << output_offset << '\n';
+            if (!file.flush())
+                throw std::runtime_error("Cannot write checkpoint: " + temporary_path);
+        }
+        std::filesystem::rename(temporary_path, path);
+    }
+
+    // Reads a checkpoint written by `write`.
+    run_checkpoint run_checkpoint::read(const std::string& path) noexcept(false)
+    {
+        std::ifstream file {path};
+        std::string line {};
+        if (!std::getline(file, line) || (line != signature_))
+            throw std::runtime_error("Not a checkpoint: " + path);
+
+        std::map<std::string, std::string, std::less<>> values {};
+        while (std::getline(file, line))
+            if (const std::size_t equals {line.find('=')}; equals != std::string::npos)
+                values[line.substr(0u, equals)] = line.substr(equals + 1u);
+
+        const auto text = [&](const std::string_view key) -> const std::string&
+        {
+            const auto it = values.find(key);
+            if (it == values.end())
+                throw std::runtime_error("Checkpoint " + path + " lacks '" + std::string {key} + "'");
+            return it->second;
+        };
+        const auto number = [&](const std::string_view key)
+        {
+            const std::string& value {text(key)};
+            std::uint64_t result {};
+            const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+            if (value.empty() || (error != std::errc {}) || (end != value.data() + value.size()))
+                throw std::runtime_error("Checkpoint " + path + " has an invalid '" + std::string {key} + "': " + value);
+            return result;
+        };
+
+        run_checkpoint checkpoint {};
+        checkpoint.input = text("input");
+        checkpoint.input_size = number("input_size");
+        // Unsharded runs record "0/0", which `shard_spec::parse` rejects.
+        if (text("shard") != "0/0")
+        {
+            const std::optional<shard_spec> shard {shard_spec::parse(text("shard"))};
+            if (!shard.has_value())
+                throw std::runtime_error("Checkpoint " + path + " has an invalid 'shard': " + text("shard"));
+            checkpoint.shard = *shard;
+        }
+        checkpoint.window = text("window");
+        checkpoint.features = number("features");
+        checkpoint.input_offset = number("input_offset");
+        checkpoint.output_offset = number("output_offset");
+        return checkpoint;
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,69 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file segment_index.cpp
+#include "kmx/gis/segment_index.hpp"
+#include <cmath>
+
+namespace kmx::gis
+{
+    std::uint32_t segment_index::band_of(const double y) const noexcept
+    {
+        const double band {std::floor((y - min_y_) / band_height_)};
+        return static_cast<std::uint32_t>(std::clamp(band, 0.0, static_cast<double>(band_offsets_.size() - 2u)));
+    }
+
+    void segment_index::build() noexcept(false)
+    {
+        min_x_ = min_y_ = max_x_ = max_y_ = 0.0;
+        band_offsets_.assign(2u, 0u);
+        band_segments_.clear();
+        if (segments_.empty())
+            return;
+
+        min_x_ = max_x_ = segments_.front().x0;
+        min_y_ = max_y_ = segments_.front().y0;
+        for (const line_segment& s: segments_)
+        {
+            min_x_ = std::min({min_x_, s.x0, s.x1});
+            max_x_ = std::max({max_x_, s.x0, s.x1});
+            min_y_ = std::min({min_y_, s.y0, s.y1});
+            max_y_ = std::max({max_y_, s.y0, s.y1});
+        }
+
+        // About 16 segments per band keeps both the index and the per-query scans small
+        const auto band_count = static_cast<std::uint32_t>(std::clamp<std::size_t>(segments_.size() / 16u, 1u, 4096u));
+        band_height_ = (max_y_ > min_y_) ? (max_y_ - min_y_) / band_count : 1.0;
+        band_offsets_.assign(band_count + 1u, 0u);
+        for (const line_segment& s: segments_)
+            for (std::uint32_t b {band_of(std::min(s.y0, s.y1))}, last {band_of(std::max(s.y0, s.y1))}; b <= last; ++b)
+                ++band_offsets_[b + 1u];
+        for (std::uint32_t b {}; b < band_count; ++b)
+            band_offsets_[b + 1u] += band_offsets_[b];
+
+        band_segments_.resize(band_offsets_.back());
+        cursor_.assign(band_offsets_.begin(), band_offsets_.end() - 1);
+        for (std::uint32_t i {}; i < segments_.size(); ++i)
+        {
+            const line_segment& s {segments_[i]};
+            for (std::uint32_t b {band_of(std::min(s.y0, s.y1))}, last {band_of(std::max(s.y0, s.y1))}; b <= last; ++b)
+                band_segments_[cursor_[b]++] = i;
+        }
+    }
+
+    bool segment_index::contains(const double x, const double y) const noexcept
+    {
+        if (segments_.empty() || (y < min_y_) || (y > max_y_) || (x < min_x_) || (x > max_x_))
+            return false;
+
+        // Each segment spanning y lies in y's band, so scanning that band alone gives the full crossing parity
+        const std::uint32_t band {band_of(y)};
+        bool inside {};
+        for (std::uint32_t k {band_offsets_[band]}; k < band_offsets_[band + 1u]; ++k)
+        {
+            const line_segment& e {segments_[band_segments_[k]]};
+            if (((e.y0 > y) != (e.y1 > y)) && (x < (e.x1 - e.x0) * (y - e.y0) / (e.y1 - e.y0) + e.x0))
+                inside = !inside;
+        }
+        return inside;
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,211 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file shapefile_dataset.cpp
+#include "kmx/gis/shapefile_dataset.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace kmx::gis
+{
+    // Reads a value stored with the given byte order (the .shp/.shx headers mix both orders).
+    template <class T, std::endian order = std::endian::little>
+    static T read_value(const std::uint8_t* const data) noexcept
+    {
+        std::array<std::uint8_t, sizeof(T)> bytes {};
+        std::memcpy(bytes.data(), data, sizeof(T));
+        if constexpr (order != std::endian::native)
+            std::reverse(bytes.begin(), bytes.end());
+        return std::bit_cast<T>(bytes);
+    }
+
+    // Reads a big-endian 32-bit integer.
+    static std::int32_t read_big_endian_int32(const std::uint8_t* const data) noexcept
+    {
+        return read_value<std::int32_t, std::endian::big>(data);
+    }
+
+    // Path of a sibling component (.shx, .dbf, .cpg), matching the case of the .shp extension.
+    static std::string sibling_path(const std::string& shp_path, const std::string_view extension)
+    {
+        std::filesystem::path path {shp_path};
+        const std::string shp_extension {path.extension().string()};
+        const bool upper_case {(shp_extension.size() > 1u) && std::isupper(static_cast<unsigned char>(shp_extension[1]))};
+        std::string sibling_extension {'.'};
+        for (const char c: extension)
+            sibling_extension += static_cast<char>(upper_case ? std::toupper(static_cast<unsigned char>(c)) : c);
+        return path.replace_extension(sibling_extension).string();
+    }
+
+    shapefile_dataset::shapefile_dataset(const std::string& shp_path) noexcept(false):
+        shp_ {shp_path},
+        shx_ {sibling_path(shp_path, "shx")},
+        dbf_ {sibling_path(shp_path, "dbf")}
+    {
+        for (const mapped_file* const file: {&shp_, &shx_})
+            if ((file->size() < main_header_size_) || (read_big_endian_int32(file->data()) != file_code_))
+                throw std::runtime_error("Not a valid shapefile component: " + file->path());
+        shape_type_ = read_value<std::int32_t>(shp_.data() + 32u);
+
+        parse_dbf_header();
+        const std::size_t shx_count {(shx_.size() - main_header_size_) / 8u};
+        const std::size_t dbf_count {read_value<std::uint32_t>(dbf_.data() + 4u)};
+        record_count_ = std::min(shx_count, dbf_count);
+        if (shx_count != dbf_count)
+            std::cerr << "Warning: The .shx lists " << shx_count << " records and the .dbf " << dbf_count << ". Using " << record_count_
+                      << "." << std::endl;
+
+        std::ifstream cpg_file {sibling_path(shp_path, "cpg")};
+        if (cpg_file.is_open())
+            std::getline(cpg_file, code_page_);
+    }
+
+    void shapefile_dataset::parse_dbf_header() noexcept(false)
+    {
+        static constexpr std::size_t descriptor_size {32u};
+        static constexpr std::uint8_t descriptor_terminator {0x0Du};
+
+        if (dbf_.size() < descriptor_size)
+            throw std::runtime_error("Not a valid dBASE file: " + dbf_.path());
+        dbf_header_size_ = read_value<std::uint16_t>(dbf_.data() + 8u);
+        dbf_record_size_ = read_value<std::uint16_t>(dbf_.data() + 10u);
+        if ((dbf_header_size_ > dbf_.size()) || (dbf_record_size_ == 0u))
+            throw std::runtime_error("Not a valid dBASE file: " + dbf_.path());
+
+        std::uint32_t offset {1u}; // Each record starts with its deletion flag
+        for (std::size_t at {descriptor_size}; (at + descriptor_size <= dbf_header_size_) && (dbf_.data()[at] != descriptor_terminator);
+             at += descriptor_size)
+        {
+            const auto* const descriptor = reinterpret_cast<const char*>(dbf_.data() + at);
+            dbf_field field {};
+            field.name.assign(descriptor, std::find(descriptor, descriptor + 11, '\0'));
+            field.type = descriptor[11];
+            field.offset = offset;
+            field.length = dbf_.data()[at + 16u];
+            // Character fields wider than 255 bytes keep the high byte of their width in the decimal count
+            if (field.type == 'C')
+                field.length += static_cast<std::uint32_t>(dbf_.data()[at + 17u]) << 8u;
+            offset += field.length;
+            fields_.push_back(std::move(field));
+        }
+        if (offset > dbf_record_size_)
+            throw std::runtime_error("Inconsistent dBASE record layout: " + dbf_.path());
+    }
+
+    std::string_view shapefile_dataset::shape_type_name(const std::int32_t type) noexcept
+    {
+        switch (type)
+        {
+            case 0:
+                return "Null";
+            case 1:
+                return "Point";
+            case 3:
+                return "PolyLine";
+            case 5:
+                return "Polygon";
+            case 8:
+                return "MultiPoint";
+            case 11:
+                return "PointZ";
+            case 13:
+                return "PolyLineZ";
+            case 15:
+                return "PolygonZ";
+            case 18:
+                return "MultiPointZ";
+            case 21:
+                return "PointM";
+            case 23:
+                return "PolyLineM";
+            case 25:
+                return "PolygonM";
+            case 28:
+                return "MultiPointM";
+            case 31:
+                return "MultiPatch";
+            default:
+                return "Unknown";
+        }
+    }
+
+    std::uint64_t shapefile_dataset::record_offset(const std::size_t index) const noexcept
+    {
+        // Offsets in .shx are counted in 16-bit words
+        const std::int32_t words {read_big_endian_int32(shx_.data() + main_header_size_ + index * 8u)};
+        return static_cast<std::uint64_t>(static_cast<std::uint32_t>(words)) * 2u;
+    }
+
+    bounding_box shapefile_dataset::record_bbox(const std::size_t index) const noexcept
+    {
+        static constexpr std::size_t record_header_size {8u};
+        bounding_box bbox {};
+        const std::size_t offset {static_cast<std::size_t>(record_offset(index))};
+        const std::uint8_t* const content {shp_.data() + offset + record_header_size};
+        if (offset + record_header_size + sizeof(std::int32_t) > shp_.size())
+            return bbox;
+
+        switch (read_value<std::int32_t>(content))
+        {
+            case 1:
+            case 11:
+            case 21:
+                if (offset + record_header_size + 20u <= shp_.size())
+                    bbox.update(read_value<double>(content + 4u), read_value<double>(content + 12u));
+                break;
+            case 3:
+            case 5:
+            case 8:
+            case 13:
+            case 15:
+            case 18:
+            case 23:
+            case 25:
+            case 28:
+            case 31:
+                // Every multi-vertex shape starts with its box (Xmin, Ymin, Xmax, Ymax)
+                if (offset + record_header_size + 36u <= shp_.size())
+                {
+                    bbox.update(read_value<double>(content + 4u), read_value<double>(content + 12u));
+                    bbox.update(read_value<double>(content + 20u), read_value<double>(content + 28u));
+                }
+                break;
+            default: // Null shape
+                break;
+        }
+        return bbox;
+    }
+
+    std::optional<std::size_t> shapefile_dataset::find_field(const std::string_view name) const noexcept
+    {
+        const auto same_name = [&](const dbf_field& field)
+        {
+            const auto lower = [](const char c) { return std::tolower(static_cast<unsigned char>(c)); };
+            return std::equal(field.name.begin(), field.name.end(), name.begin(), name.end(),
+                              [&](const char a, const char b) { return lower(a) == lower(b); });
+        };
+        const auto it = std::find_if(fields_.begin(), fields_.end(), same_name);
+        return (it != fields_.end()) ? std::optional<std::size_t> {static_cast<std::size_t>(it - fields_.begin())} : std::nullopt;
+    }
+
+    std::string_view shapefile_dataset::field_text(const std::size_t index, const std::size_t field) const noexcept
+    {
+        const std::size_t record {dbf_header_size_ + index * dbf_record_size_};
+        if (record + dbf_record_size_ > dbf_.size())
+            return {};
+        std::string_view text {reinterpret_cast<const char*>(dbf_.data() + record + fields_[field].offset), fields_[field].length};
+        const std::size_t first {text.find_first_not_of(' ')};
+        if (first == std::string_view::npos)
+            return {};
+        text.remove_prefix(first);
+        text.remove_suffix(text.size() - 1u - text.find_last_not_of(' '));
+        // Unused trailing bytes may also be NULs
+        return text.substr(0u, text.find('\0'));
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,93 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file shapefile_feature_source.cpp
+#include "kmx/gis/shapefile_feature_source.hpp"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+
+namespace kmx::gis
+{
+    // Maps and validates the shapefile components.
+    shapefile_feature_source::shapefile_feature_source(const std::string& shp_path) noexcept(false):
+        dataset_ {shp_path},
+        range_end_ {dataset_.record_count()}
+    {
+    }
+
+    // Prints the record count and shape type, and warns about non-UTF-8 attribute tables.
+    void shapefile_feature_source::print_info() const noexcept(false)
+    {
+        std::cout << "Processing shapefile with " << dataset_.record_count() << " records." << std::endl;
+        std::cout << "Shape Type: " << geometry_type_name() << std::endl;
+
+        std::string code_page {dataset_.code_page()};
+        std::transform(code_page.begin(), code_page.end(), code_page.begin(), [](const unsigned char c) { return std::toupper(c); });
+        if (!code_page.empty() && (code_page.find("UTF-8") == std::string::npos) && (code_page.find("UTF8") == std::string::npos) &&
+            (code_page.find("65001") == std::string::npos))
+            std::cout << "Warning: The .dbf uses code page '" << dataset_.code_page() << "'; text fields are written as stored."
+                      << std::endl;
+    }
+
+    // Name of the shape type.
+    std::string_view shapefile_feature_source::geometry_type_name() const noexcept
+    {
+        return shapefile_dataset::shape_type_name(dataset_.shape_type());
+    }
+
+    // True for Polygon, PolygonZ and PolygonM shapefiles.
+    bool shapefile_feature_source::is_polygonal() const noexcept
+    {
+        const std::int32_t type {dataset_.shape_type()};
+        return (type == 5) || (type == 15) || (type == 25);
+    }
+
+    // Resolves the property names against the .dbf fields.
+    std::vector<std::optional<std::size_t>> shapefile_feature_source::project(const std::span<const std::string_view> names) noexcept(false)
+    {
+        fields_.clear();
+        for (const std::string_view name: names)
+            fields_.push_back(dataset_.find_field(name));
+        return fields_;
+    }
+
+    // Splits the records by their .shx offsets.
+    std::optional<shard_range> shapefile_feature_source::restrict_to_shard(const shard_spec& shard) noexcept(false)
+    {
+        const shard_range range {shard_plan::split(dataset_.record_count(), dataset_.shp_size(),
+                                                   [this](const std::uint64_t index)
+                                                   { return dataset_.record_offset(static_cast<std::size_t>(index)); },
+                                                   shard)};
+        range_begin_ = static_cast<std::size_t>(range.first_feature);
+        range_end_ = static_cast<std::size_t>(range.end_feature);
+        next_index_ = range_begin_;
+        return range;
+    }
+
+    // Jumps to the record at `position` of the shard.
+    bool shapefile_feature_source::seek(const std::uint64_t position, const std::uint64_t offset) noexcept(false)
+    {
+        static_cast<void>(offset);
+        if (position > feature_count())
+            return false;
+        next_index_ = range_begin_ + static_cast<std::size_t>(position);
+        return true;
+    }
+
+    // Reads the next records: their header boxes plus the projected fields.
+    bool shapefile_feature_source::next_batch(feature_batch& batch, const std::size_t max_features) noexcept(false)
+    {
+        batch.reset(next_index_, fields_.size());
+        const std::size_t end {std::min(range_end_, next_index_ + max_features)};
+        for (; next_index_ < end; ++next_index_)
+        {
+            batch.ring_offsets.push_back(0u);
+            batch.bboxes.push_back(dataset_.record_bbox(next_index_));
+            for (std::size_t c {}; c < fields_.size(); ++c)
+                batch.properties[c].emplace_back(fields_[c].has_value() ? dataset_.field_text(next_index_, *fields_[c])
+                                                                        : std::string_view {});
+            ++batch.size;
+        }
+        return batch.size > 0u;
+    }
+
+} // namespace kmx::gis
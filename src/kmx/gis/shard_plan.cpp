@@ -0,0 +1,123 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file shard_plan.cpp
+#include "kmx/gis/shard_plan.hpp"
+#include <charconv>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+
+namespace kmx::gis
+{
+    // Parses "<index>/<count>".
+    std::optional<shard_spec> shard_spec::parse(const std::string_view text) noexcept
+    {
+        const std::size_t slash {text.find('/')};
+        if (slash == std::string_view::npos)
+            return {};
+        shard_spec shard {};
+        const auto parse_part = [](const std::string_view part, std::uint32_t& value)
+        {
+            const auto [end, error] = std::from_chars(part.data(), part.data() + part.size(), value);
+            return !part.empty() && (error == std::errc {}) && (end == part.data() + part.size());
+        };
+        if (!parse_part(text.substr(0u, slash), shard.index) || !parse_part(text.substr(slash + 1u), shard.count) ||
+            (shard.index >= shard.count))
+            return {};
+        return shard;
+    }
+
+    // Computes the range of one shard.
+    shard_range shard_plan::split(const std::uint64_t feature_count, const std::uint64_t section_size, const offset_function& offset_of,
+                                  const shard_spec& shard) noexcept(false)
+    {
+        if (!shard.is_sharded())
+            return {0u, feature_count, 0u, section_size};
+
+        // Byte boundary of slice `i`, computed without overflowing 64 bits (`count` fits in 32).
+        const auto boundary = [&](const std::uint64_t i)
+        { return (section_size / shard.count) * i + ((section_size % shard.count) * i) / shard.count; };
+        // First feature starting at or after `offset`.
+        const auto first_feature_at = [&](const std::uint64_t offset)
+        {
+            std::uint64_t low {}, high {feature_count};
+            while (low < high)
+            {
+                const std::uint64_t middle {low + (high - low) / 2u};
+                if (offset_of(middle) < offset)
+                    low = middle + 1u;
+                else
+                    high = middle;
+            }
+            return low;
+        };
+
+        shard_range range {};
+        range.first_feature = first_feature_at(boundary(shard.index));
+        range.end_feature = (shard.index + 1u == shard.count) ? feature_count : first_feature_at(boundary(shard.index + 1u));
+        range.first_byte = (range.first_feature < feature_count) ? offset_of(range.first_feature) : section_size;
+        range.end_byte = (range.end_feature < feature_count) ? offset_of(range.end_feature) : section_size;
+        return range;
+    }
+
+    // Writes the manifest as "key=value" lines.
+    void shard_manifest::write(const std::string& path) const noexcept(false)
+    {
+        std::ofstream file {path};
+        file << signature_ << '\n'
+             << "input=" << input << '\n'
+             << "input_size=" << input_size << '\n'
+             << "shard=" << shard.index << '/' << shard.count << '\n'
+             << "first_feature=" << range.first_feature << '\n'
+             << "end_feature=" << range.end_feature << '\n'
+             << "first_byte=" << range.first_byte << '\n'
+             << "end_byte=" << range.end_byte << '\n'
+             << "features=" << features << '\n'
+             << "output=" << output << '\n';
+        if (!file.flush())
+            throw std::runtime_error("Cannot write shard manifest: " + path);
+    }
+
+    // Reads a manifest written by `write`.
+    shard_manifest shard_manifest::read(const std::string& path) noexcept(false)
+    {
+        std::ifstream file {path};
+        std::string line {};
+        if (!std::getline(file, line) || (line != signature_))
+            throw std::runtime_error("Not a shard manifest: " + path);
+
+        std::map<std::string, std::string, std::less<>> values {};
+        while (std::getline(file, line))
+            if (const std::size_t equals {line.find('=')}; equals != std::string::npos)
+                values[line.substr(0u, equals)] = line.substr(equals + 1u);
+
+        const auto text = [&](const std::string_view key) -> const std::string&
+        {
+            const auto it = values.find(key);
+            if (it == values.end())
+                throw std::runtime_error("Shard manifest " + path + " lacks '" + std::string {key} + "'");
+            return it->second;
+        };
+        const auto number = [&](const std::string_view key)
+        {
+            const std::string& value {text(key)};
+            std::uint64_t result {};
+            const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+            if (value.empty() || (error != std::errc {}) || (end != value.data() + value.size()))
+                throw std::runtime_error("Shard manifest " + path + " has an invalid '" + std::string {key} + "': " + value);
+            return result;
+        };
+
+        shard_manifest manifest {};
+        manifest.input = text("input");
+        manifest.input_size = number("input_size");
+        const std::optional<shard_spec> shard {shard_spec::parse(text("shard"))};
+        if (!shard.has_value())
+            throw std::runtime_error("Shard manifest " + path + " has an invalid 'shard': " + text("shard"));
+        manifest.shard = *shard;
+        manifest.range = {number("first_feature"), number("end_feature"), number("first_byte"), number("end_byte")};
+        manifest.features = number("features");
+        manifest.output = text("output");
+        return manifest;
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,244 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file spatial_partitioner.cpp
+#include "kmx/gis/spatial_partitioner.hpp"
+#include "flatgeobuf/packedrtree.h"
+#include "kmx/gis/fgb_writer.hpp"
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <numeric>
+
+namespace kmx::gis
+{
+    spatial_partitioner::spatial_partitioner(const std::string& input_fgb_path, const std::string& output_directory,
+                                             const std::uint32_t num_threads, const std::uint32_t shard_count) noexcept(false):
+        output_directory_ {output_directory},
+        shard_count_ {std::max(shard_count, 1u)},
+        thread_pool_ {num_threads},
+        dataset_ {input_fgb_path}
+    {
+        std::cout << "Thread pool initialized with " << num_threads << " threads.\n";
+    }
+
+    // Reduces per-chunk extents, so no box is kept per feature.
+    bounding_box spatial_partitioner::layer_extent() noexcept(false)
+    {
+        const std::uint64_t feature_count {dataset_.feature_count()};
+        std::mutex mutex {};
+        bounding_box extent {};
+        const std::size_t chunk_size {std::max<std::size_t>(1u, feature_count / (thread_pool_.size() * 8u + 1u))};
+        thread_pool_.parallel_for(feature_count, chunk_size,
+                                  [&](const std::size_t begin, const std::size_t end)
+                                  {
+                                      bounding_box part {};
+                                      for (std::size_t i {begin}; i < end; ++i)
+                                          if (const bounding_box bbox {dataset_.feature_bbox(i)}; bbox.is_valid)
+                                          {
+                                              part.update(bbox.min_x, bbox.min_y);
+                                              part.update(bbox.max_x, bbox.max_y);
+                                          }
+                                      if (!part.is_valid)
+                                          return;
+                                      std::lock_guard<std::mutex> lock {mutex};
+                                      extent.update(part.min_x, part.min_y);
+                                      extent.update(part.max_x, part.max_y);
+                                  });
+        return extent;
+    }
+
+    // Features without a valid box get key 0 and land in the first shard.
+    std::vector<std::uint32_t> spatial_partitioner::hilbert_keys(const bounding_box& extent) noexcept(false)
+    {
+        const std::uint64_t feature_count {dataset_.feature_count()};
+        std::vector<std::uint32_t> keys(feature_count);
+        const double width {extent.max_x - extent.min_x};
+        const double height {extent.max_y - extent.min_y};
+        const std::size_t chunk_size {std::max<std::size_t>(1u, feature_count / (thread_pool_.size() * 8u + 1u))};
+        thread_pool_.parallel_for(feature_count, chunk_size,
+                                  [&](const std::size_t begin, const std::size_t end)
+                                  {
+                                      for (std::size_t i {begin}; i < end; ++i)
+                                          if (const bounding_box bbox {dataset_.feature_bbox(i)}; bbox.is_valid)
+                                          {
+                                              const FlatGeobuf::NodeItem node {bbox.min_x, bbox.min_y, bbox.max_x, bbox.max_y, 0u};
+                                              keys[i] = FlatGeobuf::hilbert(node, FlatGeobuf::HILBERT_MAX, extent.min_x, extent.min_y,
+                                                                            width, height);
+                                          }
+                                  });
+        return keys;
+    }
+
+    // Shard `s` takes the keys in [split[s - 1], split[s]); equal keys never straddle a boundary.
+    std::vector<std::uint32_t> spatial_partitioner::split_keys(const std::span<const std::uint32_t> keys) const noexcept(false)
+    {
+        const std::size_t stride {std::max<std::size_t>(1u, keys.size() / sample_size_)};
+        std::vector<std::pair<std::uint32_t, std::uint64_t>> sample {};
+        sample.reserve(keys.size() / stride + 1u);
+        std::uint64_t total {};
+        for (std::size_t i {}; i < keys.size(); i += stride)
+        {
+            sample.emplace_back(keys[i], dataset_.feature_bytes(i).size());
+            total += sample.back().second;
+        }
+        std::sort(sample.begin(), sample.end());
+
+        std::vector<std::uint32_t> splits {};
+        splits.reserve(shard_count_ - 1u);
+        std::uint64_t cumulative {};
+        for (const auto& [key, size]: sample)
+        {
+            // The boundary of shard `s` lies at s/n of the sampled bytes
+            while ((splits.size() + 1u < shard_count_) && (cumulative * shard_count_ >= total * (splits.size() + 1u)))
+                splits.push_back(key);
+            cumulative += size;
+        }
+        while (splits.size() + 1u < shard_count_)
+            splits.push_back(std::numeric_limits<std::uint32_t>::max());
+        return splits;
+    }
+
+    bool spatial_partitioner::write_shard(const std::span<const std::uint64_t> members, const std::span<const std::uint32_t> keys,
+                                          partition_shard& shard) const noexcept(false)
+    {
+        std::vector<fgb_feature_entry> entries(members.size());
+        for (std::size_t k {}; k < members.size(); ++k)
+        {
+            entries[k] = {dataset_.feature_bytes(members[k]), dataset_.feature_bbox(members[k])};
+            shard.bytes += entries[k].bytes.size();
+        }
+        shard.features = members.size();
+        shard.extent = fgb_writer::envelope_of(entries);
+        if (!members.empty())
+        {
+            shard.first_key = keys[members.front()];
+            shard.last_key = keys[members.back()];
+        }
+        const fgb_writer writer {dataset_.header(), dataset_.has_index() ? dataset_.index_node_size() : std::uint16_t {16u}};
+        return writer.write((std::filesystem::path {output_directory_} / shard.file).string(), entries);
+    }
+
+    bool spatial_partitioner::write_manifest(const std::span<const partition_shard> shards) const noexcept(false)
+    {
+        const std::filesystem::path path {std::filesystem::path {output_directory_} / "manifest.csv"};
+        std::ofstream manifest {path, std::ios::trunc};
+        if (!manifest.is_open())
+        {
+            std::cerr << "Error: Could not open manifest file for writing: " << path << std::endl;
+            return false;
+        }
+
+        manifest.precision(15);
+        manifest << "shard,file,features,bytes,min_x,min_y,max_x,max_y,first_key,last_key\n";
+        for (std::size_t s {}; s < shards.size(); ++s)
+        {
+            const partition_shard& shard {shards[s]};
+            manifest << s << ',' << shard.file << ',' << shard.features << ',' << shard.bytes << ',';
+            if (shard.extent.is_valid)
+                manifest << shard.extent.min_x << ',' << shard.extent.min_y << ',' << shard.extent.max_x << ',' << shard.extent.max_y;
+            else
+                manifest << ",,,";
+            manifest << ',' << shard.first_key << ',' << shard.last_key << '\n';
+        }
+        if (!manifest)
+        {
+            std::cerr << "Error: Failed writing manifest file: " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool spatial_partitioner::partition() noexcept(false)
+    {
+        std::error_code error {};
+        std::filesystem::create_directories(output_directory_, error);
+        if (error)
+        {
+            std::cerr << "Error: Could not create output directory " << output_directory_ << ": " << error.message() << std::endl;
+            return false;
+        }
+
+        const std::vector<std::uint32_t> keys {hilbert_keys(layer_extent())};
+        const std::vector<std::uint32_t> splits {split_keys(keys)};
+
+        // Bucket the features by shard (a counting sort keeps file order within a shard)
+        const std::uint64_t feature_count {dataset_.feature_count()};
+        std::vector<std::uint32_t> shard_of(feature_count);
+        std::vector<std::uint64_t> starts(shard_count_ + 1u);
+        for (std::uint64_t i {}; i < feature_count; ++i)
+        {
+            shard_of[i] = static_cast<std::uint32_t>(std::upper_bound(splits.begin(), splits.end(), keys[i]) - splits.begin());
+            ++starts[shard_of[i] + 1u];
+        }
+        std::partial_sum(starts.begin(), starts.end(), starts.begin());
+        std::vector<std::uint64_t> members(feature_count);
+        {
+            std::vector<std::uint64_t> next {starts.begin(), starts.end() - 1};
+            for (std::uint64_t i {}; i < feature_count; ++i)
+                members[next[shard_of[i]]++] = i;
+        }
+
+        // Every shard is sorted into Hilbert order and written by its own task. The tasks use the locals above, so all
+        // of them finish before an exception (enqueueing, or thrown by a task) leaves this function.
+        std::vector<partition_shard> shards(shard_count_);
+        std::vector<std::future<bool>> writes {};
+        const auto wait_all = [&writes]
+        {
+            for (const std::future<bool>& write: writes)
+                write.wait();
+        };
+        try
+        {
+            writes.reserve(shard_count_);
+            for (std::uint32_t s {}; s < shard_count_; ++s)
+            {
+                shards[s].file = "shard_" + std::to_string(s) + ".fgb";
+                writes.push_back(thread_pool_.enqueue_task(
+                    [&, s]
+                    {
+                        const std::span<std::uint64_t> shard_members {members.data() + starts[s], members.data() + starts[s + 1u]};
+                        std::stable_sort(shard_members.begin(), shard_members.end(),
+                                         [&](const std::uint64_t a, const std::uint64_t b) { return keys[a] < keys[b]; });
+                        return write_shard(shard_members, keys, shards[s]);
+                    }));
+            }
+        }
+        catch (...)
+        {
+            wait_all();
+            throw;
+        }
+        wait_all();
+
+        bool ok {true};
+        std::exception_ptr failure {};
+        for (std::future<bool>& write: writes)
+        {
+            try
+            {
+                ok = write.get() && ok;
+            }
+            catch (...)
+            {
+                if (!failure)
+                    failure = std::current_exception();
+            }
+        }
+        if (failure)
+            std::rethrow_exception(failure);
+        if (!ok || !write_manifest(shards))
+            return false;
+
+        const auto by_size = [](const partition_shard& a, const partition_shard& b) { return a.bytes < b.bytes; };
+        const auto [smallest, largest] = std::minmax_element(shards.begin(), shards.end(), by_size);
+        std::cout << "Partitioned " << feature_count << " features into " << shard_count_ << " shards of " << smallest->bytes << " to "
+                  << largest->bytes << " bytes." << std::endl;
+        std::cout << "Output written to: " << output_directory_ << std::endl;
+        return true;
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,399 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file stream_feature_source.cpp
+#include "kmx/gis/stream_feature_source.hpp"
+#include "kmx/gis/csv_format.hpp"
+#include "kmx/gis/wkb_reader.hpp"
+#include "kmx/gis/wkt_reader.hpp"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace kmx::gis
+{
+    // Case-insensitive comparison of column names.
+    static bool equals_ignore_case(const std::string_view a, const std::string_view b) noexcept
+    {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                          [](const char x, const char y)
+                          { return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y)); });
+    }
+
+    // Maps the file and locates the geometry column.
+    stream_feature_source::stream_feature_source(const std::string& path, const stream_format format, thread_pool& pool) noexcept(false):
+        file_ {path},
+        format_ {format},
+        pool_ {pool}
+    {
+        if (file_.size() == 0u)
+            throw std::runtime_error("Empty input file: " + path);
+        if (format_ != stream_format::wkb)
+            read_header();
+    }
+
+    // The stream format implied by the file extension.
+    std::optional<stream_format> stream_feature_source::format_of(const std::string_view path) noexcept
+    {
+        if (has_extension(path, ".wkb"))
+            return stream_format::wkb;
+        if (has_extension(path, ".hexwkb") || has_extension(path, ".copy") || has_extension(path, ".tsv"))
+            return stream_format::hex_wkb;
+        if (has_extension(path, ".csv"))
+            return stream_format::wkt_csv;
+        return std::nullopt;
+    }
+
+    // The next line and its end, without '\r\n' or '\n'.
+    std::string_view stream_feature_source::next_line(std::size_t& offset, const std::size_t end) const noexcept
+    {
+        const char* const begin {reinterpret_cast<const char*>(file_.data()) + offset};
+        const void* const newline {std::memchr(begin, '\n', end - offset)};
+        const std::size_t length {(newline != nullptr) ? static_cast<std::size_t>(static_cast<const char*>(newline) - begin)
+                                                       : end - offset};
+        offset += length + ((newline != nullptr) ? 1u : 0u);
+        std::string_view line {begin, length};
+        if (!line.empty() && (line.back() == '\r'))
+            line.remove_suffix(1u);
+        return line;
+    }
+
+    // Splits a line into fields, undoing CSV quoting or COPY text escapes.
+    void stream_feature_source::split_fields(const std::string_view line, std::vector<std::string>& fields) const noexcept(false)
+    {
+        // Reuse the field strings (and their capacity) from the previous line.
+        std::size_t count {};
+        const auto next_field = [&]() -> std::string&
+        {
+            if (count == fields.size())
+                fields.emplace_back();
+            std::string& field {fields[count++]};
+            field.clear();
+            return field;
+        };
+
+        if (format_ == stream_format::wkt_csv)
+        {
+            // RFC 4180: quoted fields may contain delimiters and doubled quotes.
+            std::string* field {&next_field()};
+            bool quoted {};
+            for (std::size_t i {}; i < line.size(); ++i)
+            {
+                const char c {line[i]};
+                if (quoted)
+                {
+                    if (c != '"')
+                        *field += c;
+                    else if (((i + 1u) < line.size()) && (line[i + 1u] == '"'))
+                        *field += line[++i];
+                    else
+                        quoted = false;
+                }
+                else if (c == '"')
+                    quoted = true;
+                else if (c == csv_format::delimiter)
+                    field = &next_field();
+                else
+                    *field += c;
+            }
+        }
+        else
+        {
+            // COPY text format: tab-separated, `\N` for NULL, backslash escapes for special characters.
+            static constexpr std::string_view escapes {"b\bf\fn\nr\rt\tv\v"};
+            std::string* field {&next_field()};
+            for (std::size_t i {}; i < line.size(); ++i)
+            {
+                const char c {line[i]};
+                if (c == '\t')
+                    field = &next_field();
+                else if ((c != '\\') || ((i + 1u) == line.size()))
+                    *field += c;
+                else if (const char e {line[++i]}; e == 'N')
+                    field->clear();
+                else if (const std::size_t pos {escapes.find(e)}; (pos != std::string_view::npos) && ((pos % 2u) == 0u))
+                    *field += escapes[pos + 1u];
+                else
+                    *field += e;
+            }
+        }
+        fields.resize(count);
+    }
+
+    // Parses a geometry field into `out`.
+    bool stream_feature_source::read_geometry_field(const std::string_view text, std::vector<std::uint8_t>& wkb,
+                                                    polygon_buffer& out) const noexcept(false)
+    {
+        if (format_ == stream_format::wkt_csv)
+            return wkt_reader::read_polygonal(text, out);
+        // geometry columns are written as bare hex, bytea columns (e.g. ST_AsEWKB) with a "\x" prefix.
+        const std::string_view hex {text.starts_with("\\x") ? text.substr(2u) : text};
+        return wkb_reader::hex_decode(hex, wkb) && (wkb_reader::read_polygonal(wkb, out) == wkb.size());
+    }
+
+    // Reads the header line (if any) and finds the geometry column.
+    void stream_feature_source::read_header() noexcept(false)
+    {
+        static constexpr std::array<std::string_view, 5u> geometry_names {"wkt", "geom", "geometry", "the_geom", "wkb_geometry"};
+
+        std::size_t offset {};
+        std::vector<std::string> first {};
+        split_fields(next_line(offset, file_.size()), first);
+        const std::size_t second_offset {offset};
+        std::vector<std::string> second {};
+        split_fields(next_line(offset, file_.size()), second);
+
+        // The geometry column is the first field of a record that parses as a polygon.
+        std::vector<std::uint8_t> wkb {};
+        polygon_buffer scratch {};
+        const auto find_geometry = [&](const std::vector<std::string>& fields) -> std::optional<std::size_t>
+        {
+            for (std::size_t i {}; i < fields.size(); ++i)
+                if (!fields[i].empty() && read_geometry_field(fields[i], wkb, scratch))
+                    return i;
+            return std::nullopt;
+        };
+
+        // COPY text output carries a header only with the HEADER option; CSV always does.
+        std::optional<std::size_t> geometry {(format_ == stream_format::hex_wkb) ? find_geometry(first) : std::nullopt};
+        if (geometry.has_value())
+        {
+            for (std::size_t i {}; i < first.size(); ++i)
+                column_names_.push_back("field_" + std::to_string(i + 1u));
+        }
+        else
+        {
+            column_names_ = std::move(first);
+            data_offset_ = second_offset;
+            first_record_number_ = 2u;
+            for (std::size_t i {}; !geometry.has_value() && (i < column_names_.size()); ++i)
+                if (std::any_of(geometry_names.begin(), geometry_names.end(),
+                                [&](const std::string_view name) { return equals_ignore_case(name, column_names_[i]); }))
+                    geometry = i;
+            if (!geometry.has_value())
+                geometry = find_geometry(second);
+        }
+
+        if (!geometry.has_value())
+            throw std::runtime_error("No polygon geometry column found in: " + file_.path());
+        geometry_column_ = *geometry;
+    }
+
+    // Cuts the data into chunks at record boundaries.
+    void stream_feature_source::split_chunks() noexcept(false)
+    {
+        const std::size_t data_size {file_.size() - data_offset_};
+        const std::size_t chunk_count {std::clamp<std::size_t>(data_size / min_chunk_size_, 1u, pool_.size() * chunks_per_thread_)};
+        const std::size_t target_size {data_size / chunk_count + 1u};
+
+        chunks_.clear();
+        std::size_t begin {data_offset_};
+        if (format_ != stream_format::wkb)
+        {
+            // Each cut moves forward to the next line start.
+            while (begin < file_.size())
+            {
+                std::size_t end {std::min(file_.size(), begin + target_size)};
+                if (end < file_.size())
+                {
+                    const void* const newline {std::memchr(file_.data() + end, '\n', file_.size() - end)};
+                    end = (newline != nullptr) ? static_cast<std::size_t>(static_cast<const std::uint8_t*>(newline) - file_.data()) + 1u
+                                               : file_.size();
+                }
+                chunks_.push_back({begin, end});
+                begin = end;
+            }
+            return;
+        }
+
+        // Binary WKB has no separators: walk the geometry sizes (counts only) and cut between geometries.
+        std::size_t end {begin};
+        while (end < file_.size())
+        {
+            const std::size_t size {wkb_reader::measure(file_.bytes().subspan(end))};
+            if (size == 0u)
+            {
+                std::cerr << "Warning: Malformed or non-polygonal WKB at offset " << end << "; ignoring the rest of the file." << std::endl;
+                break;
+            }
+            end += size;
+            if ((end - begin) >= target_size)
+            {
+                chunks_.push_back({begin, end});
+                begin = end;
+            }
+        }
+        if (end > begin)
+            chunks_.push_back({begin, end});
+    }
+
+    // Parses the records of one chunk.
+    void stream_feature_source::parse_chunk(parsed_chunk& chunk) const noexcept(false)
+    {
+        chunk.properties.assign(columns_.size(), {});
+        if (format_ == stream_format::wkb)
+        {
+            for (std::size_t offset {chunk.begin}; offset < chunk.end; ++chunk.record_count)
+            {
+                const std::size_t size {wkb_reader::read_polygonal(file_.bytes().subspan(offset, chunk.end - offset), chunk.geometry)};
+                if (size == 0u)
+                    break; // Cannot happen: the chunk was cut at measured geometry boundaries.
+                offset += size;
+                chunk.ring_offsets.push_back(static_cast<std::uint32_t>(chunk.geometry.rings.size()));
+                chunk.feature_ends.push_back(offset);
+                for (std::vector<std::string>& column: chunk.properties)
+                    column.emplace_back(); // Binary WKB carries no attributes.
+            }
+            return;
+        }
+
+        std::vector<std::string> fields {};
+        std::vector<std::uint8_t> wkb {};
+        for (std::size_t offset {chunk.begin}; offset < chunk.end; ++chunk.record_count)
+        {
+            const std::string_view line {next_line(offset, chunk.end)};
+            if (line.empty())
+                continue;
+            split_fields(line, fields);
+            if (geometry_column_ >= fields.size())
+            {
+                chunk.errors.emplace_back(chunk.record_count, "missing geometry field");
+                continue;
+            }
+            // An empty geometry field is a NULL geometry: the feature is kept without rings.
+            if (!fields[geometry_column_].empty() && !read_geometry_field(fields[geometry_column_], wkb, chunk.geometry))
+            {
+                chunk.errors.emplace_back(chunk.record_count, "invalid or non-polygonal geometry");
+                continue;
+            }
+            chunk.ring_offsets.push_back(static_cast<std::uint32_t>(chunk.geometry.rings.size()));
+            chunk.feature_ends.push_back(offset);
+            for (std::size_t c {}; c < columns_.size(); ++c)
+            {
+                const std::optional<std::size_t> column {columns_[c]};
+                const bool present {column.has_value() && (*column < fields.size())};
+                chunk.properties[c].push_back(present ? std::move(fields[*column]) : std::string {});
+            }
+        }
+    }
+
+    // Parses all chunks in parallel and reports the skipped records.
+    void stream_feature_source::parse() noexcept(false)
+    {
+        split_chunks();
+        pool_.parallel_for(chunks_.size(), 1u,
+                           [this](const std::size_t begin, const std::size_t end)
+                           {
+                               for (std::size_t i {begin}; i < end; ++i)
+                                   parse_chunk(chunks_[i]);
+                           });
+
+        std::size_t record_number {first_record_number_};
+        for (const parsed_chunk& chunk: chunks_)
+        {
+            for (const auto& [record, reason]: chunk.errors)
+                std::cerr << "Warning: Skipping line " << (record_number + record) << ": " << reason << "." << std::endl;
+            record_number += chunk.record_count;
+            feature_count_ += chunk.size();
+        }
+        parsed_ = true;
+        std::cout << "Feature count (parsed): " << feature_count_ << std::endl;
+    }
+
+    // Prints the stream layout and feature count.
+    void stream_feature_source::print_info() const noexcept(false)
+    {
+        std::cout << "Processing " << geometry_type_name() << " file: " << file_.path() << std::endl;
+        if (format_ != stream_format::wkb)
+            std::cout << "Geometry column: " << column_names_[geometry_column_] << std::endl;
+        std::cout << "File size: " << file_.size() << " bytes (parsed on the first read)." << std::endl;
+    }
+
+    // Name of the stream format.
+    std::string_view stream_feature_source::geometry_type_name() const noexcept
+    {
+        switch (format_)
+        {
+            case stream_format::wkb:
+                return "WKB";
+            case stream_format::hex_wkb:
+                return "hex WKB";
+            default:
+                return "CSV with WKT";
+        }
+    }
+
+    // Resolves the property names against the column names.
+    std::vector<std::optional<std::size_t>> stream_feature_source::project(const std::span<const std::string_view> names) noexcept(false)
+    {
+        columns_.clear();
+        for (const std::string_view name: names)
+        {
+            const auto it = std::find_if(column_names_.begin(), column_names_.end(),
+                                         [&](const std::string& column) { return equals_ignore_case(column, name); });
+            if (it != column_names_.end())
+                columns_.emplace_back(static_cast<std::size_t>(it - column_names_.begin()));
+            else
+                columns_.emplace_back(std::nullopt);
+        }
+        return columns_;
+    }
+
+    // Parses the stream from `offset` on, counting the `position` features before it as delivered.
+    bool stream_feature_source::seek(const std::uint64_t position, const std::uint64_t offset) noexcept(false)
+    {
+        if (parsed_ || (offset < data_offset_) || (offset > file_.size()))
+            return feature_source::seek(position, offset);
+        std::cout << "Resuming at byte offset " << offset << "; line numbers below count from there." << std::endl;
+        data_offset_ = static_cast<std::size_t>(offset);
+        first_record_number_ = 1u;
+        feature_count_ = position;
+        next_index_ = position;
+        parse();
+        return true;
+    }
+
+    // The mapping plus the parsed coordinates, which outweigh the text for WKT.
+    std::uint64_t stream_feature_source::resident_bytes() const noexcept
+    {
+        std::uint64_t bytes {file_.size()};
+        for (const parsed_chunk& chunk: chunks_)
+            bytes += chunk.geometry.xy.capacity() * sizeof(double) + chunk.geometry.rings.capacity() * sizeof(polygon_buffer::ring_extent) +
+                     chunk.ring_offsets.capacity() * sizeof(std::uint32_t) + chunk.feature_ends.capacity() * sizeof(std::size_t);
+        return bytes;
+    }
+
+    // Delivers the next parsed features; a batch never spans two chunks.
+    bool stream_feature_source::next_batch(feature_batch& batch, const std::size_t max_features) noexcept(false)
+    {
+        if (!parsed_)
+            parse();
+        batch.reset(next_index_, columns_.size());
+        while ((next_chunk_ < chunks_.size()) && (next_in_chunk_ >= chunks_[next_chunk_].size()))
+        {
+            ++next_chunk_;
+            next_in_chunk_ = 0u;
+        }
+        if (next_chunk_ == chunks_.size())
+            return false;
+
+        parsed_chunk& chunk {chunks_[next_chunk_]};
+        const std::size_t end {std::min(chunk.size(), next_in_chunk_ + max_features)};
+        // Skipped records after the last feature of the chunk need not be read again on resume.
+        batch.end_offset = (end == chunk.size()) ? chunk.end : chunk.feature_ends[end - 1u];
+        for (; next_in_chunk_ < end; ++next_in_chunk_)
+        {
+            for (std::uint32_t r {chunk.ring_offsets[next_in_chunk_]}; r < chunk.ring_offsets[next_in_chunk_ + 1u]; ++r)
+                batch.rings.push_back(chunk.geometry.view(r));
+            batch.ring_offsets.push_back(static_cast<std::uint32_t>(batch.rings.size()));
+            // Every feature is delivered once, so its properties can be handed over.
+            for (std::size_t c {}; c < columns_.size(); ++c)
+                batch.properties[c].push_back(std::move(chunk.properties[c][next_in_chunk_]));
+            ++batch.size;
+        }
+        next_index_ += batch.size;
+        return true;
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,518 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file vector_tile_generator.cpp
+#include "kmx/gis/vector_tile_generator.hpp"
+#include "kmx/gis/feature_properties.hpp"
+#include "kmx/gis/geometry_processor.hpp"
+#include "kmx/gis/ring_clipper.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string_view>
+
+namespace kmx::gis
+{
+    /// @brief Deepest zoom level supported (tile indices must fit the R-tree query precision comfortably).
+    static constexpr std::uint32_t max_supported_zoom {24u};
+
+    /// @brief A vertex in (unquantized) tile coordinates, y pointing down.
+    struct tile_coordinate
+    {
+        double x;
+        double y;
+    };
+
+    /// @brief Scratch buffers of one tile worker.
+    struct tile_scratch
+    {
+        std::vector<ring_view> rings {};
+        std::vector<double> projected {};
+        ring_clipper<tile_coordinate> clipper {};
+        clipped_polygons<tile_coordinate> clipped {};
+        std::vector<tile_coordinate> ring {};
+        std::vector<std::uint8_t> keep {};
+        std::vector<std::pair<std::size_t, std::size_t>> stack {};
+        std::vector<tile_point> points {};
+        std::vector<std::uint32_t> geometry {};
+        std::vector<std::uint32_t> tags {};
+        std::string tile {};
+    };
+
+    // Douglas-Peucker simplification of a closed ring, keeping its first vertex.
+    static void simplify_ring(tile_scratch& scratch, const double tolerance) noexcept(false)
+    {
+        std::vector<tile_coordinate>& ring {scratch.ring};
+        const std::size_t n {ring.size()};
+        if ((n < 4u) || !(tolerance > 0.0))
+            return;
+
+        scratch.keep.assign(n, 0u);
+        scratch.keep[0u] = 1u;
+        scratch.stack.assign(1u, {0u, n}); // Index n stands for the closing vertex (= vertex 0)
+        const double tolerance_squared {tolerance * tolerance};
+        while (!scratch.stack.empty())
+        {
+            const auto [first, last] = scratch.stack.back();
+            scratch.stack.pop_back();
+            const tile_coordinate& a {ring[first]};
+            const tile_coordinate& b {ring[last % n]};
+            const double dx {b.x - a.x};
+            const double dy {b.y - a.y};
+            const double length_squared {dx * dx + dy * dy};
+
+            double max_distance {-1.0};
+            std::size_t farthest {};
+            for (std::size_t i {first + 1u}; i < last; ++i)
+            {
+                const double px {ring[i].x - a.x};
+                const double py {ring[i].y - a.y};
+                const double cross {dx * py - dy * px};
+                const double distance {(length_squared > 0.0) ? cross * cross / length_squared : px * px + py * py};
+                if (distance > max_distance)
+                {
+                    max_distance = distance;
+                    farthest = i;
+                }
+            }
+            if (max_distance > tolerance_squared)
+            {
+                scratch.keep[farthest] = 1u;
+                scratch.stack.emplace_back(first, farthest);
+                scratch.stack.emplace_back(farthest, last);
+            }
+        }
+
+        std::size_t count {};
+        for (std::size_t i {}; i < n; ++i)
+            if (scratch.keep[i] != 0u)
+                ring[count++] = ring[i];
+        ring.resize(count);
+    }
+
+    // Rounds the ring to integer tile units and drops repeated vertices; false if fewer than 3 vertices or no area remain.
+    static bool quantize_ring(const std::vector<tile_coordinate>& ring, std::vector<tile_point>& out_points,
+                              std::int64_t& out_area2) noexcept(false)
+    {
+        out_points.clear();
+        for (const tile_coordinate& p: ring)
+        {
+            const tile_point q {static_cast<std::int32_t>(std::lround(p.x)), static_cast<std::int32_t>(std::lround(p.y))};
+            if (out_points.empty() || (out_points.back() != q))
+                out_points.push_back(q);
+        }
+        while ((out_points.size() > 1u) && (out_points.back() == out_points.front()))
+            out_points.pop_back();
+        if (out_points.size() < 3u)
+            return false;
+
+        out_area2 = 0;
+        for (std::size_t i {}; i < out_points.size(); ++i)
+        {
+            const tile_point& a {out_points[i]};
+            const tile_point& b {out_points[(i + 1u) % out_points.size()]};
+            out_area2 += std::int64_t {a.x} * b.y - std::int64_t {b.x} * a.y;
+        }
+        return out_area2 != 0;
+    }
+
+    // Escapes a string for a JSON document.
+    static std::string json_escape(const std::string_view text) noexcept(false)
+    {
+        std::string result {};
+        for (const char c: text)
+        {
+            if ((c == '"') || (c == '\\'))
+                result += '\\';
+            if (static_cast<unsigned char>(c) < 0x20u)
+            {
+                static constexpr char hex[] {"0123456789abcdef"};
+                result += "\\u00";
+                result += hex[(c >> 4) & 0xF];
+                result += hex[c & 0xF];
+                continue;
+            }
+            result += c;
+        }
+        return result;
+    }
+
+    vector_tile_generator::vector_tile_generator(const std::string& input_fgb_path, const std::string& output_directory,
+                                                 const std::uint32_t num_threads, const vector_tile_settings& settings) noexcept(false):
+        output_directory_ {output_directory},
+        settings_ {settings},
+        thread_pool_ {num_threads},
+        dataset_ {input_fgb_path},
+        projection_ {dataset_.header()}
+    {
+        std::cout << "Thread pool initialized with " << num_threads << " threads.\n";
+        const flatbuffers::String* const name {dataset_.header()->name()};
+        layer_name_ = (name && (name->size() > 0u)) ? name->str() : std::filesystem::path {input_fgb_path}.stem().string();
+    }
+
+    bool vector_tile_generator::generate() noexcept(false)
+    {
+        const FgbGeometryType header_geom_type {dataset_.geometry_type()};
+        if ((header_geom_type != FgbGeometryType::Polygon) && (header_geom_type != FgbGeometryType::MultiPolygon))
+        {
+            std::cerr << "Error: Vector tiles require Polygon/MultiPolygon FGB files. Found: "
+                      << FlatGeobuf::EnumNameGeometryType(header_geom_type) << std::endl;
+            return false;
+        }
+        if ((settings_.min_zoom > settings_.max_zoom) || (settings_.max_zoom > max_supported_zoom) || (settings_.extent == 0u))
+        {
+            std::cerr << "Error: Invalid zoom range " << settings_.min_zoom << "-" << settings_.max_zoom << " (max zoom is "
+                      << max_supported_zoom << ")." << std::endl;
+            return false;
+        }
+        if (dataset_.feature_count() == 0u)
+        {
+            std::cerr << "Error: The input has no features." << std::endl;
+            return false;
+        }
+
+        std::error_code error {};
+        std::filesystem::create_directories(output_directory_, error);
+        if (error)
+        {
+            std::cerr << "Error: Could not create output directory " << output_directory_ << ": " << error.message() << std::endl;
+            return false;
+        }
+
+        project_features();
+
+        std::uint64_t total_tiles {};
+        for (std::uint32_t zoom {settings_.min_zoom}; zoom <= settings_.max_zoom; ++zoom)
+        {
+            const std::optional<std::uint64_t> tiles {generate_zoom(zoom)};
+            if (!tiles.has_value())
+                return false;
+            total_tiles += *tiles;
+        }
+
+        std::cout << "Wrote " << total_tiles << " tiles to " << output_directory_ << std::endl;
+        return write_metadata();
+    }
+
+    // Projects the boxes of all features and builds the Web Mercator R-tree over them.
+    void vector_tile_generator::project_features() noexcept(false)
+    {
+        const std::size_t feature_count {static_cast<std::size_t>(dataset_.feature_count())};
+
+        std::vector<FlatGeobuf::NodeItem> nodes(feature_count);
+        const std::size_t chunk_size {std::max<std::size_t>(1u, feature_count / (thread_pool_.size() * 8u + 1u))};
+        thread_pool_.parallel_for(
+            feature_count, chunk_size,
+            [&](const std::size_t begin, const std::size_t end)
+            {
+                std::vector<ring_view> rings {};
+                const std::size_t ahead {dataset_.prefetch_distance()};
+                for (std::size_t i {begin}; i < end; ++i)
+                {
+                    if ((i + ahead) < end)
+                        dataset_.prefetch_feature(i + ahead);
+                    const FlatGeobuf::Geometry* const geometry {dataset_.feature(i)->geometry()};
+                    geometry_processor::collect_rings(geometry, dataset_.geometry_type_of(geometry), rings);
+
+                    FlatGeobuf::NodeItem node {FlatGeobuf::NodeItem::create(i)};
+                    for (const ring_view& ring: rings)
+                        for (std::uint32_t p {}; p < ring.point_count; ++p)
+                        {
+                            const auto [mx, my] = projection_.project(ring.x(p), ring.y(p));
+                            node.expand({mx, my, mx, my, 0u});
+                        }
+                    nodes[i] = node;
+                }
+            });
+
+        extent_ = FlatGeobuf::calcExtent(nodes);
+        index_ = std::make_unique<FlatGeobuf::PackedRTree>(nodes, extent_);
+        std::cout << "Indexed " << feature_count << " features in Web Mercator (source EPSG:" << projection_.source_code() << ")."
+                  << std::endl;
+    }
+
+    // Collects the rings of a feature, projected into `projected` and redirected to it unless the source is Web Mercator.
+    void vector_tile_generator::collect_projected_rings(const std::uint64_t feature_index, std::vector<ring_view>& out_rings,
+                                                        std::vector<double>& projected) const noexcept(false)
+    {
+        const FlatGeobuf::Geometry* const geometry {dataset_.feature(feature_index)->geometry()};
+        geometry_processor::collect_rings(geometry, dataset_.geometry_type_of(geometry), out_rings);
+        if (projection_.is_identity())
+            return;
+
+        // Sized before any ring is redirected, so the buffer does not move under them
+        std::size_t coordinates {};
+        for (const ring_view& ring: out_rings)
+            coordinates += 2u * ring.point_count;
+        projected.resize(coordinates);
+        double* xy {projected.data()};
+        for (ring_view& ring: out_rings)
+        {
+            for (std::uint32_t p {}; p < ring.point_count; ++p)
+            {
+                const auto [mx, my] = projection_.project(ring.x(p), ring.y(p));
+                xy[2u * p] = mx;
+                xy[2u * p + 1u] = my;
+            }
+            ring.xy = xy;
+            xy += 2u * ring.point_count;
+        }
+    }
+
+    // Appends key/value tag pairs for the properties of a feature.
+    void vector_tile_generator::append_tags(const FlatGeobuf::Feature* const feature, mvt_layer_builder& layer,
+                                            std::vector<std::uint32_t>& tags) const noexcept(false)
+    {
+        tags.clear();
+        const auto* const columns = dataset_.header()->columns();
+        const auto* const properties = feature->properties();
+        if (!columns || !properties)
+            return;
+
+        const std::uint8_t* const data {properties->data()};
+        const flatbuffers::uoffset_t size {properties->size()};
+        flatbuffers::uoffset_t offset {};
+        while (offset + sizeof(std::uint16_t) <= size)
+        {
+            const std::uint16_t column_index {flatbuffers::ReadScalar<std::uint16_t>(data + offset)};
+            offset += sizeof(std::uint16_t);
+            if (column_index >= columns->size())
+                return;
+
+            const FlatGeobuf::Column* const column {columns->Get(column_index)};
+            const FgbColumnType type {column->type()};
+            const flatbuffers::uoffset_t value_size {feature_properties::skip_value_at_offset(type, data, offset, size)};
+            if ((value_size == 0u) || (offset + value_size > size))
+                return;
+
+            const std::uint8_t* const value {data + offset};
+            const auto scalar = [value]<class T>(T) { return flatbuffers::ReadScalar<T>(value); };
+            std::optional<std::uint32_t> value_index {};
+            switch (type)
+            {
+                case FgbColumnType::Byte:
+                    value_index = layer.int_value_index(scalar(std::int8_t {}));
+                    break;
+                case FgbColumnType::UByte:
+                    value_index = layer.uint_value_index(scalar(std::uint8_t {}));
+                    break;
+                case FgbColumnType::Bool:
+                    value_index = layer.bool_value_index(scalar(std::uint8_t {}) != 0u);
+                    break;
+                case FgbColumnType::Short:
+                    value_index = layer.int_value_index(scalar(std::int16_t {}));
+                    break;
+                case FgbColumnType::UShort:
+                    value_index = layer.uint_value_index(scalar(std::uint16_t {}));
+                    break;
+                case FgbColumnType::Int:
+                    value_index = layer.int_value_index(scalar(std::int32_t {}));
+                    break;
+                case FgbColumnType::UInt:
+                    value_index = layer.uint_value_index(scalar(std::uint32_t {}));
+                    break;
+                case FgbColumnType::Long:
+                    value_index = layer.int_value_index(scalar(std::int64_t {}));
+                    break;
+                case FgbColumnType::ULong:
+                    value_index = layer.uint_value_index(scalar(std::uint64_t {}));
+                    break;
+                case FgbColumnType::Float:
+                    value_index = layer.double_value_index(scalar(float {}));
+                    break;
+                case FgbColumnType::Double:
+                    value_index = layer.double_value_index(scalar(double {}));
+                    break;
+                case FgbColumnType::String:
+                case FgbColumnType::Json:
+                case FgbColumnType::DateTime:
+                    value_index = layer.string_value_index(
+                        {reinterpret_cast<const char*>(value + sizeof(std::uint32_t)), value_size - sizeof(std::uint32_t)});
+                    break;
+                default: // Binary values have no vector tile representation
+                    break;
+            }
+            offset += value_size;
+
+            if (value_index.has_value())
+            {
+                tags.push_back(layer.key_index(column->name() ? column->name()->string_view() : std::string_view {}));
+                tags.push_back(*value_index);
+            }
+        }
+    }
+
+    // Generates the tiles of one zoom level.
+    std::optional<std::uint64_t> vector_tile_generator::generate_zoom(const std::uint32_t zoom) noexcept(false)
+    {
+        constexpr double half_world {web_mercator_projection::half_world_size};
+        const std::uint64_t tiles_per_axis {std::uint64_t {1u} << zoom};
+        const double tile_size {2.0 * half_world / static_cast<double>(tiles_per_axis)};
+        const double buffer {tile_size * settings_.buffer / settings_.extent};
+        const auto tile_index = [&](const double offset)
+        { return static_cast<std::uint64_t>(std::clamp(std::floor(offset / tile_size), 0.0, static_cast<double>(tiles_per_axis - 1u))); };
+
+        const std::uint64_t x_begin {tile_index(extent_.minX - buffer + half_world)};
+        const std::uint64_t x_end {tile_index(extent_.maxX + buffer + half_world) + 1u};
+        const std::uint64_t y_begin {tile_index(half_world - extent_.maxY - buffer)};
+        const std::uint64_t y_end {tile_index(half_world - extent_.minY + buffer) + 1u};
+        const std::uint64_t columns {x_end - x_begin};
+        const std::uint64_t tile_count {columns * (y_end - y_begin)};
+
+        std::atomic<std::uint64_t> written {};
+        std::atomic<bool> failed {};
+        const double scale {settings_.extent / tile_size};
+        const double clip_min {-static_cast<double>(settings_.buffer)};
+        const double clip_max {static_cast<double>(settings_.extent + settings_.buffer)};
+
+        const auto process_tiles = [&](const std::size_t begin, const std::size_t end)
+        {
+            tile_scratch scratch {};
+            scratch.clipper.set_rectangle(clip_min, clip_min, clip_max, clip_max);
+            mvt_layer_builder layer {layer_name_, settings_.extent};
+            for (std::size_t t {begin}; (t < end) && !failed.load(std::memory_order_relaxed); ++t)
+            {
+                const std::uint64_t x {x_begin + t % columns};
+                const std::uint64_t y {y_begin + t / columns};
+                const double tile_min_x {-half_world + static_cast<double>(x) * tile_size};
+                const double tile_max_y {half_world - static_cast<double>(y) * tile_size};
+
+                const double tile_min_y {tile_max_y - tile_size};
+                std::vector<FlatGeobuf::SearchResultItem> hits {
+                    index_->search(tile_min_x - buffer, tile_min_y - buffer, tile_min_x + tile_size + buffer, tile_max_y + buffer)};
+                if (hits.empty())
+                    continue;
+                std::sort(hits.begin(), hits.end(), [](const auto& a, const auto& b) { return a.offset < b.offset; });
+
+                layer.clear();
+                for (const FlatGeobuf::SearchResultItem& hit: hits)
+                {
+                    collect_projected_rings(hit.offset, scratch.rings, scratch.projected);
+                    // Every polygon is clipped on its own; the window may cut it into several
+                    scratch.clipped.clear();
+                    bool polygon_open {};
+                    for (const ring_view& source: scratch.rings)
+                    {
+                        if (source.is_exterior)
+                        {
+                            if (polygon_open)
+                                scratch.clipper.clip_polygon(scratch.clipped);
+                            scratch.clipper.begin_polygon();
+                            polygon_open = true;
+                        }
+                        for (std::uint32_t p {}; p < source.point_count; ++p)
+                            scratch.clipper.add_point((source.x(p) - tile_min_x) * scale, (tile_max_y - source.y(p)) * scale);
+                        scratch.clipper.end_ring();
+                    }
+                    if (polygon_open)
+                        scratch.clipper.clip_polygon(scratch.clipped);
+
+                    scratch.geometry.clear();
+                    tile_point cursor {};
+                    for (std::size_t polygon {}; polygon < scratch.clipped.polygon_count(); ++polygon)
+                    {
+                        const std::size_t exterior {scratch.clipped.first_ring(polygon)};
+                        for (std::size_t r {exterior}; r < scratch.clipped.polygon_ends[polygon]; ++r)
+                        {
+                            const std::span<const tile_coordinate> ring {scratch.clipped.ring(r)};
+                            scratch.ring.assign(ring.begin(), ring.end());
+                            simplify_ring(scratch, settings_.simplify_tolerance);
+
+                            // Holes of a dropped exterior ring are dropped with it
+                            std::int64_t area2 {};
+                            if (!quantize_ring(scratch.ring, scratch.points, area2))
+                            {
+                                if (r == exterior)
+                                    break;
+                                continue;
+                            }
+                            // Exterior rings have positive area in tile coordinates (clockwise with y down), holes negative
+                            if ((area2 > 0) != (r == exterior))
+                                std::reverse(scratch.points.begin(), scratch.points.end());
+                            mvt_layer_builder::encode_ring(scratch.points, cursor, scratch.geometry);
+                        }
+                    }
+
+                    if (scratch.geometry.empty())
+                        continue;
+                    append_tags(dataset_.feature(hit.offset), layer, scratch.tags);
+                    layer.add_polygon(hit.offset, scratch.tags, scratch.geometry);
+                }
+                if (layer.empty())
+                    continue;
+
+                layer.write_tile(scratch.tile);
+                const std::filesystem::path directory {std::filesystem::path {output_directory_} / std::to_string(zoom) /
+                                                       std::to_string(x)};
+                std::error_code error {};
+                std::filesystem::create_directories(directory, error);
+                std::ofstream tile_file {directory / (std::to_string(y) + ".pbf"), std::ios::binary | std::ios::trunc};
+                tile_file.write(scratch.tile.data(), static_cast<std::streamsize>(scratch.tile.size()));
+                if (!tile_file)
+                {
+                    if (!failed.exchange(true))
+                        std::cerr << "Error: Could not write tile " << zoom << "/" << x << "/" << y << " in " << directory << std::endl;
+                    return;
+                }
+                written.fetch_add(1u, std::memory_order_relaxed);
+            }
+        };
+
+        const std::size_t chunk_size {std::max<std::size_t>(1u, static_cast<std::size_t>(tile_count) / (thread_pool_.size() * 16u + 1u))};
+        thread_pool_.parallel_for(static_cast<std::size_t>(tile_count), chunk_size, process_tiles);
+        if (failed.load())
+            return std::nullopt;
+
+        std::cout << "Zoom " << zoom << ": " << written.load() << " of " << tile_count << " candidate tiles written." << std::endl;
+        return written.load();
+    }
+
+    // Writes `metadata.json` describing the tile set.
+    bool vector_tile_generator::write_metadata() const noexcept(false)
+    {
+        const std::filesystem::path path {std::filesystem::path {output_directory_} / "metadata.json"};
+        std::ofstream metadata {path, std::ios::trunc};
+        if (!metadata.is_open())
+        {
+            std::cerr << "Error: Could not open metadata file for writing: " << path << std::endl;
+            return false;
+        }
+
+        const auto [west, south] = web_mercator_projection::to_lon_lat(extent_.minX, extent_.minY);
+        const auto [east, north] = web_mercator_projection::to_lon_lat(extent_.maxX, extent_.maxY);
+        const std::string name {json_escape(layer_name_)};
+        metadata.precision(8);
+        metadata << "{\n  \"name\": \"" << name << "\",\n  \"format\": \"pbf\",\n  \"scheme\": \"xyz\",\n"
+                 << "  \"minzoom\": " << settings_.min_zoom << ",\n  \"maxzoom\": " << settings_.max_zoom << ",\n"
+                 << "  \"bounds\": [" << west << ", " << south << ", " << east << ", " << north << "],\n"
+                 << "  \"center\": [" << (west + east) / 2.0 << ", " << (south + north) / 2.0 << ", " << settings_.min_zoom << "],\n"
+                 << "  \"vector_layers\": [\n    {\n      \"id\": \"" << name << "\",\n      \"fields\": {";
+
+        const char* separator {""};
+        if (const auto* const columns = dataset_.header()->columns())
+            for (flatbuffers::uoffset_t i {}; i < columns->size(); ++i)
+            {
+                const FlatGeobuf::Column* const column {columns->Get(i)};
+                const FgbColumnType type {column->type()};
+                if (type == FgbColumnType::Binary)
+                    continue;
+                const bool is_text {(type == FgbColumnType::String) || (type == FgbColumnType::Json) || (type == FgbColumnType::DateTime)};
+                metadata << separator << "\n        \"" << json_escape(column->name() ? column->name()->string_view() : "") << "\": \""
+                         << (is_text ? "String" : (type == FgbColumnType::Bool) ? "Boolean" : "Number") << "\"";
+                separator = ",";
+            }
+
+        metadata << "\n      },\n      \"minzoom\": " << settings_.min_zoom << ",\n      \"maxzoom\": " << settings_.max_zoom
+                 << "\n    }\n  ]\n}\n";
+        if (!metadata)
+        {
+            std::cerr << "Error: Failed writing metadata file: " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,164 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file web_mercator.cpp
+#include "kmx/gis/web_mercator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace kmx::gis
+{
+    static constexpr double degrees_to_radians {std::numbers::pi / 180.0};
+    static constexpr double arc_seconds_to_radians {degrees_to_radians / 3600.0};
+    /// @brief Latitude limit of the square Web Mercator world.
+    static constexpr double max_mercator_latitude {85.05112877980659 * degrees_to_radians};
+
+    /// @brief Krassovsky 1940 ellipsoid (Pulkovo 1942(58) datum).
+    static constexpr double krassovsky_a {6378245.0};
+    static constexpr double krassovsky_f {1.0 / 298.3};
+    /// @brief WGS 84 ellipsoid.
+    static constexpr double wgs84_a {6378137.0};
+    static constexpr double wgs84_f {1.0 / 298.257223563};
+
+    /// @brief Stereo 70 projection parameters.
+    static constexpr double stereo_70_lat0 {46.0 * degrees_to_radians};
+    static constexpr double stereo_70_lon0 {25.0 * degrees_to_radians};
+    static constexpr double stereo_70_k0 {0.99975};
+    static constexpr double stereo_70_false_easting {500000.0};
+    static constexpr double stereo_70_false_northing {500000.0};
+
+    /// @brief Pulkovo 1942(58) to WGS 84 (EPSG:15994), coordinate frame rotation convention.
+    static constexpr double helmert_tx {2.329}, helmert_ty {-147.042}, helmert_tz {-92.08};
+    static constexpr double helmert_rx {0.309 * arc_seconds_to_radians};
+    static constexpr double helmert_ry {-0.325 * arc_seconds_to_radians};
+    static constexpr double helmert_rz {-0.497 * arc_seconds_to_radians};
+    static constexpr double helmert_scale {1.0 + 5.69e-6};
+
+    web_mercator_projection::web_mercator_projection(const FlatGeobuf::Header* const fbs_header) noexcept(false)
+    {
+        const FlatGeobuf::Crs* const crs {fbs_header ? fbs_header->crs() : nullptr};
+        if (!crs)
+            throw std::runtime_error("The layer declares no CRS; cannot project to Web Mercator.");
+
+        const std::string_view org {crs->org() ? crs->org()->string_view() : std::string_view {"EPSG"}};
+        source_code_ = crs->code();
+        if ((org != "EPSG") && (org != "epsg"))
+            throw std::runtime_error("Unsupported CRS authority: " + std::string {org});
+
+        switch (source_code_)
+        {
+            case 3857:
+            case 900913:
+                source_ = source_crs::web_mercator;
+                return;
+            case 4326:
+                source_ = source_crs::geographic;
+                return;
+            case 3844:
+            case 31700:
+                source_ = source_crs::stereo_70;
+                break;
+            default:
+                throw std::runtime_error("Unsupported CRS for Web Mercator output: EPSG:" + std::to_string(source_code_));
+        }
+
+        // Conformal sphere of the oblique stereographic projection (IOGP guidance note 7-2, method 9809)
+        const double e2 {krassovsky_f * (2.0 - krassovsky_f)};
+        const double e {std::sqrt(e2)};
+        const double sin_lat0 {std::sin(stereo_70_lat0)};
+        const double cos_lat0 {std::cos(stereo_70_lat0)};
+        const double rho0 {krassovsky_a * (1.0 - e2) / std::pow(1.0 - e2 * sin_lat0 * sin_lat0, 1.5)};
+        const double nu0 {krassovsky_a / std::sqrt(1.0 - e2 * sin_lat0 * sin_lat0)};
+        const double radius {std::sqrt(rho0 * nu0)};
+        n_ = std::sqrt(1.0 + e2 * std::pow(cos_lat0, 4.0) / (1.0 - e2));
+        const double s1 {(1.0 + sin_lat0) / (1.0 - sin_lat0)};
+        const double s2 {(1.0 - e * sin_lat0) / (1.0 + e * sin_lat0)};
+        const double w1 {std::pow(s1 * std::pow(s2, e), n_)};
+        const double sin_chi00 {(w1 - 1.0) / (w1 + 1.0)};
+        c_ = (n_ + sin_lat0) * (1.0 - sin_chi00) / ((n_ - sin_lat0) * (1.0 + sin_chi00));
+        const double w2 {c_ * w1};
+        chi0_ = std::asin((w2 - 1.0) / (w2 + 1.0));
+        r_k0_ = radius * stereo_70_k0;
+        g_ = 2.0 * r_k0_ * std::tan(std::numbers::pi / 4.0 - chi0_ / 2.0);
+        h_ = 4.0 * r_k0_ * std::tan(chi0_) + g_;
+    }
+
+    std::pair<double, double> web_mercator_projection::from_radians(const double lon, const double lat) noexcept
+    {
+        const double clamped_lat {std::clamp(lat, -max_mercator_latitude, max_mercator_latitude)};
+        return {earth_radius * lon, earth_radius * std::log(std::tan(std::numbers::pi / 4.0 + clamped_lat / 2.0))};
+    }
+
+    std::pair<double, double> web_mercator_projection::to_lon_lat(const double mx, const double my) noexcept
+    {
+        return {mx / earth_radius / degrees_to_radians, std::atan(std::sinh(my / earth_radius)) / degrees_to_radians};
+    }
+
+    std::pair<double, double> web_mercator_projection::project(const double x, const double y) const noexcept
+    {
+        switch (source_)
+        {
+            case source_crs::web_mercator:
+                return {x, y};
+            case source_crs::geographic:
+                return from_radians(x * degrees_to_radians, y * degrees_to_radians);
+            case source_crs::stereo_70:
+            default:
+            {
+                const auto [lon, lat] = stereo_70_to_wgs84(x, y);
+                return from_radians(lon, lat);
+            }
+        }
+    }
+
+    std::pair<double, double> web_mercator_projection::stereo_70_to_wgs84(const double easting, const double northing) const noexcept
+    {
+        const double e2 {krassovsky_f * (2.0 - krassovsky_f)};
+        const double e {std::sqrt(e2)};
+        const double de {easting - stereo_70_false_easting};
+        const double dn {northing - stereo_70_false_northing};
+
+        // Inverse oblique stereographic: conformal sphere, then iterate back to the geodetic latitude
+        const double i {std::atan(de / (h_ + dn))};
+        const double j {std::atan(de / (g_ - dn)) - i};
+        const double chi {chi0_ + 2.0 * std::atan((dn - de * std::tan(j / 2.0)) / (2.0 * r_k0_))};
+        const double lon {(j + 2.0 * i) / n_ + stereo_70_lon0};
+        const double sin_chi {std::sin(chi)};
+        const double psi {0.5 * std::log((1.0 + sin_chi) / (c_ * (1.0 - sin_chi))) / n_};
+        double lat {2.0 * std::atan(std::exp(psi)) - std::numbers::pi / 2.0};
+        for (int iteration {}; iteration < 6; ++iteration)
+        {
+            const double sin_lat {std::sin(lat)};
+            const double psi_i {std::log(std::tan(lat / 2.0 + std::numbers::pi / 4.0) *
+                                         std::pow((1.0 - e * sin_lat) / (1.0 + e * sin_lat), e / 2.0))};
+            lat -= (psi_i - psi) * std::cos(lat) * (1.0 - e2 * sin_lat * sin_lat) / (1.0 - e2);
+        }
+
+        // Geodetic to geocentric on Krassovsky (height 0)
+        const double sin_lat {std::sin(lat)};
+        const double cos_lat {std::cos(lat)};
+        const double nu {krassovsky_a / std::sqrt(1.0 - e2 * sin_lat * sin_lat)};
+        const double xs {nu * cos_lat * std::cos(lon)};
+        const double ys {nu * cos_lat * std::sin(lon)};
+        const double zs {nu * (1.0 - e2) * sin_lat};
+
+        // Helmert transformation, coordinate frame rotation
+        const double xt {helmert_scale * (xs + helmert_rz * ys - helmert_ry * zs) + helmert_tx};
+        const double yt {helmert_scale * (-helmert_rz * xs + ys + helmert_rx * zs) + helmert_ty};
+        const double zt {helmert_scale * (helmert_ry * xs - helmert_rx * ys + zs) + helmert_tz};
+
+        // Geocentric to geodetic on WGS 84 (Bowring)
+        const double wgs_e2 {wgs84_f * (2.0 - wgs84_f)};
+        const double wgs_b {wgs84_a * (1.0 - wgs84_f)};
+        const double ep2 {(wgs84_a * wgs84_a - wgs_b * wgs_b) / (wgs_b * wgs_b)};
+        const double p {std::hypot(xt, yt)};
+        const double theta {std::atan2(zt * wgs84_a, p * wgs_b)};
+        const double sin_theta {std::sin(theta)};
+        const double cos_theta {std::cos(theta)};
+        const double wgs_lat {std::atan2(zt + ep2 * wgs_b * sin_theta * sin_theta * sin_theta,
+                                         p - wgs_e2 * wgs84_a * cos_theta * cos_theta * cos_theta)};
+        return {std::atan2(yt, xt), wgs_lat};
+    }
+
+} // namespace kmx::gis
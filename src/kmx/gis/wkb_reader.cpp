@@ -0,0 +1,198 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file wkb_reader.cpp
+#include "kmx/gis/wkb_reader.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+namespace kmx::gis
+{
+    static constexpr std::uint32_t ewkb_z_flag {0x80000000u};    /// EWKB flag: coordinates have Z.
+    static constexpr std::uint32_t ewkb_m_flag {0x40000000u};    /// EWKB flag: coordinates have M.
+    static constexpr std::uint32_t ewkb_srid_flag {0x20000000u}; /// EWKB flag: an SRID follows the type.
+
+    // Reads a value stored in the byte order given by the WKB byte order flag.
+    template <class T>
+    static T read_value(const std::uint8_t* const data, const bool little_endian) noexcept
+    {
+        std::array<std::uint8_t, sizeof(T)> bytes {};
+        std::memcpy(bytes.data(), data, sizeof(T));
+        if (little_endian != (std::endian::native == std::endian::little))
+            std::reverse(bytes.begin(), bytes.end());
+        return std::bit_cast<T>(bytes);
+    }
+
+    // Value of a hex digit, or -1.
+    static int hex_digit_value(const char c) noexcept
+    {
+        if ((c >= '0') && (c <= '9'))
+            return c - '0';
+        const char lower {static_cast<char>(c | 0x20)};
+        if ((lower >= 'a') && (lower <= 'f'))
+            return lower - 'a' + 10;
+        return -1;
+    }
+
+#if defined(__SSE2__)
+    // Decodes 16 hex digits into 8 bytes; returns false if one of them is not a hex digit.
+    static bool hex_decode_16(const char* const hex, std::uint8_t* const out) noexcept
+    {
+        const __m128i chars {_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex))};
+        const __m128i lower {_mm_or_si128(chars, _mm_set1_epi8(0x20))};
+        // Signed compares: bytes >= 0x80 are negative and fail both ranges.
+        const __m128i is_digit {
+            _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)))};
+        const __m128i is_alpha {
+            _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)))};
+        if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha)) != 0xFFFF)
+            return false;
+
+        const __m128i digits {_mm_and_si128(is_digit, _mm_sub_epi8(chars, _mm_set1_epi8('0')))};
+        const __m128i letters {_mm_and_si128(is_alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10)))};
+        const __m128i nibbles {_mm_or_si128(digits, letters)};
+        // Each 16-bit lane holds (high nibble, low nibble) in its (low, high) byte.
+        const __m128i high {_mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4)};
+        const __m128i low {_mm_srli_epi16(nibbles, 8)};
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(_mm_or_si128(high, low), _mm_setzero_si128()));
+        return true;
+    }
+#endif
+
+    // Decodes hexadecimal text into bytes.
+    bool wkb_reader::hex_decode(const std::string_view hex, std::vector<std::uint8_t>& out) noexcept(false)
+    {
+        out.clear();
+        if ((hex.size() % 2u) != 0u)
+            return false;
+        out.resize(hex.size() / 2u);
+
+        std::size_t i {};
+#if defined(__SSE2__)
+        for (; (i + 16u) <= hex.size(); i += 16u)
+            if (!hex_decode_16(hex.data() + i, out.data() + i / 2u))
+                return false;
+#endif
+        for (; i < hex.size(); i += 2u)
+        {
+            const int high {hex_digit_value(hex[i])};
+            const int low {hex_digit_value(hex[i + 1u])};
+            if ((high < 0) || (low < 0))
+                return false;
+            out[i / 2u] = static_cast<std::uint8_t>((high << 4) | low);
+        }
+        return true;
+    }
+
+    // Decodes one polygonal WKB geometry.
+    std::size_t wkb_reader::read_polygonal(const std::span<const std::uint8_t> wkb, polygon_buffer& out) noexcept(false)
+    {
+        const std::size_t ring_count {out.rings.size()};
+        const std::size_t size {read_geometry(wkb, &out)};
+        if (size == 0u)
+            out.truncate(ring_count);
+        return size;
+    }
+
+    // Measures one WKB geometry.
+    std::size_t wkb_reader::measure(const std::span<const std::uint8_t> wkb) noexcept
+    {
+        return read_geometry(wkb, nullptr);
+    }
+
+    // Reads a byte order flag and a geometry type; returns false if they are truncated or invalid.
+    static bool read_type(const std::span<const std::uint8_t> wkb, std::size_t& offset, bool& little_endian, std::uint32_t& type,
+                          std::uint32_t& dimensions) noexcept
+    {
+        if ((offset + 5u) > wkb.size() || (wkb[offset] > 1u))
+            return false;
+        little_endian = (wkb[offset] == 1u);
+        const std::uint32_t raw_type {read_value<std::uint32_t>(wkb.data() + offset + 1u, little_endian)};
+        offset += 5u;
+        if ((raw_type & ewkb_srid_flag) != 0u)
+        {
+            if ((offset + 4u) > wkb.size())
+                return false;
+            offset += 4u;
+        }
+
+        // ISO WKB encodes Z/M as 1000/2000/3000 added to the type, EWKB as high bits.
+        const std::uint32_t iso_type {raw_type & 0x0FFFFFFFu};
+        const std::uint32_t iso_dimensions {iso_type / 1000u};
+        const bool has_z {((raw_type & ewkb_z_flag) != 0u) || (iso_dimensions == 1u) || (iso_dimensions == 3u)};
+        const bool has_m {((raw_type & ewkb_m_flag) != 0u) || (iso_dimensions == 2u) || (iso_dimensions == 3u)};
+        type = iso_type % 1000u;
+        dimensions = 2u + (has_z ? 1u : 0u) + (has_m ? 1u : 0u);
+        return iso_dimensions <= 3u;
+    }
+
+    // Decodes or measures a Polygon or MultiPolygon geometry.
+    std::size_t wkb_reader::read_geometry(const std::span<const std::uint8_t> wkb, polygon_buffer* const out) noexcept(false)
+    {
+        std::size_t offset {};
+        bool little_endian {};
+        std::uint32_t type {};
+        std::uint32_t dimensions {};
+        if (!read_type(wkb, offset, little_endian, type, dimensions))
+            return 0u;
+
+        if (type == polygon_type_)
+            return read_polygon_body(wkb, offset, little_endian, dimensions, 0u, out) ? offset : 0u;
+        if (type != multi_polygon_type_)
+            return 0u;
+
+        if ((offset + 4u) > wkb.size())
+            return 0u;
+        const std::uint32_t polygon_count {read_value<std::uint32_t>(wkb.data() + offset, little_endian)};
+        offset += 4u;
+        for (std::uint32_t p {}; p < polygon_count; ++p)
+        {
+            // Every part carries its own byte order and type.
+            bool part_little_endian {};
+            std::uint32_t part_type {};
+            std::uint32_t part_dimensions {};
+            if (!read_type(wkb, offset, part_little_endian, part_type, part_dimensions) || (part_type != polygon_type_) ||
+                !read_polygon_body(wkb, offset, part_little_endian, part_dimensions, p, out))
+                return 0u;
+        }
+        return offset;
+    }
+
+    // Decodes or measures the rings of a Polygon.
+    bool wkb_reader::read_polygon_body(const std::span<const std::uint8_t> wkb, std::size_t& offset, const bool little_endian,
+                                       const std::uint32_t dimensions, const std::uint32_t polygon_index,
+                                       polygon_buffer* const out) noexcept(false)
+    {
+        if ((offset + 4u) > wkb.size())
+            return false;
+        const std::uint32_t ring_count {read_value<std::uint32_t>(wkb.data() + offset, little_endian)};
+        offset += 4u;
+
+        const std::size_t point_size {dimensions * sizeof(double)};
+        for (std::uint32_t r {}; r < ring_count; ++r)
+        {
+            if ((offset + 4u) > wkb.size())
+                return false;
+            const std::uint32_t point_count {read_value<std::uint32_t>(wkb.data() + offset, little_endian)};
+            offset += 4u;
+            if (point_count > (wkb.size() - offset) / point_size)
+                return false;
+
+            if (out != nullptr)
+            {
+                out->begin_ring(polygon_index, r == 0u);
+                for (std::uint32_t i {}; i < point_count; ++i)
+                {
+                    const std::uint8_t* const point {wkb.data() + offset + i * point_size};
+                    out->add_point(read_value<double>(point, little_endian), read_value<double>(point + sizeof(double), little_endian));
+                }
+            }
+            offset += point_count * point_size;
+        }
+        return true;
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,134 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file wkt_reader.cpp
+#include "kmx/gis/wkt_reader.hpp"
+#include <cctype>
+#include <charconv>
+
+namespace kmx::gis
+{
+    // Skips whitespace and consumes `c` if it comes next.
+    bool wkt_reader::cursor::accept(const char c) noexcept
+    {
+        while ((position < end) && std::isspace(static_cast<unsigned char>(*position)))
+            ++position;
+        if ((position == end) || (*position != c))
+            return false;
+        ++position;
+        return true;
+    }
+
+    // Skips whitespace and reads an upper-cased keyword (truncated to the buffer size).
+    std::string_view wkt_reader::cursor::keyword(char (&out)[16u]) noexcept
+    {
+        while ((position < end) && std::isspace(static_cast<unsigned char>(*position)))
+            ++position;
+        std::size_t length {};
+        for (; (position < end) && std::isalpha(static_cast<unsigned char>(*position)); ++position)
+            if (length < sizeof(out))
+                out[length++] = static_cast<char>(std::toupper(static_cast<unsigned char>(*position)));
+        return {out, length};
+    }
+
+    // Skips whitespace and parses a number (`std::from_chars` does not take a leading '+').
+    bool wkt_reader::cursor::number(double& value) noexcept
+    {
+        while ((position < end) && std::isspace(static_cast<unsigned char>(*position)))
+            ++position;
+        if ((position < end) && (*position == '+'))
+            ++position;
+        const auto [ptr, ec] = std::from_chars(position, end, value);
+        if (ec != std::errc {})
+            return false;
+        position = ptr;
+        return true;
+    }
+
+    // Parses one ring; points may carry Z and M values, which are skipped.
+    bool wkt_reader::read_ring(cursor& text, const std::uint32_t polygon_index, const bool is_exterior, polygon_buffer& out) noexcept(false)
+    {
+        if (!text.accept('('))
+            return false;
+        out.begin_ring(polygon_index, is_exterior);
+        do
+        {
+            double x {};
+            double y {};
+            if (!text.number(x) || !text.number(y))
+                return false;
+            for (double ignored {}; text.number(ignored);)
+                ;
+            out.add_point(x, y);
+        } while (text.accept(','));
+        return text.accept(')');
+    }
+
+    // Parses one polygon: a list of rings, the first being the exterior.
+    bool wkt_reader::read_polygon(cursor& text, const std::uint32_t polygon_index, polygon_buffer& out) noexcept(false)
+    {
+        if (!text.accept('('))
+        {
+            char word[16u];
+            return text.keyword(word) == "EMPTY";
+        }
+        bool is_exterior {true};
+        do
+        {
+            if (!read_ring(text, polygon_index, is_exterior, out))
+                return false;
+            is_exterior = false;
+        } while (text.accept(','));
+        return text.accept(')');
+    }
+
+    // Parses a polygonal WKT geometry.
+    bool wkt_reader::read_polygonal(const std::string_view wkt, polygon_buffer& out) noexcept(false)
+    {
+        cursor text {wkt.data(), wkt.data() + wkt.size()};
+        char word[16u];
+        std::string_view type {text.keyword(word)};
+        // EWKT: SRID=<code>;<geometry>
+        if (type == "SRID")
+        {
+            double srid {};
+            if (!text.accept('=') || !text.number(srid) || !text.accept(';'))
+                return false;
+            type = text.keyword(word);
+        }
+        const bool is_multi {type == "MULTIPOLYGON"};
+        if (!is_multi && (type != "POLYGON"))
+            return false;
+
+        const std::size_t ring_count {out.rings.size()};
+        const char* const after_type {text.position};
+        // Optional dimension tag (Z, M or ZM) or EMPTY.
+        char tag_word[16u];
+        const std::string_view tag {text.keyword(tag_word)};
+        bool succeeded {tag == "EMPTY"};
+        if (!succeeded)
+        {
+            if ((tag != "Z") && (tag != "M") && (tag != "ZM"))
+                text.position = after_type;
+            if (!is_multi)
+                succeeded = read_polygon(text, 0u, out);
+            else if (text.accept('('))
+            {
+                std::uint32_t polygon_index {};
+                do
+                    succeeded = read_polygon(text, polygon_index++, out);
+                while (succeeded && text.accept(','));
+                succeeded = succeeded && text.accept(')');
+            }
+            else
+                succeeded = (text.keyword(tag_word) == "EMPTY");
+        }
+
+        // Nothing but whitespace may follow.
+        while (succeeded && (text.position < text.end) && std::isspace(static_cast<unsigned char>(*text.position)))
+            ++text.position;
+        succeeded = succeeded && (text.position == text.end);
+        if (!succeeded)
+            out.truncate(ring_count);
+        return succeeded;
+    }
+
+} // namespace kmx::gis
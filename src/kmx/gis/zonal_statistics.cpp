@@ -0,0 +1,193 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file zonal_statistics.cpp
+#include "kmx/gis/zonal_statistics.hpp"
+#include "flatgeobuf/packedrtree.h"
+#include "kmx/gis/feature_properties.hpp"
+#include "kmx/gis/geometry_processor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+
+namespace kmx::gis
+{
+    // Accumulates the valid pixels of `spans` into `stats`; the pixel type is resolved once per feature.
+    template <class T>
+    static void accumulate_spans(const raster_dataset& raster, const std::vector<cell_span>& spans, zonal_stats& stats) noexcept
+    {
+        const std::optional<double> no_data {raster.no_data()};
+        // Float rasters store the ignore value rounded to float precision
+        double ignored {std::numeric_limits<double>::quiet_NaN()};
+        if (no_data.has_value())
+            ignored = std::is_same_v<T, float> ? static_cast<double>(static_cast<float>(*no_data)) : *no_data;
+        const std::size_t stride {raster.pixel_stride()};
+        for (const cell_span& span: spans)
+        {
+            const std::uint8_t* address {raster.pixel_address(span.row, span.col_begin)};
+            for (std::uint32_t col {span.col_begin}; col < span.col_end; ++col, address += stride)
+            {
+                const auto value = static_cast<double>(raster.template read<T>(address));
+                if ((value == ignored) || std::isnan(value))
+                    continue;
+                ++stats.count;
+                stats.sum += value;
+                stats.min = std::min(stats.min, value);
+                stats.max = std::max(stats.max, value);
+            }
+        }
+    }
+
+    zonal_statistics::zonal_statistics(const std::string& input_fgb_path, const std::string& raster_path,
+                                       const std::string& output_csv_path, const std::uint32_t num_threads) noexcept(false):
+        output_csv_path_ {output_csv_path},
+        thread_pool_ {num_threads},
+        dataset_ {input_fgb_path},
+        raster_ {raster_path}
+    {
+        std::cout << "Thread pool initialized with " << num_threads << " threads.\n";
+    }
+
+    // Orders the features by the Hilbert index of the raster block containing their bounding box centre.
+    std::vector<std::uint32_t> zonal_statistics::tile_aware_order() const noexcept(false)
+    {
+        const raster_grid& grid {raster_.grid()};
+        const auto feature_count = static_cast<std::uint32_t>(dataset_.feature_count());
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> keyed(feature_count);
+        for (std::uint32_t i {}; i < feature_count; ++i)
+        {
+            const bounding_box bbox {dataset_.feature_bbox(i)};
+            std::uint32_t key {};
+            if (bbox.is_valid)
+            {
+                const auto block_of = [](const double pixel)
+                { return static_cast<std::uint32_t>(std::clamp(std::floor(pixel / block_size_), 0.0, 65535.0)); };
+                key = FlatGeobuf::hilbert(block_of(grid.column_of((bbox.min_x + bbox.max_x) / 2.0)),
+                                          block_of(grid.row_of((bbox.min_y + bbox.max_y) / 2.0)));
+            }
+            keyed[i] = {key, i};
+        }
+        std::sort(keyed.begin(), keyed.end());
+
+        std::vector<std::uint32_t> order(feature_count);
+        std::transform(keyed.begin(), keyed.end(), order.begin(), [](const auto& k) { return k.second; });
+        return order;
+    }
+
+    bool zonal_statistics::compute() noexcept(false)
+    {
+        const FgbGeometryType header_geom_type {dataset_.geometry_type()};
+        if ((header_geom_type != FgbGeometryType::Polygon) && (header_geom_type != FgbGeometryType::MultiPolygon))
+        {
+            std::cerr << "Error: Zonal statistics require Polygon/MultiPolygon FGB files. Found: "
+                      << FlatGeobuf::EnumNameGeometryType(header_geom_type) << std::endl;
+            return false;
+        }
+        if (dataset_.feature_count() > std::numeric_limits<std::uint32_t>::max())
+        {
+            std::cerr << "Error: Too many features for zonal statistics: " << dataset_.feature_count() << std::endl;
+            return false;
+        }
+
+        const raster_grid& grid {raster_.grid()};
+        std::cout << "Raster: " << grid.cols << " x " << grid.rows << " pixels of " << grid.cell_width << " x "
+                  << std::abs(grid.cell_height) << ", " << raster_dataset::size_of(raster_.data_type()) << "-byte values." << std::endl;
+
+        const std::vector<std::uint32_t> order {tile_aware_order()};
+        std::vector<zonal_stats> results(order.size());
+        thread_pool_.parallel_for(order.size(), features_per_task_,
+                                  [&](const std::size_t begin, const std::size_t end)
+                                  {
+                                      polygon_rasterizer rasterizer {};
+                                      std::vector<ring_view> rings {};
+                                      std::vector<cell_span> spans {};
+                                      const std::size_t ahead {dataset_.prefetch_distance()};
+                                      for (std::size_t k {begin}; k < end; ++k)
+                                      {
+                                          if ((k + ahead) < end)
+                                              dataset_.prefetch_feature(order[k + ahead]);
+                                          const std::uint32_t i {order[k]};
+                                          const FlatGeobuf::Geometry* const geometry {dataset_.feature(i)->geometry()};
+                                          geometry_processor::collect_rings(geometry, dataset_.geometry_type_of(geometry), rings);
+                                          rasterizer.fill(rings, grid, spans);
+
+                                          zonal_stats& stats {results[i]};
+                                          switch (raster_.data_type())
+                                          {
+                                              case raster_data_type::uint8:
+                                                  accumulate_spans<std::uint8_t>(raster_, spans, stats);
+                                                  break;
+                                              case raster_data_type::int16:
+                                                  accumulate_spans<std::int16_t>(raster_, spans, stats);
+                                                  break;
+                                              case raster_data_type::uint16:
+                                                  accumulate_spans<std::uint16_t>(raster_, spans, stats);
+                                                  break;
+                                              case raster_data_type::int32:
+                                                  accumulate_spans<std::int32_t>(raster_, spans, stats);
+                                                  break;
+                                              case raster_data_type::uint32:
+                                                  accumulate_spans<std::uint32_t>(raster_, spans, stats);
+                                                  break;
+                                              case raster_data_type::int64:
+                                                  accumulate_spans<std::int64_t>(raster_, spans, stats);
+                                                  break;
+                                              case raster_data_type::uint64:
+                                                  accumulate_spans<std::uint64_t>(raster_, spans, stats);
+                                                  break;
+                                              case raster_data_type::float32:
+                                                  accumulate_spans<float>(raster_, spans, stats);
+                                                  break;
+                                              case raster_data_type::float64:
+                                                  accumulate_spans<double>(raster_, spans, stats);
+                                                  break;
+                                          }
+                                      }
+                                  });
+
+        std::cout << "Computed statistics for " << results.size() << " features." << std::endl;
+        return write_results(results);
+    }
+
+    // Writes the result rows in feature order.
+    bool zonal_statistics::write_results(const std::vector<zonal_stats>& results) const noexcept(false)
+    {
+        std::ofstream output_file {output_csv_path_};
+        if (!output_file.is_open())
+        {
+            std::cerr << "Error: Could not open CSV file for writing: " << output_csv_path_ << std::endl;
+            return false;
+        }
+
+        const std::optional<std::size_t> code_column {dataset_.find_column(expected_uat_code_column_)};
+        if (!code_column.has_value())
+            std::cout << "Warning: Could not find the expected UAT code property '" << expected_uat_code_column_
+                      << "'. UAT codes will be written as 0." << std::endl;
+
+        output_file.precision(15);
+        output_file << "feature_index,uat_code,count,sum,min,max,mean\n";
+        for (std::size_t i {}; i < results.size(); ++i)
+        {
+            std::uint32_t uat_code {};
+            if (code_column.has_value())
+                uat_code = feature_properties::parse_uint32(
+                               feature_properties::get_string_value(dataset_.feature(i), dataset_.header(), *code_column))
+                               .value_or(0u);
+            const zonal_stats& stats {results[i]};
+            output_file << i << ',' << uat_code << ',' << stats.count << ',' << stats.sum << ',';
+            if (stats.count != 0u)
+                output_file << stats.min << ',' << stats.max << ',' << stats.sum / static_cast<double>(stats.count) << '\n';
+            else
+                output_file << ",,\n";
+        }
+
+        if (!output_file)
+        {
+            std::cerr << "Error: Failed writing CSV file: " << output_csv_path_ << std::endl;
+            return false;
+        }
+        std::cout << "Output written to: " << output_csv_path_ << std::endl;
+        return true;
+    }
+
+} // namespace kmx::gis
@@ -0,0 +1,134 @@
+/// Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file ring_clipper_test.cpp
+#include "kmx/gis/ring_clipper.hpp"
+#include <cmath>
+#include <initializer_list>
+#include <iostream>
+#include <utility>
+
+namespace
+{
+    struct point
+    {
+        double x;
+        double y;
+    };
+
+    using polygon = std::initializer_list<std::initializer_list<std::pair<double, double>>>;
+
+    int failures {};
+
+    void check(const bool condition, const char* const what) noexcept(false)
+    {
+        if (condition)
+            return;
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+
+    /// @brief Clips `rings` (the exterior, then the holes) against [0, 10] x [0, 10].
+    kmx::gis::clipped_polygons<point> clip(const polygon rings) noexcept(false)
+    {
+        kmx::gis::ring_clipper<point> clipper {};
+        clipper.set_rectangle(0.0, 0.0, 10.0, 10.0);
+        clipper.begin_polygon();
+        for (const auto& ring: rings)
+        {
+            for (const auto& [x, y]: ring)
+                clipper.add_point(x, y);
+            clipper.end_ring();
+        }
+        kmx::gis::clipped_polygons<point> out {};
+        clipper.clip_polygon(out);
+        return out;
+    }
+
+    double area(const kmx::gis::clipped_polygons<point>& out, const std::size_t ring) noexcept
+    {
+        return kmx::gis::ring_clipper<point>::signed_area2(out.ring(ring)) / 2.0;
+    }
+
+    /// @brief True if no vertex of the ring appears twice (a ring touching itself repeats a vertex).
+    bool simple_vertices(const kmx::gis::clipped_polygons<point>& out, const std::size_t ring) noexcept
+    {
+        const auto vertices {out.ring(ring)};
+        for (std::size_t i {}; i < vertices.size(); ++i)
+            for (std::size_t j {i + 1u}; j < vertices.size(); ++j)
+                if ((vertices[i].x == vertices[j].x) && (vertices[i].y == vertices[j].y))
+                    return false;
+        return true;
+    }
+
+    // A U open downwards whose base lies above the window: the two arms are separate polygons, not one ring bridged
+    // along the top edge.
+    void u_shape_crossing_one_edge() noexcept(false)
+    {
+        const auto out {clip({{{2, 5}, {4, 5}, {4, 12}, {6, 12}, {6, 5}, {8, 5}, {8, 15}, {2, 15}, {2, 5}}})};
+        check(out.polygon_count() == 2u, "U shape: two polygons");
+        check(out.ring_ends.size() == 2u, "U shape: one ring per polygon");
+        for (std::size_t r {}; r < out.ring_ends.size(); ++r)
+        {
+            check(std::abs(area(out, r) - 10.0) < 1e-9, "U shape: every arm keeps an area of 10");
+            check(out.ring(r).size() == 4u, "U shape: every arm is a rectangle");
+            check(simple_vertices(out, r), "U shape: no repeated vertex");
+        }
+    }
+
+    // A clockwise ring with a notch inside the window, crossing its top edge: one polygon, counter-clockwise.
+    void notch_clockwise() noexcept(false)
+    {
+        const auto out {clip({{{2, 15}, {8, 15}, {8, 5}, {6, 5}, {6, 7}, {4, 7}, {4, 5}, {2, 5}}})};
+        check(out.polygon_count() == 1u, "clockwise notch: one polygon");
+        check(std::abs(area(out, 0u) - 26.0) < 1e-9, "clockwise notch: area 30 - 4, counter-clockwise");
+    }
+
+    // A hole crossing the right edge becomes a notch of the exterior.
+    void hole_crossing_edge() noexcept(false)
+    {
+        const auto out {clip({{{2, 2}, {12, 2}, {12, 8}, {2, 8}}, {{8, 4}, {8, 6}, {14, 6}, {14, 4}}})};
+        check(out.polygon_count() == 1u, "crossing hole: one polygon");
+        check(out.ring_ends.size() == 1u, "crossing hole: merged into the exterior");
+        check(std::abs(area(out, 0u) - 44.0) < 1e-9, "crossing hole: area 48 - 4");
+    }
+
+    // A hole inside the window stays a hole, clockwise.
+    void hole_inside() noexcept(false)
+    {
+        const auto out {clip({{{-5, -5}, {5, -5}, {5, 5}, {-5, 5}}, {{1, 1}, {3, 1}, {3, 3}, {1, 3}}})};
+        check(out.polygon_count() == 1u, "inner hole: one polygon");
+        check(out.ring_ends.size() == 2u, "inner hole: exterior and hole");
+        check(std::abs(area(out, 0u) - 25.0) < 1e-9, "inner hole: exterior area 25");
+        check(std::abs(area(out, 1u) + 4.0) < 1e-9, "inner hole: hole area -4");
+    }
+
+    // The window inside the polygon is the result; inside a hole of the polygon, nothing is.
+    void window_enclosed() noexcept(false)
+    {
+        const auto covered {clip({{{-5, -5}, {15, -5}, {15, 15}, {-5, 15}}})};
+        check(covered.polygon_count() == 1u, "enclosed window: one polygon");
+        check(std::abs(area(covered, 0u) - 100.0) < 1e-9, "enclosed window: the window");
+        const auto in_hole {clip({{{-9, -9}, {19, -9}, {19, 19}, {-9, 19}}, {{-5, -5}, {15, -5}, {15, 15}, {-5, 15}}})};
+        check(in_hole.polygon_count() == 0u, "window in a hole: nothing");
+    }
+
+    // Polygons outside the window, or only touching it along its border, leave nothing.
+    void outside_and_touching() noexcept(false)
+    {
+        check(clip({{{20, 20}, {30, 20}, {30, 30}}}).polygon_count() == 0u, "outside: nothing");
+        check(clip({{{2, -4}, {6, -4}, {6, 0}, {2, 0}}}).polygon_count() == 0u, "touching the border: nothing");
+    }
+
+} // namespace
+
+int main()
+{
+    u_shape_crossing_one_edge();
+    notch_clockwise();
+    hole_crossing_edge();
+    hole_inside();
+    window_enclosed();
+    outside_and_touching();
+    if (failures == 0)
+        std::cout << "ring_clipper_test: all passed" << std::endl;
+    return (failures == 0) ? 0 : 1;
+}